@@ -14,22 +14,25 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 CONFIG += c++17
 
+# 核心模块
+include(src/core/core.pri)
+
 SOURCES += \
     src/main.cpp \
-    src/core/agent/LLMAgent.cpp \
-    src/core/agent/ToolDispatcher.cpp \
-    src/core/utils/AppSettings.cpp \
-    src/core/utils/ToolSchemaLoader.cpp \
-    src/core/parser/TreeSitterParser.cpp \
-    src/ui/AgentChatWidget.cpp
+    src/ui/AgentChatWidget.cpp \
+    src/ui/HistoryModel.cpp \
+    src/ui/HistoryDelegate.cpp \
+    src/ui/TranscriptModel.cpp \
+    src/ui/TranscriptDelegate.cpp \
+    src/ui/TranscriptView.cpp
 
 HEADERS += \
-    src/core/agent/LLMAgent.h \
-    src/core/agent/ToolDispatcher.h \
-    src/core/utils/AppSettings.h \
-    src/core/utils/ToolSchemaLoader.h \
-    src/core/parser/TreeSitterParser.h \
-    src/ui/AgentChatWidget.h
+    src/ui/AgentChatWidget.h \
+    src/ui/HistoryModel.h \
+    src/ui/HistoryDelegate.h \
+    src/ui/TranscriptModel.h \
+    src/ui/TranscriptDelegate.h \
+    src/ui/TranscriptView.h
 
 # FORMS += \
 #    src/ui/LLMConfigWidget.ui
@@ -0,0 +1,42 @@
+# TmAgent 命令行版本（无界面，适用于 CI 与批量执行）
+QT       += core network
+QT       -= gui
+INCLUDEPATH += src
+
+# 第三方库
+include(3rdparty/yaml-cpp.pri)
+include(3rdparty/tree-sitter.pri)
+
+TARGET = TmAgentCli
+TEMPLATE = app
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 核心模块
+include(src/core/core.pri)
+
+SOURCES += \
+    src/cli/main.cpp \
+    src/cli/ApprovalPolicy.cpp \
+    src/cli/CliRunner.cpp
+
+HEADERS += \
+    src/cli/ApprovalPolicy.h \
+    src/cli/CliRunner.h
+
+# 自动复制 resources 目录到构建输出目录
+win32 {
+    RESOURCES_SRC_DIR = $$replace(PWD, /, \\)\\resources
+    BUILD_DEST_DIR = $$replace(OUT_PWD, /, \\)
+
+    CONFIG(debug, debug|release) {
+        QMAKE_POST_LINK += xcopy /Y /E /I \"$$RESOURCES_SRC_DIR\" \"$$BUILD_DEST_DIR\\debug\\resources\\\"
+    } else {
+        QMAKE_POST_LINK += xcopy /Y /E /I \"$$RESOURCES_SRC_DIR\" \"$$BUILD_DEST_DIR\\release\\resources\\\"
+    }
+}
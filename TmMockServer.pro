@@ -0,0 +1,27 @@
+# Mock LLM 服务（OpenAI 兼容的流式接口，用于压测 Agent 运行时，不消耗 token）
+QT       += core network
+QT       -= gui
+INCLUDEPATH += src
+
+TARGET = TmMockServer
+TEMPLATE = app
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# 只依赖网络层的 SSE 服务，不链接 Agent 核心模块
+SOURCES += \
+    src/core/net/SseServer.cpp \
+    src/mock/main.cpp \
+    src/mock/MockLLMServer.cpp \
+    src/mock/MockScript.cpp
+
+HEADERS += \
+    src/core/net/SessionCassette.h \
+    src/core/net/SseServer.h \
+    src/mock/MockLLMServer.h \
+    src/mock/MockScript.h
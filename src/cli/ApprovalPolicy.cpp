@@ -0,0 +1,109 @@
+#include "ApprovalPolicy.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+bool ApprovalPolicy::loadFromFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = QString("无法打开审批策略文件 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+    return loadFromJson(file.readAll());
+}
+
+bool ApprovalPolicy::loadFromJson(const QByteArray& json) {
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (!doc.isObject()) {
+        m_error = QString("审批策略格式错误: %1").arg(parseError.errorString());
+        return false;
+    }
+
+    const QJsonObject obj = doc.object();
+    const QString defaultAction = obj["default"].toString("deny");
+    if (defaultAction != "allow" && defaultAction != "deny") {
+        m_error = QString("审批策略 default 只能是 allow 或 deny，实际为 %1").arg(defaultAction);
+        return false;
+    }
+
+    m_defaultAllow = (defaultAction == "allow");
+    m_allow.clear();
+    m_deny.clear();
+    for (const QJsonValue& value : obj["allow"].toArray()) {
+        m_allow.append(compilePattern(value.toString()));
+    }
+    for (const QJsonValue& value : obj["deny"].toArray()) {
+        m_deny.append(compilePattern(value.toString()));
+    }
+    m_error.clear();
+    return true;
+}
+
+bool ApprovalPolicy::allows(const QString& command) const {
+    const QString trimmed = command.trimmed();
+    // deny 规则先对整条命令匹配，"*--force*" 这类规则不受拆分影响
+    for (const QRegularExpression& pattern : m_deny) {
+        if (pattern.match(trimmed).hasMatch()) {
+            return false;
+        }
+    }
+
+    // NOTE: 命令替换 $(…)、`…` 与进程替换 <(…)、>(…) 中的命令由 shell 先于外层命令执行，
+    // 通配符规则看到的只是外层命令（"python *" 会放过 "python build.py $(./evil.sh)"），一律拒绝
+    static const QRegularExpression substitution("\\$\\(|`|[<>]\\(");
+    if (substitution.match(trimmed).hasMatch()) {
+        return false;
+    }
+
+    const QStringList subCommands = splitCommands(trimmed);
+    if (subCommands.isEmpty()) {
+        return allowsSingle(trimmed);
+    }
+    for (const QString& subCommand : subCommands) {
+        if (!allowsSingle(subCommand)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList ApprovalPolicy::splitCommands(const QString& command) {
+    // NOTE: 与 ShellTool::isSafeCommand 一样按连接符拆分，额外处理 ;、管道、后台 & 和换行，
+    // 这些在 shell 中同样会执行后一条命令；重定向中的 &（2>&1、&>）不是连接符
+    static const QRegularExpression separator("\\s*(?:&&|\\|\\||[;|\\n]|(?<![<>])&(?!>))\\s*");
+    // 子 shell 与命令组 ( … )、{ …; } 的括号不属于命令本身
+    static const QRegularExpression grouping("^[\\s({]+|[\\s)}]+$");
+    QStringList subCommands;
+    for (const QString& part : command.split(separator)) {
+        const QString trimmedPart = QString(part).remove(grouping);
+        if (!trimmedPart.isEmpty()) {
+            subCommands << trimmedPart;
+        }
+    }
+    return subCommands;
+}
+
+bool ApprovalPolicy::allowsSingle(const QString& command) const {
+    const QString trimmed = command.trimmed();
+    for (const QRegularExpression& pattern : m_deny) {
+        if (pattern.match(trimmed).hasMatch()) {
+            return false;
+        }
+    }
+    for (const QRegularExpression& pattern : m_allow) {
+        if (pattern.match(trimmed).hasMatch()) {
+            return true;
+        }
+    }
+    return m_defaultAllow;
+}
+
+QRegularExpression ApprovalPolicy::compilePattern(const QString& pattern) {
+    // NOTE: 不用 QRegularExpression::wildcardToRegularExpression，它按文件路径处理 '/'，命令中的路径会匹配失败
+    QString regex = QRegularExpression::escape(pattern.trimmed());
+    regex.replace("\\*", ".*");
+    regex.replace("\\?", ".");
+    return QRegularExpression(QRegularExpression::anchoredPattern(regex));
+}
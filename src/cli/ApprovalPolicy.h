@@ -0,0 +1,50 @@
+#ifndef APPROVALPOLICY_H
+#define APPROVALPOLICY_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QRegularExpression>
+
+/**
+ * @brief 非交互式命令审批策略（CLI 模式代替 GUI 的执行确认弹窗）
+ *
+ * 策略文件为 JSON:
+ *   {
+ *     "default": "deny",              // 未匹配任何规则时: allow / deny
+ *     "allow": ["cmake *", "ctest*"], // 允许的命令（通配符: * 任意字符, ? 单个字符）
+ *     "deny":  ["*--force*"]          // 拒绝的命令，优先于 allow
+ *   }
+ *
+ * 未加载策略文件时拒绝所有需要确认的命令。
+ * 复合命令（&&、||、;、|、&、换行连接）按子命令逐个判断，全部允许才放行，
+ * 避免 "cmake *" 之类的规则放过 "cmake . && rm -rf ~"。子 shell ( … ) 按其中的子命令判断；
+ * 含命令替换 $(…)、`…` 或进程替换 <(…)、>(…) 的命令无法可靠拆分，一律拒绝。
+ */
+class ApprovalPolicy {
+public:
+    /**
+     * @brief 从策略文件加载
+     * @return 成功返回 true；失败时 errorString() 给出原因
+     */
+    bool loadFromFile(const QString& path);
+    bool loadFromJson(const QByteArray& json);
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief 判断命令是否允许执行（首尾空白忽略，复合命令要求每个子命令都允许）
+     */
+    bool allows(const QString& command) const;
+
+private:
+    static QRegularExpression compilePattern(const QString& pattern);
+    static QStringList splitCommands(const QString& command);
+    bool allowsSingle(const QString& command) const;
+
+    bool m_defaultAllow = false;
+    QList<QRegularExpression> m_allow;
+    QList<QRegularExpression> m_deny;
+    QString m_error;
+};
+
+#endif // APPROVALPOLICY_H
@@ -0,0 +1,479 @@
+#include "CliRunner.h"
+#include "core/agent/LLMAgent.h"
+#include "core/agent/ToolDispatcher.h"
+#include "core/events/EventBus.h"
+#include "core/orchestrator/Orchestrator.h"
+#include "core/orchestrator/BatchRunner.h"
+#include "core/net/LLMTransport.h"
+#include "core/net/RateLimiter.h"
+#include "core/metrics/MetricsRegistry.h"
+#include "core/log/Logger.h"
+#include "core/tools/ShellTool.h"
+#include "core/utils/AppSettings.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QProcessEnvironment>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTimer>
+
+// CLI 自身发布事件时使用的来源
+static const char* kCliSource = "cli";
+
+CliRunner::CliRunner(QObject *parent) : QObject(parent) {
+}
+
+// ==================== 参数与配置 ====================
+
+int CliRunner::parseArguments(const QStringList& arguments, Options& options) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TmAgent 命令行模式：运行一个 prompt、plan 文件或批量任务清单");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    const QCommandLineOption promptOption({"p", "prompt"}, "要执行的任务描述", "text");
+    const QCommandLineOption planOption("plan", "plan 文件 (JSON)，按依赖与资源锁并发执行其中的任务", "file");
+    const QCommandLineOption batchOption("batch", "批量任务清单 (JSON)，用同一模板处理多个条目，可断点续跑", "file");
+    const QCommandLineOption resultsOption("results", "批量结果文件 (JSON Lines)，默认为 <清单名>.results.jsonl", "file");
+    const QCommandLineOption rpmOption("rpm", "所有 Agent 共享的每分钟请求数上限，0 表示不限制", "n", "0");
+    const QCommandLineOption tpmOption("tpm", "所有 Agent 共享的每分钟 token 数上限，0 表示不限制", "n", "0");
+    const QCommandLineOption policyOption("policy", "命令审批策略文件 (JSON)；未指定时拒绝所有需要确认的命令", "file");
+    const QCommandLineOption formatOption("format", "输出格式: text 或 jsonl", "format", "text");
+    const QCommandLineOption timeoutOption("timeout", "总超时 (秒)，0 表示不限制", "seconds", "0");
+    const QCommandLineOption parallelOption("max-parallel", "plan / batch 模式的并发上限", "n", "0");
+    const QCommandLineOption workDirOption({"C", "workdir"}, "工作目录（写操作限定在其中）", "dir");
+    const QCommandLineOption metricsOption("metrics", "结束时把指标（首 token 延迟、生成速度、token、重试、工具耗时等）写入该文件 (JSON)，- 表示 stderr", "file");
+    const QCommandLineOption logOption("log", "日志文件 (JSON Lines，超过 10 MB 轮转)，设置后 stderr 只输出 warning 及以上", "file");
+    const QCommandLineOption logLevelOption("log-level", "日志级别: debug、info、warning 或 critical", "level");
+    const QCommandLineOption allToolsOption("all-tools", "每次请求都发送全部工具定义（默认按任务类型只发送相关工具）");
+    const QCommandLineOption sessionOption("session", "会话日志：文件已存在时恢复之前的对话并继续，每条消息追加写入", "file");
+    const QCommandLineOption sessionBinaryOption("session-binary", "新建的会话日志使用 CBOR 编码（体积更小）");
+    const QCommandLineOption forkFromOption("fork-from", "从该会话日志分叉出 --session 指定的新会话（不重新请求 LLM）", "file");
+    const QCommandLineOption forkAtOption("fork-at", "分叉时保留的记录数，默认全部", "n", "-1");
+    parser.addOptions({promptOption, planOption, batchOption, resultsOption, rpmOption, tpmOption,
+                       policyOption, formatOption, timeoutOption, parallelOption, workDirOption, metricsOption,
+                       logOption, logLevelOption, allToolsOption, sessionOption, sessionBinaryOption,
+                       forkFromOption, forkAtOption});
+    parser.addPositionalArgument("prompt", "任务描述（也可以用 --prompt 指定）", "[prompt...]");
+
+    if (!parser.parse(arguments)) {
+        fprintf(stderr, "%s\n\n%s", qPrintable(parser.errorText()), qPrintable(parser.helpText()));
+        return UsageError;
+    }
+    if (parser.isSet(helpOption)) {
+        fputs(qPrintable(parser.helpText()), stdout);
+        return Success;
+    }
+
+    options.prompt = parser.isSet(promptOption) ? parser.value(promptOption)
+                                                : parser.positionalArguments().join(' ');
+    options.planFile = parser.value(planOption);
+    options.batchFile = parser.value(batchOption);
+    options.resultsFile = parser.value(resultsOption);
+    if (options.resultsFile.isEmpty() && !options.batchFile.isEmpty()) {
+        const QFileInfo info(options.batchFile);
+        options.resultsFile = info.path() + "/" + info.completeBaseName() + ".results.jsonl";
+    }
+    options.policyFile = parser.value(policyOption);
+    options.workDir = parser.value(workDirOption);
+    options.metricsFile = parser.value(metricsOption);
+    options.logFile = parser.value(logOption);
+    options.logLevel = parser.value(logLevelOption);
+    options.allTools = parser.isSet(allToolsOption);
+    options.sessionFile = parser.value(sessionOption);
+    options.sessionBinary = parser.isSet(sessionBinaryOption);
+    options.forkFrom = parser.value(forkFromOption);
+
+    QString error;
+    const int modes = int(!options.prompt.trimmed().isEmpty()) + int(!options.planFile.isEmpty())
+                    + int(!options.batchFile.isEmpty());
+    if (modes != 1) {
+        error = "必须且只能指定 prompt、--plan、--batch 之一";
+    }
+
+    const QString format = parser.value(formatOption);
+    if (format == "text") {
+        options.format = OutputFormat::Text;
+    } else if (format == "jsonl" || format == "json") {
+        options.format = OutputFormat::JsonLines;
+    } else {
+        error = QString("未知的输出格式: %1").arg(format);
+    }
+
+    bool timeoutOk = false;
+    bool parallelOk = false;
+    bool rpmOk = false;
+    bool tpmOk = false;
+    options.timeoutSec = parser.value(timeoutOption).toInt(&timeoutOk);
+    options.maxParallel = parser.value(parallelOption).toInt(&parallelOk);
+    options.requestsPerMinute = parser.value(rpmOption).toInt(&rpmOk);
+    options.tokensPerMinute = parser.value(tpmOption).toInt(&tpmOk);
+    if (!timeoutOk || !parallelOk || !rpmOk || !tpmOk
+        || options.timeoutSec < 0 || options.maxParallel < 0
+        || options.requestsPerMinute < 0 || options.tokensPerMinute < 0) {
+        error = "--timeout、--max-parallel、--rpm 与 --tpm 必须是非负整数";
+    }
+
+    bool forkAtOk = false;
+    options.forkAt = parser.value(forkAtOption).toInt(&forkAtOk);
+    if (!forkAtOk || options.forkAt < -1) {
+        error = "--fork-at 必须是非负整数";
+    }
+    if (!options.sessionFile.isEmpty() && options.prompt.trimmed().isEmpty()) {
+        error = "--session 只能用于 prompt 模式";
+    }
+    if (!options.forkFrom.isEmpty() && options.sessionFile.isEmpty()) {
+        error = "--fork-from 需要用 --session 指定新会话的文件";
+    }
+
+    QtMsgType logLevel = QtInfoMsg;
+    if (!options.logLevel.isEmpty() && !Logger::parseLevel(options.logLevel, logLevel)) {
+        error = QString("未知的日志级别: %1").arg(options.logLevel);
+    }
+
+    if (!error.isEmpty()) {
+        fprintf(stderr, "%s\n\n%s", qPrintable(error), qPrintable(parser.helpText()));
+        return UsageError;
+    }
+    return -1;
+}
+
+bool CliRunner::loadConfig(LLMConfig& config) {
+    // NOTE: 环境变量优先，CI 中无需落盘 config.ini
+    const QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    config.apiKey = env.value("TMAGENT_API_KEY", AppSettings::getApiKey());
+    config.baseUrl = env.value("TMAGENT_BASE_URL", AppSettings::getBaseUrl());
+    config.model = env.value("TMAGENT_MODEL", AppSettings::getModel());
+    config.systemPrompt = AppSettings::getSystemPrompt();
+    config.temperature = AppSettings::getTemperature();
+
+    if (!config.isValid()) {
+        fprintf(stderr, "缺少 API Key: 请设置环境变量 TMAGENT_API_KEY 或在 config.ini 中配置\n");
+        return false;
+    }
+    return true;
+}
+
+// ==================== 运行 ====================
+
+int CliRunner::start(const Options& options) {
+    m_options = options;
+
+    if (!m_options.logFile.isEmpty() || !m_options.logLevel.isEmpty()) {
+        Logger::Options logOptions;
+        logOptions.filePath = m_options.logFile.isEmpty() ? qEnvironmentVariable("TMAGENT_LOG") : m_options.logFile;
+        Logger::parseLevel(m_options.logLevel.isEmpty() ? qEnvironmentVariable("TMAGENT_LOG_LEVEL") : m_options.logLevel,
+                           logOptions.level);  // 已在 parseArguments 中校验；无法识别的环境变量保持默认
+        if (!Logger::install(logOptions)) {
+            fprintf(stderr, "无法打开日志文件: %s\n", qPrintable(logOptions.filePath));
+            return UsageError;
+        }
+    }
+
+    if (!m_options.workDir.isEmpty() && !QDir::setCurrent(m_options.workDir)) {
+        fprintf(stderr, "无法进入工作目录: %s\n", qPrintable(m_options.workDir));
+        return UsageError;
+    }
+    if (!m_options.policyFile.isEmpty() && !m_policy.loadFromFile(m_options.policyFile)) {
+        fprintf(stderr, "%s\n", qPrintable(m_policy.errorString()));
+        return ConfigError;
+    }
+
+    LLMConfig config;
+    if (!loadConfig(config)) {
+        return ConfigError;
+    }
+    config.toolRouting = !m_options.allTools;
+
+    // NOTE: 无人值守，命令确认完全由审批策略决定，每次决定都作为事件输出以便审计
+    ShellTool::setApprovalHandler([this](const QString& command, const QString& workingDir) {
+        const bool allowed = m_policy.allows(command);
+        QJsonObject data;
+        data["command"] = command;
+        data["workingDir"] = workingDir;
+        data["allowed"] = allowed;
+        EventBus::instance().publish(AgentEvent::log(kCliSource, "approval",
+            QString("%1: %2").arg(allowed ? "allow" : "deny", command), data));
+        return allowed;
+    });
+
+    m_toolDispatcher = new ToolDispatcher(this);
+    m_toolDispatcher->registerDefaultTools();
+
+    // 主 Agent、Worker 与子 Agent 都经同一个全局限流器发送请求
+    RateLimiter* limiter = LLMTransport::instance().rateLimiter();
+    limiter->setRequestsPerMinute(m_options.requestsPerMinute);
+    limiter->setTokensPerMinute(m_options.tokensPerMinute);
+
+    // 输出不能丢事件，流式片段在写出前合并
+    EventBus::Options busOptions;
+    busOptions.overflow = EventBus::Overflow::Coalesce;
+    EventBus::instance().subscribe(this, [this](const QVector<AgentEvent>& events) {
+        onEvents(events);
+    }, busOptions);
+
+    if (m_options.timeoutSec > 0) {
+        QTimer::singleShot(m_options.timeoutSec * 1000, this, [this]() {
+            if (m_agent) {
+                m_agent->abort();
+            }
+            if (m_orchestrator) {
+                m_orchestrator->cancelAll();
+            }
+            if (m_batchRunner) {
+                m_batchRunner->cancel();
+            }
+            finish(TimedOut, QString("超过总超时 %1 秒").arg(m_options.timeoutSec));
+        });
+    }
+
+    if (!m_options.batchFile.isEmpty()) {
+        return startBatch(config);
+    }
+    return m_options.planFile.isEmpty() ? startPrompt(config) : startPlan(config);
+}
+
+int CliRunner::startPrompt(const LLMConfig& config) {
+    m_agent = new LLMAgent(this);
+    m_agent->setConfig(config);
+    m_agent->setToolDispatcher(m_toolDispatcher);
+    m_agentSource = m_agent->eventSource();
+    if (m_options.sessionFile.isEmpty()) {
+        m_agent->askOnce(m_options.prompt);
+        return -1;
+    }
+    
+    // 会话模式：恢复（或分叉出）之前的对话，本次 prompt 作为新的一轮
+    QString error;
+    if (!m_options.forkFrom.isEmpty()
+        && !SessionJournal::fork(m_options.forkFrom, m_options.sessionFile, m_options.forkAt, &error)) {
+        fprintf(stderr, "无法从 %s 分叉会话: %s\n", qPrintable(m_options.forkFrom), qPrintable(error));
+        return ConfigError;
+    }
+    if (!m_agent->openSession(m_options.sessionFile, m_options.sessionBinary ? SessionJournal::Encoding::Cbor
+                                                                             : SessionJournal::Encoding::Json)) {
+        fprintf(stderr, "无法打开会话日志 %s: %s\n", qPrintable(m_options.sessionFile),
+                qPrintable(m_agent->sessionError()));
+        return ConfigError;
+    }
+    m_agent->sendMessage(m_options.prompt);
+    return -1;
+}
+
+int CliRunner::startPlan(const LLMConfig& config) {
+    QFile file(m_options.planFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "无法打开 plan 文件 %s: %s\n",
+                qPrintable(m_options.planFile), qPrintable(file.errorString()));
+        return UsageError;
+    }
+
+    // plan 可以是任务数组，也可以是 {"tasks": [...], "maxParallel": N}
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    const QJsonArray taskArray = doc.isArray() ? doc.array() : doc.object()["tasks"].toArray();
+    if (doc.isNull()) {
+        fprintf(stderr, "plan 文件格式错误: %s\n", qPrintable(parseError.errorString()));
+        return UsageError;
+    }
+
+    QList<AgentTask> tasks;
+    for (const QJsonValue& value : taskArray) {
+        const AgentTask task = AgentTask::fromJson(value.toObject());
+        if (task.prompt.trimmed().isEmpty()) {
+            fprintf(stderr, "plan 中的任务 %s 缺少 prompt\n", qPrintable(task.id));
+            return UsageError;
+        }
+        tasks.append(task);
+    }
+    if (tasks.isEmpty()) {
+        fprintf(stderr, "plan 中没有任务\n");
+        return UsageError;
+    }
+
+    m_orchestrator = new Orchestrator(this);
+    m_orchestrator->setConfig(config);
+    m_orchestrator->setToolDispatcher(m_toolDispatcher);
+    const int maxParallel = m_options.maxParallel > 0 ? m_options.maxParallel
+                                                      : doc.object()["maxParallel"].toInt();
+    if (maxParallel > 0) {
+        m_orchestrator->scheduler()->setGlobalLimit(maxParallel);
+    }
+
+    for (const AgentTask& task : tasks) {
+        const QString taskId = m_orchestrator->submit(task);
+        if (taskId.isEmpty()) {
+            fprintf(stderr, "任务 %s 提交失败（ID 重复？）\n", qPrintable(task.id));
+            m_orchestrator->cancelAll();
+            return UsageError;
+        }
+        m_pendingTasks.insert(taskId);
+    }
+    return -1;
+}
+
+int CliRunner::startBatch(const LLMConfig& config) {
+    QFile file(m_options.batchFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "无法打开批量任务清单 %s: %s\n",
+                qPrintable(m_options.batchFile), qPrintable(file.errorString()));
+        return UsageError;
+    }
+
+    BatchManifest manifest;
+    QString error;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!BatchManifest::fromJson(doc.object(), manifest, error)) {
+        fprintf(stderr, "批量任务清单错误: %s\n", qPrintable(error));
+        return UsageError;
+    }
+
+    m_batchRunner = new BatchRunner(this);
+    m_batchRunner->setConfig(config);
+    m_batchRunner->setToolDispatcher(m_toolDispatcher);
+
+    BatchRunner::Options batchOptions;
+    batchOptions.resultsPath = m_options.resultsFile;
+    if (m_options.maxParallel > 0) {
+        batchOptions.concurrency = m_options.maxParallel;
+    }
+    if (!m_batchRunner->start(manifest, batchOptions, error)) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return UsageError;
+    }
+    return -1;
+}
+
+// ==================== 事件输出 ====================
+
+void CliRunner::onEvents(const QVector<AgentEvent>& events) {
+    for (const AgentEvent& event : events) {
+        if (m_finished) {
+            return;
+        }
+        writeEvent(event);
+
+        // prompt 模式：主 Agent 的结束或错误即运行结束（子 Agent 的事件来源不同）
+        if (m_agent && event.source == m_agentSource) {
+            if (event.kind == EventKind::Finished) {
+                finish(Success, QString());
+            } else if (event.kind == EventKind::Log && event.channel == EventChannel::FAILURE) {
+                finish(TaskFailed, event.message);
+            }
+        }
+
+        // plan 模式：所有提交的任务都结束后汇总
+        if (m_orchestrator && event.kind == EventKind::Finished && event.channel == EventChannel::TASK
+            && m_pendingTasks.remove(event.source) && m_pendingTasks.isEmpty()) {
+            bool failed = false;
+            bool timedOut = false;
+            for (const TaskResult& result : m_orchestrator->results()) {
+                failed = failed || result.status == TaskStatus::Failed || result.status == TaskStatus::Canceled;
+                timedOut = timedOut || result.status == TaskStatus::TimedOut;
+            }
+            finish(failed ? TaskFailed : (timedOut ? TimedOut : Success), QString());
+        }
+
+        // batch 模式：全部条目结束（含跳过的已完成条目）
+        if (m_batchRunner && event.kind == EventKind::Finished && event.channel == EventChannel::BATCH) {
+            finish(m_batchRunner->failedCount() > 0 ? TaskFailed : Success, QString());
+        }
+    }
+}
+
+void CliRunner::writeEvent(const AgentEvent& event) {
+    if (m_options.format == OutputFormat::JsonLines) {
+        writeLine(stdout, QJsonDocument(event.toJson()).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    // 文本模式：主 Agent 的回复写 stdout，其余信息写 stderr，便于重定向
+    const QString prefix = (event.source == m_agentSource) ? QString() : QString("[%1] ").arg(event.source);
+    if (event.isStreamLog()) {
+        if (event.source == m_agentSource) {
+            const QByteArray text = event.message.toUtf8();
+            fwrite(text.constData(), 1, text.size(), stdout);
+            fflush(stdout);
+        }
+    } else if (event.kind == EventKind::Finished) {
+        if (event.channel == EventChannel::TASK) {
+            const QString status = event.data["status"].toString();
+            writeLine(stderr, QString("%1[task] %2").arg(prefix, status).toUtf8());
+            writeLine(stdout, event.message.toUtf8());
+        } else if (event.source == m_agentSource) {
+            writeLine(stdout, QByteArray());
+        }
+    } else if (event.kind == EventKind::Log) {
+        writeLine(stderr, QString("%1[%2] %3").arg(prefix, event.channel, event.message).toUtf8());
+    }
+}
+
+void CliRunner::writeLine(FILE* stream, const QByteArray& line) {
+    fwrite(line.constData(), 1, line.size(), stream);
+    fputc('\n', stream);
+    fflush(stream);
+}
+
+void CliRunner::writeMetrics() {
+    const QByteArray json = QJsonDocument(MetricsRegistry::instance().toJson()).toJson(QJsonDocument::Indented);
+    if (m_options.metricsFile == "-") {
+        writeLine(stderr, json.trimmed());
+        return;
+    }
+    QFile file(m_options.metricsFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        writeLine(stderr, QString("[%1] 无法写入指标文件 %2: %3")
+                              .arg(kCliSource, m_options.metricsFile, file.errorString()).toUtf8());
+        return;
+    }
+    file.write(json);
+}
+
+void CliRunner::finish(int exitCode, const QString& reason) {
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+
+    QJsonObject summary;
+    summary["kind"] = "summary";
+    summary["exitCode"] = exitCode;
+    if (!reason.isEmpty()) {
+        summary["reason"] = reason;
+    }
+    if (m_agent) {
+        const TokenUsage usage = m_agent->totalUsage();
+        QJsonObject usageObj;
+        usageObj["promptTokens"] = usage.promptTokens;
+        usageObj["completionTokens"] = usage.completionTokens;
+        usageObj["cachedPromptTokens"] = usage.cachedPromptTokens;
+        summary["usage"] = usageObj;
+    }
+    if (m_batchRunner) {
+        summary["batch"] = m_batchRunner->statsJson();
+        summary["resultsFile"] = m_options.resultsFile;
+    }
+    if (m_orchestrator) {
+        QJsonArray results;
+        for (const TaskResult& result : m_orchestrator->results()) {
+            results.append(result.toJson());
+        }
+        summary["results"] = results;
+    }
+
+    if (!m_options.metricsFile.isEmpty()) {
+        writeMetrics();
+    }
+
+    if (m_options.format == OutputFormat::JsonLines) {
+        writeLine(stdout, QJsonDocument(summary).toJson(QJsonDocument::Compact));
+    } else {
+        if (!reason.isEmpty()) {
+            writeLine(stderr, QString("[%1] %2").arg(kCliSource, reason).toUtf8());
+        }
+        writeLine(stderr, QString("[%1] 退出码 %2").arg(kCliSource).arg(exitCode).toUtf8());
+    }
+
+    QCoreApplication::exit(exitCode);
+}
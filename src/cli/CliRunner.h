@@ -0,0 +1,106 @@
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QObject>
+#include <QSet>
+#include <QVector>
+#include <cstdio>
+#include "ApprovalPolicy.h"
+#include "core/agent/ToolTypes.h"
+#include "core/events/AgentEvent.h"
+
+class LLMAgent;        // 前向声明
+class ToolDispatcher;  // 前向声明
+class Orchestrator;    // 前向声明
+class BatchRunner;     // 前向声明
+
+/**
+ * @brief 无界面运行入口（设计文档 10.1 CLI 模式）
+ *
+ * 一次运行一个 prompt、一个 plan 文件或一个批量任务清单，事件经 EventBus 输出为文本或 JSON Lines，
+ * 可执行文件的确认由审批策略文件决定，结束时返回退出码。
+ *
+ * 使用方式:
+ *   TmAgentCli --prompt "检查构建错误" --policy approval.json --format jsonl
+ *   TmAgentCli --plan plan.json --max-parallel 4 --timeout 600
+ *   TmAgentCli --batch manifest.json --results results.jsonl --max-parallel 8 --rpm 120 --tpm 200000
+ *   TmAgentCli --prompt "..." --metrics metrics.json
+ *   TmAgentCli --prompt "..." --log agent.log --log-level debug
+ */
+class CliRunner : public QObject {
+    Q_OBJECT
+public:
+    // 退出码
+    enum ExitCode {
+        Success = 0,      // 全部成功
+        TaskFailed = 1,   // Agent 报错或有任务失败/取消
+        UsageError = 2,   // 参数或 plan 文件错误
+        ConfigError = 3,  // 缺少 API Key 或审批策略无效
+        TimedOut = 4      // 超过 --timeout 或有任务超时
+    };
+
+    enum class OutputFormat {
+        Text,       // 流式文本输出到 stdout，工具与错误信息输出到 stderr
+        JsonLines   // 每个事件一行 JSON，最后一行为 summary
+    };
+
+    struct Options {
+        QString prompt;
+        QString planFile;
+        QString batchFile;      // 批量任务清单
+        QString resultsFile;    // 批量结果文件（默认为清单同名的 .results.jsonl）
+        QString policyFile;
+        QString metricsFile;    // 结束时写入指标（JSON）
+        QString logFile;        // 日志文件（JSON Lines，自动轮转），覆盖 TMAGENT_LOG
+        QString logLevel;       // 日志级别，覆盖 TMAGENT_LOG_LEVEL
+        QString workDir;
+        OutputFormat format = OutputFormat::Text;
+        int timeoutSec = 0;     // 0 表示不限制
+        int maxParallel = 0;    // plan / batch 模式的并发上限，0 表示使用默认值
+        int requestsPerMinute = 0;  // 所有 Agent 共享的请求速率上限，0 表示不限制
+        int tokensPerMinute = 0;    // 所有 Agent 共享的 token 速率上限，0 表示不限制
+        bool allTools = false;      // 每次请求都发送全部允许的工具（关闭 ToolRouter）
+        QString sessionFile;        // prompt 模式的会话日志：存在时恢复对话后继续
+        bool sessionBinary = false; // 新建会话日志使用 CBOR 编码
+        QString forkFrom;           // 从该会话日志分叉出 sessionFile
+        int forkAt = -1;            // 分叉时保留的记录数，-1 表示全部
+    };
+
+    explicit CliRunner(QObject *parent = nullptr);
+
+    /**
+     * @brief 解析命令行参数
+     * @return -1 表示继续运行；否则为应立即返回的退出码（--help 为 0）
+     */
+    static int parseArguments(const QStringList& arguments, Options& options);
+
+    /**
+     * @brief 开始运行
+     * @return -1 表示已开始异步运行（结束时退出事件循环）；否则为立即返回的退出码
+     */
+    int start(const Options& options);
+
+private:
+    bool loadConfig(LLMConfig& config);
+    int startPrompt(const LLMConfig& config);
+    int startPlan(const LLMConfig& config);
+    int startBatch(const LLMConfig& config);
+
+    void onEvents(const QVector<AgentEvent>& events);
+    void writeEvent(const AgentEvent& event);
+    void writeLine(FILE* stream, const QByteArray& line);
+    void writeMetrics();
+    void finish(int exitCode, const QString& reason);
+
+    Options m_options;
+    ApprovalPolicy m_policy;
+    ToolDispatcher* m_toolDispatcher = nullptr;
+    LLMAgent* m_agent = nullptr;
+    Orchestrator* m_orchestrator = nullptr;
+    BatchRunner* m_batchRunner = nullptr;
+    QString m_agentSource;        // prompt 模式下主 Agent 的事件来源
+    QSet<QString> m_pendingTasks; // plan 模式下尚未结束的任务
+    bool m_finished = false;
+};
+
+#endif // CLIRUNNER_H
@@ -0,0 +1,25 @@
+#include <QCoreApplication>
+#include "cli/CliRunner.h"
+#include "core/trace/Tracer.h"
+#include "core/log/Logger.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    Logger::initFromEnvironment();  // TMAGENT_LOG / TMAGENT_LOG_LEVEL，--log 参数会覆盖
+    Tracer::initFromEnvironment();  // TMAGENT_TRACE=<文件> 时记录并在退出时导出
+    
+    CliRunner::Options options;
+    const int parseResult = CliRunner::parseArguments(a.arguments(), options);
+    if (parseResult >= 0) {
+        return parseResult;
+    }
+    
+    CliRunner runner;
+    const int startResult = runner.start(options);
+    if (startResult >= 0) {
+        return startResult;
+    }
+    
+    return a.exec();
+}
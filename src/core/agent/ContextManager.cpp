@@ -0,0 +1,300 @@
+#include "ContextManager.h"
+#include "core/tools/FileTool.h"
+#include "core/tools/CodeParserTool.h"
+#include "core/utils/Tokenizer.h"
+#include "core/log/LogCategories.h"
+#include <QJsonDocument>
+#include <QSet>
+#include <QDir>
+#include <QDebug>
+
+// 工具输出小于该值时不再压缩（压缩后的摘要本身也有开销）
+static const int kMinCollapseTokens = 64;
+
+// 每条消息的固定开销（role、分隔符等）
+static const int kMessageOverheadTokens = 4;
+
+// ==================== 消息管理 ====================
+
+int ContextManager::append(const QJsonObject& message) {
+    return append(message, QByteArray(), 0);
+}
+
+int ContextManager::append(const QJsonObject& message, const QByteArray& serialized, int tokens) {
+    Entry entry;
+    entry.message = message;
+    entry.tokens = tokens > 0 ? tokens : estimateTokens(message);
+    if (serialized.isEmpty()) {
+        serialize(entry);
+    } else {
+        entry.serialized = serialized;
+        m_serializedSize += serialized.size() + 1;  // 含分隔逗号
+    }
+
+    const QString role = message["role"].toString();
+    if (role == "tool") {
+        // 工具结果归属于发起调用的 assistant 步骤
+        entry.step = m_stepCount;
+        const ToolCallInfo info = m_toolCalls.value(message["tool_call_id"].toString());
+        entry.toolName = info.name;
+        entry.filePath = info.filePath;
+    } else {
+        entry.step = ++m_stepCount;
+        if (role == "user") {
+            if (m_firstUserStep < 0) {
+                m_firstUserStep = entry.step;
+            }
+            m_lastUserStep = entry.step;
+        }
+    }
+
+    // 记录 assistant 发起的工具调用，供之后的 tool 消息关联工具名和文件路径
+    if (role == "assistant" && message.contains("tool_calls")) {
+        for (const QJsonValue& tc : message["tool_calls"].toArray()) {
+            const QJsonObject tcObj = tc.toObject();
+            const QJsonObject funcObj = tcObj["function"].toObject();
+            const QJsonObject args = QJsonDocument::fromJson(
+                funcObj["arguments"].toString().toUtf8()).object();
+
+            ToolCallInfo info;
+            info.name = funcObj["name"].toString();
+            info.filePath = filePathFromArguments(args);
+            m_toolCalls.insert(tcObj["id"].toString(), info);
+        }
+    }
+
+    m_totalTokens += entry.tokens;
+    m_entries.append(entry);
+    return entry.tokens;
+}
+
+void ContextManager::clear() {
+    m_entries.clear();
+    m_toolCalls.clear();
+    m_totalTokens = 0;
+    m_serializedSize = 0;
+    m_stepCount = 0;
+    m_firstUserStep = -1;
+    m_lastUserStep = -1;
+}
+
+QJsonArray ContextManager::messages() const {
+    QJsonArray result;
+    for (const Entry& entry : m_entries) {
+        result.append(entry.message);
+    }
+    return result;
+}
+
+void ContextManager::appendSerialized(QByteArray& out) const {
+    out.reserve(out.size() + m_serializedSize);
+    for (const Entry& entry : m_entries) {
+        out.append(',');
+        out.append(entry.serialized);
+    }
+}
+
+void ContextManager::serialize(Entry& entry) {
+    m_serializedSize -= entry.serialized.isEmpty() ? 0 : entry.serialized.size() + 1;
+    entry.serialized = QJsonDocument(entry.message).toJson(QJsonDocument::Compact);
+    m_serializedSize += entry.serialized.size() + 1;  // 含分隔逗号
+}
+
+// ==================== 预算裁剪 ====================
+
+int ContextManager::enforceBudget(int reservedTokens) {
+    if (m_tokenBudget <= 0) {
+        return 0;
+    }
+
+    const int available = m_tokenBudget - reservedTokens;
+    if (m_totalTokens <= available) {
+        return 0;
+    }
+
+    // NOTE: 一次裁到低水位，留出余量给之后的轮次，避免每轮都改写前缀中的一条消息
+    const int lowWater = static_cast<int>(available * m_lowWaterRatio);
+    int overBudget = m_totalTokens - lowWater;
+    const int before = m_totalTokens;
+    const int recentFromStep = protectedFromStep();
+
+    // NOTE: 按代价从低到高依次裁剪，任一阶段降到低水位即停止
+    overBudget -= dropStaleFileDumps(recentFromStep, overBudget);
+    if (overBudget > 0) {
+        overBudget -= collapseToolOutputs(recentFromStep, overBudget);
+    }
+    if (overBudget > 0) {
+        overBudget -= dropOldestSteps(recentFromStep, overBudget);
+    }
+
+    const int freed = before - m_totalTokens;
+    qCDebug(lcAgent) << "[ContextManager] 上下文超出预算，已释放" << freed << "tokens,"
+             << "剩余" << m_totalTokens << "/" << available;
+    if (m_totalTokens > available) {
+        qCWarning(lcAgent) << "[ContextManager] 固定保留的消息仍超出预算" << m_totalTokens - available << "tokens";
+    }
+    return freed;
+}
+
+int ContextManager::protectedFromStep() const {
+    return m_stepCount - m_recentSteps + 1;
+}
+
+bool ContextManager::isPinned(const Entry& entry, int recentFromStep) const {
+    return entry.step >= recentFromStep
+        || entry.step == m_firstUserStep
+        || entry.step == m_lastUserStep
+        || entry.message["role"].toString() == "system";
+}
+
+void ContextManager::replaceContent(Entry& entry, const QString& content) {
+    entry.message["content"] = content;
+    const int tokens = estimateTokens(entry.message);
+    m_totalTokens += tokens - entry.tokens;
+    entry.tokens = tokens;
+    entry.compacted = true;
+    serialize(entry);
+}
+
+int ContextManager::dropStaleFileDumps(int recentFromStep, int overBudget) {
+    Q_UNUSED(overBudget);  // 过期内容对模型无用，一次性全部省略
+
+    const int before = m_totalTokens;
+    QSet<QString> touchedLater;  // 之后被重新读取或修改过的文件
+
+    // 从新到旧遍历：遇到读文件结果时，若该文件之后还被访问过，则旧内容已过期
+    for (int i = m_entries.size() - 1; i >= 0; --i) {
+        Entry& entry = m_entries[i];
+        if (entry.filePath.isEmpty()) {
+            continue;
+        }
+
+        if (isFileReadTool(entry.toolName) && !entry.compacted
+            && !isPinned(entry, recentFromStep)
+            && touchedLater.contains(entry.filePath)) {
+            replaceContent(entry, QString("[已省略] %1 的旧内容，该文件之后已被重新读取或修改")
+                                      .arg(entry.filePath));
+        }
+
+        if (isFileReadTool(entry.toolName) || isFileWriteTool(entry.toolName)) {
+            touchedLater.insert(entry.filePath);
+        }
+    }
+
+    return before - m_totalTokens;
+}
+
+int ContextManager::collapseToolOutputs(int recentFromStep, int overBudget) {
+    const int before = m_totalTokens;
+
+    // 从旧到新压缩，越早的工具输出对当前决策越不重要
+    for (Entry& entry : m_entries) {
+        if (before - m_totalTokens >= overBudget) {
+            break;
+        }
+        if (entry.message["role"].toString() != "tool" || entry.compacted
+            || entry.tokens < kMinCollapseTokens || isPinned(entry, recentFromStep)) {
+            continue;
+        }
+
+        const QString content = entry.message["content"].toString();
+        const QStringList lines = content.split('\n');
+        QString firstLine;
+        for (const QString& line : lines) {
+            if (!line.trimmed().isEmpty()) {
+                firstLine = line.trimmed().left(120);
+                break;
+            }
+        }
+
+        replaceContent(entry, QString("[已压缩] %1 的输出 (原 %2 行, 约 %3 tokens), 首行: %4")
+                                  .arg(entry.toolName.isEmpty() ? "工具" : entry.toolName)
+                                  .arg(lines.size())
+                                  .arg(entry.tokens)
+                                  .arg(firstLine));
+    }
+
+    return before - m_totalTokens;
+}
+
+int ContextManager::dropOldestSteps(int recentFromStep, int overBudget) {
+    const int before = m_totalTokens;
+    QVector<Entry> kept;
+    kept.reserve(m_entries.size());
+
+    int droppingStep = -1;
+    for (const Entry& entry : m_entries) {
+        // NOTE: 以步骤为单位整体丢弃，保证 tool_calls 与 tool 结果成对出现
+        const bool stepStart = entry.message["role"].toString() != "tool";
+        if (stepStart) {
+            droppingStep = -1;
+            if (before - m_totalTokens < overBudget && !isPinned(entry, recentFromStep)) {
+                droppingStep = entry.step;
+            }
+        }
+
+        if (entry.step == droppingStep) {
+            m_totalTokens -= entry.tokens;
+            m_serializedSize -= entry.serialized.size() + 1;
+            for (const QJsonValue& tc : entry.message["tool_calls"].toArray()) {
+                m_toolCalls.remove(tc.toObject()["id"].toString());
+            }
+        } else {
+            kept.append(entry);
+        }
+    }
+
+    m_entries = kept;
+    return before - m_totalTokens;
+}
+
+// ==================== Token 估算 ====================
+
+int ContextManager::estimateTokens(const QJsonObject& message) {
+    int tokens = kMessageOverheadTokens + estimateTokens(message["content"].toString());
+
+    if (message.contains("tool_call_id")) {
+        tokens += estimateTokens(message["tool_call_id"].toString());
+    }
+
+    for (const QJsonValue& tc : message["tool_calls"].toArray()) {
+        const QJsonObject funcObj = tc.toObject()["function"].toObject();
+        tokens += kMessageOverheadTokens
+                + estimateTokens(tc.toObject()["id"].toString())
+                + estimateTokens(funcObj["name"].toString())
+                + estimateTokens(funcObj["arguments"].toString());
+    }
+    return tokens;
+}
+
+int ContextManager::estimateTokens(const QString& text) {
+    return Tokenizer::instance().countTokens(text);
+}
+
+// ==================== 工具分类辅助 ====================
+
+QString ContextManager::filePathFromArguments(const QJsonObject& args) {
+    if (args.contains("file_path")) {
+        return QDir::cleanPath(FileTool::convertMsysPath(args["file_path"].toString()));
+    }
+    if (args.contains("directory") && args.contains("filename")) {
+        return QDir::cleanPath(FileTool::convertMsysPath(args["directory"].toString())
+                               + "/" + args["filename"].toString());
+    }
+    return QString();
+}
+
+bool ContextManager::isFileReadTool(const QString& toolName) {
+    return toolName == FileTool::VIEW_FILE
+        || toolName == FileTool::READ_FILE_LINES
+        || toolName == CodeParserTool::VIEW_FILE_OUTLINE
+        || toolName == CodeParserTool::VIEW_CODE_ITEM;
+}
+
+bool ContextManager::isFileWriteTool(const QString& toolName) {
+    return toolName == FileTool::CREATE_FILE
+        || toolName == FileTool::REPLACE_IN_FILE
+        || toolName == FileTool::INSERT_CONTENT
+        || toolName == FileTool::MULTI_REPLACE_IN_FILE
+        || toolName == FileTool::DELETE_FILE;
+}
@@ -0,0 +1,155 @@
+#ifndef CONTEXTMANAGER_H
+#define CONTEXTMANAGER_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+
+/**
+ * @brief 上下文窗口管理器
+ *
+ * 维护 Agent 发送给 LLM 的消息列表，并为每条消息记录估算的 token 数。
+ * 发送请求前按预算裁剪上下文，策略依次为:
+ *   1. 固定保留首条用户消息（任务描述）、最新的用户消息和最近若干步
+ *   2. 省略过期的文件内容（同一文件之后被重新读取或修改过）
+ *   3. 将较早的工具输出压缩为一行摘要
+ *   4. 仍超出预算时，从最早的步骤开始整步丢弃
+ *
+ * 压缩和丢弃是持久的：一旦裁剪，后续请求不会再恢复原文，
+ * 这样已经发送过的前缀在之后的轮次中保持稳定。
+ * 超出预算时一次裁剪到低水位（默认可用预算的 75%），之后若干轮追加都不再触发裁剪；
+ * 若只裁到恰好满足预算，长会话的每一轮都会改写靠前的消息，服务端前缀缓存随之失效。
+ *
+ * 每条消息在追加（或被压缩）时序列化一次，构造请求体时直接拼接这些字节，
+ * 不再每轮重新序列化整个历史。
+ *
+ * 使用方式:
+ *   ContextManager context;
+ *   context.setTokenBudget(config.contextWindowTokens);
+ *   context.append(userMsg);
+ *   context.enforceBudget(reservedTokens);
+ *   postRequestToServer(requestBuilder.build(context));
+ */
+class ContextManager {
+public:
+    ContextManager() = default;
+
+    /**
+     * @brief 设置上下文总预算（token），0 表示不限制
+     */
+    void setTokenBudget(int tokens) { m_tokenBudget = tokens; }
+    int tokenBudget() const { return m_tokenBudget; }
+
+    /**
+     * @brief 设置固定保留的最近步骤数（一步 = 一条 user/assistant 消息及其工具结果）
+     */
+    void setRecentSteps(int steps) { m_recentSteps = qMax(1, steps); }
+    int recentSteps() const { return m_recentSteps; }
+
+    /**
+     * @brief 设置低水位：超出预算时裁剪到可用预算的该比例（0.1 ~ 1.0，1.0 表示只裁到恰好满足预算）
+     */
+    void setLowWaterRatio(double ratio) { m_lowWaterRatio = qBound(0.1, ratio, 1.0); }
+    double lowWaterRatio() const { return m_lowWaterRatio; }
+
+    // 消息管理
+    /**
+     * @return 该消息的估算 token 数
+     */
+    int append(const QJsonObject& message);
+
+    /**
+     * @brief 追加已序列化过的消息（从会话日志恢复时使用，跳过序列化与 token 估算）
+     * @param serialized message 的紧凑 JSON，为空时重新序列化
+     * @param tokens 已知的 token 数，0 表示重新估算
+     */
+    int append(const QJsonObject& message, const QByteArray& serialized, int tokens);
+    void clear();
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    int size() const { return m_entries.size(); }
+
+    /**
+     * @brief 当前保留消息的估算 token 总数（增量维护，O(1)）
+     */
+    int totalTokens() const { return m_totalTokens; }
+
+    /**
+     * @brief 获取当前保留的消息列表（已应用压缩）
+     */
+    QJsonArray messages() const;
+
+    /**
+     * @brief 已序列化消息的总字节数（含分隔逗号，增量维护）
+     */
+    int serializedSize() const { return m_serializedSize; }
+
+    /**
+     * @brief 将保留的消息以 ",{...},{...}" 的形式追加到 out
+     * @note 每条消息的紧凑 JSON 在追加时已缓存，这里只做字节拼接
+     */
+    void appendSerialized(QByteArray& out) const;
+
+    /**
+     * @brief 按预算裁剪上下文（超出时裁剪到低水位）
+     * @param reservedTokens 预留给 system prompt、工具定义和模型回复的 token 数
+     * @return 本次裁剪释放的 token 数（未超预算时为 0）
+     */
+    int enforceBudget(int reservedTokens);
+
+    /**
+     * @brief 估算单条消息的 token 数（含角色与工具调用开销）
+     */
+    static int estimateTokens(const QJsonObject& message);
+
+    /**
+     * @brief 统计文本的 token 数
+     * @note 委托给 Tokenizer，未加载词表时为经验估算
+     */
+    static int estimateTokens(const QString& text);
+
+private:
+    struct Entry {
+        QJsonObject message;
+        QByteArray serialized;   // 紧凑 JSON，随内容一起更新
+        int tokens = 0;
+        int step = 0;            // 所属步骤序号
+        QString toolName;        // tool 消息: 对应的工具名
+        QString filePath;        // tool 消息: 读取/修改的文件路径
+        bool compacted = false;  // 是否已被压缩或省略
+    };
+
+    // 工具调用信息（从 assistant 消息的 tool_calls 中提取）
+    struct ToolCallInfo {
+        QString name;
+        QString filePath;
+    };
+
+    int protectedFromStep() const;
+    bool isPinned(const Entry& entry, int recentFromStep) const;
+    void replaceContent(Entry& entry, const QString& content);
+    void serialize(Entry& entry);
+
+    int dropStaleFileDumps(int recentFromStep, int overBudget);
+    int collapseToolOutputs(int recentFromStep, int overBudget);
+    int dropOldestSteps(int recentFromStep, int overBudget);
+
+    static QString filePathFromArguments(const QJsonObject& args);
+    static bool isFileReadTool(const QString& toolName);
+    static bool isFileWriteTool(const QString& toolName);
+
+    QVector<Entry> m_entries;
+    QHash<QString, ToolCallInfo> m_toolCalls;  // tool_call_id -> 工具调用信息
+    int m_totalTokens = 0;
+    int m_serializedSize = 0;
+    int m_tokenBudget = 0;
+    int m_recentSteps = 6;
+    double m_lowWaterRatio = 0.75;
+    int m_stepCount = 0;
+    int m_firstUserStep = -1;    // 首条用户消息所在步骤（任务描述）
+    int m_lastUserStep = -1;     // 最新用户消息所在步骤
+};
+
+#endif // CONTEXTMANAGER_H
@@ -1,47 +1,91 @@
 #include "LLMAgent.h"
 #include "ToolDispatcher.h"
+#include "SubAgentDelegator.h"
+#include "core/events/EventBus.h"
+#include "core/net/LLMTransport.h"
+#include "core/net/RateLimiter.h"
+#include "core/net/SessionRecorder.h"
+#include "core/trace/Tracer.h"
+#include "core/metrics/MetricsRegistry.h"
+#include "core/log/LogCategories.h"
+#include "core/log/Logger.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QNetworkRequest>
 #include <QDebug>
 #include <QTimer>
+#include <QPointer>
 #include <QRegularExpression>
 #include <QFileInfo>
+#include <QDateTime>
+
+namespace {
+// 所有 Agent 共用的指标（注册表中的指针一直有效，首次使用时取得）
+struct AgentMetrics {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    Counter* requests = registry.counter("llm.requests");
+    Counter* retries = registry.counter("llm.retries");
+    Counter* errors = registry.counter("llm.errors");
+    Counter* bytesSent = registry.counter("llm.bytes_sent");
+    Counter* bytesReceived = registry.counter("llm.bytes_received");
+    Counter* promptTokens = registry.counter("llm.prompt_tokens");
+    Counter* cachedPromptTokens = registry.counter("llm.cached_prompt_tokens");
+    Counter* completionTokens = registry.counter("llm.completion_tokens");
+    Gauge* inFlight = registry.gauge("llm.in_flight");
+    Histogram* ttft = registry.histogram("llm.ttft_us");
+    Histogram* requestLatency = registry.histogram("llm.request_us");
+    Histogram* tokensPerSecond = registry.histogram("llm.tokens_per_second", "tok/s");
+    Histogram* requestTools = registry.histogram("llm.request_tools", "tools");
+};
+
+AgentMetrics& metrics() {
+    static AgentMetrics instance;
+    return instance;
+}
+}
 
 LLMAgent::LLMAgent(QObject *parent) : QObject(parent) {
-    m_manager = new QNetworkAccessManager(this);
-    m_timeoutTimer = new QTimer(this);
-    m_timeoutTimer->setSingleShot(true);
-    m_timeoutTimer->setInterval(180000);  // 3分钟超时
+    m_idleTimer = new QTimer(this);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(m_config.idleTimeoutMs);
+    connect(m_idleTimer, &QTimer::timeout, this, &LLMAgent::onIdleTimeout);
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &LLMAgent::queueRequest);
+    m_context.setTokenBudget(m_config.contextWindowTokens);
+    m_requestBuilder.setModel(m_config.model, m_config.maxTokens);
     
     // 默认角色定义
-    m_systemPrompt = "你是一个专业的 AI 助手，能够帮助用户完成各种任务。"
-                     "你可以使用工具来执行文件操作和命令行操作。"
-                     "请简洁、准确地回答用户的问题。";
-    
-    connect(m_timeoutTimer, &QTimer::timeout, this, [this]() {
-        qDebug() << "WARNING: 网络请求超时!";
-        if (m_currentReply) {
-            m_currentReply->abort();
-        }
-        m_isToolMode = false;
-        emit errorOccurred("请求超时,请检查网络连接或稍后重试");
-    });
+    m_requestBuilder.setSystemPrompt("你是一个专业的 AI 助手，能够帮助用户完成各种任务。"
+                                     "你可以使用工具来执行文件操作和命令行操作。"
+                                     "请简洁、准确地回答用户的问题。");
 }
 
 void LLMAgent::setSystemPrompt(const QString& prompt) {
+    // NOTE: 覆盖而不是追加，重复设置同一提示词时请求前缀保持不变，服务端前缀缓存才能命中
     if (!prompt.isEmpty()) {
-        m_systemPrompt += "\n" + prompt;  // 追加用户设置的提示词
+        m_config.systemPrompt = prompt;
+        m_requestBuilder.setSystemPrompt(prompt);
     }
 }
 
 void LLMAgent::setConfig(const LLMConfig& config) {
+    // 工具权限或层级变化时需要重新筛选可用工具
+    const bool toolsChanged = config.allowedTools != m_config.allowedTools
+                           || config.agentLevel != m_config.agentLevel
+                           || config.toolRouting != m_config.toolRouting;
     m_config = config;
+    Logger::addSecret(config.apiKey);
+    if (toolsChanged && m_toolDispatcher) {
+        refreshTools();
+    }
+    m_context.setTokenBudget(config.contextWindowTokens);
     
     // 同步更新相关成员变量
-    m_systemPrompt = config.systemPrompt;
-    m_timeoutTimer->setInterval(config.timeoutMs);
+    m_requestBuilder.setModel(config.model, config.maxTokens);
+    m_requestBuilder.setSystemPrompt(config.systemPrompt);
+    m_idleTimer->setInterval(config.idleTimeoutMs);
 }
 
 void LLMAgent::sendMessage(const QString& prompt) {
@@ -58,122 +102,322 @@ void LLMAgent::sendRequest(const QString& prompt, bool saveToHistory) {
     }
 
     m_fullContent.clear();
+    m_lastFinishReason.clear();
+    m_toolCallAssembler.clear();
     m_saveToHistory = saveToHistory;
     m_isToolMode = !m_tools.isEmpty();
     
+    if (m_isToolMode) {
+        // 按本轮任务挑选工具；单次调用不沿用上一个会话选过的工具
+        if (!saveToHistory) {
+            m_toolRouter.reset();
+        }
+        const QList<Tool> tools = m_config.toolRouting ? m_toolRouter.select(m_tools, prompt) : m_tools;
+        m_requestBuilder.setTools(tools);
+        metrics().requestTools->record(tools.size());
+    }
+    
     // 构造用户消息
     QJsonObject userMsg;
     userMsg["role"] = "user";
     userMsg["content"] = prompt;
     
     if (saveToHistory) {
-        m_conversationHistory.append(userMsg);
+        appendHistory(userMsg);
     }
     
-    // 准备消息列表并发送
-    QJsonArray messages = buildMessageHistory(userMsg, saveToHistory);
-    postRequestToServer(messages);
+    // 准备请求体并发送
+    QByteArray body;
+    {
+        TraceSpan span("llm", "build", eventSource());
+        body = buildRequestBody(userMsg, saveToHistory);
+        span.setArg("bytes", body.size());
+    }
+    postRequestToServer(body);
 }
 
-QJsonArray LLMAgent::buildMessageHistory(const QJsonObject& userMsg, bool saveToHistory) {
-    QJsonArray messages;
-    
+QByteArray LLMAgent::buildRequestBody(const QJsonObject& userMsg, bool saveToHistory) {
     if (m_isToolMode) {
         // 工具模式：使用独立的消息历史
         m_pendingToolCalls.clear();
         m_toolResults.clear();
+        m_preparedInputs.clear();
         
         if (!saveToHistory) {
-            m_currentMessages = QJsonArray();  // 单次调用，清空历史
+            m_context.clear();  // 单次调用，清空历史
+            journal(SessionJournal::ClearContext);
         }
-        m_currentMessages.append(userMsg);
-        messages = m_currentMessages;
+        appendContext(userMsg);
+        return contextRequestBody();
     } else if (saveToHistory) {
-        // 多轮对话：使用完整对话历史
+        // 多轮对话：使用对话历史，同样受上下文预算约束
+        ContextManager historyContext;
+        historyContext.setTokenBudget(m_config.contextWindowTokens);
         for (const QJsonValue& msg : m_conversationHistory) {
-            messages.append(msg);
+            historyContext.append(msg.toObject());
         }
-    } else {
-        // 单次问答：只发送当前消息
-        messages.append(userMsg);
+        historyContext.enforceBudget(reservedContextTokens());
+        m_requestTokens = historyContext.totalTokens() + m_requestBuilder.prefixTokens();
+        return m_requestBuilder.build(historyContext);
     }
     
-    return messages;
+    // 单次问答：只发送当前消息
+    m_requestTokens = ContextManager::estimateTokens(userMsg) + m_requestBuilder.prefixTokens();
+    return m_requestBuilder.build(QJsonArray{userMsg});
 }
 
 
 void LLMAgent::abort() {
     if (m_currentReply) {
-        m_currentReply->abort();
-        m_currentReply->deleteLater();
+        // NOTE: abort() 会同步发出 finished，先断开连接，避免 onStreamFinished 把中断当作网络错误上报
+        QNetworkReply* reply = m_currentReply;
         m_currentReply = nullptr;
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+    m_idleTimer->stop();
+    m_retryTimer->stop();
+    resetSpeculation();
+    m_isToolMode = false;
+    m_canResume = false;
+    rateLimiter()->cancel(this);
+    
+    // 未完成的异步工具（如子 Agent）一并取消
+    if (m_toolDispatcher && !m_pendingToolCalls.isEmpty()) {
+        m_toolDispatcher->cancelPending(this);
     }
+    m_pendingToolCalls.clear();
+    m_toolResults.clear();
+    m_preparedInputs.clear();
 }
 
 
 
 void LLMAgent::clearHistory() {
     m_conversationHistory = QJsonArray();
-    m_currentMessages = QJsonArray();  // NOTE: 同时清空工具模式的对话历史
+    m_userTurns = 0;
+    m_context.clear();  // NOTE: 同时清空工具模式的对话历史
+    m_toolRouter.reset();
+    journal(SessionJournal::ClearAll);
+    m_totalUsage = TokenUsage();
+    emit historyReset();
 }
 
 QJsonArray LLMAgent::getHistory() const {
     return m_conversationHistory;
 }
 
-int LLMAgent::getConversationCount() const {
-    int count = 0;
-    for (const QJsonValue& msg : m_conversationHistory) {
-        if (msg.toObject()["role"].toString() == "user") {
-            count++;
+// ==================== 会话持久化 ====================
+
+bool LLMAgent::openSession(const QString& path, SessionJournal::Encoding encoding) {
+    auto journal = std::make_unique<SessionJournal>();
+    if (!journal->open(path, encoding)) {
+        m_sessionError = journal->errorString();
+        qCWarning(lcAgent) << "[Session] 无法打开会话日志:" << m_sessionError;
+        return false;
+    }
+    if (m_currentReply) {
+        abort();
+    }
+    
+    // 按记录顺序重放，恢复到上次退出时的对话（不重新请求 LLM，也不重新执行工具）
+    m_conversationHistory = QJsonArray();
+    m_userTurns = 0;
+    m_context.clear();
+    m_toolRouter.reset();
+    for (const SessionJournal::Record& record : journal->loadedRecords()) {
+        switch (record.kind) {
+            case SessionJournal::HistoryMessage:
+                m_conversationHistory.append(record.data);
+                m_userTurns += record.data["role"].toString() == "user" ? 1 : 0;
+                break;
+            case SessionJournal::ContextMessage:
+                m_context.append(record.data, record.json, record.tokens);
+                for (const QJsonValue& call : record.data["tool_calls"].toArray()) {
+                    m_toolRouter.recordUse(call.toObject()["function"].toObject()["name"].toString());
+                }
+                break;
+            case SessionJournal::ClearContext:
+                m_context.clear();
+                break;
+            case SessionJournal::ClearAll:
+                m_conversationHistory = QJsonArray();
+                m_userTurns = 0;
+                m_context.clear();
+                m_toolRouter.reset();
+                break;
+            case SessionJournal::Meta:
+                break;
         }
     }
-    return count;
+    
+    if (journal->recordCount() == 0) {
+        QJsonObject meta;
+        meta["agent"] = eventSource();
+        meta["model"] = m_config.model;
+        meta["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        journal->append(SessionJournal::Meta, meta);
+    } else {
+        qCInfo(lcAgent) << "[Session] 已恢复会话" << path << ":" << journal->recordCount() << "条记录,"
+                        << m_context.size() << "条上下文消息";
+    }
+    m_journal = std::move(journal);
+    m_sessionError.clear();
+    syncResultDirectory();
+    emit historyReset();
+    return true;
+}
+
+void LLMAgent::closeSession() {
+    // 只恢复自己设置的目录，共用调度器的其他会话不受影响
+    if (m_toolDispatcher && m_journal && m_toolDispatcher->resultDirectory() == sessionResultDirectory()) {
+        m_toolDispatcher->setResultDirectory(QString());
+    }
+    m_journal.reset();
+}
+
+QString LLMAgent::sessionResultDirectory() const {
+    return m_journal ? m_journal->path() + ".results" : QString();
+}
+
+void LLMAgent::syncResultDirectory() {
+    // NOTE: 压缩后的工具消息（含"完整结果已保存至 <路径>"）会写入会话日志，
+    //       完整结果必须与日志一起保留，不能放在调度器析构时删除的临时目录中；
+    //       未打开会话时不改动，Orchestrator 的 Worker 与主 Agent 共用调度器
+    if (m_toolDispatcher && m_journal) {
+        m_toolDispatcher->setResultDirectory(sessionResultDirectory());
+    }
+}
+
+void LLMAgent::appendHistory(const QJsonObject& message) {
+    m_conversationHistory.append(message);
+    m_userTurns += message["role"].toString() == "user" ? 1 : 0;
+    journal(SessionJournal::HistoryMessage, message);
+    emit historyAppended(message);
+}
+
+void LLMAgent::appendContext(const QJsonObject& message) {
+    const int tokens = m_context.append(message);
+    journal(SessionJournal::ContextMessage, message, tokens);
+}
+
+void LLMAgent::journal(SessionJournal::RecordKind kind, const QJsonObject& data, int tokens) {
+    if (m_journal && !m_journal->append(kind, data, tokens)) {
+        // NOTE: 写入失败（如磁盘已满）不影响当前对话，只是之后无法从日志完整恢复
+        m_sessionError = m_journal->errorString();
+    }
 }
 
 // ==================== 工具管理函数 ====================
 
 void LLMAgent::registerTool(const Tool& tool) {
     m_tools.append(tool);
-    qDebug() << "注册工具:" << tool.name;
+    qCDebug(lcAgent) << "注册工具:" << tool.name;
 }
 
 void LLMAgent::clearTools() {
     m_tools.clear();
-    qDebug() << "清空所有工具";
+    m_requestBuilder.setTools(m_tools);
+    qCDebug(lcAgent) << "清空所有工具";
 }
 
 QList<Tool> LLMAgent::getTools() const {
     return m_tools;
 }
 
+void LLMAgent::setRateLimiter(RateLimiter* limiter) {
+    if (rateLimiter() != (limiter ? limiter : LLMTransport::instance().rateLimiter())) {
+        rateLimiter()->cancel(this);
+    }
+    m_rateLimiter = limiter;
+}
+
+RateLimiter* LLMAgent::rateLimiter() const {
+    return m_rateLimiter ? m_rateLimiter : LLMTransport::instance().rateLimiter();
+}
+
 void LLMAgent::setToolDispatcher(ToolDispatcher* dispatcher) {
+    if (m_toolDispatcher) {
+        disconnect(m_toolDispatcher, &ToolDispatcher::toolsChanged, this, nullptr);
+    }
     m_toolDispatcher = dispatcher;
     
-    // 自动从 dispatcher 获取并注册所有工具 Schema
+    // 自动从 dispatcher 获取并注册工具 Schema，tools.yaml 修改后随之刷新
     if (dispatcher) {
-        clearTools();  // 清空旧的工具
-        QList<Tool> tools = dispatcher->getAllToolSchemas();
-        for (const Tool& tool : tools) {
+        connect(dispatcher, &ToolDispatcher::toolsChanged, this, [this]() { refreshTools(); });
+        refreshTools();
+        syncResultDirectory();
+        qCDebug(lcAgent) << "工具调度器已设置，自动注册" << m_tools.size() << "个工具";
+    }
+}
+
+void LLMAgent::refreshTools() {
+    m_tools.clear();
+    for (const Tool& tool : m_toolDispatcher->getAllToolSchemas()) {
+        if (isToolAllowed(tool.name)) {
             registerTool(tool);
         }
-        qDebug() << "工具调度器已设置，自动注册" << tools.size() << "个工具";
     }
+    m_requestBuilder.setTools(routedTools());  // 工具定义只序列化一次
+}
+
+QList<Tool> LLMAgent::routedTools() const {
+    return m_config.toolRouting ? m_toolRouter.filter(m_tools) : m_tools;
+}
+
+bool LLMAgent::isToolAllowed(const QString& toolName) const {
+    // NOTE: 已到最大层级的 Agent 不再提供 delegate_task，避免无限递归
+    if (toolName == SubAgentDelegator::DELEGATE_TASK && !m_config.canDelegate()) {
+        return false;
+    }
+    return m_config.isToolAllowed(toolName);
 }
 
-void LLMAgent::postRequestToServer(const QJsonArray& messages) {
+void LLMAgent::postRequestToServer(const QByteArray& body) {
     // 从 m_config 获取配置
     if (!m_config.isValid()) {
-        emit errorOccurred("API Key is empty! Please configure it first.");
+        reportError("API Key is empty! Please configure it first.");
         return;
     }
     
-    // 构造请求（已注册工具会自动附带）
-    QJsonObject root = buildApiRequestBody(messages);
-
-    QByteArray jsonData = QJsonDocument(root).toJson(QJsonDocument::Indented);
-    qDebug().noquote() << "[Request JSON]" << QString::fromUtf8(jsonData);
+    // NOTE: 请求体转储默认关闭（tmagent.request.debug），开启后按采样截断输出，不再重新缩进格式化
+    Logger::logPayload(lcRequest(), "Request JSON", body);
+    qCDebug(lcAgent) << "[Request] 请求体" << body.size() << "字节";
     
+    m_lastBody = body;
+    m_retryCount = 0;
+    m_canResume = false;
+    m_shownContent.clear();
+    m_replayPos = -1;
+    m_retryTimer->stop();
+    queueRequest();
+}
+
+void LLMAgent::resume() {
+    if (!m_canResume || m_currentReply) {
+        return;
+    }
+    qCDebug(lcAgent) << "[Resume] 从最后完成的步骤继续";
+    m_canResume = false;
+    m_retryCount = 0;
+    m_isToolMode = m_resumeToolMode;
+    queueRequest();
+}
+
+void LLMAgent::queueRequest() {
+    // NOTE: 所有 Agent 经限流器排队等待许可（未设置上限时同步放行），同一 Agent 同时只保留一个待发送的请求
+    RateLimiter* limiter = rateLimiter();
+    limiter->cancel(this);
+    const qint64 queuedNs = Tracer::now();
+    limiter->acquire(this, m_requestTokens, [this, queuedNs]() {
+        Tracer::complete("llm", "queue", queuedNs, Tracer::now(), eventSource());
+        m_chargedTokens = m_requestTokens;
+        sendRequestBody(m_lastBody);
+    });
+}
+
+void LLMAgent::sendRequestBody(const QByteArray& body) {
     // 发送请求到 LLM API
     QUrl url(m_config.baseUrl + m_config.endpoint);
     QNetworkRequest request(url);
@@ -192,6 +436,9 @@ void LLMAgent::postRequestToServer(const QJsonArray& messages) {
     }
     
 
+    // 上一步提前执行的结果都已领取，新的一步重新开始
+    resetSpeculation();
+    
     // 清理旧的请求（如果存在）
     if (m_currentReply) {
         m_currentReply->disconnect();
@@ -200,22 +447,39 @@ void LLMAgent::postRequestToServer(const QJsonArray& messages) {
         m_currentReply = nullptr;
     }
     
-    // 创建新请求
-    m_currentReply = m_manager->post(request, QJsonDocument(root).toJson());
+    // 创建新请求（共享连接池）
+    m_currentReply = LLMTransport::instance().post(request, body);
+    m_requestSentNs = Tracer::now();
+    m_firstTokenNs = 0;
+    m_streamCompletionTokens = 0;
+    metrics().requests->add();
+    metrics().bytesSent->add(body.size());
+    metrics().inFlight->add(1);
+    connect(m_currentReply, &QObject::destroyed, []() { metrics().inFlight->add(-1); });
+    SessionRecorder* recorder = LLMTransport::instance().recorder();
+    m_recordSeq = recorder ? recorder->beginExchange(eventSource(), body) : 0;
     
     // NOTE: 流式数据处理 - 委托给 parseStreamEventLine
     connect(m_currentReply, &QNetworkReply::readyRead, this, [this]() {
         if (!m_currentReply) return;
+        restartIdleTimer();
         while (m_currentReply->canReadLine()) {
-            QByteArray line = m_currentReply->readLine().trimmed();
+            QByteArray line = m_currentReply->readLine();
+            metrics().bytesReceived->add(line.size());
+            line = line.trimmed();
             if (!line.isEmpty()) {
+                if (m_recordSeq && LLMTransport::instance().recorder()) {
+                    LLMTransport::instance().recorder()->recordLine(m_recordSeq, line);
+                }
                 parseStreamEventLine(line);
             }
         }
     });
     
-    // 启动超时定时器
-    m_timeoutTimer->start();
+    // NOTE: 空闲超时而不是总时长超时，长回复只要还在输出就不会被中断；
+    // 服务端排队时发送的 SSE 注释行（": keep-alive"）同样会重新计时
+    m_stalled = false;
+    restartIdleTimer();
     
     // NOTE: 请求完成处理 - 委托给 onStreamFinished
     connect(m_currentReply, &QNetworkReply::finished, this, 
@@ -229,8 +493,8 @@ void LLMAgent::executeToolCalls(const QJsonArray& toolCalls) {
     
     // 检查是否设置了工具调度器
     if (!m_toolDispatcher) {
-        qDebug() << "错误: 未设置 ToolDispatcher，无法执行工具调用";
-        emit errorOccurred("内部错误: 未配置工具调度器");
+        qCWarning(lcAgent) << "错误: 未设置 ToolDispatcher，无法执行工具调用";
+        reportError("内部错误: 未配置工具调度器");
         return;
     }
     
@@ -241,22 +505,108 @@ void LLMAgent::executeToolCalls(const QJsonArray& toolCalls) {
         // DeepSeek 格式: {id, type: "function", function: {name, arguments}}
         QString type = obj["type"].toString();
         if (type == "function") {
-            ToolCall call = ToolCall::fromDeepSeekJson(obj);
-            
-            m_pendingToolCalls.append(call);
-            
-            // NOTE: 发射工具事件信号
-            emit toolEvent(ToolExecutionEvent(call));
-            
-            // NOTE: Agent 自治执行 - 直接调用 ToolDispatcher
-            QString result = m_toolDispatcher->dispatch(call);
-            
-            // NOTE: 自动提交结果，完成闭环
-            submitToolResult(call.id, result);
+            m_pendingToolCalls.append(ToolCall::fromDeepSeekJson(obj));
+        }
+    }
+    
+    // NOTE: 先登记全部调用再执行，否则第一个结果返回时就会误判为全部完成
+    ToolContext context;
+    context.caller = m_config;
+    context.owner = this;
+    const QList<ToolCall> calls = m_pendingToolCalls;
+    for (const ToolCall& call : calls) {
+        // NOTE: 发射工具事件信号
+        reportToolEvent(ToolExecutionEvent(call));
+        
+        if (!isToolAllowed(call.name)) {
+            submitToolResult(call.id, QString("错误: 工具 %1 不在当前 Agent 的允许列表中").arg(call.name));
+            continue;
+        }
+        
+        // 模型调用了本轮未提供但允许使用的工具（如沿用之前见过的定义）：照常执行，之后的请求一并提供
+        if (m_config.toolRouting && m_toolRouter.recordUse(call.name)) {
+            m_requestBuilder.setTools(routedTools());
+        }
+        
+        // 流式输出期间已提前执行的只读工具：参数一致时直接使用结果，仍在执行时等它完成后提交
+        auto speculative = m_speculativeCalls.constFind(call.id);
+        if (speculative != m_speculativeCalls.constEnd()
+            && speculative->name == call.name && speculative->input == call.input) {
+            if (m_speculativeResults.contains(call.id)) {
+                submitToolResult(call.id, m_speculativeResults.take(call.id));
+            }
+            continue;
+        }
+        m_speculativeCalls.remove(call.id);  // 参数与提前执行时不同，结果作废
+        
+        // NOTE: Agent 自治执行 - 同步工具立即回调；异步工具（如 delegate_task）并行执行，完成后回调
+        QPointer<LLMAgent> self(this);
+        const QString toolId = call.id;
+        m_toolDispatcher->dispatchAsync(call, context, [self, toolId](const ToolCall& prepared, const QString& result) {
+            if (self) {
+                self->m_preparedInputs.insert(toolId, prepared.input);
+                self->submitToolResult(toolId, result);  // 自动提交结果，完成闭环
+            }
+        });
+    }
+}
+
+// ==================== 只读工具提前执行 ====================
+
+void LLMAgent::startSpeculativeTool(int index) {
+    if (!m_toolDispatcher) {
+        return;
+    }
+    const ToolCall call = ToolCall::fromDeepSeekJson(m_toolCallAssembler.call(index));
+    if (call.id.isEmpty() || m_speculativeCalls.contains(call.id)
+        || !isToolAllowed(call.name) || !m_toolDispatcher->isReadOnly(call.name)) {
+        return;
+    }
+    m_speculativeCalls.insert(call.id, call);
+    qCDebug(lcAgent) << "[Speculative] 参数已完整，提前执行:" << call.name << call.id;
+
+    // NOTE: 放到事件循环中执行，先把本次 readyRead 中剩余的行解析完，流式文本不被工具耗时阻塞
+    ToolContext context;
+    context.caller = m_config;
+    context.owner = this;
+    const int epoch = m_speculationEpoch;
+    QTimer::singleShot(0, this, [this, call, context, epoch]() {
+        if (epoch != m_speculationEpoch || !m_toolDispatcher) {
+            return;
+        }
+        QPointer<LLMAgent> self(this);
+        const QString toolId = call.id;
+        m_toolDispatcher->dispatchAsync(call, context,
+                                        [self, toolId, epoch](const ToolCall& prepared, const QString& result) {
+            if (self && epoch == self->m_speculationEpoch) {
+                self->m_preparedInputs.insert(toolId, prepared.input);
+            }
+            if (self) {
+                self->onSpeculativeResult(toolId, result, epoch);
+            }
+        });
+    });
+}
+
+void LLMAgent::onSpeculativeResult(const QString& toolId, const QString& result, int epoch) {
+    if (epoch != m_speculationEpoch || !m_speculativeCalls.contains(toolId)) {
+        return;  // 已中断、已重试或参数变化后作废
+    }
+    // executeToolCalls 已登记该调用（消息先于工具结束）时直接提交，否则等它来领取
+    for (const ToolCall& call : m_pendingToolCalls) {
+        if (call.id == toolId) {
+            submitToolResult(toolId, result);
+            return;
         }
     }
+    m_speculativeResults.insert(toolId, result);
 }
 
+void LLMAgent::resetSpeculation() {
+    ++m_speculationEpoch;
+    m_speculativeCalls.clear();
+    m_speculativeResults.clear();
+}
 
 void LLMAgent::submitToolResult(const QString& toolId, const QString& result) {
     // 找到对应的工具名
@@ -264,10 +614,21 @@ void LLMAgent::submitToolResult(const QString& toolId, const QString& result) {
     for (const ToolCall& call : m_pendingToolCalls) {
         if (call.id == toolId) {
             toolName = call.name;
+            if (SessionRecorder* recorder = LLMTransport::instance().recorder()) {
+                if (!m_toolResults.contains(toolId)) {
+                    recorder->recordTool(call, result);
+                }
+            }
             break;
         }
     }
     
+    // 已被中断或不属于当前轮次的结果直接丢弃
+    if (toolName.isEmpty() || m_toolResults.contains(toolId)) {
+        qCDebug(lcAgent) << "忽略过期的工具结果:" << toolId;
+        return;
+    }
+    
     // NOTE: 保存原始结果给 LLM，而不是摘要
     m_toolResults[toolId] = result;
     
@@ -283,7 +644,7 @@ void LLMAgent::submitToolResult(const QString& toolId, const QString& result) {
     event.rawResult = result;
     event.formattedResult = formattedResult;
     event.success = success;
-    emit toolEvent(event);
+    reportToolEvent(event);
     
     // 检查是否所有工具都已返回结果
     bool allCompleted = true;
@@ -304,10 +665,17 @@ void LLMAgent::resumeAfterToolExecution() {
     for (const ToolCall& call : m_pendingToolCalls) {
         QString result = m_toolResults[call.id];
         
-        // NOTE: 保留完整结果，仅限制最大长度为 2000 字符
-        // 这样 LLM 能看到足够的信息来做出正确决策
-        if (result.length() > 2000) {
-            result = result.left(2000) + "\n...(输出过长，已截断)";
+        // NOTE: 按工具输出结构压缩（去重、保留首尾、按目录汇总），
+        // 超出预算的完整结果会落盘，LLM 可自行分页查看；
+        // 压缩函数读取的参数（搜索模式、文件路径）使用分发时修复后的版本，而不是模型给出的原文
+        if (m_toolDispatcher) {
+            ToolCall prepared = call;
+            auto input = m_preparedInputs.constFind(call.id);
+            if (input != m_preparedInputs.constEnd()) {
+                prepared.input = input.value();
+                prepared.rawArguments.clear();
+            }
+            result = m_toolDispatcher->compactResult(prepared, result);
         }
         
         QJsonObject toolMsg;
@@ -315,13 +683,20 @@ void LLMAgent::resumeAfterToolExecution() {
         toolMsg["tool_call_id"] = call.id;
         toolMsg["content"] = result;
         
-        m_currentMessages.append(toolMsg);
+        appendContext(toolMsg);
     }
+    m_preparedInputs.clear();
     
     
     // 使用 QTimer::singleShot 延迟发送，确保当前请求的 finished 处理完全结束
     QTimer::singleShot(0, this, [this]() {
-        postRequestToServer(m_currentMessages);
+        QByteArray body;
+        {
+            TraceSpan span("llm", "build", eventSource());
+            body = contextRequestBody();
+            span.setArg("bytes", body.size());
+        }
+        postRequestToServer(body);
     });
 }
 
@@ -439,29 +814,62 @@ void LLMAgent::parseStreamEventLine(const QByteArray& line) {
     QString data = QString::fromUtf8(line.mid(6));
     if (data == "[DONE]") return;
     
+    TraceSpan span("llm", "decode");
+    span.setArg("bytes", line.size());
     QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
     if (doc.isNull()) return;
     
     QJsonObject obj = doc.object();
+    
+    // NOTE: 开启 include_usage 后，最后一个 chunk 的 choices 为空，只携带 usage
+    if (obj.contains("usage") && obj["usage"].isObject()) {
+        const TokenUsage usage = TokenUsage::fromJson(obj["usage"].toObject());
+        m_totalUsage += usage;
+        m_streamCompletionTokens = usage.completionTokens;
+        metrics().promptTokens->add(usage.promptTokens);
+        metrics().cachedPromptTokens->add(usage.cachedPromptTokens);
+        metrics().completionTokens->add(usage.completionTokens);
+        rateLimiter()->settle(m_chargedTokens, usage.promptTokens + usage.completionTokens);
+        m_chargedTokens = 0;
+        qCDebug(lcAgent) << "[Usage] prompt:" << usage.promptTokens
+                 << "cached:" << usage.cachedPromptTokens
+                 << "completion:" << usage.completionTokens;
+        emit usageReported(usage);
+        
+        EventBus& bus = EventBus::instance();
+        bus.publish(AgentEvent::metricDelta(eventSource(), "prompt_tokens", usage.promptTokens));
+        bus.publish(AgentEvent::metricDelta(eventSource(), "cached_prompt_tokens", usage.cachedPromptTokens));
+        bus.publish(AgentEvent::metricDelta(eventSource(), "completion_tokens", usage.completionTokens));
+    }
+    
     QJsonArray choices = obj["choices"].toArray();
     if (choices.isEmpty()) return;
     
     QJsonObject choice = choices[0].toObject();
     QJsonObject delta = choice["delta"].toObject();
     
+    // 首个 token（文本或工具调用）到达
+    if (!m_firstTokenNs && (delta.contains("content") || delta.contains("tool_calls"))) {
+        m_firstTokenNs = Tracer::now();
+        metrics().ttft->record((m_firstTokenNs - m_requestSentNs) / 1000);
+        Tracer::complete("llm", "ttft", m_requestSentNs, m_firstTokenNs, eventSource());
+    }
+    
     // 累积 finish_reason
     if (choice.contains("finish_reason") && !choice["finish_reason"].isNull()) {//如果有字段，且不是null代表结束了，且如果携带工具调用的时候会显示“tool_calls”
         m_lastFinishReason = choice["finish_reason"].toString();
-        qDebug() << "[Detect] 检测到 finish_reason:" << m_lastFinishReason;
+        qCDebug(lcAgent) << "[Detect] 检测到 finish_reason:" << m_lastFinishReason;
     }
     
     // 流式输出文本内容
     if (delta.contains("content")) {
         QString content = delta["content"].toString();
         m_fullContent += content;
+        const QString unseen = takeUnseenContent(content);
         // NOTE: 只有非空内容才发射信号，避免 UI 层处理空 chunk 的边界情况
-        if (!content.isEmpty()) {
-            emit streamDataReceived(content);
+        if (!unseen.isEmpty()) {
+            emit streamDataReceived(unseen);
+            EventBus::instance().publish(AgentEvent::log(eventSource(), EventChannel::STREAM, unseen));
         }
     }
     
@@ -469,34 +877,72 @@ void LLMAgent::parseStreamEventLine(const QByteArray& line) {
     data: {"id":"f8ae835f-7db0-45cd-8582-302476f993b3","object":"chat.completion.chunk","created":1766478438,"model":"deepseek-chat","system_fingerprint":"fp_eaab8d114b_prod0820_fp8_kvcache"
     ,"choices":[{"index":0,"delta":{"tool_calls":[{"index":0,"id":"call_00_DvuHu0LSMPedPY4cTMP0s0D5","type":"function","function":{"name":"create_file","arguments":""}}]},"logprobs":null,"finish_reason":null}]}
     */
-    // 累积 tool_calls
+    // 增量拼装 tool_calls，参数已完整的只读工具立即开始执行
     if (delta.contains("tool_calls")) {
-        QJsonArray toolCallsArray = delta["tool_calls"].toArray();
+        const QJsonArray toolCallsArray = delta["tool_calls"].toArray();
         for (const QJsonValue& tc : toolCallsArray) {
-            m_streamingToolCallsJson.append(tc);
+            for (int index : m_toolCallAssembler.append(tc.toObject())) {
+                startSpeculativeTool(index);
+            }
         }
     }
 }
 
 void LLMAgent::onStreamFinished() {
-    m_timeoutTimer->stop();
+    m_idleTimer->stop();
     
     if (!m_currentReply) {
-        qDebug() << "错误: m_currentReply 为空";
+        qCWarning(lcAgent) << "错误: m_currentReply 为空";
         return;
     }
     // 无论成功失败，先清空缓冲区
-    m_currentReply->readAll();
+    const QByteArray rest = m_currentReply->readAll().trimmed();
+    metrics().bytesReceived->add(rest.size());
+    if (SessionRecorder* recorder = m_recordSeq ? LLMTransport::instance().recorder() : nullptr) {
+        if (!rest.isEmpty()) {
+            recorder->recordLine(m_recordSeq, rest);  // 错误响应体等没有换行结尾的数据
+        }
+        recorder->endExchange(m_recordSeq,
+                              m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
+    }
+    m_recordSeq = 0;
+    Tracer::complete("llm", "request", m_requestSentNs, Tracer::now(), eventSource(), "status",
+                     m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt());
     // 处理网络错误
     if (m_currentReply->error() != QNetworkReply::NoError) {
-        handleNetworkError(m_currentReply->errorString());
+        // 失败的请求不计入 TPM（usage 不会到达），退还估算的 token
+        rateLimiter()->settle(m_chargedTokens, 0);
+        m_chargedTokens = 0;
+        if (scheduleRetry(m_currentReply, m_stalled ? QString("空闲超时") : QString())) {
+            return;
+        }
+        handleNetworkError(m_stalled ? QString("连接空闲超过 %1 秒，已重试 %2 次仍失败")
+                                           .arg(m_config.idleTimeoutMs / 1000).arg(m_retryCount)
+                                     : m_currentReply->errorString());
+        return;
+    }
+
+    // 没有 finish_reason 就结束的流同样是中途断开（例如代理提前关闭了连接）
+    if (m_lastFinishReason.isEmpty()) {
+        rateLimiter()->settle(m_chargedTokens, 0);
+        m_chargedTokens = 0;
+        if (!scheduleRetry(m_currentReply, "回复在 finish_reason 之前结束")) {
+            handleNetworkError("回复不完整：连接在输出结束前关闭");
+        }
         return;
     }
     
+    // 完整结束的请求：总耗时，以及首个 token 之后的生成速度
+    const qint64 finishedNs = Tracer::now();
+    metrics().requestLatency->record((finishedNs - m_requestSentNs) / 1000);
+    if (m_firstTokenNs && m_streamCompletionTokens > 0 && finishedNs > m_firstTokenNs) {
+        metrics().tokensPerSecond->record(qint64(m_streamCompletionTokens * 1e9 / (finishedNs - m_firstTokenNs)));
+    }
 
     const bool hasToolCalls = (m_lastFinishReason == "tool_calls");
-    if (hasToolCalls && !m_streamingToolCallsJson.isEmpty()) {
-        QJsonArray assembledToolCalls = mergeStreamingToolCalls(m_streamingToolCallsJson);
+    if (hasToolCalls && !m_toolCallAssembler.isEmpty()) {
+        m_toolCallAssembler.finish();
+        QJsonArray assembledToolCalls = m_toolCallAssembler.toolCalls();
         
         QJsonObject assistantMsg;
         assistantMsg["role"] = "assistant";
@@ -504,88 +950,170 @@ void LLMAgent::onStreamFinished() {
             assistantMsg["content"] = m_fullContent;
         }
         assistantMsg["tool_calls"] = assembledToolCalls;
-        m_currentMessages.append(assistantMsg);
+        appendContext(assistantMsg);
         
         executeToolCalls(assembledToolCalls);
     } else {
+        // 最终回复同样计入上下文与对话历史，下一轮请求和恢复的会话才能看到
+        QJsonObject assistantMsg;
+        assistantMsg["role"] = "assistant";
+        assistantMsg["content"] = m_fullContent;
+        if (m_isToolMode) {
+            appendContext(assistantMsg);
+        }
+        if (m_saveToHistory) {
+            appendHistory(assistantMsg);
+        }
         m_isToolMode = false;
         emit finished(m_fullContent);
+        EventBus::instance().publish(AgentEvent::finished(eventSource(), EventChannel::AGENT, m_fullContent));
     }
     
     // 清空临时变量
     m_fullContent.clear();
     m_lastFinishReason.clear();
-    m_streamingToolCallsJson = QJsonArray();
+    m_toolCallAssembler.clear();
     
     m_currentReply->deleteLater();
     m_currentReply = nullptr;
 }
 
+bool LLMAgent::scheduleRetry(QNetworkReply* reply, const QString& interruption) {
+    // NOTE: 请求是幂等的：上下文只在整条 assistant 消息到达后才更新，工具也只在那之后执行，
+    // 所以中途断开时原样重发同一个请求体即可从最后完成的步骤继续
+    if (m_retryCount >= m_config.maxRetries || !(!interruption.isEmpty() || LLMTransport::isRetryable(reply))) {
+        return false;
+    }
+
+    ++m_retryCount;
+    metrics().retries->add();
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    const int delayMs = LLMTransport::retryDelayMs(reply, m_retryCount);
+    if (status == 429) {
+        // 共享同一个 API Key 的 Agent 一起退避，否则其余 Agent 的请求会继续撞上限流
+        rateLimiter()->pause(delayMs);
+    }
+
+    const QString reason = !interruption.isEmpty() ? interruption
+                         : (status >= 400 ? QString::number(status) : reply->errorString());
+    qCInfo(lcAgent) << "[Retry]" << reason << "，已输出" << m_shownContent.size() << "字符，"
+             << delayMs << "ms 后第" << m_retryCount << "次重试";
+    QJsonObject data;
+    data["status"] = status;
+    data["attempt"] = m_retryCount;
+    data["delayMs"] = delayMs;
+    data["stalled"] = m_stalled;
+    data["resumeFrom"] = m_shownContent.size();
+    EventBus::instance().publish(AgentEvent::log(eventSource(), EventChannel::RETRY,
+        QString("请求中断 (%1)，%2 秒后重试").arg(reason).arg(delayMs / 1000.0, 0, 'f', 1), data));
+
+    // 本次尝试的残缺内容丢弃（工具参数可能不完整），已输出的文本留作比对
+    m_fullContent.clear();
+    m_lastFinishReason.clear();
+    m_toolCallAssembler.clear();
+    m_replayPos = m_shownContent.isEmpty() ? -1 : 0;
+
+    m_currentReply->deleteLater();
+    m_currentReply = nullptr;
+    m_retryTimer->start(delayMs);
+    return true;
+}
+
 void LLMAgent::handleNetworkError(const QString& errorMsg) {
-    qDebug() << "[FAIL] 网络请求失败:" << errorMsg;
-    emit errorOccurred(errorMsg);
+    qCWarning(lcAgent) << "[FAIL] 网络请求失败:" << errorMsg;
+    metrics().errors->add();
     if (m_currentReply) {
         m_currentReply->deleteLater();
         m_currentReply = nullptr;
     }
+
+    // 保留上下文与请求体，用户可以 resume() 从最后完成的步骤继续
+    m_resumeToolMode = m_isToolMode;
+    m_canResume = !m_lastBody.isEmpty();
+    m_fullContent.clear();
+    m_lastFinishReason.clear();
+    m_toolCallAssembler.clear();
+    m_replayPos = m_shownContent.isEmpty() ? -1 : 0;
     m_isToolMode = false;
+    reportError(errorMsg);
 }
 
-QJsonArray LLMAgent::mergeStreamingToolCalls(const QJsonArray& streamingToolCallsJson) {
-    QMap<int, QJsonObject> toolCallsMap;
-    
-    for (const QJsonValue& tcVal : streamingToolCallsJson) {
-        const QJsonObject toolObject = tcVal.toObject();
-        const int index = toolObject["index"].toInt();
-        QJsonObject& current = toolCallsMap[index];
-        if (toolObject.contains("id")) current["id"] = toolObject["id"];
-        if (toolObject.contains("type")) current["type"] = toolObject["type"];
-        
-        const QJsonObject funcObj = toolObject["function"].toObject();
-        if (!funcObj.isEmpty()) {
-            QJsonObject currentFunc = current["function"].toObject();
-            if (funcObj.contains("name")) currentFunc["name"] = funcObj["name"];
-            if (funcObj.contains("arguments")) {
-                currentFunc["arguments"] = currentFunc["arguments"].toString()+funcObj["arguments"].toString();
-            }
-            current["function"] = currentFunc;
-        }
+// ==================== 空闲超时与断流续传 ====================
+
+void LLMAgent::restartIdleTimer() {
+    if (m_config.idleTimeoutMs > 0) {
+        m_idleTimer->start();
     }
-    
-    QJsonArray result;
-    for (const QJsonObject& tc : toolCallsMap.values()) {
-        result.append(tc);
+}
+
+void LLMAgent::onIdleTimeout() {
+    if (!m_currentReply) {
+        return;
     }
-    return result;
+    qCWarning(lcAgent) << "连接空闲超过" << m_config.idleTimeoutMs << "ms，中断并重试";
+    m_stalled = true;
+    m_currentReply->abort();  // 同步触发 finished -> onStreamFinished
 }
 
-QJsonObject LLMAgent::buildApiRequestBody(const QJsonArray& messages) {
-    QJsonObject root;
-    root["model"] = m_config.model;
-    root["max_tokens"] = m_config.maxTokens;
-    root["stream"] = true;
-    
-    // System Prompt 作为第一条消息（始终存在）
-    QJsonArray finalMessages;
-    QJsonObject systemMsg;
-    systemMsg["role"] = "system";
-    systemMsg["content"] = m_systemPrompt;
-    finalMessages.append(systemMsg);
-    
-    // 添加用户消息
-    for (const QJsonValue& msg : messages) {
-        finalMessages.append(msg);
+QString LLMAgent::takeUnseenContent(const QString& chunk) {
+    if (m_replayPos < 0) {
+        m_shownContent += chunk;
+        return chunk;
     }
-    
-    root["messages"] = finalMessages;
-    
-    // 添加工具定义
-    if (!m_tools.isEmpty()) {
-        QJsonArray tools;
-        for (const Tool& tool : m_tools) {
-            tools.append(tool.toJson());
-        }
-        root["tools"] = tools;
-    }    
-    return root;
+
+    // 重试后的流与已输出的文本逐字比对，相同的部分不再重复输出
+    int i = 0;
+    while (i < chunk.size() && m_replayPos < m_shownContent.size() && chunk[i] == m_shownContent[m_replayPos]) {
+        ++i;
+        ++m_replayPos;
+    }
+    if (i == chunk.size()) {
+        return QString();
+    }
+
+    if (m_replayPos >= m_shownContent.size()) {
+        // 追上已输出的部分，之后正常输出
+        m_replayPos = -1;
+        const QString rest = chunk.mid(i);
+        m_shownContent += rest;
+        return rest;
+    }
+
+    // 重新生成的内容与已输出的不同：已输出的文本收不回来，另起一段完整输出新内容
+    m_replayPos = -1;
+    m_shownContent = m_fullContent;
+    EventBus::instance().publish(AgentEvent::log(eventSource(), EventChannel::RETRY,
+        "重试后的回复与已输出部分不同，以下为重新生成的内容"));
+    return "\n\n" + m_fullContent;
+}
+
+// ==================== 事件上报 ====================
+
+QString LLMAgent::eventSource() const {
+    return m_config.agentId.isEmpty() ? QString("agent") : m_config.agentId;
+}
+
+void LLMAgent::reportError(const QString& errorMsg) {
+    emit errorOccurred(errorMsg);
+    EventBus::instance().publish(AgentEvent::log(eventSource(), EventChannel::FAILURE, errorMsg));
+}
+
+void LLMAgent::reportToolEvent(const ToolExecutionEvent& event) {
+    emit toolEvent(event);
+    EventBus::instance().publish(AgentEvent::log(eventSource(), EventChannel::TOOL, event.userMessage(), event.toJson()));
+}
+
+// ==================== 上下文预算 ====================
+
+QByteArray LLMAgent::contextRequestBody() {
+    // NOTE: 不在这里开 build span，由调用方统一计时，避免 sendRequest 路径出现嵌套的重复 span
+    // 未超预算时裁剪是 O(1)，请求体只拼接已缓存的消息字节
+    m_context.enforceBudget(reservedContextTokens());
+    m_requestTokens = m_context.totalTokens() + m_requestBuilder.prefixTokens();
+    return m_requestBuilder.build(m_context);
+}
+
+int LLMAgent::reservedContextTokens() const {
+    // 回复空间 + system prompt + 工具定义，这些部分每次请求都会完整发送
+    return m_config.maxTokens + m_requestBuilder.prefixTokens();
 }
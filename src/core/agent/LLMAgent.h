@@ -2,7 +2,6 @@
 #define LLMAGENT_H
 
 #include <QObject>
-#include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QJsonDocument>
@@ -10,9 +9,17 @@
 #include <QJsonArray>
 #include <QDebug>
 #include "ToolTypes.h"
+#include "ContextManager.h"
+#include "RequestBuilder.h"
+#include "ToolCallAssembler.h"
+#include "ToolRouter.h"
+#include "SessionJournal.h"
+#include <QHash>
+#include <memory>
 
 class QTimer;  // 前向声明
 class ToolDispatcher;  // 前向声明
+class RateLimiter;     // 前向声明
 
 
 class LLMAgent : public QObject {
@@ -26,32 +33,63 @@ public:
     // 单次问答,不保存对话历史(适用于短期调用、工具调用等场景)
     void askOnce(const QString& prompt);
     
-    // 设置 Agent 的角色 (System Prompt)
+    // 设置 Agent 的角色 (System Prompt)，覆盖之前的设置
     void setSystemPrompt(const QString& prompt);
-    QString systemPrompt() const { return m_systemPrompt; }
+    QString systemPrompt() const { return m_requestBuilder.systemPrompt(); }
 
     // 对话历史管理
     void clearHistory();                    // 清空对话历史
     QJsonArray getHistory() const;          // 获取对话历史
-    int getConversationCount() const;       // 获取对话轮数
+    int getConversationCount() const { return m_userTurns; }  // 获取对话轮数（用户消息数）
 
     // 中断请求
     void abort();
 
+    /**
+     * @brief 从最后完成的步骤继续（自动重试用尽后由用户触发）
+     * @note 已完成的工具调用与结果保留在上下文中，重新发送失败的那一次请求
+     */
+    void resume();
+    bool canResume() const { return m_canResume; }
+
     // 工具管理
     QList<Tool> getTools() const;                  // 获取已注册的工具列表
     
     /**
      * @brief 设置工具调度器（Agent 自治执行工具调用）
      * @param dispatcher 工具调度器指针（生命周期由外部管理）
-     * @note 会自动从 dispatcher 获取并注册所有工具 Schema
+     * @note 会自动从 dispatcher 获取并注册 LLMConfig::allowedTools 允许的工具 Schema
      */
     void setToolDispatcher(ToolDispatcher* dispatcher);
 
+    /**
+     * @brief 设置请求限流器（生命周期由外部管理）
+     * @note 为空时使用 LLMTransport 的全局限流器
+     */
+    void setRateLimiter(RateLimiter* limiter);
+    RateLimiter* rateLimiter() const;
+
     // 配置管理
     void setConfig(const LLMConfig& config);
     LLMConfig config() const { return m_config; }
 
+    /**
+     * @brief 会话持久化：打开会话日志，已有记录时恢复对话历史与上下文，之后每条消息追加写入
+     * @param encoding 新建日志时的编码（已有日志以文件头为准）
+     * @return 失败时为 false，对话保持不变（错误见 sessionError()）
+     * @note 会话期间超出预算的完整工具结果保存在日志旁的 <path>.results 目录，随日志保留
+     */
+    bool openSession(const QString& path, SessionJournal::Encoding encoding = SessionJournal::Encoding::Json);
+    void closeSession();
+    QString sessionPath() const { return m_journal ? m_journal->path() : QString(); }
+    QString sessionError() const { return m_sessionError; }
+
+    // 累计 token 用量（含前缀缓存命中数），clearHistory 时清零
+    TokenUsage totalUsage() const { return m_totalUsage; }
+    
+    // 发布到 EventBus 时使用的来源标识（agentId，未设置时为 "agent"）
+    QString eventSource() const;
+
 signals:
     void streamDataReceived(const QString& data);    // 收到流式字节流数据
     void finished(const QString& fullContent);   // 请求圆满结束
@@ -62,6 +100,13 @@ signals:
     // 工具事件信号（结构化事件，统一处理）
     void toolEvent(const ToolExecutionEvent& event);
 
+    // 每次请求结束时上报本次 token 用量
+    void usageReported(const TokenUsage& usage);
+
+    // 对话历史变化：追加一条消息 / 整体替换（清空或从会话日志恢复，需重新调用 getHistory()）
+    void historyAppended(const QJsonObject& message);
+    void historyReset();
+
 public slots:
     // 提交工具执行结果
     void submitToolResult(const QString& toolId, const QString& result);
@@ -71,11 +116,17 @@ private:
     // 内部发送流程
     void sendRequest(const QString& prompt, bool saveToHistory);
     
-    // 准备发送的消息列表（处理工具模式和历史记录）
-    QJsonArray buildMessageHistory(const QJsonObject& userMsg, bool saveToHistory);
+    // 准备请求体（处理工具模式和历史记录）
+    QByteArray buildRequestBody(const QJsonObject& userMsg, bool saveToHistory);
     
-    // 统一的内部发送函数（已注册工具会自动带上）
-    void postRequestToServer(const QJsonArray& messages);
+    // 统一的内部发送函数（请求体由 RequestBuilder 拼接，已注册工具会自动带上）
+    void postRequestToServer(const QByteArray& body);
+    void queueRequest();                           // 申请限流许可，获得后发送 m_lastBody
+    void sendRequestBody(const QByteArray& body);  // 获得限流许可后实际发送
+    bool scheduleRetry(QNetworkReply* reply, const QString& interruption = QString());  // 可重试的失败：退避后重新排队
+    void restartIdleTimer();
+    void onIdleTimeout();
+    QString takeUnseenContent(const QString& chunk);  // 重试后跳过已输出过的文本
     void executeToolCalls(const QJsonArray& toolCalls);
     void resumeAfterToolExecution();
     
@@ -89,34 +140,82 @@ private:
     void parseStreamEventLine(const QByteArray& line);
     void onStreamFinished();
     void handleNetworkError(const QString& errorMsg);
-    QJsonArray mergeStreamingToolCalls(const QJsonArray& streamingToolCallsJson);
-    QJsonObject buildApiRequestBody(const QJsonArray& messages);
+    
+    // 只读工具提前执行
+    void startSpeculativeTool(int index);
+    void onSpeculativeResult(const QString& toolId, const QString& result, int epoch);
+    void resetSpeculation();
+    
+    // 事件上报：同时发射信号并发布到 EventBus
+    void reportError(const QString& errorMsg);
+    void reportToolEvent(const ToolExecutionEvent& event);
+    
+    // 上下文预算：裁剪后返回本次请求的请求体
+    QByteArray contextRequestBody();
+    int reservedContextTokens() const;
+    
+    // 消息追加（同时写入会话日志）
+    void appendHistory(const QJsonObject& message);   // 对话历史
+    void appendContext(const QJsonObject& message);   // 工具模式上下文
+    void journal(SessionJournal::RecordKind kind, const QJsonObject& data = QJsonObject(), int tokens = 0);
+    QString sessionResultDirectory() const;            // 会话的完整工具结果目录（未打开会话时为空）
+    void syncResultDirectory();                        // 打开会话时让调度器把完整结果保存到会话目录
     
     // 工具管理（内部调用）
     void registerTool(const Tool& tool);           // 注册工具
     void clearTools();                             // 清空所有工具
+    void refreshTools();                           // 按当前配置的权限重新注册工具
+    QList<Tool> routedTools() const;               // 本会话发送的工具（开启路由时为已选子集）
+    bool isToolAllowed(const QString& toolName) const;
 
-    QNetworkAccessManager *m_manager;
     QNetworkReply *m_currentReply = nullptr;
-    QTimer *m_timeoutTimer = nullptr;  // 超时定时器
+    QTimer *m_idleTimer = nullptr;     // 空闲超时定时器（每收到数据重新计时）
+    QTimer *m_retryTimer = nullptr;    // 重试退避定时器
+    QByteArray m_lastBody;             // 最近一次请求体（重试时原样重发）
+    int m_requestTokens = 0;           // 最近一次请求的估算输入 token（TPM 限流）
+    int m_chargedTokens = 0;           // 本次尝试已从 TPM 扣除、尚未按 usage 补差的 token
+    int m_recordSeq = 0;               // 会话录制中当前请求的序号（未录制时为 0）
+    qint64 m_requestSentNs = 0;        // 当前请求发出的时间（Tracer 时钟，同时用于指标）
+    qint64 m_firstTokenNs = 0;         // 当前请求首个 token 到达的时间，0 表示尚未到达
+    int m_streamCompletionTokens = 0;  // 当前请求 usage 中的 completion token 数
+    int m_retryCount = 0;              // 当前请求已重试次数
+    bool m_stalled = false;            // 当前连接因空闲超时被中断
+    bool m_canResume = false;          // 重试用尽后可由 resume() 继续
+    bool m_resumeToolMode = false;     // 失败请求所处的工具模式
+    
+    // 断流续传：重试前已输出的文本，新的流先与之比对，相同部分不再重复输出
+    QString m_shownContent;
+    int m_replayPos = -1;              // 比对位置，-1 表示不在比对中
     QString m_fullContent;
-    QString m_systemPrompt;
+    RequestBuilder m_requestBuilder;   // 请求体构造（缓存 system prompt 与工具定义的序列化结果）
+    TokenUsage m_totalUsage;           // 累计 token 用量
     QJsonArray m_conversationHistory;  // 对话历史
+    int m_userTurns = 0;               // 历史中的用户消息数，随追加维护
     bool m_saveToHistory = true;       // 是否保存到对话历史
     
     // 工具相关成员变量
     QList<Tool> m_tools;               // 已注册的工具列表
+    ToolRouter m_toolRouter;           // 按任务类型挑选每轮发送的工具
+    std::unique_ptr<SessionJournal> m_journal;  // 会话日志（未打开时为空）
+    QString m_sessionError;
     QList<ToolCall> m_pendingToolCalls; // 待处理的工具调用
-    QJsonArray m_currentMessages;      // 当前对话的完整消息历史
+    ContextManager m_context;          // 当前对话的消息历史（按 token 预算裁剪）
     QMap<QString, QString> m_toolResults; // 工具执行结果 (toolId -> result)
+    QHash<QString, QJsonObject> m_preparedInputs;  // 分发时校验修复后的参数 (toolId -> input)，压缩结果时使用
     bool m_isToolMode = false;         // 是否处于工具调用模式
     
     // 流式工具调用累积变量
     QString m_lastFinishReason;        // 最后的 finish_reason
-    QJsonArray m_streamingToolCallsJson; // 累积的工具调用 JSON 片段
+    ToolCallAssembler m_toolCallAssembler; // 增量拼装的工具调用
+    
+    // 只读工具的提前执行（参数一完整就开始，与剩余的流式输出并行）
+    QHash<QString, ToolCall> m_speculativeCalls;    // 已提前开始的调用 (toolId -> call)
+    QHash<QString, QString> m_speculativeResults;  // 已完成、等待 executeToolCalls 领取的结果
+    int m_speculationEpoch = 0;                    // 中断、重试或进入下一步时递增，丢弃过期结果
     
     // 工具调度器（Agent 自治执行）
     ToolDispatcher* m_toolDispatcher = nullptr;
+    RateLimiter* m_rateLimiter = nullptr;  // 限流器（为空时使用全局限流器）
     
     // Agent 配置
     LLMConfig m_config;
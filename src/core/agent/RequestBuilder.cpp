@@ -0,0 +1,121 @@
+#include "RequestBuilder.h"
+#include "ContextManager.h"
+#include "core/utils/Tokenizer.h"
+#include "core/log/LogCategories.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+// ==================== 前缀内容 ====================
+
+void RequestBuilder::setModel(const QString& model, int maxTokens) {
+    if (model == m_model && maxTokens == m_maxTokens) {
+        return;
+    }
+    m_model = model;
+    m_maxTokens = maxTokens;
+    m_prefixDirty = true;
+}
+
+void RequestBuilder::setSystemPrompt(const QString& prompt) {
+    if (prompt == m_systemPrompt) {
+        return;
+    }
+    m_systemPrompt = prompt;
+    m_systemTokens = Tokenizer::instance().countTokens(prompt);
+    m_prefixDirty = true;
+}
+
+void RequestBuilder::setTools(const QList<Tool>& tools) {
+    // NOTE: 与 QJsonDocument 序列化数组的字节一致（紧凑格式，逗号分隔），已预序列化的工具不再重复序列化
+    QByteArray toolsBytes;
+    if (!tools.isEmpty()) {
+        toolsBytes.append('[');
+        for (int i = 0; i < tools.size(); ++i) {
+            if (i > 0) {
+                toolsBytes.append(',');
+            }
+            toolsBytes.append(tools[i].toJsonBytes());
+        }
+        toolsBytes.append(']');
+    }
+    if (toolsBytes == m_toolsBytes) {
+        return;
+    }
+
+    m_toolsBytes = toolsBytes;
+    m_toolsTokens = m_toolsBytes.isEmpty() ? 0 : Tokenizer::instance().countTokens(QString::fromUtf8(m_toolsBytes));
+    m_prefixDirty = true;
+}
+
+// ==================== 构造请求体 ====================
+
+const QByteArray& RequestBuilder::prefix() const {
+    if (m_prefixDirty) {
+        rebuildPrefix();
+    }
+    return m_prefix;
+}
+
+QByteArray RequestBuilder::build(const ContextManager& context) const {
+    const QByteArray& head = prefix();
+
+    QByteArray body;
+    body.reserve(head.size() + context.serializedSize() + 2);
+    body.append(head);
+    context.appendSerialized(body);
+    body.append("]}");
+    return body;
+}
+
+QByteArray RequestBuilder::build(const QJsonArray& messages) const {
+    const QByteArray& head = prefix();
+
+    QByteArray body;
+    body.reserve(head.size() + messages.size() * 256 + 2);
+    body.append(head);
+    for (const QJsonValue& msg : messages) {
+        body.append(',');
+        body.append(QJsonDocument(msg.toObject()).toJson(QJsonDocument::Compact));
+    }
+    body.append("]}");
+    return body;
+}
+
+void RequestBuilder::rebuildPrefix() const {
+    // NOTE: QJsonObject 按键名排序序列化，内容相同则字节相同；
+    // messages 放在最后，前面的部分在会话内保持不变
+    QJsonObject header;
+    header["model"] = m_model;
+    header["max_tokens"] = m_maxTokens;
+    header["stream"] = true;
+
+    // 流式响应的最后一个 chunk 携带 usage（含前缀缓存命中数）
+    QJsonObject streamOptions;
+    streamOptions["include_usage"] = true;
+    header["stream_options"] = streamOptions;
+
+    QJsonObject systemMsg;
+    systemMsg["role"] = "system";
+    systemMsg["content"] = m_systemPrompt;
+
+    // "tools" 按键名排序恰好排在其余字段之后，直接拼接工具定义的字节
+    QByteArray bytes = QJsonDocument(header).toJson(QJsonDocument::Compact);
+    bytes.chop(1);  // 去掉末尾的 '}'，接上 tools 与 messages 数组
+    if (!m_toolsBytes.isEmpty()) {
+        bytes.append(",\"tools\":");
+        bytes.append(m_toolsBytes);
+    }
+    bytes.append(",\"messages\":[");
+    bytes.append(QJsonDocument(systemMsg).toJson(QJsonDocument::Compact));
+
+    if (bytes != m_prefix) {
+        if (m_prefixRevision > 0) {
+            qCDebug(lcAgent) << "[RequestBuilder] 请求前缀已变化，服务端前缀缓存将失效, 版本:"
+                     << m_prefixRevision + 1;
+        }
+        m_prefix = bytes;
+        ++m_prefixRevision;
+    }
+    m_prefixDirty = false;
+}
@@ -0,0 +1,92 @@
+#ifndef REQUESTBUILDER_H
+#define REQUESTBUILDER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QJsonArray>
+#include <QList>
+#include "ToolTypes.h"
+
+class ContextManager;
+
+/**
+ * @brief 请求体构造器
+ *
+ * DeepSeek 等服务端会缓存已见过的 prompt 前缀（KV cache），命中部分计费更低、首包更快。
+ * 前提是每次请求的前缀完全一致，因此请求体按固定顺序拼接:
+ *
+ *   {"max_tokens":..,"model":..,"stream":true,"stream_options":{..},"tools":[..],
+ *    "messages":[{system}, 历史消息..., 最新消息]}
+ *
+ * messages 之前的部分（模型参数、工具定义、system prompt）只在内容变化时重新序列化，
+ * 之后每次请求直接复用缓存的字节；工具定义使用 ToolSchemaLoader 预序列化的字节原样拼接；历史消息由 ContextManager 保证只追加不改写，
+ * 且每条消息只序列化一次，请求体只是各段字节的拼接。
+ *
+ * 使用方式:
+ *   RequestBuilder builder;
+ *   builder.setModel(config.model, config.maxTokens);
+ *   builder.setSystemPrompt(prompt);
+ *   builder.setTools(tools);
+ *   QByteArray body = builder.build(context);
+ */
+class RequestBuilder {
+public:
+    RequestBuilder() = default;
+
+    // ==================== 前缀内容 ====================
+
+    void setModel(const QString& model, int maxTokens);
+    void setSystemPrompt(const QString& prompt);
+    void setTools(const QList<Tool>& tools);
+
+    const QString& systemPrompt() const { return m_systemPrompt; }
+    bool hasTools() const { return !m_toolsBytes.isEmpty(); }
+
+    /**
+     * @brief system prompt 与工具定义的 token 数（每次请求都会完整发送）
+     */
+    int prefixTokens() const { return m_systemTokens + m_toolsTokens; }
+
+    /**
+     * @brief 前缀版本号，前缀字节每变化一次加 1
+     * @note 会话中途变化意味着服务端前缀缓存失效，可用于排查缓存命中率下降
+     */
+    int prefixRevision() const { return m_prefixRevision; }
+
+    // ==================== 构造请求体 ====================
+
+    /**
+     * @brief 拼接完整请求体
+     * @param context 历史消息（不含 system），复用其中已序列化的字节
+     * @return 紧凑格式的 JSON 字节
+     */
+    QByteArray build(const ContextManager& context) const;
+
+    /**
+     * @brief 拼接完整请求体（消息未缓存序列化结果时使用，如单次问答）
+     */
+    QByteArray build(const QJsonArray& messages) const;
+
+    /**
+     * @brief 缓存的前缀字节（至 system 消息为止，messages 数组未闭合）
+     */
+    const QByteArray& prefix() const;
+
+private:
+    void rebuildPrefix() const;
+
+    QString m_model;
+    int m_maxTokens = 0;
+    QString m_systemPrompt;
+    QByteArray m_toolsBytes;  // 工具定义数组的紧凑 JSON（DeepSeek 格式），为空表示没有工具
+
+    int m_systemTokens = 0;
+    int m_toolsTokens = 0;
+
+    // 惰性重建: 前缀内容变化时只标记，下一次 build 时序列化
+    mutable QByteArray m_prefix;
+    mutable bool m_prefixDirty = true;
+    mutable int m_prefixRevision = 0;
+};
+
+#endif // REQUESTBUILDER_H
@@ -0,0 +1,227 @@
+#include "SessionJournal.h"
+#include "core/log/LogCategories.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtEndian>
+#include <array>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'T', 'M', 'J', 'L'};
+
+QByteArray encodePayload(SessionJournal::Encoding encoding, const QJsonObject& data) {
+    if (encoding == SessionJournal::Encoding::Cbor) {
+        return QCborValue::fromJsonValue(data).toCbor();
+    }
+    return QJsonDocument(data).toJson(QJsonDocument::Compact);
+}
+
+QByteArray fileHeader(SessionJournal::Encoding encoding) {
+    QByteArray header(SessionJournal::kHeaderSize, '\0');
+    memcpy(header.data(), kMagic, sizeof(kMagic));
+    header[4] = char(SessionJournal::kVersion);
+    header[5] = char(encoding);
+    return header;
+}
+
+} // namespace
+
+SessionJournal::~SessionJournal() {
+    close();
+}
+
+quint32 SessionJournal::crc32(const char* data, qint64 size, quint32 crc) {
+    static const auto table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table[(crc ^ quint8(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+SessionJournal::LoadResult SessionJournal::load(const QString& path) {
+    LoadResult result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+    const qint64 size = file.size();
+    if (size < kHeaderSize) {
+        result.error = "文件过短，不是会话日志";
+        return result;
+    }
+
+    // NOTE: 内存映射整个文件，负载以 fromRawData 包装后直接解析，不经过一次读入拷贝
+    QByteArray fallback;
+    const uchar* mapped = file.map(0, size);
+    const char* data = reinterpret_cast<const char*>(mapped);
+    if (!data) {
+        fallback = file.readAll();
+        data = fallback.constData();
+    }
+
+    if (memcmp(data, kMagic, sizeof(kMagic)) != 0 || quint8(data[4]) != kVersion || quint8(data[5]) > 1) {
+        result.error = "文件头无效或版本不受支持";
+    } else {
+        result.ok = true;
+        result.encoding = Encoding(quint8(data[5]));
+        qint64 offset = kHeaderSize;
+        while (offset + kRecordHeaderSize <= size) {
+            const quint32 length = qFromLittleEndian<quint32>(data + offset);
+            const quint32 checksum = qFromLittleEndian<quint32>(data + offset + 4);
+            if (length > quint64(size - offset - kRecordHeaderSize)
+                || crc32(data + offset + 8, kRecordHeaderSize - 8 + qint64(length)) != checksum) {
+                break;
+            }
+
+            Record record;
+            record.kind = RecordKind(quint8(data[offset + 8]));
+            record.tokens = int(qFromLittleEndian<quint32>(data + offset + 9));
+            const QByteArray payload = QByteArray::fromRawData(data + offset + kRecordHeaderSize, int(length));
+            if (result.encoding == Encoding::Cbor) {
+                record.data = QCborValue::fromCbor(payload).toMap().toJsonObject();
+            } else {
+                record.data = QJsonDocument::fromJson(payload).object();
+                record.json = QByteArray(payload.constData(), payload.size());  // 映射解除后仍要使用，深拷贝
+            }
+            offset += kRecordHeaderSize + qint64(length);
+            record.end = offset;
+            result.records.append(record);
+        }
+        result.validBytes = offset;
+        result.truncated = offset < size;
+    }
+
+    if (mapped) {
+        file.unmap(const_cast<uchar*>(mapped));
+    }
+    return result;
+}
+
+bool SessionJournal::open(const QString& path, Encoding encoding) {
+    close();
+    m_loaded.clear();
+    m_recordCount = 0;
+    m_error.clear();
+    m_encoding = encoding;
+    m_file.setFileName(path);
+
+    if (m_file.exists() && m_file.size() > 0) {
+        LoadResult loaded = load(path);
+        if (!loaded.ok) {
+            m_error = QString("无法加载会话日志 %1: %2").arg(path, loaded.error);
+            return false;
+        }
+        if (!m_file.open(QIODevice::ReadWrite)) {
+            m_error = m_file.errorString();
+            return false;
+        }
+        if (loaded.truncated) {
+            // 上次写到一半就退出：丢弃不完整的尾部，之后的记录接在最后一条完整记录后面
+            qCWarning(lcAgent) << "[SessionJournal] 日志尾部不完整，已截断:" << path
+                               << m_file.size() - loaded.validBytes << "字节";
+            m_file.resize(loaded.validBytes);
+        }
+        m_file.seek(loaded.validBytes);
+        m_encoding = loaded.encoding;
+        m_loaded = std::move(loaded.records);
+        m_recordCount = m_loaded.size();
+        return true;
+    }
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_file.write(fileHeader(m_encoding));
+    m_file.flush();
+    return true;
+}
+
+void SessionJournal::close() {
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+bool SessionJournal::append(RecordKind kind, const QJsonObject& data, int tokens) {
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    const QByteArray payload = encodePayload(m_encoding, data);
+
+    // 记录头与负载拼成一次写入，崩溃时最多留下一条不完整的记录
+    QByteArray record(kRecordHeaderSize, '\0');
+    qToLittleEndian<quint32>(quint32(payload.size()), record.data());
+    record[8] = char(kind);
+    qToLittleEndian<quint32>(quint32(qMax(0, tokens)), record.data() + 9);
+    record.append(payload);
+    qToLittleEndian<quint32>(crc32(record.constData() + 8, record.size() - 8), record.data() + 4);
+
+    if (m_file.write(record) != record.size() || !m_file.flush()) {
+        m_error = m_file.errorString();
+        qCWarning(lcAgent) << "[SessionJournal] 写入失败:" << m_file.fileName() << m_error;
+        return false;
+    }
+    ++m_recordCount;
+    return true;
+}
+
+bool SessionJournal::fork(const QString& source, const QString& target, int keepRecords, QString* error) {
+    const LoadResult loaded = load(source);
+    if (keepRecords < 0) {
+        keepRecords = loaded.records.size();
+    }
+    if (!loaded.ok || keepRecords > loaded.records.size()) {
+        if (error) {
+            *error = loaded.ok ? QString("分叉位置 %1 超出记录数 %2").arg(keepRecords).arg(loaded.records.size())
+                               : loaded.error;
+        }
+        return false;
+    }
+    const qint64 end = keepRecords == 0 ? kHeaderSize : loaded.records[keepRecords - 1].end;
+
+    // 前缀按原始字节复制，不解码也不重新编码
+    QFile in(source);
+    QSaveFile out(target);
+    if (!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = in.isOpen() ? out.errorString() : in.errorString();
+        }
+        return false;
+    }
+    out.write(in.read(end));
+    if (!out.commit()) {
+        if (error) {
+            *error = out.errorString();
+        }
+        return false;
+    }
+
+    SessionJournal journal;
+    if (!journal.open(target)) {
+        if (error) {
+            *error = journal.errorString();
+        }
+        return false;
+    }
+    QJsonObject meta;
+    meta["forkedFrom"] = source;
+    meta["forkedAt"] = keepRecords;
+    return journal.append(Meta, meta);
+}
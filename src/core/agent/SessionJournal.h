@@ -0,0 +1,112 @@
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QVector>
+#include <QFile>
+
+/**
+ * @brief 会话日志：只追加、带校验的对话持久化
+ *
+ * LLMAgent 每追加一条消息就写入一条记录并 flush，进程退出或崩溃后可从日志恢复对话，
+ * 不必重新进行代价高昂的探索。文件格式（整数均为小端）:
+ *
+ *   文件头 8 字节:  "TMJL" | 版本 (1) | 编码 (0 = JSON, 1 = CBOR) | 保留 2 字节
+ *   每条记录:       长度 u32 | CRC-32 u32 | 类型 u8 | token 数 u32 | 负载（长度字节）
+ *
+ * CRC 覆盖类型、token 数与负载；加载时在第一条长度越界或校验失败的记录处停止（写了一半的尾部），
+ * 重新打开追加时截掉这部分。负载为消息的紧凑 JSON 或 CBOR（体积更小），
+ * JSON 编码的负载与 ContextManager 缓存的序列化结果相同，恢复时直接复用，不再重新序列化。
+ *
+ * 加载通过内存映射读取，多 MB 的会话也只需一次顺序扫描。
+ *
+ * 分叉：fork() 复制前 N 条记录的原始字节到新文件（不重新编码、不重放 LLM 请求），
+ * 之后可以在新文件上继续另一种尝试。
+ *
+ * 使用方式:
+ *   SessionJournal journal;
+ *   journal.open("session.tmj");              // 已存在时先加载，之后追加
+ *   for (const auto& record : journal.loadedRecords()) { ... }
+ *   journal.append(SessionJournal::ContextMessage, message);
+ */
+class SessionJournal {
+public:
+    enum class Encoding : quint8 { Json = 0, Cbor = 1 };
+
+    enum RecordKind : quint8 {
+        Meta = 0,            // 会话信息（Agent、模型、分叉来源）
+        HistoryMessage = 1,  // 对话历史（界面显示的 user / assistant 消息）
+        ContextMessage = 2,  // 工具模式的上下文消息（含 tool_calls 与工具结果）
+        ClearContext = 3,    // 单次调用前清空上下文
+        ClearAll = 4         // 清空对话历史与上下文
+    };
+
+    static constexpr int kVersion = 1;
+    static constexpr int kHeaderSize = 8;
+    static constexpr int kRecordHeaderSize = 13;
+
+    struct Record {
+        RecordKind kind = Meta;
+        QJsonObject data;
+        QByteArray json;   // JSON 编码时为负载原文（紧凑 JSON），CBOR 编码时为空
+        int tokens = 0;    // 写入时估算的 token 数，0 表示未记录
+        qint64 end = 0;    // 记录结束位置（文件偏移）
+    };
+
+    struct LoadResult {
+        bool ok = false;
+        QString error;
+        Encoding encoding = Encoding::Json;
+        QVector<Record> records;
+        qint64 validBytes = 0;   // 最后一条完整记录之后的偏移
+        bool truncated = false;  // 文件尾部有不完整或损坏的记录
+    };
+
+    SessionJournal() = default;
+    ~SessionJournal();
+
+    /**
+     * @brief 打开日志：文件存在时先加载（loadedRecords），不存在时按 encoding 创建
+     * @note 已有文件的编码以文件头为准
+     */
+    bool open(const QString& path, Encoding encoding = Encoding::Json);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+    Encoding encoding() const { return m_encoding; }
+
+    /**
+     * @brief 打开时已有的记录（恢复会话用）
+     */
+    const QVector<Record>& loadedRecords() const { return m_loaded; }
+    int recordCount() const { return m_recordCount; }
+
+    /**
+     * @brief 追加一条记录并 flush
+     */
+    bool append(RecordKind kind, const QJsonObject& data = QJsonObject(), int tokens = 0);
+
+    /**
+     * @brief 读取整个日志（内存映射）
+     */
+    static LoadResult load(const QString& path);
+
+    /**
+     * @brief 从 source 的前 keepRecords 条记录（-1 表示全部）分叉出新会话 target（覆盖已存在的文件）
+     */
+    static bool fork(const QString& source, const QString& target, int keepRecords, QString* error = nullptr);
+
+    static quint32 crc32(const char* data, qint64 size, quint32 crc = 0);
+
+private:
+    QFile m_file;
+    Encoding m_encoding = Encoding::Json;
+    QVector<Record> m_loaded;
+    int m_recordCount = 0;
+    QString m_error;
+};
+
+#endif // SESSIONJOURNAL_H
@@ -0,0 +1,195 @@
+#include "SubAgentDelegator.h"
+#include "core/orchestrator/Orchestrator.h"
+#include "core/orchestrator/TaskLockTable.h"
+#include "core/tools/FileTool.h"
+#include "core/tools/ShellTool.h"
+#include "core/tools/CodeParserTool.h"
+#include "core/log/LogCategories.h"
+#include <QJsonArray>
+#include <QDebug>
+
+// 子 Agent 的角色：聚焦单个子任务，只返回结论
+static const char* kChildSystemPrompt =
+    "你是一个子 Agent，负责完成主 Agent 委派的单个子任务。"
+    "只进行完成任务所必需的工具调用。"
+    "完成后只输出结论摘要：关键发现、相关文件路径与行号、尚未确认的问题；"
+    "不要复述执行过程，不要粘贴大段文件内容。";
+
+SubAgentDelegator::SubAgentDelegator(ToolDispatcher* dispatcher, QObject *parent)
+    : QObject(parent)
+    , m_dispatcher(dispatcher)
+    , m_locks(new TaskLockTable(this))
+{
+}
+
+QStringList SubAgentDelegator::defaultChildTools() {
+    return {
+        FileTool::VIEW_FILE,
+        FileTool::READ_FILE_LINES,
+        FileTool::LIST_DIRECTORY,
+        FileTool::GREP_SEARCH,
+        FileTool::FIND_BY_NAME,
+        CodeParserTool::VIEW_FILE_OUTLINE,
+        CodeParserTool::VIEW_CODE_ITEM
+    };
+}
+
+// ==================== 委派与回收 ====================
+
+void SubAgentDelegator::execute(const ToolCall& call, const ToolContext& context, ToolDoneFn done) {
+    // NOTE: 层级限制，防止子 Agent 无限递归委派
+    if (!context.caller.canDelegate()) {
+        done(QString("错误: 当前 Agent 已处于最大层级 %1，不能继续委派子任务，请直接完成")
+                 .arg(LLMConfig::MaxLevel));
+        return;
+    }
+
+    const QString taskText = call.input["task"].toString().trimmed();
+    if (taskText.isEmpty()) {
+        done("错误: 缺少参数 task");
+        return;
+    }
+
+    QStringList tools;
+    for (const QJsonValue& value : call.input["tools"].toArray()) {
+        tools.append(value.toString());
+    }
+    if (tools.isEmpty()) {
+        tools = defaultChildTools();
+    }
+    // 子 Agent 的工具不能超出调用方自身的权限
+    QStringList allowed;
+    for (const QString& tool : tools) {
+        if (context.caller.isToolAllowed(tool)) {
+            allowed.append(tool);
+        }
+    }
+    if (allowed.isEmpty()) {
+        done("错误: 指定的工具均不在当前 Agent 的权限范围内");
+        return;
+    }
+
+    AgentTask task;
+    task.id = QString("delegate-%1").arg(m_nextId++);
+    task.type = DELEGATE_TASK;
+    task.systemPrompt = kChildSystemPrompt;
+    task.allowedTools = allowed;
+    task.prompt = taskText;
+    const QString background = call.input["context"].toString().trimmed();
+    if (!background.isEmpty()) {
+        task.prompt += "\n\n背景信息:\n" + background;
+    }
+
+    // 只读子任务之间可以并发；可能写入的子任务独占工作区
+    bool writes = false;
+    for (const QString& tool : allowed) {
+        writes = writes || isWriteTool(tool);
+    }
+    if (writes) {
+        task.exclusiveLocks << TaskLock::WORKSPACE;
+    } else {
+        task.sharedLocks << TaskLock::WORKSPACE;
+    }
+
+    // 调用方本身是委派出的子 Agent 时，子任务在它的锁下运行
+    const QString parentTaskId = m_agentTasks.value(context.caller.agentId);
+    if (!parentTaskId.isEmpty()) {
+        task.lockParents = m_delegations.value(parentTaskId).lockParents;
+        task.lockParents << parentTaskId;
+    }
+    task.config = std::make_shared<const LLMConfig>(childConfig(context.caller));
+
+    Orchestrator* orchestrator = orchestratorFor(context.caller.agentLevel);
+
+    // NOTE: 先登记回调再提交，子任务同步失败（如未配置 API Key）时也能回调
+    m_delegations.insert(task.id, Delegation{context.owner, orchestrator, done, task.lockParents});
+    if (orchestrator->submit(task).isEmpty()) {
+        m_delegations.remove(task.id);
+        done("错误: 子任务提交失败");
+        return;
+    }
+    qCDebug(lcAgent) << "[SubAgentDelegator] 委派子任务" << task.id << "层级:" << context.caller.agentLevel + 1
+             << "工具:" << allowed.join(",");
+}
+
+void SubAgentDelegator::cancel(QObject* owner) {
+    QList<QPair<QString, Orchestrator*>> canceled;
+    for (auto it = m_delegations.begin(); it != m_delegations.end(); ) {
+        if (it->owner == owner) {
+            canceled.append(qMakePair(it.key(), it->orchestrator));
+            it = m_delegations.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 先移除回调再取消，调用方不会收到已取消子任务的结果
+    for (const auto& item : canceled) {
+        qCDebug(lcAgent) << "[SubAgentDelegator] 取消子任务" << item.first;
+        item.second->cancel(item.first);
+    }
+}
+
+void SubAgentDelegator::onTaskFinished(const TaskResult& result) {
+    if (m_agentTasks.value(result.agentId) == result.taskId) {
+        m_agentTasks.remove(result.agentId);
+    }
+
+    auto it = m_delegations.find(result.taskId);
+    if (it == m_delegations.end()) {
+        return;
+    }
+    const ToolDoneFn done = it->done;
+    m_delegations.erase(it);
+
+    // NOTE: 只回传结论摘要，子 Agent 的中间过程留在它自己的上下文中
+    if (result.succeeded()) {
+        done(QString("[子任务完成] 工具调用 %1 次, 耗时 %2 秒\n%3")
+                 .arg(result.metrics["toolCalls"].toInt())
+                 .arg(result.metrics["durationMs"].toDouble() / 1000.0, 0, 'f', 1)
+                 .arg(result.summary));
+    } else {
+        done(QString("错误: 子任务未完成 (%1): %2").arg(taskStatusName(result.status), result.summary));
+    }
+}
+
+// ==================== 辅助函数 ====================
+
+Orchestrator* SubAgentDelegator::orchestratorFor(int callerLevel) {
+    Orchestrator* orchestrator = m_orchestrators.value(callerLevel);
+    if (!orchestrator) {
+        // NOTE: 基础配置只决定层级与 Worker 命名（各层级的 Worker ID 不重复），连接配置随任务传入
+        LLMConfig base;
+        base.agentId = QString("subagent-L%1").arg(callerLevel + 1);
+        base.agentLevel = callerLevel;
+
+        orchestrator = new Orchestrator(this);
+        orchestrator->setConfig(base);
+        orchestrator->setToolDispatcher(m_dispatcher);
+        orchestrator->scheduler()->setLockTable(m_locks);
+        connect(orchestrator, &Orchestrator::taskStarted, this, [this](const AgentTask& task, const QString& agentId) {
+            m_agentTasks.insert(agentId, task.id);
+        });
+        connect(orchestrator, &Orchestrator::taskFinished, this, &SubAgentDelegator::onTaskFinished);
+        m_orchestrators.insert(callerLevel, orchestrator);
+    }
+    return orchestrator;
+}
+
+LLMConfig SubAgentDelegator::childConfig(const LLMConfig& caller) {
+    // 子 Agent 继承调用方的连接配置，但使用更小的上下文预算
+    LLMConfig config = caller;
+    config.contextWindowTokens = qMin(caller.contextWindowTokens, CHILD_CONTEXT_TOKENS);
+    config.maxTokens = qMin(caller.maxTokens, CHILD_MAX_TOKENS);
+    config.allowedTools.clear();
+    return config;
+}
+
+bool SubAgentDelegator::isWriteTool(const QString& toolName) {
+    return toolName == FileTool::CREATE_FILE
+        || toolName == FileTool::REPLACE_IN_FILE
+        || toolName == FileTool::INSERT_CONTENT
+        || toolName == FileTool::MULTI_REPLACE_IN_FILE
+        || toolName == FileTool::DELETE_FILE
+        || toolName == ShellTool::EXECUTE_COMMAND;
+}
@@ -0,0 +1,74 @@
+#ifndef SUBAGENTDELEGATOR_H
+#define SUBAGENTDELEGATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include "ToolDispatcher.h"
+#include "core/orchestrator/TaskTypes.h"
+
+class Orchestrator;   // 前向声明
+class TaskLockTable;  // 前向声明
+
+/**
+ * @brief delegate_task 工具的执行者
+ *
+ * 为调用方 Agent 启动一个层级 +1 的子 Agent，子 Agent 使用独立的小上下文和受限的工具集，
+ * 结束后只把结论摘要作为工具结果返回给调用方，中间的工具调用与文件内容不进入调用方上下文。
+ *
+ * 子 Agent 由 Orchestrator 调度（每个调用方层级一个），同一轮中的多个 delegate_task 并行执行，
+ * 只读子任务共享 workspace 锁，带写入工具的子任务独占。各层级的调度器共用一张锁表，
+ * 子任务可以在祖先任务持有的锁下运行。每个子任务携带调用方的配置，不修改共用的 Orchestrator。
+ */
+class SubAgentDelegator : public QObject {
+    Q_OBJECT
+public:
+    // ==================== 工具名称常量 ====================
+    static constexpr const char* DELEGATE_TASK = "delegate_task";
+
+    // 子 Agent 的上下文与回复预算（远小于主 Agent，保证子任务聚焦）
+    static constexpr int CHILD_CONTEXT_TOKENS = 32768;
+    static constexpr int CHILD_MAX_TOKENS = 2048;
+
+    explicit SubAgentDelegator(ToolDispatcher* dispatcher, QObject *parent = nullptr);
+
+    /**
+     * @brief 执行 delegate_task
+     * @param call 工具调用 {task, context?, tools?}
+     * @param context 调用方信息（决定子 Agent 的层级与可用工具上限）
+     * @param done 子任务结束后回调结论摘要
+     */
+    void execute(const ToolCall& call, const ToolContext& context, ToolDoneFn done);
+
+    /**
+     * @brief 取消某调用方发起的所有子任务（回调不再被调用）
+     */
+    void cancel(QObject* owner);
+
+    /**
+     * @brief 未指定 tools 时子 Agent 可用的只读工具
+     */
+    static QStringList defaultChildTools();
+
+private:
+    struct Delegation {
+        QObject* owner = nullptr;
+        Orchestrator* orchestrator = nullptr;
+        ToolDoneFn done;
+        QStringList lockParents;  // 祖先委派任务（由外到内）
+    };
+
+    Orchestrator* orchestratorFor(int callerLevel);
+    void onTaskFinished(const TaskResult& result);
+    static LLMConfig childConfig(const LLMConfig& caller);
+    static bool isWriteTool(const QString& toolName);
+
+    ToolDispatcher* m_dispatcher;
+    TaskLockTable* m_locks;                     // 各层级调度器共用的锁表
+    QHash<int, Orchestrator*> m_orchestrators;  // 调用方层级 -> 调度子 Agent 的 Orchestrator
+    QHash<QString, Delegation> m_delegations;   // 任务 ID -> 调用方回调
+    QHash<QString, QString> m_agentTasks;       // 子 Agent ID -> 正在执行的委派任务 ID
+    int m_nextId = 1;
+};
+
+#endif // SUBAGENTDELEGATOR_H
@@ -0,0 +1,320 @@
+#include "ToolArgumentValidator.h"
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPair>
+#include <cmath>
+
+struct ToolArgumentValidator::Node {
+    enum class Type { Any, String, Integer, Number, Boolean, Array, Object, Null };
+
+    Type type = Type::Any;
+    QVector<QPair<QString, NodePtr>> properties;  // 按 schema 中的顺序
+    QStringList required;
+    NodePtr items;
+    QJsonArray enumValues;
+};
+
+namespace {
+
+QString jsonTypeName(const QJsonValue& value) {
+    switch (value.type()) {
+        case QJsonValue::Null:   return "null";
+        case QJsonValue::Bool:   return "boolean";
+        case QJsonValue::Double: return "number";
+        case QJsonValue::String: return "string";
+        case QJsonValue::Array:  return "array";
+        case QJsonValue::Object: return "object";
+        default:                 return "undefined";
+    }
+}
+
+QString childPath(const QString& path, const QString& name) {
+    return path.isEmpty() ? name : path + "." + name;
+}
+
+// 整数值的 double（JSON 中 3 与 3.0 无法区分），超出 2^53 的不算
+bool isIntegral(double value) {
+    return std::isfinite(value) && std::floor(value) == value && std::fabs(value) <= 9007199254740992.0;
+}
+
+/**
+ * @brief 宽松解析：去掉 ```json 代码块，忽略 JSON 之前 / 之后的多余文本
+ */
+bool parseLenient(const QString& raw, QJsonDocument& doc, QStringList& repairs) {
+    QString text = raw.trimmed();
+    if (text.startsWith("```")) {
+        const int firstLineEnd = text.indexOf('\n');
+        text = firstLineEnd < 0 ? QString() : text.mid(firstLineEnd + 1);
+        const int fenceEnd = text.lastIndexOf("```");
+        if (fenceEnd >= 0) {
+            text.truncate(fenceEnd);
+        }
+        text = text.trimmed();
+        repairs << "arguments: 去掉代码块标记";
+    }
+
+    auto tryParse = [&doc](const QByteArray& bytes, bool& trailing) {
+        QJsonParseError error;
+        doc = QJsonDocument::fromJson(bytes, &error);
+        trailing = false;
+        if (error.error == QJsonParseError::GarbageAtEnd) {
+            doc = QJsonDocument::fromJson(bytes.left(error.offset), &error);
+            trailing = true;
+        }
+        return error.error == QJsonParseError::NoError;
+    };
+
+    bool trailing = false;
+    QByteArray bytes = text.toUtf8();
+    bool ok = tryParse(bytes, trailing);
+    if (!ok) {
+        const int start = bytes.indexOf('{');
+        if (start > 0 && tryParse(bytes.mid(start), trailing)) {
+            ok = true;
+            repairs << "arguments: 去掉 JSON 之前的多余文本";
+        }
+    }
+    if (ok && trailing) {
+        repairs << "arguments: 去掉 JSON 之后的多余文本";
+    }
+    return ok;
+}
+
+} // namespace
+
+QJsonObject ToolArgumentValidator::Error::toJson() const {
+    QJsonObject json;
+    json["path"] = path;
+    json["code"] = code;
+    if (!expected.isEmpty()) {
+        json["expected"] = expected;
+    }
+    if (!actual.isEmpty()) {
+        json["actual"] = actual;
+    }
+    return json;
+}
+
+ToolArgumentValidator::ToolArgumentValidator(const QJsonObject& schema)
+    : m_root(compile(schema)) {
+}
+
+ToolArgumentValidator::NodePtr ToolArgumentValidator::compile(const QJsonObject& schema) {
+    auto node = std::make_shared<Node>();
+
+    static const QHash<QString, Node::Type> kTypes = {
+        {"string", Node::Type::String}, {"integer", Node::Type::Integer}, {"number", Node::Type::Number},
+        {"boolean", Node::Type::Boolean}, {"array", Node::Type::Array}, {"object", Node::Type::Object},
+        {"null", Node::Type::Null}
+    };
+    // NOTE: 联合类型（["string", "null"]）与未知类型不做类型检查
+    node->type = kTypes.value(schema["type"].toString(), Node::Type::Any);
+
+    const QJsonObject properties = schema["properties"].toObject();
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        node->properties.append(qMakePair(it.key(), compile(it.value().toObject())));
+    }
+    if (!properties.isEmpty() && node->type == Node::Type::Any) {
+        node->type = Node::Type::Object;
+    }
+    for (const QJsonValue& name : schema["required"].toArray()) {
+        node->required.append(name.toString());
+    }
+    if (schema["items"].isObject()) {
+        node->items = compile(schema["items"].toObject());
+    }
+    node->enumValues = schema["enum"].toArray();
+    return node;
+}
+
+ToolArgumentValidator::Result ToolArgumentValidator::validate(const QJsonObject& arguments) const {
+    Result result;
+    result.arguments = check(*m_root, arguments, QString(), result).toObject();
+    return result;
+}
+
+ToolArgumentValidator::Result ToolArgumentValidator::decode(const QString& rawArguments) const {
+    // 无参数的工具常收到空字符串
+    if (rawArguments.trimmed().isEmpty()) {
+        Result result = validate(QJsonObject());
+        result.repairs.prepend("arguments: 空字符串视为 {}");
+        return result;
+    }
+
+    QJsonDocument doc;
+    QStringList repairs;
+    if (!parseLenient(rawArguments, doc, repairs) || !doc.isObject()) {
+        Result result;
+        result.ok = false;
+        result.errors.append({QString(), doc.isNull() ? "invalid_json" : "not_object", "object",
+                              rawArguments.left(80)});
+        return result;
+    }
+
+    Result result = validate(doc.object());
+    result.repairs = repairs + result.repairs;
+    return result;
+}
+
+QJsonValue ToolArgumentValidator::check(const Node& node, const QJsonValue& value, const QString& path,
+                                        Result& result) {
+    auto mismatch = [&](const QString& expected) {
+        result.ok = false;
+        result.errors.append({path, "type_mismatch", expected, jsonTypeName(value)});
+        return value;
+    };
+    auto repaired = [&](const QJsonValue& fixed, const char* to) {
+        result.repairs.append(QString("%1: %2 -> %3").arg(path, jsonTypeName(value), to));
+        return fixed;
+    };
+
+    QJsonValue checked = value;
+    switch (node.type) {
+        case Node::Type::Any:
+            break;
+
+        case Node::Type::String:
+            if (value.isDouble() || value.isBool()) {
+                checked = repaired(value.toVariant().toString(), "string");
+            } else if (!value.isString()) {
+                return mismatch("string");
+            }
+            break;
+
+        case Node::Type::Integer:
+            if (value.isDouble()) {
+                if (!isIntegral(value.toDouble())) {
+                    return mismatch("integer");
+                }
+            } else if (value.isString()) {
+                bool ok = false;
+                const double number = value.toString().trimmed().toDouble(&ok);
+                if (!ok || !isIntegral(number)) {
+                    return mismatch("integer");
+                }
+                checked = repaired(number, "integer");
+            } else {
+                return mismatch("integer");
+            }
+            break;
+
+        case Node::Type::Number:
+            if (value.isString()) {
+                bool ok = false;
+                const double number = value.toString().trimmed().toDouble(&ok);
+                if (!ok || !std::isfinite(number)) {
+                    return mismatch("number");
+                }
+                checked = repaired(number, "number");
+            } else if (!value.isDouble()) {
+                return mismatch("number");
+            }
+            break;
+
+        case Node::Type::Boolean:
+            if (value.isString()) {
+                const QString text = value.toString().trimmed().toLower();
+                if (text != "true" && text != "false") {
+                    return mismatch("boolean");
+                }
+                checked = repaired(text == "true", "boolean");
+            } else if (value.isDouble() && (value.toDouble() == 0 || value.toDouble() == 1)) {
+                checked = repaired(value.toDouble() == 1, "boolean");
+            } else if (!value.isBool()) {
+                return mismatch("boolean");
+            }
+            break;
+
+        case Node::Type::Array: {
+            QJsonArray array;
+            if (value.isArray()) {
+                array = value.toArray();
+            } else if (value.isString() && value.toString().trimmed().startsWith('[')) {
+                const QJsonDocument doc = QJsonDocument::fromJson(value.toString().toUtf8());
+                if (!doc.isArray()) {
+                    return mismatch("array");
+                }
+                array = doc.array();
+                result.repairs.append(QString("%1: string -> array").arg(path));
+            } else {
+                return mismatch("array");
+            }
+            if (node.items) {
+                for (int i = 0; i < array.size(); ++i) {
+                    array[i] = check(*node.items, array[i], QString("%1[%2]").arg(path).arg(i), result);
+                }
+            }
+            checked = array;
+            break;
+        }
+
+        case Node::Type::Object: {
+            QJsonObject object;
+            if (value.isObject()) {
+                object = value.toObject();
+            } else if (value.isString() && value.toString().trimmed().startsWith('{')) {
+                const QJsonDocument doc = QJsonDocument::fromJson(value.toString().toUtf8());
+                if (!doc.isObject()) {
+                    return mismatch("object");
+                }
+                object = doc.object();
+                result.repairs.append(QString("%1: string -> object").arg(path));
+            } else {
+                return mismatch("object");
+            }
+
+            for (const QString& name : node.required) {
+                if (!object.contains(name) || object[name].isNull()) {
+                    result.ok = false;
+                    result.errors.append({childPath(path, name), "missing_required", QString(), QString()});
+                }
+            }
+            for (const auto& property : node.properties) {
+                auto it = object.find(property.first);
+                if (it == object.end()) {
+                    continue;
+                }
+                if (it.value().isNull() && !node.required.contains(property.first)) {
+                    // 可选参数给了 null，按未提供处理
+                    result.repairs.append(QString("%1: null -> 未提供").arg(childPath(path, property.first)));
+                    object.erase(it);
+                    continue;
+                }
+                if (!it.value().isNull()) {
+                    it.value() = check(*property.second, it.value(), childPath(path, property.first), result);
+                }
+            }
+            checked = object;
+            break;
+        }
+
+        case Node::Type::Null:
+            if (!value.isNull()) {
+                return mismatch("null");
+            }
+            break;
+    }
+
+    if (!node.enumValues.isEmpty() && !node.enumValues.contains(checked)) {
+        QStringList allowed;
+        for (const QJsonValue& option : node.enumValues) {
+            allowed.append(option.toVariant().toString());
+        }
+        result.ok = false;
+        result.errors.append({path, "enum_mismatch", allowed.join('|'), checked.toVariant().toString()});
+    }
+    return checked;
+}
+
+QString ToolArgumentValidator::errorReport(const QString& toolName, const Result& result) {
+    QJsonArray errors;
+    for (const Error& error : result.errors) {
+        errors.append(error.toJson());
+    }
+    QJsonObject report;
+    report["error"] = "invalid_arguments";
+    report["tool"] = toolName;
+    report["errors"] = errors;
+    return "错误: 参数校验失败 " + QString::fromUtf8(QJsonDocument(report).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,76 @@
+#ifndef TOOLARGUMENTVALIDATOR_H
+#define TOOLARGUMENTVALIDATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QVector>
+#include <memory>
+
+/**
+ * @brief 工具参数校验器
+ *
+ * 注册工具时从 inputSchema 编译一次（JSON Schema 子集：type、properties、required、items、enum），
+ * 分发前校验模型给出的参数，出错时不执行工具，直接把机器可读的错误回给模型:
+ *
+ *   错误: 参数校验失败 {"error":"invalid_arguments","tool":"read_file_lines",
+ *                      "errors":[{"path":"start_line","code":"type_mismatch","expected":"integer","actual":"string"}]}
+ *
+ * 常见的模型失误就地修复，不再多一轮请求:
+ *   - 数字、布尔值写成字符串（"42"、"true"），整数写成 3.0，字符串参数给了数字
+ *   - 数组 / 对象参数被序列化成字符串（"[\"a\", \"b\"]"）
+ *   - arguments 外面包了 ```json 代码块，或 JSON 之后还有多余文本
+ *
+ * 使用方式:
+ *   ToolArgumentValidator validator(tool.inputSchema);
+ *   ToolArgumentValidator::Result result = validator.validate(call.input);
+ *   if (!result.ok) return ToolArgumentValidator::errorReport(call.name, result);
+ */
+class ToolArgumentValidator {
+public:
+    struct Error {
+        QString path;      // 参数路径，如 "replacements[1].old_text"；arguments 整体错误时为空
+        QString code;      // invalid_json / not_object / missing_required / type_mismatch / enum_mismatch
+        QString expected;  // 期望的类型或取值
+        QString actual;    // 实际的类型或取值
+
+        QJsonObject toJson() const;
+    };
+
+    struct Result {
+        bool ok = true;
+        QJsonObject arguments;  // 修复后的参数（ok 为 false 时为尽力修复的结果）
+        QList<Error> errors;
+        QStringList repairs;    // 做过的修复，如 "start_line: string -> integer"
+    };
+
+    explicit ToolArgumentValidator(const QJsonObject& schema = QJsonObject());
+
+    /**
+     * @brief 校验已解析的参数（并修复类型）
+     */
+    Result validate(const QJsonObject& arguments) const;
+
+    /**
+     * @brief 解析 arguments 原文并校验（原文不是合法 JSON 对象时使用）
+     */
+    Result decode(const QString& rawArguments) const;
+
+    /**
+     * @brief 回给模型的错误结果（"错误: 参数校验失败 " + JSON）
+     */
+    static QString errorReport(const QString& toolName, const Result& result);
+
+private:
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    static NodePtr compile(const QJsonObject& schema);
+    static QJsonValue check(const Node& node, const QJsonValue& value, const QString& path, Result& result);
+
+    NodePtr m_root;
+};
+
+#endif // TOOLARGUMENTVALIDATOR_H
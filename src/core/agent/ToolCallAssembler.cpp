@@ -0,0 +1,103 @@
+#include "ToolCallAssembler.h"
+#include <QJsonDocument>
+
+void ToolCallAssembler::clear() {
+    m_entries.clear();
+}
+
+QList<int> ToolCallAssembler::append(const QJsonObject& fragment) {
+    QList<int> completed;
+    const int index = fragment["index"].toInt();
+
+    // NOTE: 模型按 index 顺序输出调用，后一个开始即说明前面的参数已输出完毕
+    for (auto it = m_entries.begin(); it != m_entries.end() && it.key() < index; ++it) {
+        if (!it->complete) {
+            it->complete = true;
+            completed.append(it.key());
+        }
+    }
+
+    Entry& entry = m_entries[index];
+    if (fragment.contains("id")) entry.id = fragment["id"].toString();
+    if (fragment.contains("type")) entry.type = fragment["type"].toString();
+
+    const QJsonObject function = fragment["function"].toObject();
+    if (function.contains("name")) entry.name = function["name"].toString();
+    if (function.contains("arguments")) {
+        const QString chunk = function["arguments"].toString();
+        entry.arguments += chunk;
+        if (!entry.complete && scan(entry, chunk)) {
+            // 括号平衡只是必要条件，能解析为对象才算完整
+            const QJsonDocument doc = QJsonDocument::fromJson(entry.arguments.toUtf8());
+            if (doc.isObject()) {
+                entry.complete = true;
+                completed.append(index);
+            }
+        }
+    }
+    return completed;
+}
+
+QList<int> ToolCallAssembler::finish() {
+    QList<int> completed;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (!it->complete) {
+            it->complete = true;
+            completed.append(it.key());
+        }
+    }
+    return completed;
+}
+
+bool ToolCallAssembler::isComplete(int index) const {
+    return m_entries.value(index).complete;
+}
+
+QJsonObject ToolCallAssembler::call(int index) const {
+    const Entry entry = m_entries.value(index);
+    QJsonObject function;
+    function["name"] = entry.name;
+    function["arguments"] = entry.arguments;
+
+    QJsonObject call;
+    call["id"] = entry.id;
+    call["type"] = entry.type.isEmpty() ? QString("function") : entry.type;
+    call["function"] = function;
+    return call;
+}
+
+QJsonArray ToolCallAssembler::toolCalls() const {
+    QJsonArray calls;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        calls.append(call(it.key()));
+    }
+    return calls;
+}
+
+bool ToolCallAssembler::scan(Entry& entry, const QString& chunk) {
+    for (const QChar c : chunk) {
+        if (entry.inString) {
+            if (entry.escaped) {
+                entry.escaped = false;
+            } else if (c == '\\') {
+                entry.escaped = true;
+            } else if (c == '"') {
+                entry.inString = false;
+            }
+            continue;
+        }
+
+        if (c == '"') {
+            entry.inString = true;
+        } else if (c == '{' || c == '[') {
+            entry.opened = true;
+            ++entry.depth;
+        } else if (c == '}' || c == ']') {
+            --entry.depth;
+            if (entry.opened && entry.depth == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,81 @@
+#ifndef TOOLCALLASSEMBLER_H
+#define TOOLCALLASSEMBLER_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonArray>
+
+/**
+ * @brief 流式工具调用增量拼装器
+ *
+ * 流式响应中每个 tool_calls 片段只带一部分 arguments:
+ *   {"index":0,"id":"call_0","type":"function","function":{"name":"view_file","arguments":""}}
+ *   {"index":0,"function":{"arguments":"{\"file_path\":"}}
+ *   {"index":0,"function":{"arguments":"\"a.cpp\"}"}}
+ *
+ * 拼装器逐字符跟踪 arguments 的括号深度（跳过字符串内部），满足以下任一条件时判定该调用已完整:
+ *   - arguments 的最外层对象已闭合且能解析为 JSON 对象
+ *   - 下一个 index 的片段已经开始（模型按顺序输出调用）
+ * 这样不必等到整条消息结束就能提前执行只读工具。
+ *
+ * 使用方式:
+ *   for (const QJsonValue& fragment : delta["tool_calls"].toArray()) {
+ *       for (int index : assembler.append(fragment.toObject())) {
+ *           startTool(assembler.call(index));
+ *       }
+ *   }
+ *   ...
+ *   assembler.finish();
+ *   QJsonArray toolCalls = assembler.toolCalls();
+ */
+class ToolCallAssembler {
+public:
+    void clear();
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+    /**
+     * @brief 追加一个 tool_calls 片段
+     * @return 因本片段而变为完整的调用 index（按升序）
+     */
+    QList<int> append(const QJsonObject& fragment);
+
+    /**
+     * @brief 流结束，剩余未完整的调用全部视为完整
+     * @return 本次变为完整的调用 index
+     */
+    QList<int> finish();
+
+    bool isComplete(int index) const;
+
+    /**
+     * @brief 某个调用当前拼装的结果: {id, type, function: {name, arguments}}
+     */
+    QJsonObject call(int index) const;
+
+    /**
+     * @brief 全部调用（按 index 排序），格式与非流式响应的 tool_calls 相同
+     */
+    QJsonArray toolCalls() const;
+
+private:
+    struct Entry {
+        QString id;
+        QString type;
+        QString name;
+        QString arguments;
+        int depth = 0;          // 当前括号深度
+        bool opened = false;    // 已遇到最外层的 '{'
+        bool inString = false;  // 处于字符串内部
+        bool escaped = false;   // 上一个字符是字符串内的反斜杠
+        bool complete = false;
+    };
+
+    // 扫描新增的 arguments 片段，返回最外层对象是否在本片段中闭合
+    static bool scan(Entry& entry, const QString& chunk);
+
+    QMap<int, Entry> m_entries;
+};
+
+#endif // TOOLCALLASSEMBLER_H
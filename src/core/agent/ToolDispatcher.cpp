@@ -3,49 +3,86 @@
 #include "core/tools/ShellTool.h"
 #include "core/tools/CodeParserTool.h"
 #include "core/utils/ToolSchemaLoader.h"
+#include "core/utils/Tokenizer.h"
+#include "ToolResultCompactor.h"
+#include "SubAgentDelegator.h"
+#include "core/trace/Tracer.h"
+#include "core/metrics/MetricsRegistry.h"
+#include "core/log/LogCategories.h"
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QTimer>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+namespace {
+
+// 与 FileTool 相同的路径解析：转换 MSYS 路径，相对路径基于工作目录
+QString workspacePath(const QString& path) {
+    return QDir::cleanPath(QDir::current().absoluteFilePath(FileTool::convertMsysPath(path)));
+}
+
+ToolPathsFn pathArgument(const char* name) {
+    return [name](const QJsonObject& input) { return QStringList{workspacePath(input[name].toString())}; };
+}
+
+} // namespace
 
 ToolDispatcher::ToolDispatcher(QObject *parent) : QObject(parent) {
 }
 
+ToolDispatcher::~ToolDispatcher() = default;
+
 void ToolDispatcher::registerTool(const Tool& schema, 
                                    const QString& description,
-                                   std::function<QString(const QJsonObject&)> executor) {
+                                   std::function<QString(const QJsonObject&)> executor,
+                                   ToolResultCompactFn compactor) {
     ToolEntry entry;
     entry.schema = schema;
     entry.description = description;
     entry.execute = executor;
+    entry.compact = compactor;
+    entry.validator = std::make_shared<const ToolArgumentValidator>(schema.inputSchema);
     
     m_registry[schema.name] = entry;
-    qDebug() << "[ToolDispatcher] 注册工具:" << schema.name << "-" << description;
+    qCDebug(lcTool) << "[ToolDispatcher] 注册工具:" << schema.name << "-" << description;
 }
 
-void ToolDispatcher::registerDefaultTools() {
-    // 从 YAML 文件加载工具定义（尝试多个路径）
-    QStringList possiblePaths = {
-        QCoreApplication::applicationDirPath() + "/resources/tools.yaml",
-        QCoreApplication::applicationDirPath() + "/../resources/tools.yaml",
-        QDir::currentPath() + "/resources/tools.yaml",
-        "resources/tools.yaml"
-    };
-    
-    QVector<Tool> tools;
-    for (const QString& path : possiblePaths) {
-        qDebug() << "[ToolDispatcher] 尝试加载:" << path;
-        if (QFile::exists(path)) {
-            tools = ToolSchemaLoader::loadFromFile(path);
-            if (!tools.isEmpty()) {
-                qDebug() << "[ToolDispatcher] 成功从" << path << "加载" << tools.size() << "个工具";
-                break;
-            }
-        }
-    }
+void ToolDispatcher::registerAsyncTool(const Tool& schema,
+                                       const QString& description,
+                                       ToolAsyncExecuteFn executor,
+                                       std::function<void(QObject*)> cancel,
+                                       ToolResultCompactFn compactor) {
+    ToolEntry entry;
+    entry.schema = schema;
+    entry.description = description;
+    entry.executeAsync = executor;
+    entry.cancel = cancel;
+    entry.compact = compactor;
+    entry.validator = std::make_shared<const ToolArgumentValidator>(schema.inputSchema);
     
+    m_registry[schema.name] = entry;
+    qCDebug(lcTool) << "[ToolDispatcher] 注册异步工具:" << schema.name << "-" << description;
+}
+
+void ToolDispatcher::registerDefaultTools() {
+    // 从 YAML 文件加载工具定义（路径只探测一次，内容未变时读取编译缓存）
+    const QString path = ToolSchemaLoader::defaultPath();
+    const QVector<Tool> tools = path.isEmpty() ? QVector<Tool>() : ToolSchemaLoader::loadFromFile(path);
     if (tools.isEmpty()) {
-        qWarning() << "[ToolDispatcher] 警告: 未能加载任何工具定义!";
+        qCWarning(lcTool) << "[ToolDispatcher] 警告: 未能加载任何工具定义!";
+        return;
     }
-    
+    registerSchemaTools(tools);
+    watchSchemaFile(path);
+}
+
+void ToolDispatcher::registerSchemaTools(const QVector<Tool>& tools) {
     // 工具名称 -> 执行函数的映射表
     QMap<QString, std::function<QString(const QJsonObject&)>> executors = {
         // FileTool
@@ -84,13 +121,148 @@ void ToolDispatcher::registerDefaultTools() {
         {CodeParserTool::VIEW_CODE_ITEM, "查看代码项"}
     };
     
+    // 工具名称 -> 结果压缩函数的映射表（未列出的工具只按 token 预算保留首尾）
+    QMap<QString, ToolResultCompactFn> compactors = {
+        {FileTool::VIEW_FILE, ToolResultCompactor::compactFileView},
+        {FileTool::READ_FILE_LINES, ToolResultCompactor::compactFileView},
+        {FileTool::LIST_DIRECTORY, ToolResultCompactor::compactListing},
+        {FileTool::FIND_BY_NAME, ToolResultCompactor::compactListing},
+        {FileTool::GREP_SEARCH, ToolResultCompactor::compactGrep},
+        {ShellTool::EXECUTE_COMMAND, ToolResultCompactor::compactShell}
+    };
+    
+    // 只读工具：流式输出期间参数一完整即可提前执行，重复执行也没有副作用
+    const QStringList readOnlyTools = {
+        FileTool::VIEW_FILE,
+        FileTool::READ_FILE_LINES,
+        FileTool::LIST_DIRECTORY,
+        FileTool::GREP_SEARCH,
+        FileTool::FIND_BY_NAME,
+        CodeParserTool::VIEW_FILE_OUTLINE,
+        CodeParserTool::VIEW_CODE_ITEM
+    };
+    
+    // 工具名称 -> 读取的路径（只读工具，声明后结果可缓存）
+    QMap<QString, ToolPathsFn> readPaths = {
+        {FileTool::VIEW_FILE, pathArgument("file_path")},
+        {FileTool::READ_FILE_LINES, pathArgument("file_path")},
+        {FileTool::LIST_DIRECTORY, pathArgument("directory_path")},
+        {FileTool::GREP_SEARCH, pathArgument("directory")},
+        {FileTool::FIND_BY_NAME, pathArgument("directory")},
+        {CodeParserTool::VIEW_FILE_OUTLINE, pathArgument("file_path")},
+        {CodeParserTool::VIEW_CODE_ITEM, pathArgument("file_path")}
+    };
+    
+    // 工具名称 -> 写入的路径（未列出的非只读工具，如 execute_command，执行后作废全部缓存）
+    QMap<QString, ToolPathsFn> writePaths = {
+        {FileTool::CREATE_FILE, [](const QJsonObject& input) {
+            return QStringList{workspacePath(input["directory"].toString() + "/" + input["filename"].toString())};
+        }},
+        {FileTool::REPLACE_IN_FILE, pathArgument("file_path")},
+        {FileTool::DELETE_FILE, pathArgument("file_path")},
+        {FileTool::INSERT_CONTENT, pathArgument("file_path")},
+        {FileTool::MULTI_REPLACE_IN_FILE, pathArgument("file_path")}
+    };
+    
     // 注册所有工具
     for (const Tool& tool : tools) {
-        if (executors.contains(tool.name)) {
-            registerTool(tool, descriptions.value(tool.name, tool.name), executors[tool.name]);
+        if (tool.name == SubAgentDelegator::DELEGATE_TASK) {
+            // NOTE: 子 Agent 需要多轮网络请求，只能异步执行
+            if (!m_delegator) {
+                m_delegator = new SubAgentDelegator(this, this);
+            }
+            registerAsyncTool(tool, "委派子任务",
+                [this](const ToolCall& call, const ToolContext& context, ToolDoneFn done) {
+                    m_delegator->execute(call, context, done);
+                },
+                [this](QObject* owner) { m_delegator->cancel(owner); });
+        } else if (executors.contains(tool.name)) {
+            registerTool(tool, descriptions.value(tool.name, tool.name), executors[tool.name],
+                         compactors.value(tool.name));
+            setReadOnly(tool.name, readOnlyTools.contains(tool.name));
+            setToolPaths(tool.name, readPaths.value(tool.name), writePaths.value(tool.name));
         } else {
-            qWarning() << "[ToolDispatcher] 工具" << tool.name << "没有对应的执行函数，跳过注册";
+            qCWarning(lcTool) << "[ToolDispatcher] 工具" << tool.name << "没有对应的执行函数，跳过注册";
+            continue;
         }
+        m_schemaTools.insert(tool.name);
+    }
+}
+
+void ToolDispatcher::watchSchemaFile(const QString& path) {
+    if (!m_schemaWatcher) {
+        m_schemaWatcher = new QFileSystemWatcher(this);
+        m_schemaReloadTimer = new QTimer(this);
+        m_schemaReloadTimer->setSingleShot(true);
+        m_schemaReloadTimer->setInterval(kSchemaReloadDelayMs);
+        connect(m_schemaWatcher, &QFileSystemWatcher::fileChanged, m_schemaReloadTimer, qOverload<>(&QTimer::start));
+        // NOTE: 编辑器保存时常先删除再改名，文件的监视随删除失效；同时监视所在目录，
+        //       文件重新出现（无论间隔多久）时重新加入监视并重新加载
+        connect(m_schemaWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+            if (!m_schemaWatcher->files().contains(m_schemaPath) && QFile::exists(m_schemaPath)) {
+                m_schemaWatcher->addPath(m_schemaPath);
+                m_schemaReloadTimer->start();
+            }
+        });
+        connect(m_schemaReloadTimer, &QTimer::timeout, this, &ToolDispatcher::reloadSchemas);
+    }
+    if (!m_schemaWatcher->files().isEmpty()) {
+        m_schemaWatcher->removePaths(m_schemaWatcher->files());
+    }
+    if (!m_schemaWatcher->directories().isEmpty()) {
+        m_schemaWatcher->removePaths(m_schemaWatcher->directories());
+    }
+    m_schemaPath = path;
+    m_schemaWatcher->addPath(path);
+    m_schemaWatcher->addPath(QFileInfo(path).absolutePath());
+}
+
+void ToolDispatcher::reloadSchemas() {
+    // 改名完成得早时文件已存在但尚未重新监视，这里补上（晚于此时由 directoryChanged 补上）
+    if (!m_schemaWatcher->files().contains(m_schemaPath) && QFile::exists(m_schemaPath)) {
+        m_schemaWatcher->addPath(m_schemaPath);
+    }
+    
+    const QVector<Tool> tools = ToolSchemaLoader::loadFromFile(m_schemaPath);
+    if (tools.isEmpty()) {
+        qCWarning(lcTool) << "[ToolDispatcher] 工具定义重新加载失败，继续使用原有定义";
+        return;
+    }
+    
+    // 从文件中删除的工具一并注销
+    QSet<QString> removed = m_schemaTools;
+    for (const Tool& tool : tools) {
+        removed.remove(tool.name);
+    }
+    for (const QString& name : removed) {
+        m_registry.remove(name);
+        m_schemaTools.remove(name);
+    }
+    
+    registerSchemaTools(tools);
+    m_resultCache.invalidateAll();  // 工具实现可能随定义一起变化
+    qCInfo(lcTool) << "[ToolDispatcher] 工具定义已重新加载:" << tools.size() << "个工具";
+    emit toolsChanged();
+}
+
+void ToolDispatcher::setReadOnly(const QString& toolName, bool readOnly) {
+    auto it = m_registry.find(toolName);
+    if (it != m_registry.end()) {
+        it->readOnly = readOnly;
+    }
+}
+
+bool ToolDispatcher::isReadOnly(const QString& toolName) const {
+    // NOTE: 每次流式工具调用都会查询，value() 会复制整个 ToolEntry（含 schema 与多个 std::function）
+    auto it = m_registry.constFind(toolName);
+    return it != m_registry.constEnd() && it->readOnly;
+}
+
+void ToolDispatcher::setToolPaths(const QString& toolName, ToolPathsFn readPaths, ToolPathsFn writePaths) {
+    auto it = m_registry.find(toolName);
+    if (it != m_registry.end()) {
+        it->readPaths = readPaths;
+        it->writePaths = writePaths;
     }
 }
 
@@ -103,18 +275,185 @@ QList<Tool> ToolDispatcher::getAllToolSchemas() const {
 }
 
 QString ToolDispatcher::dispatch(const ToolCall& call) {
-    const QString& toolName = call.name;
-    const QJsonObject& input = call.input;
-    QString inputStr = QString::fromUtf8(QJsonDocument(input).toJson(QJsonDocument::Compact));
+    auto it = m_registry.constFind(call.name);
+    if (it == m_registry.constEnd()) {
+        return QString("错误: 未知的工具 %1").arg(call.name);
+    }
+    ToolCall prepared = call;
+    const QString invalid = prepareArguments(*it, prepared);
+    if (!invalid.isEmpty()) {
+        return invalid;
+    }
+    return executePrepared(*it, prepared);
+}
+
+QString ToolDispatcher::executePrepared(const ToolEntry& entry, const ToolCall& prepared) {
+    const QString& toolName = prepared.name;
+    TraceSpan span("tool", "dispatch", toolName);
     
-    qDebug() << "[ToolDispatcher] 分发工具调用:" << toolName;
+    qCDebug(lcTool) << "[ToolDispatcher] 分发工具调用:" << toolName;
+    if (!entry.execute) {
+        return QString("错误: 工具 %1 只能异步调用").arg(toolName);
+    }
+    emit toolStarted(entry.description, QString::fromUtf8(QJsonDocument(prepared.input).toJson(QJsonDocument::Compact)));
+    return executeWithCache(entry, prepared.input);
+}
+
+void ToolDispatcher::dispatchAsync(const ToolCall& call, const ToolContext& context, ToolDispatchedFn done) {
+    auto it = m_registry.constFind(call.name);
+    if (it == m_registry.constEnd()) {
+        done(call, QString("错误: 未知的工具 %1").arg(call.name));
+        return;
+    }
     
-    if (m_registry.contains(toolName)) {
-        const ToolEntry& entry = m_registry[toolName];
-        emit toolStarted(entry.description, inputStr);
-        return entry.execute(input);
+    ToolCall prepared = call;
+    const QString invalid = prepareArguments(*it, prepared);
+    if (!invalid.isEmpty()) {
+        done(prepared, invalid);
+        return;
+    }
+    if (!it->executeAsync) {
+        done(prepared, executePrepared(*it, prepared));
+        return;
     }
     
-    return QString("错误: 未知的工具 %1").arg(toolName);
+    qCDebug(lcTool) << "[ToolDispatcher] 分发异步工具调用:" << call.name;
+    emit toolStarted(it->description,
+                     QString::fromUtf8(QJsonDocument(prepared.input).toJson(QJsonDocument::Compact)));
+    // 异步工具的耗时从分发到结果返回
+    const qint64 startNs = Tracer::now();
+    Histogram* latency = MetricsRegistry::instance().histogram(MetricsRegistry::labeled("tool.latency_us", call.name));
+    it->executeAsync(prepared, context, [done, startNs, latency, prepared](const QString& result) {
+        const qint64 endNs = Tracer::now();
+        latency->record((endNs - startNs) / 1000);
+        Tracer::complete("tool", "dispatch_async", startNs, endNs, prepared.name);
+        done(prepared, result);
+    });
+}
+
+void ToolDispatcher::cancelPending(QObject* owner) {
+    for (const ToolEntry& entry : m_registry) {
+        if (entry.cancel) {
+            entry.cancel(owner);
+        }
+    }
 }
 
+QString ToolDispatcher::compactResult(const ToolCall& call, const QString& rawResult) const {
+    QString result = rawResult;
+    auto it = m_registry.constFind(call.name);
+    if (it != m_registry.constEnd() && it->compact) {
+        result = it->compact(rawResult, call.input);
+    }
+    result = ToolResultCompactor::keepHeadAndTail(result, ToolResultCompactor::DEFAULT_TOKEN_BUDGET);
+    
+    // NOTE: 原始结果超出预算时落盘，模型可用 read_file_lines 分页查看被省略的部分
+    if (Tokenizer::instance().countTokens(rawResult) > ToolResultCompactor::DEFAULT_TOKEN_BUDGET) {
+        QString path = saveFullResult(call, rawResult);
+        if (!path.isEmpty()) {
+            result += QString("\n[完整结果已保存至 %1 (共 %2 行)，可用 read_file_lines 分页查看]")
+                          .arg(path).arg(rawResult.count('\n') + 1);
+        }
+    }
+    return result;
+}
+
+QString ToolDispatcher::executeWithCache(const ToolEntry& entry, const QJsonObject& input) {
+    const QString& toolName = entry.schema.name;
+    const bool cacheable = entry.readOnly && entry.readPaths;
+    QString cacheKey;
+    QVector<ToolResultCache::Fingerprint> fingerprints;
+    if (cacheable) {
+        cacheKey = ToolResultCache::key(toolName, input);
+        QString cached;
+        if (m_resultCache.lookup(cacheKey, cached)) {
+            MetricsRegistry::instance().counter(MetricsRegistry::labeled("tool.cache_hits", toolName))->add();
+            qCDebug(lcTool) << "[ToolDispatcher] 使用缓存结果:" << toolName;
+            return cached;
+        }
+        MetricsRegistry::instance().counter(MetricsRegistry::labeled("tool.cache_misses", toolName))->add();
+        fingerprints = ToolResultCache::capture(entry.readPaths(input));
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    const QString result = entry.execute(input);
+    MetricsRegistry::instance().histogram(MetricsRegistry::labeled("tool.latency_us", toolName))
+        ->record(timer.nsecsElapsed() / 1000);
+    
+    if (cacheable) {
+        m_resultCache.store(cacheKey, fingerprints, result);
+    } else if (entry.writePaths) {
+        m_resultCache.invalidatePaths(entry.writePaths(input));
+    } else if (!entry.readOnly) {
+        // NOTE: 写入范围未知（如 execute_command），工作区整体视为已变化
+        m_resultCache.invalidateAll();
+    }
+    return result;
+}
+
+QString ToolDispatcher::prepareArguments(const ToolEntry& entry, ToolCall& call) const {
+    if (!entry.validator) {
+        return QString();
+    }
+    
+    // NOTE: 原文只在 arguments 不是合法 JSON 对象时保留，正常情况下只做一次类型检查
+    const ToolArgumentValidator::Result result = call.rawArguments.isNull()
+        ? entry.validator->validate(call.input)
+        : entry.validator->decode(call.rawArguments);
+    if (!result.ok) {
+        static Counter* errors = MetricsRegistry::instance().counter("tool.argument_errors");
+        errors->add();
+        qCInfo(lcTool) << "[ToolDispatcher] 参数校验失败，未执行:" << call.name << result.errors.size() << "处错误";
+        return ToolArgumentValidator::errorReport(call.name, result);
+    }
+    if (!result.repairs.isEmpty()) {
+        static Counter* repairs = MetricsRegistry::instance().counter("tool.argument_repairs");
+        repairs->add();
+        qCInfo(lcTool) << "[ToolDispatcher] 已修复参数:" << call.name << result.repairs.join("; ");
+        call.input = result.arguments;
+    }
+    call.rawArguments.clear();
+    return QString();
+}
+
+QString ToolDispatcher::saveFullResult(const ToolCall& call, const QString& rawResult) const {
+    // NOTE: 打开会话日志时保存在日志旁的目录，随日志保留（恢复会话后压缩结果中的路径仍有效）；
+    //       否则每个调度器使用独立的临时目录，析构时删除。
+    //       工具调用 ID 在不同会话间会重复，共用目录时会互相覆盖且文件永不清理
+    QDir dir(m_resultDirPath);
+    if (!m_resultDirPath.isEmpty()) {
+        if (!dir.mkpath(".")) {
+            qCWarning(lcTool) << "[ToolDispatcher] 无法创建结果目录:" << m_resultDirPath;
+            return QString();
+        }
+    } else {
+        if (!m_resultDir) {
+            const QString base = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/TmAgent";
+            QDir().mkpath(base);
+            m_resultDir = std::make_unique<QTemporaryDir>(base + "/tool_results-XXXXXX");
+        }
+        if (!m_resultDir->isValid()) {
+            qCWarning(lcTool) << "[ToolDispatcher] 无法创建结果目录:" << m_resultDir->errorString();
+            return QString();
+        }
+        dir.setPath(m_resultDir->path());
+    }
+    
+    // 工具调用 ID 由模型生成，只保留安全字符作为文件名；加序号避免同一会话中的 ID 重复，
+    // 恢复会话后序号从头开始，跳过已有的文件，不覆盖日志中引用的旧结果
+    QString safeId = call.id;
+    safeId.replace(QRegularExpression("[^A-Za-z0-9_-]"), "_");
+    QString fileName;
+    do {
+        fileName = QString("%1-%2.txt").arg(++m_savedResults).arg(safeId);
+    } while (dir.exists(fileName));
+    
+    QFile file(dir.filePath(fileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(lcTool) << "[ToolDispatcher] 无法保存完整结果:" << file.fileName();
+        return QString();
+    }
+    file.write(rawResult.toUtf8());
+    return file.fileName();
+}
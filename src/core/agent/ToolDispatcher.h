@@ -5,8 +5,52 @@
 #include <QJsonObject>
 #include <QList>
 #include <QMap>
+#include <QSet>
+#include <QVector>
 #include <functional>
+#include <memory>
 #include "ToolTypes.h"
+#include "ToolArgumentValidator.h"
+#include "ToolResultCache.h"
+
+class SubAgentDelegator;  // 前向声明
+class QFileSystemWatcher; // 前向声明
+class QTimer;             // 前向声明
+class QTemporaryDir;      // 前向声明
+
+/**
+ * @brief 工具结果压缩函数
+ * @param rawResult 工具原始输出
+ * @param input 工具调用参数
+ * @return 按该工具输出结构压缩后的结果
+ */
+using ToolResultCompactFn = std::function<QString(const QString& rawResult, const QJsonObject& input)>;
+
+/**
+ * @brief 工具调用方信息（异步工具需要知道由哪个 Agent 发起）
+ */
+struct ToolContext {
+    LLMConfig caller;            // 调用方 Agent 的配置（层级、API 等）
+    QObject* owner = nullptr;    // 调用方对象，用于取消其未完成的调用
+};
+
+using ToolDoneFn = std::function<void(const QString& result)>;
+
+/**
+ * @brief dispatchAsync 的结果回调
+ * @param prepared 校验与修复后的调用（参数可能与模型给出的原文不同，压缩结果时应使用它）
+ */
+using ToolDispatchedFn = std::function<void(const ToolCall& prepared, const QString& result)>;
+
+/**
+ * @brief 由参数推出工具读取 / 写入的路径（绝对路径，用于结果缓存的失效判断）
+ */
+using ToolPathsFn = std::function<QStringList(const QJsonObject& input)>;
+
+/**
+ * @brief 异步工具执行函数，完成后调用 done（可在之后的事件循环中调用）
+ */
+using ToolAsyncExecuteFn = std::function<void(const ToolCall& call, const ToolContext& context, ToolDoneFn done)>;
 
 /**
  * @brief 工具注册条目
@@ -15,6 +59,13 @@ struct ToolEntry {
     Tool schema;                                          // Schema 定义
     QString description;                                  // 中文描述
     std::function<QString(const QJsonObject&)> execute;   // 执行函数
+    ToolResultCompactFn compact;                          // 结果压缩函数（可选）
+    ToolAsyncExecuteFn executeAsync;                      // 异步执行函数（可选，设置后取代 execute）
+    std::function<void(QObject* owner)> cancel;           // 取消某调用方未完成的异步调用（可选）
+    bool readOnly = false;                                // 只读、无副作用，可在模型输出完整消息前提前执行
+    std::shared_ptr<const ToolArgumentValidator> validator;  // 注册时从 schema 编译的参数校验器
+    ToolPathsFn readPaths;                                // 读取的路径（只读工具设置后结果可缓存）
+    ToolPathsFn writePaths;                               // 写入的路径（非只读工具未设置时执行后作废全部缓存）
 };
 
 /**
@@ -34,22 +85,55 @@ class ToolDispatcher : public QObject {
     Q_OBJECT
 public:
     explicit ToolDispatcher(QObject *parent = nullptr);
+    ~ToolDispatcher() override;
     
     /**
      * @brief 注册工具
      * @param schema 工具 Schema 定义
      * @param description 中文描述（用于 UI 显示）
      * @param executor 执行函数
+     * @param compactor 结果压缩函数（可选，未提供时只按 token 预算保留首尾）
      */
     void registerTool(const Tool& schema, 
                       const QString& description,
-                      std::function<QString(const QJsonObject&)> executor);
+                      std::function<QString(const QJsonObject&)> executor,
+                      ToolResultCompactFn compactor = nullptr);
     
     /**
-     * @brief 注册默认工具集（FileTool、ShellTool）
+     * @brief 注册异步工具（如 delegate_task，结果在之后的事件循环中返回）
+     * @param cancel 取消某调用方未完成的调用
+     */
+    void registerAsyncTool(const Tool& schema,
+                           const QString& description,
+                           ToolAsyncExecuteFn executor,
+                           std::function<void(QObject* owner)> cancel,
+                           ToolResultCompactFn compactor = nullptr);
+    
+    /**
+     * @brief 注册默认工具集（FileTool、ShellTool、delegate_task）
+     * @note 之后会监视 tools.yaml，修改后自动重新加载并发出 toolsChanged
      */
     void registerDefaultTools();
     
+    /**
+     * @brief 标记工具为只读（registerDefaultTools 已标记文件读取、搜索与代码解析类工具）
+     */
+    void setReadOnly(const QString& toolName, bool readOnly = true);
+    bool isReadOnly(const QString& toolName) const;
+    
+    /**
+     * @brief 声明工具读取 / 写入的路径（registerDefaultTools 已为文件与代码解析类工具声明）
+     * @param readPaths 只读工具读取的路径，设置后相同参数的重复调用直接返回缓存结果
+     * @param writePaths 写入类工具修改的路径，执行后作废读取过这些路径的缓存
+     */
+    void setToolPaths(const QString& toolName, ToolPathsFn readPaths, ToolPathsFn writePaths = nullptr);
+    
+    /**
+     * @brief 只读工具结果缓存的命中统计
+     */
+    const ToolResultCache::Stats& resultCacheStats() const { return m_resultCache.stats(); }
+    void clearResultCache() { m_resultCache.invalidateAll(); }
+    
     /**
      * @brief 获取所有已注册工具的 Schema 定义
      * @return 工具列表，用于注册到 LLMAgent
@@ -62,13 +146,81 @@ public:
      * @return 执行结果字符串
      */
     QString dispatch(const ToolCall& call);
+    
+    /**
+     * @brief 分发工具调用（同步工具立即回调，异步工具完成后回调）
+     * @param call 工具调用请求
+     * @param context 调用方信息
+     * @param done 结果回调（同时给出修复参数后的调用）
+     */
+    void dispatchAsync(const ToolCall& call, const ToolContext& context, ToolDispatchedFn done);
+    
+    /**
+     * @brief 取消某调用方所有未完成的异步工具调用（其回调不会再被调用）
+     */
+    void cancelPending(QObject* owner);
+    
+    /**
+     * @brief 压缩工具结果，供回传给 LLM
+     * @param call 工具调用请求（应为 dispatchAsync 回调给出的修复后调用）
+     * @param rawResult dispatch() 返回的原始结果
+     * @return 压缩后的结果；原始结果超出预算时会落盘，并在末尾注明完整结果路径
+     * @note 落盘文件位于 setResultDirectory 指定的目录；未指定时位于本调度器独占的临时目录，调度器销毁时一并删除
+     */
+    QString compactResult(const ToolCall& call, const QString& rawResult) const;
+    
+    /**
+     * @brief 设置完整结果的保存目录
+     * @param dir 会话日志打开时为日志旁的目录（压缩结果中的路径随日志保存，恢复会话后仍要能读取）；
+     *            为空时恢复使用临时目录
+     */
+    void setResultDirectory(const QString& dir) { m_resultDirPath = dir; }
+    QString resultDirectory() const { return m_resultDirPath; }
 
 signals:
     /// 工具开始执行 (description: 操作描述, params: 参数JSON)
     void toolStarted(const QString& description, const QString& params);
+    
+    /// tools.yaml 修改后工具定义已重新加载（Agent 据此刷新请求中的工具列表）
+    void toolsChanged();
 
 private:
+    static constexpr int kSchemaReloadDelayMs = 200;  // 合并编辑器保存时的多次文件变化
+    
+    void registerSchemaTools(const QVector<Tool>& tools);
+    void watchSchemaFile(const QString& path);
+    void reloadSchemas();
+    QString saveFullResult(const ToolCall& call, const QString& rawResult) const;
+    
+    /**
+     * @brief 分发前校验并修复参数
+     * @return 参数无效时返回回给模型的错误结果（此时不执行工具），否则为空
+     */
+    QString prepareArguments(const ToolEntry& entry, ToolCall& call) const;
+    
+    /**
+     * @brief 执行参数已准备好的同步工具
+     */
+    QString executePrepared(const ToolEntry& entry, const ToolCall& prepared);
+    
+    /**
+     * @brief 执行同步工具，只读工具经过结果缓存，写入类工具执行后作废相关缓存
+     */
+    QString executeWithCache(const ToolEntry& entry, const QJsonObject& input);
+    
     QMap<QString, ToolEntry> m_registry;  // 工具名 -> 注册条目
+    ToolResultCache m_resultCache;        // 只读工具的结果缓存
+    SubAgentDelegator* m_delegator = nullptr;  // delegate_task 的执行者（按需创建）
+    
+    QSet<QString> m_schemaTools;                      // 由 tools.yaml 定义的工具（重新加载时同步增删）
+    QString m_schemaPath;
+    QFileSystemWatcher* m_schemaWatcher = nullptr;
+    QTimer* m_schemaReloadTimer = nullptr;
+    
+    // 超出预算的完整结果（未指定目录时按需创建，每个调度器一个临时目录，析构时删除）
+    QString m_resultDirPath;
+    mutable std::unique_ptr<QTemporaryDir> m_resultDir;
+    mutable int m_savedResults = 0;
 };
 
 #endif // TOOLDISPATCHER_H
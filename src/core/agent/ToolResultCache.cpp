@@ -0,0 +1,125 @@
+#include "ToolResultCache.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonDocument>
+
+ToolResultCache::ToolResultCache(int maxEntries, qint64 maxAgeMs)
+    : m_maxEntries(qMax(1, maxEntries)), m_maxAgeMs(maxAgeMs) {
+}
+
+QString ToolResultCache::key(const QString& toolName, const QJsonObject& input) {
+    return toolName + QLatin1Char('\n') + QString::fromUtf8(QJsonDocument(input).toJson(QJsonDocument::Compact));
+}
+
+ToolResultCache::Fingerprint ToolResultCache::fingerprint(const QString& path) {
+    Fingerprint print;
+    print.path = path;
+    const QFileInfo info(path);
+    print.exists = info.exists();
+    if (print.exists) {
+        print.size = info.size();
+        print.mtimeMs = info.lastModified().toMSecsSinceEpoch();
+    }
+    return print;
+}
+
+bool ToolResultCache::overlaps(const QString& readPath, const QString& writePath) {
+    // 同一路径，或一方是另一方的上级目录（写入 src/a.cpp 影响对 src 的列目录与搜索）
+    auto isUnder = [](const QString& child, const QString& parent) {
+        return child.size() > parent.size() && child.startsWith(parent)
+            && (parent.endsWith('/') || child.at(parent.size()) == '/');
+    };
+    return readPath == writePath || isUnder(writePath, readPath) || isUnder(readPath, writePath);
+}
+
+bool ToolResultCache::lookup(const QString& key, QString& result) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_stats.misses;
+        return false;
+    }
+
+    bool valid = QDateTime::currentMSecsSinceEpoch() - it->storedAtMs <= m_maxAgeMs;
+    for (int i = 0; valid && i < it->fingerprints.size(); ++i) {
+        valid = fingerprint(it->fingerprints[i].path) == it->fingerprints[i];
+    }
+    if (!valid) {
+        m_entries.erase(it);
+        ++m_stats.invalidations;
+        ++m_stats.misses;
+        return false;
+    }
+
+    it->lastUsed = ++m_useTick;
+    result = it->result;
+    ++m_stats.hits;
+    return true;
+}
+
+QVector<ToolResultCache::Fingerprint> ToolResultCache::capture(const QStringList& paths) {
+    QVector<Fingerprint> prints;
+    prints.reserve(paths.size());
+    for (const QString& path : paths) {
+        prints.append(fingerprint(path));
+    }
+    return prints;
+}
+
+void ToolResultCache::store(const QString& key, const QVector<Fingerprint>& fingerprints, const QString& result) {
+    if (result.startsWith("错误") || result.size() > kMaxResultChars) {
+        return;  // 错误可能是暂时的（文件被占用等），下次应重新执行
+    }
+
+    Entry entry;
+    entry.result = result;
+    entry.fingerprints = fingerprints;
+    entry.storedAtMs = QDateTime::currentMSecsSinceEpoch();
+    entry.lastUsed = ++m_useTick;
+
+    if (!m_entries.contains(key) && m_entries.size() >= m_maxEntries) {
+        evictLeastRecentlyUsed();
+    }
+    m_entries.insert(key, entry);
+}
+
+void ToolResultCache::invalidatePaths(const QStringList& paths) {
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        bool stale = false;
+        for (const Fingerprint& print : it->fingerprints) {
+            for (const QString& path : paths) {
+                if (overlaps(print.path, path)) {
+                    stale = true;
+                    break;
+                }
+            }
+            if (stale) {
+                break;
+            }
+        }
+        if (stale) {
+            it = m_entries.erase(it);
+            ++m_stats.invalidations;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ToolResultCache::invalidateAll() {
+    m_stats.invalidations += quint64(m_entries.size());
+    m_entries.clear();
+    ++m_generation;
+}
+
+void ToolResultCache::evictLeastRecentlyUsed() {
+    // NOTE: 条目数上限只有几百，线性扫描比维护 LRU 链表简单
+    auto oldest = m_entries.begin();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        if (it->lastUsed < oldest->lastUsed) {
+            oldest = it;
+        }
+    }
+    if (oldest != m_entries.end()) {
+        m_entries.erase(oldest);
+    }
+}
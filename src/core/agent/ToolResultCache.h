@@ -0,0 +1,117 @@
+#ifndef TOOLRESULTCACHE_H
+#define TOOLRESULTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief 只读工具的结果缓存
+ *
+ * Agent 经常重复同样的只读调用（对根目录 list_directory、同一个 view_file、同一个 grep_search），
+ * 缓存按 工具名 + 规范化参数 保存结果，并记录工具读取的路径及其 (是否存在, 大小, 修改时间)。
+ *
+ * 失效条件:
+ *   - 命中时逐个检查读取路径，任一路径的大小或修改时间变化即作废
+ *   - 写入类工具执行后按其写入路径作废（读取路径与写入路径相同或互为上下级目录）
+ *   - 写入路径未知的工具（如 execute_command）执行后整体作废（工作区代数加 1）
+ *   - 超过 maxAgeMs：目录的修改时间只反映直接子项的增删，外部进程修改深层文件时靠过期兜底
+ *
+ * 使用方式:
+ *   const QString key = ToolResultCache::key(call.name, call.input);
+ *   QString result;
+ *   if (!cache.lookup(key, result)) {
+ *       const auto fingerprints = ToolResultCache::capture(readPaths);
+ *       result = execute(call.input);
+ *       cache.store(key, fingerprints, result);
+ *   }
+ *
+ * @note 非线程安全，与 ToolDispatcher 一样只在主线程使用
+ */
+class ToolResultCache {
+public:
+    static constexpr int kMaxEntries = 256;
+    static constexpr qint64 kMaxAgeMs = 60 * 1000;
+    static constexpr int kMaxResultChars = 256 * 1024;  // 过大的结果不缓存，避免长期占用内存
+
+    /**
+     * @brief 路径在读取时的状态
+     */
+    struct Fingerprint {
+        QString path;
+        bool exists = false;
+        qint64 size = 0;
+        qint64 mtimeMs = 0;
+
+        bool operator==(const Fingerprint& other) const {
+            return exists == other.exists && size == other.size && mtimeMs == other.mtimeMs;
+        }
+    };
+
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 invalidations = 0;  // 因文件变化、写入或整体作废而丢弃的条目数
+    };
+
+    explicit ToolResultCache(int maxEntries = kMaxEntries, qint64 maxAgeMs = kMaxAgeMs);
+
+    /**
+     * @brief 缓存键：工具名 + 紧凑 JSON（QJsonObject 按键名排序，参数顺序不影响结果）
+     */
+    static QString key(const QString& toolName, const QJsonObject& input);
+
+    /**
+     * @brief 查找结果，读取路径已变化或已过期的条目会被删除
+     * @return 命中时为 true，结果写入 result
+     */
+    bool lookup(const QString& key, QString& result);
+
+    /**
+     * @brief 记录路径的当前状态（在执行工具之前调用，执行期间发生的修改会让条目在下次查找时作废）
+     */
+    static QVector<Fingerprint> capture(const QStringList& paths);
+
+    /**
+     * @brief 保存结果（以"错误"开头的结果不缓存）
+     * @param fingerprints 执行前由 capture() 记录的读取路径状态
+     */
+    void store(const QString& key, const QVector<Fingerprint>& fingerprints, const QString& result);
+
+    /**
+     * @brief 写入类工具修改了 paths 后作废相关条目
+     */
+    void invalidatePaths(const QStringList& paths);
+
+    /**
+     * @brief 整体作废（工作区代数加 1）
+     */
+    void invalidateAll();
+
+    int size() const { return m_entries.size(); }
+    quint64 generation() const { return m_generation; }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct Entry {
+        QString result;
+        QVector<Fingerprint> fingerprints;
+        qint64 storedAtMs = 0;
+        quint64 lastUsed = 0;
+    };
+
+    static Fingerprint fingerprint(const QString& path);
+    static bool overlaps(const QString& readPath, const QString& writePath);
+    void evictLeastRecentlyUsed();
+
+    QHash<QString, Entry> m_entries;
+    int m_maxEntries;
+    qint64 m_maxAgeMs;
+    quint64 m_useTick = 0;
+    quint64 m_generation = 0;
+    Stats m_stats;
+};
+
+#endif // TOOLRESULTCACHE_H
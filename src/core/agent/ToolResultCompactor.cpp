@@ -0,0 +1,335 @@
+#include "ToolResultCompactor.h"
+#include "core/utils/Tokenizer.h"
+#include <QRegularExpression>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+
+// list_directory / find_by_name 超过该条目数时按目录汇总
+static const int kMaxListingEntries = 60;
+
+// 汇总时仍逐条列出的顶层条目上限
+static const int kMaxTopLevelEntries = 30;
+
+// execute_command 输出保留的首尾行数
+static const int kStdoutHeadLines = 30;
+static const int kStdoutTailLines = 50;
+static const int kStderrHeadLines = 20;
+static const int kStderrTailLines = 40;
+
+// 按行数保留首尾，中间以省略提示代替
+static QStringList keepHeadTailLines(const QStringList& lines, int head, int tail) {
+    if (lines.size() <= head + tail) {
+        return lines;
+    }
+    QStringList result = lines.mid(0, head);
+    result.append(QString("... (省略 %1 行) ...").arg(lines.size() - head - tail));
+    result.append(lines.mid(lines.size() - tail));
+    return result;
+}
+
+// ==================== 通用辅助 ====================
+
+QString ToolResultCompactor::keepHeadAndTail(const QString& text, int maxTokens, int firstLineNumber) {
+    const Tokenizer& tokenizer = Tokenizer::instance();
+    if (tokenizer.countTokens(text) <= maxTokens) {
+        return text;
+    }
+
+    // NOTE: 头部给 40%，尾部给剩余预算（日志、编译输出的结论通常在末尾）
+    const QStringList lines = text.split('\n');
+    const int headBudget = maxTokens * 2 / 5;
+    const int tailBudget = maxTokens - headBudget - 20;  // 预留省略提示
+
+    int head = 0;
+    int used = 0;
+    while (head < lines.size()) {
+        const int lineTokens = tokenizer.countTokens(lines[head]) + 1;
+        if (used + lineTokens > headBudget) break;
+        used += lineTokens;
+        ++head;
+    }
+
+    int tail = 0;
+    used = 0;
+    while (tail < lines.size() - head) {
+        const int lineTokens = tokenizer.countTokens(lines[lines.size() - 1 - tail]) + 1;
+        if (used + lineTokens > tailBudget) break;
+        used += lineTokens;
+        ++tail;
+    }
+
+    // 单行超长（如压缩过的 JSON）时退化为按 token 截断
+    if (head == 0 && tail == 0) {
+        return tokenizer.truncateToTokens(text, maxTokens) + "\n... (输出过长，已截断)";
+    }
+
+    const int omitted = lines.size() - head - tail;
+    const QString note = firstLineNumber > 0
+        ? QString("... (省略第 %1~%2 行，共 %3 行) ...")
+              .arg(firstLineNumber + head).arg(firstLineNumber + head + omitted - 1).arg(omitted)
+        : QString("... (省略 %1 行) ...").arg(omitted);
+
+    QStringList result = lines.mid(0, head);
+    result.append(note);
+    result.append(lines.mid(lines.size() - tail));
+    return result.join('\n');
+}
+
+QStringList ToolResultCompactor::collapseRepeatedLines(const QStringList& lines) {
+    QStringList result;
+    int repeat = 0;
+    for (int i = 0; i < lines.size(); ++i) {
+        if (i > 0 && lines[i] == lines[i - 1]) {
+            ++repeat;
+            continue;
+        }
+        if (repeat > 0) {
+            result.append(QString("(上一行重复 %1 次)").arg(repeat));
+            repeat = 0;
+        }
+        result.append(lines[i]);
+    }
+    if (repeat > 0) {
+        result.append(QString("(上一行重复 %1 次)").arg(repeat));
+    }
+    return result;
+}
+
+// ==================== grep_search ====================
+
+QString ToolResultCompactor::compactGrep(const QString& rawResult, const QJsonObject& input) {
+    if (rawResult.startsWith("错误:")) {
+        return rawResult;
+    }
+
+    // 匹配行格式: 相对路径:行号: 内容
+    static const QRegularExpression matchRe("^(.+?):(\\d+): (.*)$");
+
+    struct FileGroup {
+        QString path;
+        QStringList texts;                    // 按首次出现顺序
+        QHash<QString, QStringList> lineNos;  // 内容 -> 行号列表
+    };
+    QVector<FileGroup> groups;
+    QHash<QString, int> groupIndex;
+    QStringList header;
+    QStringList footer;
+
+    for (const QString& line : rawResult.split('\n')) {
+        const QRegularExpressionMatch match = matchRe.match(line);
+        if (match.hasMatch()) {
+            const QString path = match.captured(1);
+            if (!groupIndex.contains(path)) {
+                groupIndex.insert(path, groups.size());
+                groups.append(FileGroup{path, {}, {}});
+            }
+            FileGroup& group = groups[groupIndex.value(path)];
+            const QString text = match.captured(3);
+            if (!group.lineNos.contains(text)) {
+                group.texts.append(text);
+            }
+            group.lineNos[text].append(match.captured(2));
+        } else if (line.trimmed().isEmpty() || line == "---") {
+            continue;
+        } else if (groups.isEmpty()) {
+            header.append(line);
+        } else {
+            footer.append(line);
+        }
+    }
+
+    if (groups.isEmpty()) {
+        return rawResult;
+    }
+
+    // 工具自带的头部含搜索目录的绝对路径；参数可用时改为只给出模式与文件过滤
+    const QString pattern = input["pattern"].toString();
+    if (!pattern.isEmpty()) {
+        const QString filePattern = input["file_pattern"].toString();
+        header = QStringList{filePattern.isEmpty()
+            ? QString("搜索 \"%1\":").arg(pattern)
+            : QString("搜索 \"%1\" (%2):").arg(pattern, filePattern)};
+    }
+
+    // NOTE: 同一文件只输出一次路径，内容相同的匹配行合并为一行
+    QStringList result = header;
+    for (const FileGroup& group : groups) {
+        result.append(group.path + ":");
+        for (const QString& text : group.texts) {
+            result.append(QString("  %1: %2").arg(group.lineNos.value(text).join(", "), text));
+        }
+    }
+    result.append(footer);
+    return result.join('\n');
+}
+
+// ==================== execute_command ====================
+
+QString ToolResultCompactor::compactShell(const QString& rawResult, const QJsonObject& input) {
+    Q_UNUSED(input);
+    if (!rawResult.startsWith("退出码:")) {
+        return rawResult;
+    }
+
+    // 结果格式: 退出码 / 标准输出: / 错误输出:
+    const QString stdoutMarker = "标准输出:\n";
+    const QString stderrMarker = "错误输出:\n";
+    const int stdoutPos = rawResult.indexOf(stdoutMarker);
+    const int stderrPos = rawResult.lastIndexOf(stderrMarker);
+
+    const int firstSection = stdoutPos >= 0 ? stdoutPos : (stderrPos >= 0 ? stderrPos : rawResult.length());
+    QString result = rawResult.left(firstSection);
+
+    auto compactSection = [&](const QString& marker, int start, int end, int head, int tail) {
+        const QString body = rawResult.mid(start + marker.length(), end - start - marker.length());
+        QStringList lines = collapseRepeatedLines(body.split('\n'));
+        result += marker + keepHeadTailLines(lines, head, tail).join('\n');
+        if (!result.endsWith('\n')) {
+            result += '\n';
+        }
+    };
+
+    if (stdoutPos >= 0) {
+        const int stdoutEnd = stderrPos > stdoutPos ? stderrPos : rawResult.length();
+        compactSection(stdoutMarker, stdoutPos, stdoutEnd, kStdoutHeadLines, kStdoutTailLines);
+    }
+    if (stderrPos >= 0 && stderrPos != stdoutPos) {
+        compactSection(stderrMarker, stderrPos, rawResult.length(), kStderrHeadLines, kStderrTailLines);
+    }
+    return result;
+}
+
+// ==================== list_directory / find_by_name ====================
+
+QString ToolResultCompactor::compactListing(const QString& rawResult, const QJsonObject& input) {
+    if (rawResult.startsWith("错误:")) {
+        return rawResult;
+    }
+
+    struct Entry {
+        bool isDir;
+        QString path;
+        qint64 size;
+    };
+    static const QRegularExpression sizeRe("^(.*?)\\s+(\\d+) 字节$");
+
+    QVector<Entry> entries;
+    QStringList header;
+    QStringList footer;
+    for (const QString& line : rawResult.split('\n')) {
+        const bool isDir = line.startsWith("[目录]");
+        if (isDir || line.startsWith("[文件]")) {
+            QString rest = line.mid(4).trimmed();
+            qint64 size = 0;
+            const QRegularExpressionMatch match = sizeRe.match(rest);
+            if (match.hasMatch()) {
+                rest = match.captured(1);
+                size = match.captured(2).toLongLong();
+            }
+            entries.append(Entry{isDir, rest, size});
+        } else if (line.trimmed().isEmpty() || line == "---") {
+            continue;
+        } else if (entries.isEmpty()) {
+            header.append(line);
+        } else {
+            footer.append(line);
+        }
+    }
+
+    if (entries.size() <= kMaxListingEntries) {
+        return rawResult;
+    }
+
+    // 按所在目录汇总（保持首次出现顺序）
+    struct DirStats {
+        int files = 0;
+        int dirs = 0;
+        qint64 bytes = 0;
+    };
+    QStringList dirOrder;
+    QHash<QString, DirStats> stats;
+    QStringList topLevel;
+    for (const Entry& entry : entries) {
+        const QString parent = QFileInfo(entry.path).path();
+        if (!stats.contains(parent)) {
+            dirOrder.append(parent);
+        }
+        DirStats& dir = stats[parent];
+        if (entry.isDir) {
+            ++dir.dirs;
+        } else {
+            ++dir.files;
+            dir.bytes += entry.size;
+        }
+        if (parent == ".") {
+            topLevel.append(entry.isDir ? entry.path + "/" : entry.path);
+        }
+    }
+
+    QStringList result = header;
+    if (!topLevel.isEmpty() && topLevel.size() <= kMaxTopLevelEntries) {
+        result.append("顶层条目: " + topLevel.join(", "));
+    }
+    // list_directory 给出目录，find_by_name 给出名称模式
+    const QString directory = input["directory_path"].toString();
+    const QString namePattern = input["pattern"].toString();
+    if (!directory.isEmpty()) {
+        result.append(QString("%1 下共 %2 项，按目录汇总:").arg(directory).arg(entries.size()));
+    } else if (!namePattern.isEmpty()) {
+        result.append(QString("匹配 \"%1\" 的共 %2 项，按目录汇总:").arg(namePattern).arg(entries.size()));
+    } else {
+        result.append(QString("共 %1 项，按目录汇总:").arg(entries.size()));
+    }
+    for (const QString& dirPath : dirOrder) {
+        const DirStats& dir = stats.value(dirPath);
+        QString line = QString("  %1/  文件 %2, 目录 %3").arg(dirPath).arg(dir.files).arg(dir.dirs);
+        if (dir.bytes > 0) {
+            line += QString(", %1 KB").arg((dir.bytes + 1023) / 1024);
+        }
+        result.append(line);
+    }
+    result.append(footer);
+    return result.join('\n');
+}
+
+// ==================== view_file / read_file_lines ====================
+
+QString ToolResultCompactor::compactFileView(const QString& rawResult, const QJsonObject& input) {
+    // 元信息头被去掉后，用调用参数中的路径标注内容来自哪个文件（多次查看不同文件时便于区分）
+    const QString filePath = input["file_path"].toString();
+
+    // view_file: 去掉 文件路径/文件大小/总行数 与内容标记，长文件保留首尾并标注行号
+    if (rawResult.startsWith("文件路径:")) {
+        const QString beginMarker = "---内容开始---\n";
+        const QString endMarker = "\n---内容结束---";
+        const int begin = rawResult.indexOf(beginMarker);
+        const int end = rawResult.lastIndexOf(endMarker);
+        if (begin < 0 || end < begin) {
+            return rawResult;
+        }
+        const QString content = rawResult.mid(begin + beginMarker.length(),
+                                              end - begin - beginMarker.length());
+        const QString compacted = keepHeadAndTail(content, DEFAULT_TOKEN_BUDGET, 1);
+        return filePath.isEmpty() ? compacted : QString("[%1]\n%2").arg(filePath, compacted);
+    }
+
+    // read_file_lines: 元信息压缩为一行，内容行自带行号
+    if (rawResult.startsWith("文件:")) {
+        const int separator = rawResult.indexOf("\n---\n");
+        if (separator < 0) {
+            return rawResult;
+        }
+        static const QRegularExpression totalRe("总行数: (\\d+)");
+        static const QRegularExpression rangeRe("显示范围: (第 .+ 行)");
+        const QString meta = rawResult.left(separator);
+        QString summary = QString("(共 %1 行, 显示%2)")
+            .arg(totalRe.match(meta).captured(1), rangeRe.match(meta).captured(1));
+        if (!filePath.isEmpty()) {
+            summary = QString("[%1] %2").arg(filePath, summary);
+        }
+        return summary + "\n" + keepHeadAndTail(rawResult.mid(separator + 5), DEFAULT_TOKEN_BUDGET);
+    }
+
+    return rawResult;
+}
@@ -0,0 +1,49 @@
+#ifndef TOOLRESULTCOMPACTOR_H
+#define TOOLRESULTCOMPACTOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+/**
+ * @brief 工具结果压缩器
+ *
+ * 按工具输出的结构压缩结果，替代固定长度截断:
+ *   - grep_search:     按文件分组，合并同一文件中内容相同的匹配行
+ *   - execute_command: 保留标准输出/错误输出的头部和尾部，折叠连续重复行
+ *   - list_directory / find_by_name: 条目过多时按目录汇总数量
+ *   - view_file / read_file_lines:   去掉元信息头，长文件保留首尾并标注省略的行号
+ *
+ * 每个函数的签名与 ToolEntry::compact 一致，在 ToolDispatcher 注册工具时一并登记。
+ * input 是分发时校验修复后的参数: 文件内容用 file_path 标注来源，grep 用 pattern 代替
+ * 含绝对路径的头部，目录汇总用 directory_path / pattern 说明范围；命令输出不依赖参数。
+ */
+class ToolResultCompactor {
+public:
+    // 单个工具结果发送给 LLM 的默认 token 预算
+    static constexpr int DEFAULT_TOKEN_BUDGET = 1000;
+
+    // ==================== 按工具类型压缩 ====================
+
+    static QString compactGrep(const QString& rawResult, const QJsonObject& input);
+    static QString compactShell(const QString& rawResult, const QJsonObject& input);
+    static QString compactListing(const QString& rawResult, const QJsonObject& input);
+    static QString compactFileView(const QString& rawResult, const QJsonObject& input);
+
+    // ==================== 通用辅助 ====================
+
+    /**
+     * @brief 保留头部和尾部的行，使结果不超过 token 预算
+     * @param text 原始文本
+     * @param maxTokens token 预算
+     * @param firstLineNumber 首行的行号（>0 时在省略提示中给出行号范围）
+     */
+    static QString keepHeadAndTail(const QString& text, int maxTokens, int firstLineNumber = 0);
+
+    /**
+     * @brief 折叠连续重复的行
+     */
+    static QStringList collapseRepeatedLines(const QStringList& lines);
+};
+
+#endif // TOOLRESULTCOMPACTOR_H
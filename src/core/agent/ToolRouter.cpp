@@ -0,0 +1,119 @@
+#include "ToolRouter.h"
+#include "core/tools/FileTool.h"
+#include "core/tools/ShellTool.h"
+#include "core/tools/CodeParserTool.h"
+#include "SubAgentDelegator.h"
+
+namespace {
+
+// 英文关键词加词首边界（"test" 不匹配 "latest"），中文关键词直接匹配
+// NOTE: 不开启 UseUnicodePropertiesOption，\b 只把 ASCII 字母数字视为单词字符，"帮我fix一下" 也能匹配
+QRegularExpression compileKeywords(const QStringList& keywords) {
+    QStringList alternatives;
+    for (const QString& keyword : keywords) {
+        bool ascii = true;
+        for (const QChar ch : keyword) {
+            if (ch.unicode() > 0x7f) {
+                ascii = false;
+                break;
+            }
+        }
+        alternatives << (ascii ? "\\b" : "") + QRegularExpression::escape(keyword);
+    }
+    return QRegularExpression(alternatives.join('|'), QRegularExpression::CaseInsensitiveOption);
+}
+
+} // namespace
+
+ToolRouter::ToolRouter() {
+    setGroups(defaultGroups());
+}
+
+QVector<ToolRouter::Group> ToolRouter::defaultGroups() {
+    return {
+        {"explore",
+         {FileTool::VIEW_FILE, FileTool::READ_FILE_LINES, FileTool::LIST_DIRECTORY,
+          FileTool::GREP_SEARCH, FileTool::FIND_BY_NAME},
+         {}},
+        {"edit",
+         {FileTool::CREATE_FILE, FileTool::REPLACE_IN_FILE, FileTool::MULTI_REPLACE_IN_FILE,
+          FileTool::INSERT_CONTENT, FileTool::DELETE_FILE},
+         {"修改", "改成", "改为", "修复", "实现", "添加", "新增", "增加", "删除", "移除", "重构", "重命名",
+          "创建", "新建", "编写", "写一个", "替换", "插入", "更新", "生成",
+          "fix", "implement", "add", "remove", "delete", "refactor", "rename", "create", "write",
+          "update", "replace", "insert", "edit", "change", "modify", "generate"}},
+        {"shell",
+         {ShellTool::EXECUTE_COMMAND},
+         {"运行", "执行", "编译", "构建", "测试", "命令", "安装", "提交", "脚本", "终端",
+          "run", "execute", "build", "compile", "test", "cmake", "qmake", "make", "git", "npm", "pip",
+          "install", "shell", "command", "script", "commit"}},
+        {"code",
+         {CodeParserTool::VIEW_FILE_OUTLINE, CodeParserTool::VIEW_CODE_ITEM},
+         {"函数", "类", "方法", "结构体", "接口", "大纲", "定义", "调用", "实现", "代码结构",
+          "function", "class", "method", "struct", "symbol", "outline", "definition", "implement"}},
+        {"delegate",
+         {SubAgentDelegator::DELEGATE_TASK},
+         {"并行", "子任务", "分别", "委派", "逐个", "各个模块", "parallel", "delegate", "subtask"}}
+    };
+}
+
+void ToolRouter::setGroups(const QVector<Group>& groups) {
+    m_groups.clear();
+    m_grouped.clear();
+    for (const Group& group : groups) {
+        CompiledGroup compiled;
+        compiled.group = group;
+        if (!group.keywords.isEmpty()) {
+            compiled.pattern = compileKeywords(group.keywords);
+        }
+        m_groups.append(compiled);
+        for (const QString& tool : group.tools) {
+            m_grouped.insert(tool);
+        }
+    }
+}
+
+QStringList ToolRouter::matchedGroups(const QString& text) const {
+    QStringList matched;
+    for (const CompiledGroup& compiled : m_groups) {
+        if (!compiled.group.keywords.isEmpty() && compiled.pattern.match(text).hasMatch()) {
+            matched << compiled.group.name;
+        }
+    }
+    return matched;
+}
+
+QList<Tool> ToolRouter::select(const QList<Tool>& candidates, const QString& text) {
+    const QStringList matched = matchedGroups(text);
+    for (const CompiledGroup& compiled : m_groups) {
+        // NOTE: 没有命中任何关键词时任务类型不明，宁可多发工具定义，也不要让模型缺少需要的工具而白跑一轮
+        if (compiled.group.keywords.isEmpty() || matched.isEmpty() || matched.contains(compiled.group.name)) {
+            for (const QString& tool : compiled.group.tools) {
+                m_active.insert(tool);
+            }
+        }
+    }
+    return filter(candidates);
+}
+
+QList<Tool> ToolRouter::filter(const QList<Tool>& candidates) const {
+    QList<Tool> selected;
+    for (const Tool& tool : candidates) {
+        if (!m_grouped.contains(tool.name) || m_active.contains(tool.name)) {
+            selected.append(tool);
+        }
+    }
+    return selected;
+}
+
+bool ToolRouter::recordUse(const QString& toolName) {
+    if (m_active.contains(toolName)) {
+        return false;
+    }
+    m_active.insert(toolName);
+    return m_grouped.contains(toolName);  // 未分组的工具本来就一直提供
+}
+
+void ToolRouter::reset() {
+    m_active.clear();
+}
@@ -0,0 +1,90 @@
+#ifndef TOOLROUTER_H
+#define TOOLROUTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QVector>
+#include <QRegularExpression>
+#include "ToolTypes.h"
+
+/**
+ * @brief 工具路由：按任务类型为每轮请求挑选相关的工具子集
+ *
+ * 每个工具定义（含较长的中文描述）都会随每次请求发送，工具越多请求体越大、首 token 越慢。
+ * 路由在 Agent 的工具白名单（LLMConfig::allowedTools）之上再做一次筛选:
+ *
+ *   - 基础组（浏览与搜索）总是提供
+ *   - 其余分组（编辑、命令、代码结构、子任务）在用户消息命中该组关键词时提供
+ *   - 未归入任何分组的工具总是提供（新增工具默认不会被漏掉）
+ *   - 没有命中任何关键词时无法判断任务类型，提供全部工具
+ *
+ * 同一会话内已选过的工具保留（只增不减）：工具定义位于请求前缀中，频繁增删会让服务端前缀缓存失效；
+ * 输出的子集保持候选列表中的顺序，前缀字节只在集合扩大时变化。
+ *
+ * 使用方式:
+ *   ToolRouter router;
+ *   builder.setTools(router.select(allowedTools, userPrompt));
+ *   ...
+ *   router.reset();  // 清空历史时
+ */
+class ToolRouter {
+public:
+    struct Group {
+        QString name;
+        QStringList tools;
+        QStringList keywords;  // 为空表示总是提供；英文关键词按词首匹配，不区分大小写
+    };
+
+    ToolRouter();
+
+    /**
+     * @brief 默认分组（对应 tools.yaml 中的文件、命令、代码解析与子 Agent 工具）
+     */
+    static QVector<Group> defaultGroups();
+    void setGroups(const QVector<Group>& groups);
+
+    /**
+     * @brief 选出本轮提供的工具
+     * @param candidates 当前 Agent 允许使用的全部工具
+     * @param text 本轮的用户消息（任务描述）
+     * @return candidates 的子集，保持原顺序
+     */
+    QList<Tool> select(const QList<Tool>& candidates, const QString& text);
+
+    /**
+     * @brief 按已选工具筛选，不根据任务描述扩充（工具定义重新加载时使用）
+     */
+    QList<Tool> filter(const QList<Tool>& candidates) const;
+
+    /**
+     * @brief 记录模型调用过的工具（即使不在当前子集中，之后也一直提供）
+     * @return 该工具此前不在已选工具中时为 true（需要刷新请求中的工具列表）
+     */
+    bool recordUse(const QString& toolName);
+
+    /**
+     * @brief 新会话开始时清空已选工具
+     */
+    void reset();
+
+    const QSet<QString>& activeTools() const { return m_active; }
+
+    /**
+     * @brief 任务描述命中的分组名（调试与测试用）
+     */
+    QStringList matchedGroups(const QString& text) const;
+
+private:
+    struct CompiledGroup {
+        Group group;
+        QRegularExpression pattern;  // keywords 为空时无效
+    };
+
+    QVector<CompiledGroup> m_groups;
+    QSet<QString> m_grouped;  // 归入某个分组的工具
+    QSet<QString> m_active;   // 本会话已选的工具
+};
+
+#endif // TOOLROUTER_H
@@ -2,6 +2,7 @@
 #define TOOLTYPES_H
 
 #include <QString>
+#include <QStringList>
 #include <QJsonObject>
 #include <QJsonDocument>
 
@@ -17,6 +18,7 @@ struct Tool {
     QString name;           // 工具名称
     QString description;    // 工具描述
     QJsonObject inputSchema; // 输入参数 JSON Schema
+    QByteArray serialized;  // toJson() 的紧凑 JSON（ToolSchemaLoader 从缓存填入；修改上面的字段后需清空）
     
     // 转换为 DeepSeek API 格式 (OpenAI 兼容)
     QJsonObject toJson() const {
@@ -30,6 +32,11 @@ struct Tool {
         obj["function"] = functionObj;
         return obj;
     }
+    
+    // 请求体中的工具定义字节，已预序列化时原样复用
+    QByteArray toJsonBytes() const {
+        return serialized.isEmpty() ? QJsonDocument(toJson()).toJson(QJsonDocument::Compact) : serialized;
+    }
 };
 
 
@@ -38,6 +45,7 @@ struct ToolCall {
     QString id;             // 工具调用 ID
     QString name;           // 工具名称
     QJsonObject input;      // 输入参数
+    QString rawArguments;   // arguments 原文（仅在不是合法 JSON 对象时保留，分发前由校验器尝试修复）
     
     /**
      * @brief 从 DeepSeek API 格式的 JSON 解析 ToolCall
@@ -54,8 +62,12 @@ struct ToolCall {
         
         // arguments 是 JSON 字符串，需要解析
         QString argsStr = functionObj["arguments"].toString();
-        QJsonDocument argsDoc = QJsonDocument::fromJson(argsStr.toUtf8());
+        QJsonParseError error;
+        QJsonDocument argsDoc = QJsonDocument::fromJson(argsStr.toUtf8(), &error);
         call.input = argsDoc.object();
+        if (error.error != QJsonParseError::NoError || !argsDoc.isObject()) {
+            call.rawArguments = argsStr;  // 不再静默当作空参数执行
+        }
         
         return call;
     }
@@ -88,6 +100,33 @@ struct ToolExecutionEvent {
         , data(call.input)
     {}
     
+    /**
+     * @brief 转换为 JSON（经事件总线传递时使用）
+     */
+    QJsonObject toJson() const {
+        QJsonObject obj;
+        obj["toolName"] = toolName;
+        obj["toolId"] = toolId;
+        obj["status"] = status;
+        obj["success"] = success;
+        obj["data"] = data;
+        obj["rawResult"] = rawResult;
+        obj["formattedResult"] = formattedResult;
+        return obj;
+    }
+    
+    static ToolExecutionEvent fromJson(const QJsonObject& json) {
+        ToolExecutionEvent event;
+        event.toolName = json["toolName"].toString();
+        event.toolId = json["toolId"].toString();
+        event.status = json["status"].toString();
+        event.success = json["success"].toBool(true);
+        event.data = json["data"].toObject();
+        event.rawResult = json["rawResult"].toString();
+        event.formattedResult = json["formattedResult"].toString();
+        return event;
+    }
+    
     /**
      * @brief 根据当前状态生成用户友好消息
      */
@@ -134,11 +173,56 @@ struct LLMConfig {
     QString systemPrompt = "你是一个专业的 AI 助手。";
     double temperature = 0.7;
     int maxTokens = 4096;
-    int timeoutMs = 180000;  // 3分钟超时
+    int contextWindowTokens = 65536;  // 模型上下文窗口 (token)，请求需为 maxTokens 预留回复空间
+    int idleTimeoutMs = 60000;  // 空闲超时：连续这么久没有收到任何字节即判定连接卡住（流式回复本身不限总时长）
+    int maxRetries = 3;         // 429 / 5xx / 连接中断 / 空闲超时后的最大重试次数
+    
+    // === 工具权限 ===
+    QStringList allowedTools;  // 可用的工具名（为空表示全部），见设计文档 7.2 tool allowlist
+    bool toolRouting = true;   // 在允许的工具中按任务类型只发送相关的工具定义（见 ToolRouter）
     
     // === 辅助方法 ===
     bool isValid() const { return !apiKey.isEmpty(); }
     bool canDelegate() const { return agentLevel < MaxLevel; }  // 是否可调用子 Agent
+    bool isToolAllowed(const QString& toolName) const {
+        return allowedTools.isEmpty() || allowedTools.contains(toolName);
+    }
+};
+
+// Token 用量结构体（来自流式响应最后一个 chunk 的 usage 字段）
+struct TokenUsage {
+    int promptTokens = 0;        // 输入 token
+    int completionTokens = 0;    // 输出 token
+    int cachedPromptTokens = 0;  // 输入中命中服务端前缀缓存的部分
+
+    /**
+     * @brief 从 usage JSON 解析
+     * @note DeepSeek 使用 prompt_cache_hit_tokens，
+     *       OpenAI 兼容服务使用 prompt_tokens_details.cached_tokens
+     */
+    static TokenUsage fromJson(const QJsonObject& json) {
+        TokenUsage usage;
+        usage.promptTokens = json["prompt_tokens"].toInt();
+        usage.completionTokens = json["completion_tokens"].toInt();
+        if (json.contains("prompt_cache_hit_tokens")) {
+            usage.cachedPromptTokens = json["prompt_cache_hit_tokens"].toInt();
+        } else {
+            usage.cachedPromptTokens = json["prompt_tokens_details"].toObject()["cached_tokens"].toInt();
+        }
+        return usage;
+    }
+
+    TokenUsage& operator+=(const TokenUsage& other) {
+        promptTokens += other.promptTokens;
+        completionTokens += other.completionTokens;
+        cachedPromptTokens += other.cachedPromptTokens;
+        return *this;
+    }
+
+    // 前缀缓存命中率 (0.0 ~ 1.0)
+    double cacheHitRate() const {
+        return promptTokens > 0 ? double(cachedPromptTokens) / promptTokens : 0.0;
+    }
 };
 
 #endif // TOOLTYPES_H
@@ -0,0 +1,67 @@
+# 核心模块（Agent / 编排 / 工具 / 解析器），GUI 与 CLI 目标共用
+# 不依赖 widgets，CLI 目标可以只链接 QtCore + QtNetwork
+
+QT += network
+
+SOURCES += \
+    $$PWD/agent/LLMAgent.cpp \
+    $$PWD/agent/ContextManager.cpp \
+    $$PWD/agent/RequestBuilder.cpp \
+    $$PWD/agent/SubAgentDelegator.cpp \
+    $$PWD/agent/ToolCallAssembler.cpp \
+    $$PWD/agent/ToolResultCompactor.cpp \
+    $$PWD/agent/ToolDispatcher.cpp \
+    $$PWD/agent/ToolArgumentValidator.cpp \
+    $$PWD/agent/ToolResultCache.cpp \
+    $$PWD/agent/ToolRouter.cpp \
+    $$PWD/agent/SessionJournal.cpp \
+    $$PWD/events/EventBus.cpp \
+    $$PWD/log/LogCategories.cpp \
+    $$PWD/log/Logger.cpp \
+    $$PWD/metrics/MetricsRegistry.cpp \
+    $$PWD/net/LLMTransport.cpp \
+    $$PWD/net/RateLimiter.cpp \
+    $$PWD/net/SessionRecorder.cpp \
+    $$PWD/orchestrator/BatchRunner.cpp \
+    $$PWD/orchestrator/BatchTypes.cpp \
+    $$PWD/orchestrator/Orchestrator.cpp \
+    $$PWD/orchestrator/TaskLockTable.cpp \
+    $$PWD/orchestrator/TaskScheduler.cpp \
+    $$PWD/trace/Tracer.cpp \
+    $$PWD/utils/AppSettings.cpp \
+    $$PWD/utils/ToolSchemaLoader.cpp \
+    $$PWD/utils/Tokenizer.cpp \
+    $$PWD/parser/TreeSitterParser.cpp
+
+HEADERS += \
+    $$PWD/agent/LLMAgent.h \
+    $$PWD/agent/ContextManager.h \
+    $$PWD/agent/RequestBuilder.h \
+    $$PWD/agent/SubAgentDelegator.h \
+    $$PWD/agent/ToolCallAssembler.h \
+    $$PWD/agent/ToolResultCompactor.h \
+    $$PWD/agent/ToolDispatcher.h \
+    $$PWD/agent/ToolArgumentValidator.h \
+    $$PWD/agent/ToolResultCache.h \
+    $$PWD/agent/ToolRouter.h \
+    $$PWD/agent/SessionJournal.h \
+    $$PWD/events/AgentEvent.h \
+    $$PWD/events/EventBus.h \
+    $$PWD/events/MpscQueue.h \
+    $$PWD/log/LogCategories.h \
+    $$PWD/log/Logger.h \
+    $$PWD/metrics/MetricsRegistry.h \
+    $$PWD/net/LLMTransport.h \
+    $$PWD/net/RateLimiter.h \
+    $$PWD/net/SessionRecorder.h \
+    $$PWD/orchestrator/BatchRunner.h \
+    $$PWD/orchestrator/BatchTypes.h \
+    $$PWD/orchestrator/Orchestrator.h \
+    $$PWD/orchestrator/TaskLockTable.h \
+    $$PWD/orchestrator/TaskScheduler.h \
+    $$PWD/orchestrator/TaskTypes.h \
+    $$PWD/trace/Tracer.h \
+    $$PWD/utils/AppSettings.h \
+    $$PWD/utils/ToolSchemaLoader.h \
+    $$PWD/utils/Tokenizer.h \
+    $$PWD/parser/TreeSitterParser.h
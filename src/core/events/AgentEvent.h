@@ -0,0 +1,138 @@
+#ifndef AGENTEVENT_H
+#define AGENTEVENT_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QDateTime>
+
+/**
+ * @brief 事件总线上传递的事件（设计文档 4.3 可观测事件）
+ *
+ * 所有字段都是隐式共享的 Qt 值类型，可安全地跨线程复制。
+ */
+
+// 事件类别
+enum class EventKind {
+    Log = 0x1,       // log(channel, message)
+    Progress = 0x2,  // progress(stage, value)
+    Metric = 0x4,    // metric(key, value)
+    Finished = 0x8   // finished(result)
+};
+
+// 常用的 log 通道
+namespace EventChannel {
+    static constexpr const char* AGENT = "agent";    // Agent 自身的运行日志
+    static constexpr const char* STREAM = "stream";  // LLM 流式输出片段
+    static constexpr const char* TOOL = "tool";      // 工具执行事件（data 为 ToolExecutionEvent）
+    static constexpr const char* FAILURE = "error";  // 错误信息（避免与 Windows 的 ERROR 宏冲突）
+    static constexpr const char* TASK = "task";      // Orchestrator 任务（finished 的 data 为 TaskResult）
+    static constexpr const char* BATCH = "batch";    // 批量任务（log 的 data 为单个条目的结果记录）
+    static constexpr const char* RETRY = "retry";    // 请求失败后的自动重试（data 含 status、attempt、delayMs）
+}
+
+inline QString eventKindName(EventKind kind) {
+    switch (kind) {
+    case EventKind::Log:      return "log";
+    case EventKind::Progress: return "progress";
+    case EventKind::Metric:   return "metric";
+    case EventKind::Finished: return "finished";
+    }
+    return "unknown";
+}
+
+struct AgentEvent {
+    EventKind kind = EventKind::Log;
+    QString source;       // 事件来源（agentId / taskId）
+    QString channel;      // log 的通道 / progress 的阶段 / metric 的 key
+    QString message;      // 文本内容
+    double value = 0.0;   // progress 或 metric 的数值
+    bool delta = false;   // metric 的 value 是增量（如单次请求的 token 数），而不是当前值
+    QJsonObject data;     // 结构化附加数据
+    qint64 timestampMs = QDateTime::currentMSecsSinceEpoch();
+
+    static AgentEvent log(const QString& source, const QString& channel, const QString& message,
+                          const QJsonObject& data = QJsonObject()) {
+        AgentEvent event;
+        event.kind = EventKind::Log;
+        event.source = source;
+        event.channel = channel;
+        event.message = message;
+        event.data = data;
+        return event;
+    }
+
+    static AgentEvent progress(const QString& source, const QString& stage, double value) {
+        AgentEvent event;
+        event.kind = EventKind::Progress;
+        event.source = source;
+        event.channel = stage;
+        event.value = value;
+        return event;
+    }
+
+    static AgentEvent metric(const QString& source, const QString& key, double value) {
+        AgentEvent event;
+        event.kind = EventKind::Metric;
+        event.source = source;
+        event.channel = key;
+        event.value = value;
+        return event;
+    }
+
+    // 增量指标：订阅方需要累加，合并时求和而不是只保留最新值
+    static AgentEvent metricDelta(const QString& source, const QString& key, double value) {
+        AgentEvent event = metric(source, key, value);
+        event.delta = true;
+        return event;
+    }
+
+    static AgentEvent finished(const QString& source, const QString& channel, const QString& message,
+                               const QJsonObject& result = QJsonObject()) {
+        AgentEvent event;
+        event.kind = EventKind::Finished;
+        event.source = source;
+        event.channel = channel;
+        event.message = message;
+        event.data = result;
+        return event;
+    }
+
+    /**
+     * @brief 转换为 JSON（CLI 的 JSON Lines 输出），空字段省略
+     */
+    QJsonObject toJson() const {
+        QJsonObject obj;
+        obj["ts"] = timestampMs;
+        obj["kind"] = eventKindName(kind);
+        obj["source"] = source;
+        obj["channel"] = channel;
+        if (!message.isEmpty()) {
+            obj["message"] = message;
+        }
+        if (kind == EventKind::Progress || kind == EventKind::Metric) {
+            obj["value"] = value;
+        }
+        if (delta) {
+            obj["delta"] = true;
+        }
+        if (!data.isEmpty()) {
+            obj["data"] = data;
+        }
+        return obj;
+    }
+
+    bool isStreamLog() const {
+        return kind == EventKind::Log && channel == EventChannel::STREAM;
+    }
+
+    // progress/metric 只关心最新值，可以按 (类别, 来源, key) 合并
+    bool isLatestValue() const {
+        return kind == EventKind::Progress || (kind == EventKind::Metric && !delta);
+    }
+
+    bool isDeltaMetric() const {
+        return kind == EventKind::Metric && delta;
+    }
+};
+
+#endif // AGENTEVENT_H
@@ -0,0 +1,200 @@
+#include "EventBus.h"
+#include <QHash>
+
+// 单次唤醒最多处理的事件数，生产者持续发布时把剩余部分留给下一轮，避免饿死接收线程
+static constexpr int kMaxBatch = 4096;
+
+struct EventBus::Subscriber {
+    int id = 0;
+    Options options;
+    Handler handler;
+    QObject* drainer = nullptr;  // 位于 receiver 线程，用于投递批处理
+    MpscQueue<AgentEvent> queue;
+    std::atomic<bool> drainScheduled{false};
+    std::atomic<bool> active{true};
+    std::atomic<quint64> delivered{0};
+    std::atomic<quint64> dropped{0};
+    std::atomic<quint64> coalesced{0};
+
+    ~Subscriber() {
+        // NOTE: 最后一个持有者可能在任意线程释放，交给 drainer 所在线程删除
+        drainer->deleteLater();
+    }
+
+    bool accepts(const AgentEvent& event) const {
+        return (options.kinds & static_cast<int>(event.kind))
+            && (options.source.isEmpty() || options.source == event.source);
+    }
+};
+
+EventBus::EventBus(QObject *parent)
+    : QObject(parent)
+    , m_subscribers(std::make_shared<const SubscriberList>())
+{
+}
+
+EventBus::~EventBus() = default;
+
+EventBus& EventBus::instance() {
+    static EventBus bus;
+    return bus;
+}
+
+// ==================== 订阅管理 ====================
+
+int EventBus::subscribe(QObject* receiver, Handler handler, const Options& options) {
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->options = options;
+    subscriber->handler = std::move(handler);
+    subscriber->drainer = new QObject;
+    subscriber->drainer->moveToThread(receiver->thread());
+
+    QMutexLocker locker(&m_writeMutex);
+    subscriber->id = m_nextId++;
+
+    auto next = std::make_shared<SubscriberList>(*std::atomic_load(&m_subscribers));
+    next->append(subscriber);
+    std::atomic_store(&m_subscribers, std::shared_ptr<const SubscriberList>(next));
+
+    const int id = subscriber->id;
+    connect(receiver, &QObject::destroyed, this, [this, id]() {
+        unsubscribe(id);
+    }, Qt::DirectConnection);
+    return id;
+}
+
+void EventBus::unsubscribe(int subscriptionId) {
+    QMutexLocker locker(&m_writeMutex);
+    auto next = std::make_shared<SubscriberList>(*std::atomic_load(&m_subscribers));
+    for (int i = 0; i < next->size(); ++i) {
+        if (next->at(i)->id == subscriptionId) {
+            // 已排队的批处理不再调用 handler
+            next->at(i)->active.store(false);
+            next->removeAt(i);
+            std::atomic_store(&m_subscribers, std::shared_ptr<const SubscriberList>(next));
+            return;
+        }
+    }
+}
+
+EventBus::Stats EventBus::stats(int subscriptionId) const {
+    Stats stats;
+    for (const auto& subscriber : *std::atomic_load(&m_subscribers)) {
+        if (subscriber->id == subscriptionId) {
+            stats.delivered = subscriber->delivered.load(std::memory_order_relaxed);
+            stats.dropped = subscriber->dropped.load(std::memory_order_relaxed);
+            stats.coalesced = subscriber->coalesced.load(std::memory_order_relaxed);
+            break;
+        }
+    }
+    return stats;
+}
+
+int EventBus::subscriberCount() const {
+    return std::atomic_load(&m_subscribers)->size();
+}
+
+// ==================== 发布与投递 ====================
+
+void EventBus::publish(const AgentEvent& event) {
+    const std::shared_ptr<const SubscriberList> subscribers = std::atomic_load(&m_subscribers);
+    for (const auto& subscriber : *subscribers) {
+        if (!subscriber->accepts(event)) {
+            continue;
+        }
+
+        // finished 是任务的最终结果，任何策略下都不丢弃
+        if (subscriber->options.overflow == Overflow::Drop
+            && event.kind != EventKind::Finished
+            && subscriber->queue.size() >= static_cast<std::size_t>(subscriber->options.capacity)) {
+            subscriber->dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        subscriber->queue.push(event);
+        scheduleDrain(subscriber);
+    }
+}
+
+void EventBus::scheduleDrain(const std::shared_ptr<Subscriber>& subscriber) {
+    // NOTE: 已有待处理的唤醒时不再重复投递，一批事件只唤醒接收线程一次
+    if (subscriber->drainScheduled.exchange(true)) {
+        return;
+    }
+    std::weak_ptr<Subscriber> weak = subscriber;
+    QMetaObject::invokeMethod(subscriber->drainer, [weak]() {
+        if (auto locked = weak.lock()) {
+            drain(locked);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void EventBus::drain(const std::shared_ptr<Subscriber>& subscriber) {
+    // NOTE: 先清除标记再出队，出队期间完成入队的生产者会重新唤醒
+    subscriber->drainScheduled.store(false);
+
+    QVector<AgentEvent> batch;
+    AgentEvent event;
+    while (batch.size() < kMaxBatch && subscriber->queue.pop(event)) {
+        batch.append(std::move(event));
+    }
+    if (batch.size() == kMaxBatch) {
+        scheduleDrain(subscriber);
+    }
+    if (batch.isEmpty() || !subscriber->active.load()) {
+        return;
+    }
+
+    if (subscriber->options.overflow == Overflow::Coalesce) {
+        const int before = batch.size();
+        batch = coalesce(batch);
+        subscriber->coalesced.fetch_add(before - batch.size(), std::memory_order_relaxed);
+    }
+    subscriber->delivered.fetch_add(batch.size(), std::memory_order_relaxed);
+    subscriber->handler(batch);
+}
+
+QVector<AgentEvent> EventBus::coalesce(const QVector<AgentEvent>& batch) {
+    QVector<AgentEvent> merged;
+    merged.reserve(batch.size());
+    QHash<QString, int> latestIndex;  // (类别, 来源, key) -> merged 中的位置
+    QHash<QString, int> deltaIndex;   // (来源, key) -> merged 中的位置
+
+    for (const AgentEvent& event : batch) {
+        // 增量指标丢弃任何一条都会让订阅方的累计值偏小，同一批内求和
+        if (event.isDeltaMetric()) {
+            const QString key = event.source + '|' + event.channel;
+            auto it = deltaIndex.constFind(key);
+            if (it != deltaIndex.constEnd()) {
+                AgentEvent& sum = merged[it.value()];
+                sum.value += event.value;
+                sum.timestampMs = event.timestampMs;
+            } else {
+                deltaIndex.insert(key, merged.size());
+                merged.append(event);
+            }
+            continue;
+        }
+
+        if (event.isLatestValue()) {
+            const QString key = QString("%1|%2|%3").arg(static_cast<int>(event.kind)).arg(event.source, event.channel);
+            auto it = latestIndex.constFind(key);
+            if (it != latestIndex.constEnd()) {
+                merged[it.value()] = event;  // 只保留最新值
+            } else {
+                latestIndex.insert(key, merged.size());
+                merged.append(event);
+            }
+            continue;
+        }
+
+        // 相邻的同源流式片段拼接为一条，UI 每批只刷新一次
+        if (event.isStreamLog() && !merged.isEmpty()
+            && merged.last().isStreamLog() && merged.last().source == event.source) {
+            merged.last().message += event.message;
+            continue;
+        }
+        merged.append(event);
+    }
+    return merged;
+}
@@ -0,0 +1,84 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "AgentEvent.h"
+#include "MpscQueue.h"
+
+/**
+ * @brief 进程内事件总线（设计文档 8.3）
+ *
+ * 聚合所有 Agent / 工具 / 任务的 log、progress、metric、finished 事件。
+ *
+ * - 每个订阅者一条无锁 MPSC 队列，publish 不加锁、不等待订阅者，
+ *   多个 Agent 并发流式输出时，慢速的 UI 或日志不会拖慢工具执行与网络读取
+ * - 订阅者在自己（receiver）的线程中批量接收事件，每批只唤醒一次
+ * - 慢速订阅者可以选择丢弃（Drop）或合并（Coalesce）事件
+ */
+class EventBus : public QObject {
+    Q_OBJECT
+public:
+    // 订阅者处理不过来时的策略
+    enum class Overflow {
+        Drop,     // 队列超过容量时丢弃新事件（finished 除外）
+        Coalesce  // 不丢弃；投递前合并相邻的同源 stream 日志，progress/metric 只保留最新值，增量 metric 求和
+    };
+
+    struct Options {
+        int kinds = 0xF;                   // 订阅的 EventKind 组合（按位或）
+        QString source;                    // 只接收该来源的事件（为空表示全部）
+        Overflow overflow = Overflow::Drop;
+        int capacity = 1024;               // Drop 模式下的队列容量
+    };
+
+    struct Stats {
+        quint64 delivered = 0;  // 已投递给处理函数的事件
+        quint64 dropped = 0;    // 因队列满被丢弃的事件
+        quint64 coalesced = 0;  // 被合并掉的事件
+    };
+
+    using Handler = std::function<void(const QVector<AgentEvent>&)>;
+
+    explicit EventBus(QObject *parent = nullptr);
+    ~EventBus() override;
+
+    // 全局总线（Agent、Orchestrator 默认发布到这里）
+    static EventBus& instance();
+
+    /**
+     * @brief 订阅事件
+     * @param receiver 处理函数在 receiver 所在线程中执行；receiver 销毁时自动退订
+     * @param handler 批量处理函数（同一批事件保持发布顺序）
+     * @return 订阅 ID
+     */
+    int subscribe(QObject* receiver, Handler handler, const Options& options = Options());
+    void unsubscribe(int subscriptionId);
+
+    /**
+     * @brief 发布事件（任意线程，无锁）
+     */
+    void publish(const AgentEvent& event);
+
+    Stats stats(int subscriptionId) const;
+    int subscriberCount() const;
+
+private:
+    struct Subscriber;
+    using SubscriberList = QVector<std::shared_ptr<Subscriber>>;
+
+    static void drain(const std::shared_ptr<Subscriber>& subscriber);
+    static void scheduleDrain(const std::shared_ptr<Subscriber>& subscriber);
+    static QVector<AgentEvent> coalesce(const QVector<AgentEvent>& batch);
+
+    // NOTE: 订阅者列表写时复制，publish 只做一次原子读取
+    std::shared_ptr<const SubscriberList> m_subscribers;
+    QMutex m_writeMutex;  // 只串行化 subscribe/unsubscribe
+    int m_nextId = 1;
+};
+
+#endif // EVENTBUS_H
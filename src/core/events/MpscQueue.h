@@ -0,0 +1,72 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief 无锁多生产者单消费者队列（Vyukov 节点队列）
+ *
+ * - push 可在任意线程并发调用，只有一次原子交换，不会阻塞
+ * - pop 只能由唯一的消费者线程调用
+ *
+ * NOTE: 生产者在交换 head 与链接 next 之间被抢占时，其后入队的元素对消费者暂时不可见，
+ *       pop 会返回 false；该生产者完成链接后元素即可见（调用方需在 push 之后再唤醒消费者）。
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : m_head(new Node), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {}
+        delete m_tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // 入队（多生产者）
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // 出队（单消费者），队列为空时返回 false
+    bool pop(T& out) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        out = std::move(next->value);
+        m_tail = next;  // next 成为新的哨兵节点
+        delete tail;
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 近似长度（仅用于容量判断与统计）
+    std::size_t size() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value;
+
+        Node() = default;
+        explicit Node(T v) : value(std::move(v)) {}
+    };
+
+    std::atomic<Node*> m_head;        // 生产者端（最近入队的节点）
+    Node* m_tail;                     // 消费者端（哨兵节点）
+    std::atomic<std::size_t> m_size{0};
+};
+
+#endif // MPSCQUEUE_H
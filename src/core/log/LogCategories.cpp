@@ -0,0 +1,9 @@
+#include "LogCategories.h"
+
+// NOTE: debug 级别默认关闭（QtInfoMsg 起），请求体转储默认完全关闭
+Q_LOGGING_CATEGORY(lcAgent, "tmagent.agent", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcRequest, "tmagent.request", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcTool, "tmagent.tool", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcOrchestrator, "tmagent.orchestrator", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcConfig, "tmagent.config", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcUi, "tmagent.ui", QtInfoMsg)
@@ -0,0 +1,20 @@
+#ifndef LOGCATEGORIES_H
+#define LOGCATEGORIES_H
+
+#include <QLoggingCategory>
+
+/**
+ * @brief 日志分类
+ *
+ * 热路径上的日志统一用 qCDebug / qCInfo / qCWarning(分类) 输出：分类关闭时宏只做一次判断，
+ * 不会构造 QDebug、也不会格式化参数。默认只开启 info 及以上，调试时用 TMAGENT_LOG_LEVEL=debug
+ * 或 QT_LOGGING_RULES="tmagent.tool.debug=true" 单独打开某个分类。
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcAgent)         // tmagent.agent        Agent 请求、重试、续传
+Q_DECLARE_LOGGING_CATEGORY(lcRequest)       // tmagent.request      请求体转储（默认关闭，按采样输出）
+Q_DECLARE_LOGGING_CATEGORY(lcTool)          // tmagent.tool         工具分发与执行
+Q_DECLARE_LOGGING_CATEGORY(lcOrchestrator)  // tmagent.orchestrator 编排、调度、批量任务
+Q_DECLARE_LOGGING_CATEGORY(lcConfig)        // tmagent.config       工具定义、词表等配置加载
+Q_DECLARE_LOGGING_CATEGORY(lcUi)            // tmagent.ui           界面
+
+#endif // LOGCATEGORIES_H
@@ -0,0 +1,346 @@
+#include "Logger.h"
+#include "core/events/MpscQueue.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+struct LogRecord {
+    qint64 timeMs = 0;
+    QtMsgType type = QtDebugMsg;
+    QByteArray category;
+    quintptr threadId = 0;
+    QString message;
+};
+
+struct LogSink {
+    MpscQueue<LogRecord> queue;
+    QMutex wakeMutex;
+    QWaitCondition wake;
+    std::atomic<bool> running{false};
+    std::atomic<quint64> pendingDropped{0};  // 尚未写出提示的丢弃条数
+    std::atomic<quint64> totalDropped{0};
+    std::atomic<int> payloadSampleEvery{10};
+    std::atomic<quint64> payloadCounter{0};
+
+    Logger::Options options;
+    QFile file;
+    qint64 fileBytes = 0;  // QFile::size() 会先 flush 缓冲区，自己累计
+    QThread* thread = nullptr;
+
+    QMutex secretsMutex;
+    QStringList secrets;
+};
+
+LogSink& sink() {
+    // NOTE: 故意不析构，静态对象析构或其他线程退出时仍可能输出日志
+    static LogSink* s = new LogSink();
+    return *s;
+}
+
+// QtMsgType 的枚举值不按严重程度排列（QtInfoMsg 最大）
+int severity(QtMsgType type) {
+    switch (type) {
+        case QtDebugMsg:    return 0;
+        case QtInfoMsg:     return 1;
+        case QtWarningMsg:  return 2;
+        case QtCriticalMsg: return 3;
+        case QtFatalMsg:    return 4;
+    }
+    return 0;
+}
+
+const char* levelName(QtMsgType type) {
+    switch (type) {
+        case QtDebugMsg:    return "debug";
+        case QtInfoMsg:     return "info";
+        case QtWarningMsg:  return "warning";
+        case QtCriticalMsg: return "critical";
+        case QtFatalMsg:    return "fatal";
+    }
+    return "debug";
+}
+
+QByteArray consoleLine(const LogRecord& record, const QString& message) {
+    static const char kLetters[] = "DIWCF";
+    QByteArray line = QDateTime::fromMSecsSinceEpoch(record.timeMs).toString("HH:mm:ss.zzz").toUtf8();
+    line += ' ';
+    line += kLetters[severity(record.type)];
+    line += ' ';
+    line += record.category;
+    line += ": ";
+    line += message.toUtf8();
+    line += '\n';
+    return line;
+}
+
+QByteArray fileLine(const LogRecord& record, const QString& message) {
+    QJsonObject json;
+    json["ts"] = QDateTime::fromMSecsSinceEpoch(record.timeMs).toString(Qt::ISODateWithMs);
+    json["level"] = levelName(record.type);
+    json["cat"] = QString::fromLatin1(record.category);
+    json["tid"] = QString::number(record.threadId, 16);
+    json["msg"] = message;
+    return QJsonDocument(json).toJson(QJsonDocument::Compact) + '\n';
+}
+
+void rotate(LogSink& s) {
+    const QString path = s.options.filePath;
+    s.file.close();
+    QFile::remove(QString("%1.%2").arg(path).arg(s.options.maxFiles));
+    for (int i = s.options.maxFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(path).arg(i), QString("%1.%2").arg(path).arg(i + 1));
+    }
+    if (s.options.maxFiles > 0) {
+        QFile::rename(path, path + ".1");
+    } else {
+        QFile::remove(path);
+    }
+    s.file.open(QIODevice::WriteOnly | QIODevice::Append);
+    s.fileBytes = 0;
+}
+
+// 写入 QFile 的缓冲区，每批结束时统一 flush
+void appendFile(LogSink& s, const QByteArray& line) {
+    if (s.fileBytes > 0 && s.fileBytes + line.size() > s.options.maxFileBytes) {
+        rotate(s);
+    }
+    s.file.write(line);
+    s.fileBytes += line.size();
+}
+
+void writeConsole(const QByteArray& data) {
+    if (!data.isEmpty()) {
+        fwrite(data.constData(), 1, size_t(data.size()), stderr);
+        fflush(stderr);
+    }
+}
+
+void writerLoop() {
+    LogSink& s = sink();
+    const bool toFile = s.file.isOpen();
+    LogRecord record;
+    QByteArray consoleBuffer;
+
+    for (;;) {
+        const bool stopping = !s.running.load(std::memory_order_acquire);
+        while (s.queue.pop(record)) {
+            const QString message = Logger::redact(record.message);
+            if (toFile) {
+                appendFile(s, fileLine(record, message));
+            }
+            if (!toFile || severity(record.type) >= severity(QtWarningMsg)) {
+                consoleBuffer += consoleLine(record, message);
+            }
+        }
+
+        const quint64 dropped = s.pendingDropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LogRecord notice;
+            notice.timeMs = QDateTime::currentMSecsSinceEpoch();
+            notice.type = QtWarningMsg;
+            notice.category = "tmagent.log";
+            const QString message = QString("日志积压，已丢弃 %1 条").arg(dropped);
+            if (toFile) {
+                appendFile(s, fileLine(notice, message));
+            }
+            consoleBuffer += consoleLine(notice, message);
+        }
+
+        if (toFile) {
+            s.file.flush();
+        }
+        writeConsole(consoleBuffer);
+        consoleBuffer.clear();
+
+        if (stopping) {
+            break;
+        }
+        QMutexLocker locker(&s.wakeMutex);
+        if (s.running.load(std::memory_order_acquire) && s.queue.size() == 0) {
+            s.wake.wait(&s.wakeMutex, Logger::kFlushIntervalMs);
+        }
+    }
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message) {
+    LogSink& s = sink();
+    LogRecord record;
+    record.timeMs = QDateTime::currentMSecsSinceEpoch();
+    record.type = type;
+    record.category = context.category ? context.category : "default";
+    record.threadId = quintptr(QThread::currentThreadId());
+    record.message = message;
+
+    // NOTE: 后台线程未运行（安装前 / 退出后）或致命错误时同步输出，保证进程终止前能看到
+    if (!s.running.load(std::memory_order_acquire) || type == QtFatalMsg) {
+        writeConsole(consoleLine(record, Logger::redact(message)));
+        return;
+    }
+
+    if (s.queue.size() >= size_t(Logger::kMaxPending)) {
+        s.pendingDropped.fetch_add(1, std::memory_order_relaxed);
+        s.totalDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    s.queue.push(std::move(record));
+    if (severity(type) >= severity(QtWarningMsg)) {
+        s.wake.wakeOne();
+    }
+}
+
+QString filterRules(QtMsgType level) {
+    QStringList rules;
+    const int minimum = severity(level);
+    rules << QString("tmagent.*.debug=%1").arg(minimum <= severity(QtDebugMsg) ? "true" : "false");
+    rules << QString("tmagent.*.info=%1").arg(minimum <= severity(QtInfoMsg) ? "true" : "false");
+    rules << QString("tmagent.*.warning=%1").arg(minimum <= severity(QtWarningMsg) ? "true" : "false");
+    // 请求体转储只由 QT_LOGGING_RULES 单独打开，不随 debug 级别一起开启
+    rules << "tmagent.request.debug=false";
+    return rules.join('\n');
+}
+
+} // namespace
+
+bool Logger::install(const Options& options) {
+    shutdown();
+
+    LogSink& s = sink();
+    s.options = options;
+    s.payloadSampleEvery.store(qMax(1, options.payloadSampleEvery), std::memory_order_relaxed);
+    QLoggingCategory::setFilterRules(filterRules(options.level));
+
+    bool ok = true;
+    if (!options.filePath.isEmpty()) {
+        s.file.setFileName(options.filePath);
+        ok = s.file.open(QIODevice::WriteOnly | QIODevice::Append);
+        s.fileBytes = ok ? s.file.size() : 0;
+    }
+
+    s.running.store(true, std::memory_order_release);
+    s.thread = QThread::create(writerLoop);
+    s.thread->setObjectName("TmAgentLogger");
+    s.thread->start(QThread::LowPriority);
+    qInstallMessageHandler(messageHandler);
+
+    static bool postRoutineAdded = false;
+    if (!postRoutineAdded) {
+        qAddPostRoutine(Logger::shutdown);
+        postRoutineAdded = true;
+    }
+    return ok;
+}
+
+void Logger::shutdown() {
+    LogSink& s = sink();
+    if (!s.thread) {
+        return;
+    }
+    {
+        QMutexLocker locker(&s.wakeMutex);
+        s.running.store(false, std::memory_order_release);
+        s.wake.wakeAll();
+    }
+    s.thread->wait();
+    delete s.thread;
+    s.thread = nullptr;
+    s.file.close();
+}
+
+void Logger::initFromEnvironment() {
+    Options options;
+    options.filePath = qEnvironmentVariable("TMAGENT_LOG");
+
+    const QString levelName = qEnvironmentVariable("TMAGENT_LOG_LEVEL");
+    const bool levelOk = levelName.isEmpty() || parseLevel(levelName, options.level);
+
+    bool everyOk = false;
+    const int every = qEnvironmentVariableIntValue("TMAGENT_LOG_PAYLOAD_EVERY", &everyOk);
+    if (everyOk) {
+        options.payloadSampleEvery = every;
+    }
+
+    if (!install(options)) {
+        qWarning() << "无法打开日志文件" << options.filePath << "，只输出到 stderr";
+    }
+    if (!levelOk) {
+        qWarning() << "无法识别的 TMAGENT_LOG_LEVEL:" << levelName;
+    }
+}
+
+void Logger::addSecret(const QString& secret) {
+    if (secret.size() < 8) {
+        return;  // 过短的值替换后会误伤正常文本
+    }
+    LogSink& s = sink();
+    QMutexLocker locker(&s.secretsMutex);
+    if (!s.secrets.contains(secret)) {
+        s.secrets.append(secret);
+    }
+}
+
+QString Logger::redact(const QString& text) {
+    static const QRegularExpression bearer(R"((Bearer\s+)[A-Za-z0-9._~+/=\-]{8,})");
+    static const QRegularExpression secretKey(R"(\bsk-[A-Za-z0-9_\-]{8,})");
+
+    QString result = text;
+    if (result.contains("Bearer")) {
+        result.replace(bearer, "\\1***");
+    }
+    if (result.contains("sk-")) {
+        result.replace(secretKey, "sk-***");
+    }
+
+    LogSink& s = sink();
+    QMutexLocker locker(&s.secretsMutex);
+    for (const QString& secret : s.secrets) {
+        result.replace(secret, "***");
+    }
+    return result;
+}
+
+void Logger::logPayload(const QLoggingCategory& category, const char* label, const QByteArray& payload) {
+    if (!category.isDebugEnabled()) {
+        return;
+    }
+    LogSink& s = sink();
+    const int every = s.payloadSampleEvery.load(std::memory_order_relaxed);
+    if (s.payloadCounter.fetch_add(1, std::memory_order_relaxed) % quint64(every) != 0) {
+        return;
+    }
+
+    const bool truncated = payload.size() > kMaxPayloadBytes;
+    QMessageLogger(__FILE__, __LINE__, Q_FUNC_INFO).debug(category).noquote()
+        << QString("[%1] %2 字节%3:").arg(label).arg(payload.size()).arg(truncated ? "（已截断）" : "")
+        << QString::fromUtf8(payload.left(kMaxPayloadBytes));
+}
+
+bool Logger::parseLevel(const QString& name, QtMsgType& level) {
+    const QString lower = name.trimmed().toLower();
+    if (lower == "debug") {
+        level = QtDebugMsg;
+    } else if (lower == "info") {
+        level = QtInfoMsg;
+    } else if (lower == "warning" || lower == "warn") {
+        level = QtWarningMsg;
+    } else if (lower == "critical" || lower == "error") {
+        level = QtCriticalMsg;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+quint64 Logger::droppedCount() {
+    return sink().totalDropped.load(std::memory_order_relaxed);
+}
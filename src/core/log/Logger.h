@@ -0,0 +1,80 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QLoggingCategory>
+
+/**
+ * @brief 异步日志输出（接管 qDebug / qCDebug 等 Qt 日志）
+ *
+ * 调用线程只复制消息并推入无锁队列（MpscQueue），由后台线程脱敏、格式化后写入:
+ * - 日志文件：每行一个 JSON（ts / level / cat / tid / msg），超过 maxFileBytes 时轮转为 .1 ... .N
+ * - stderr：未设置文件时输出全部日志；设置文件后只输出 warning 及以上
+ *
+ * 脱敏：API Key（addSecret 登记）、"Bearer xxx"、"sk-xxx" 形式的密钥在写出前替换为 ***。
+ * 队列积压超过 kMaxPending 条时丢弃新日志并在之后补一行丢弃计数，日志不会拖慢 Agent 循环。
+ *
+ * 使用方式:
+ *   Logger::initFromEnvironment();   // main 中，QCoreApplication 创建之后
+ *   qCDebug(lcTool) << "[FileTool] 读取文件:" << path;
+ *   Logger::logPayload(lcRequest(), "request", body);   // 采样、截断后的请求体
+ *
+ * 环境变量: TMAGENT_LOG=<文件>、TMAGENT_LOG_LEVEL=debug|info|warning、TMAGENT_LOG_PAYLOAD_EVERY=<N>
+ */
+class Logger {
+public:
+    static constexpr int kMaxPending = 20000;          // 队列积压上限（条）
+    static constexpr int kFlushIntervalMs = 200;       // 后台线程最长等待间隔
+    static constexpr int kMaxPayloadBytes = 32 * 1024; // 单次请求体转储的上限
+
+    struct Options {
+        QString filePath;                        // 空表示只输出到 stderr
+        qint64 maxFileBytes = 10 * 1024 * 1024;  // 单个文件上限
+        int maxFiles = 3;                        // 保留的历史文件数
+        QtMsgType level = QtInfoMsg;             // tmagent.* 分类的最低级别
+        int payloadSampleEvery = 10;             // 请求体每 N 次转储一次（需打开 tmagent.request.debug）
+    };
+
+    /**
+     * @brief 安装消息处理函数并启动后台线程（重复调用时先停止旧的）
+     * @return 日志文件无法打开时返回 false（仍输出到 stderr）
+     */
+    static bool install(const Options& options);
+
+    /**
+     * @brief 写完队列中的日志并停止后台线程，之后的日志同步输出到 stderr
+     * @note install 时登记为 QCoreApplication 的退出例程，一般不需要手动调用
+     */
+    static void shutdown();
+
+    /**
+     * @brief 按环境变量安装（TMAGENT_LOG 等），未设置时同样异步输出到 stderr
+     */
+    static void initFromEnvironment();
+
+    /**
+     * @brief 登记需要在日志中隐藏的密钥（少于 8 个字符的忽略）
+     */
+    static void addSecret(const QString& secret);
+
+    /**
+     * @brief 替换文本中的密钥（后台线程在写出前调用）
+     */
+    static QString redact(const QString& text);
+
+    /**
+     * @brief 按采样输出大块内容（请求体等）：分类的 debug 关闭时不做任何事，
+     *        否则每 payloadSampleEvery 次输出一次，超过 kMaxPayloadBytes 的部分截断
+     */
+    static void logPayload(const QLoggingCategory& category, const char* label, const QByteArray& payload);
+
+    /**
+     * @brief 解析级别名称（debug / info / warning / critical），无法识别时返回 false
+     */
+    static bool parseLevel(const QString& name, QtMsgType& level);
+
+    static quint64 droppedCount();
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,169 @@
+#include "MetricsRegistry.h"
+#include <QMutexLocker>
+#include <cmath>
+#include <limits>
+
+// ==================== Histogram ====================
+
+int Histogram::bucketIndex(qint64 value) {
+    if (value < 2 * kSubBuckets) {
+        return int(qMax<qint64>(0, value));  // [0, 64) 精确
+    }
+    int msb = 63;
+    while (!(quint64(value) >> msb)) {
+        --msb;
+    }
+    // value >> shift 落在 [32, 64)，即该 2 的幂区间内的 32 个桶之一
+    const int shift = msb - 5;
+    if (shift > kMaxShift) {
+        return kBucketCount - 1;
+    }
+    return 2 * kSubBuckets + (shift - 1) * kSubBuckets + int((value >> shift) - kSubBuckets);
+}
+
+qint64 Histogram::bucketLowerBound(int index) {
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    const int shift = (index - 2 * kSubBuckets) / kSubBuckets + 1;
+    const qint64 mantissa = (index - 2 * kSubBuckets) % kSubBuckets + kSubBuckets;
+    return mantissa << shift;
+}
+
+qint64 Histogram::bucketWidth(int index) {
+    if (index < 2 * kSubBuckets) {
+        return 1;
+    }
+    return qint64(1) << ((index - 2 * kSubBuckets) / kSubBuckets + 1);
+}
+
+void Histogram::record(qint64 value) {
+    value = qMax<qint64>(0, value);
+    m_buckets[size_t(bucketIndex(value))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    qint64 current = m_min.load(std::memory_order_relaxed);
+    while (value < current && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = m_max.load(std::memory_order_relaxed);
+    while (value > current && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 Histogram::min() const {
+    return count() > 0 ? m_min.load(std::memory_order_relaxed) : 0;
+}
+
+double Histogram::mean() const {
+    const qint64 n = count();
+    return n > 0 ? double(m_sum.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+qint64 Histogram::percentile(double percentile) const {
+    const qint64 n = count();
+    if (n == 0) {
+        return 0;
+    }
+    const qint64 target = qMax<qint64>(1, qint64(std::ceil(qBound(0.0, percentile, 100.0) / 100.0 * n)));
+    qint64 seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += m_buckets[size_t(i)].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            // 桶中点，且不超出实际记录到的范围
+            return qBound(min(), bucketLowerBound(i) + bucketWidth(i) / 2, max());
+        }
+    }
+    return max();
+}
+
+QJsonObject Histogram::toJson() const {
+    QJsonObject json;
+    json["unit"] = m_unit;
+    json["count"] = count();
+    json["min"] = min();
+    json["mean"] = std::round(mean() * 10) / 10;
+    json["p50"] = percentile(50);
+    json["p90"] = percentile(90);
+    json["p99"] = percentile(99);
+    json["max"] = max();
+    return json;
+}
+
+void Histogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<qint64>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+// ==================== MetricsRegistry ====================
+
+MetricsRegistry& MetricsRegistry::instance() {
+    // NOTE: 故意不析构，静态对象与其他线程在退出时仍可能记录
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+Counter* MetricsRegistry::counter(const QString& name) {
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Counter>& metric = m_counters[name];
+    if (!metric) {
+        metric = std::make_shared<Counter>();
+    }
+    return metric.get();
+}
+
+Gauge* MetricsRegistry::gauge(const QString& name) {
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Gauge>& metric = m_gauges[name];
+    if (!metric) {
+        metric = std::make_shared<Gauge>();
+    }
+    return metric.get();
+}
+
+Histogram* MetricsRegistry::histogram(const QString& name, const QString& unit) {
+    QMutexLocker locker(&m_mutex);
+    std::shared_ptr<Histogram>& metric = m_histograms[name];
+    if (!metric) {
+        metric = std::make_shared<Histogram>(unit);
+    }
+    return metric.get();
+}
+
+QJsonObject MetricsRegistry::toJson() const {
+    QMutexLocker locker(&m_mutex);
+    QJsonObject counters;
+    for (auto it = m_counters.constBegin(); it != m_counters.constEnd(); ++it) {
+        counters[it.key()] = it.value()->value();
+    }
+    QJsonObject gauges;
+    for (auto it = m_gauges.constBegin(); it != m_gauges.constEnd(); ++it) {
+        gauges[it.key()] = it.value()->value();
+    }
+    QJsonObject histograms;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        histograms[it.key()] = it.value()->toJson();
+    }
+
+    QJsonObject json;
+    json["counters"] = counters;
+    json["gauges"] = gauges;
+    json["histograms"] = histograms;
+    return json;
+}
+
+void MetricsRegistry::reset() {
+    QMutexLocker locker(&m_mutex);
+    for (const auto& metric : m_counters) {
+        metric->reset();
+    }
+    // NOTE: 仪表反映当前状态（如在途请求数），不清零
+    for (const auto& metric : m_histograms) {
+        metric->reset();
+    }
+}
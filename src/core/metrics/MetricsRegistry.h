@@ -0,0 +1,123 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QJsonObject>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+
+/**
+ * @brief 单调递增的计数器（请求数、字节数、token 数、重试次数）
+ */
+class Counter {
+public:
+    void add(qint64 delta = 1) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+    void reset() { m_value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+/**
+ * @brief 可增可减的当前值（在途请求数等）
+ */
+class Gauge {
+public:
+    void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(qint64 delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+/**
+ * @brief HDR 风格的直方图（对数-线性分桶，相对误差约 3%）
+ *
+ * 小于 64 的值精确记录；之后每个 2 的幂区间均分为 32 个桶，记录与分位数查询都是 O(桶数) 以内、无锁。
+ * 可记录 [0, 2^41) 的整数值（微秒时约 25 天），超出的按上限计。
+ */
+class Histogram {
+public:
+    static constexpr int kSubBuckets = 32;                         // 每个 2 的幂区间的桶数
+    static constexpr int kMaxShift = 35;                           // 2^41 以内
+    static constexpr int kBucketCount = 2 * kSubBuckets + kMaxShift * kSubBuckets;
+
+    explicit Histogram(const QString& unit = "us") : m_unit(unit) {}
+
+    void record(qint64 value);
+
+    qint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    qint64 min() const;
+    qint64 max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    /**
+     * @brief 分位数（percentile 取 0~100），返回所在桶的中点
+     */
+    qint64 percentile(double percentile) const;
+
+    QString unit() const { return m_unit; }
+
+    // {"unit", "count", "min", "mean", "p50", "p90", "p99", "max"}
+    QJsonObject toJson() const;
+    void reset();
+
+    static int bucketIndex(qint64 value);
+    static qint64 bucketLowerBound(int index);
+    static qint64 bucketWidth(int index);
+
+private:
+    QString m_unit;
+    std::array<std::atomic<qint64>, kBucketCount> m_buckets{};
+    std::atomic<qint64> m_count{0};
+    std::atomic<qint64> m_sum{0};
+    std::atomic<qint64> m_min{std::numeric_limits<qint64>::max()};
+    std::atomic<qint64> m_max{0};
+};
+
+/**
+ * @brief 进程内的指标注册表（一次会话 / 一次 CLI 运行）
+ *
+ * 按名称取得指标，返回的指针在进程内一直有效（reset 只清零），热路径上可缓存在静态变量中:
+ *   static Counter* retries = MetricsRegistry::instance().counter("llm.retries");
+ *   retries->add();
+ *
+ * 带标签的指标用 labeled() 拼名称，如 tool.latency_us{view_file}。
+ * 界面的“指标”面板与 CLI 的 --metrics 都读取 toJson()。
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    Counter* counter(const QString& name);
+    Gauge* gauge(const QString& name);
+    Histogram* histogram(const QString& name, const QString& unit = "us");
+
+    static QString labeled(const QString& name, const QString& label) {
+        return name + "{" + label + "}";
+    }
+
+    // {"counters": {...}, "gauges": {...}, "histograms": {name: {...}}}
+    QJsonObject toJson() const;
+
+    /**
+     * @brief 清零所有指标（界面“重置”，或开始新的测量）
+     */
+    void reset();
+
+private:
+    MetricsRegistry() = default;
+
+    mutable QMutex m_mutex;  // 只保护注册表本身，指标的读写无锁
+    QHash<QString, std::shared_ptr<Counter>> m_counters;
+    QHash<QString, std::shared_ptr<Gauge>> m_gauges;
+    QHash<QString, std::shared_ptr<Histogram>> m_histograms;
+};
+
+#endif // METRICSREGISTRY_H
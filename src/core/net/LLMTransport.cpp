@@ -0,0 +1,84 @@
+#include "LLMTransport.h"
+#include "RateLimiter.h"
+#include "SessionRecorder.h"
+#include <QCoreApplication>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QDateTime>
+#include <QLocale>
+#include <QRandomGenerator>
+#include <QDebug>
+
+LLMTransport& LLMTransport::instance() {
+    // NOTE: 不用函数内静态对象，QNetworkAccessManager 必须在 QCoreApplication 之前析构
+    static LLMTransport* transport = new LLMTransport(QCoreApplication::instance());
+    return *transport;
+}
+
+LLMTransport::LLMTransport(QObject *parent)
+    : QObject(parent)
+    , m_manager(new QNetworkAccessManager(this))
+    , m_rateLimiter(new RateLimiter(this))
+{
+    const QString recordPath = qEnvironmentVariable("TMAGENT_RECORD");
+    if (!recordPath.isEmpty()) {
+        // 进程内只有一个录制器，进程退出时关闭文件（每行都已 flush）
+        static SessionRecorder recorder;
+        if (recorder.open(recordPath)) {
+            m_recorder = &recorder;
+        } else {
+            qWarning() << "无法打开会话录制文件" << recordPath << recorder.errorString();
+        }
+    }
+}
+
+QNetworkReply* LLMTransport::post(QNetworkRequest request, const QByteArray& body) {
+    // 服务端不支持 HTTP/2 时 ALPN 协商自动回落到 HTTP/1.1（每个主机最多 6 个复用连接）
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+    return m_manager->post(request, body);
+}
+
+bool LLMTransport::isRetryable(QNetworkReply* reply) {
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 429 || status >= 500) {
+        return true;
+    }
+    if (status >= 400) {
+        return false;  // 其余 4xx 是请求本身的问题，重试没有意义
+    }
+    // 未收到响应头，或 200 之后流式输出中途断开
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+int LLMTransport::retryDelayMs(QNetworkReply* reply, int attempt) {
+    const QByteArray retryAfter = reply->rawHeader("Retry-After").trimmed();
+    if (!retryAfter.isEmpty()) {
+        bool ok = false;
+        const int seconds = retryAfter.toInt(&ok);
+        if (ok) {
+            return qBound(0, seconds * 1000, kBackoffMaxMs);
+        }
+        // HTTP 日期格式: "Wed, 21 Oct 2015 07:28:00 GMT"
+        QDateTime at = QLocale::c().toDateTime(QString::fromLatin1(retryAfter.left(25)),
+                                                "ddd, dd MMM yyyy HH:mm:ss");
+        if (at.isValid()) {
+            at.setTimeSpec(Qt::UTC);
+            return int(qBound<qint64>(0, QDateTime::currentDateTimeUtc().msecsTo(at), kBackoffMaxMs));
+        }
+    }
+
+    // 指数退避，取 [d/2, d) 内的随机值，避免多个 Agent 同时重试再次撞上限流
+    const int delay = int(qMin<qint64>(kBackoffMaxMs, qint64(kBackoffBaseMs) << qBound(0, attempt - 1, 16)));
+    return delay / 2 + QRandomGenerator::global()->bounded(qMax(1, delay / 2));
+}
@@ -0,0 +1,72 @@
+#ifndef LLMTRANSPORT_H
+#define LLMTRANSPORT_H
+
+#include <QObject>
+#include <QNetworkRequest>
+
+class QNetworkAccessManager;  // 前向声明
+class QNetworkReply;          // 前向声明
+class RateLimiter;            // 前向声明
+class SessionRecorder;        // 前向声明
+
+/**
+ * @brief 进程内共享的 LLM 传输层
+ *
+ * 所有 LLMAgent（包括 Orchestrator 的 Worker 与 delegate_task 的子 Agent）共用:
+ *   - 一个 QNetworkAccessManager：同一主机的连接被复用，服务端支持时走 HTTP/2 多路复用
+ *   - 一个默认的 RateLimiter：RPM / TPM 令牌桶，429 时所有 Agent 一起退避
+ *   - 可选的 SessionRecorder：设置环境变量 TMAGENT_RECORD=<文件> 时录制所有请求与 SSE 响应
+ *
+ * 使用方式:
+ *   LLMTransport::instance().rateLimiter()->setRequestsPerMinute(60);
+ *   QNetworkReply* reply = LLMTransport::instance().post(request, body);
+ *
+ * NOTE: QNetworkAccessManager 只能在创建它的线程使用，Agent 均运行在主线程
+ */
+class LLMTransport : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief 全局实例（以 QCoreApplication 为父对象，随应用一起析构）
+     */
+    static LLMTransport& instance();
+
+    QNetworkAccessManager* networkManager() const { return m_manager; }
+    RateLimiter* rateLimiter() const { return m_rateLimiter; }
+
+    /**
+     * @brief 会话录制器，未启用录制时为 nullptr
+     * @note 应在第一个请求发出前设置；传入 nullptr 关闭录制（不接管所有权）
+     */
+    SessionRecorder* recorder() const { return m_recorder; }
+    void setRecorder(SessionRecorder* recorder) { m_recorder = recorder; }
+
+    /**
+     * @brief 发送请求（允许 HTTP/2，复用共享连接）
+     */
+    QNetworkReply* post(QNetworkRequest request, const QByteArray& body);
+
+    /**
+     * @brief 是否值得重试：429 与 5xx，以及连接被拒绝、流式输出中途被远端关闭等网络错误
+     */
+    static bool isRetryable(QNetworkReply* reply);
+
+    /**
+     * @brief 第 attempt 次重试（从 1 开始）前的等待时间
+     *
+     * 响应带 Retry-After（秒数或 HTTP 日期）时以它为准，否则为带随机抖动的指数退避。
+     */
+    static int retryDelayMs(QNetworkReply* reply, int attempt);
+
+    static constexpr int kBackoffBaseMs = 1000;
+    static constexpr int kBackoffMaxMs = 60000;
+
+private:
+    explicit LLMTransport(QObject *parent = nullptr);
+
+    QNetworkAccessManager* m_manager;
+    RateLimiter* m_rateLimiter;
+    SessionRecorder* m_recorder = nullptr;
+};
+
+#endif // LLMTRANSPORT_H
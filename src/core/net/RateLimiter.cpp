@@ -0,0 +1,128 @@
+#include "RateLimiter.h"
+#include <QtMath>
+
+RateLimiter::RateLimiter(QObject *parent) : QObject(parent) {
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &RateLimiter::dispatchWaiting);
+}
+
+void RateLimiter::setRequestsPerMinute(int rpm) {
+    refill();
+    m_rpm = qMax(0, rpm);
+    m_requests = m_rpm;
+    m_timer.stop();
+    dispatchWaiting();
+}
+
+void RateLimiter::setTokensPerMinute(int tpm) {
+    refill();
+    m_tpm = qMax(0, tpm);
+    m_tokens = m_tpm;
+    m_timer.stop();
+    dispatchWaiting();
+}
+
+void RateLimiter::acquire(QObject* owner, int tokens, std::function<void()> ready) {
+    // NOTE: 有人排队时新申请也要排队，保证 FIFO，避免长时间等待的 Agent 被插队饿死
+    refill();
+    if (m_waiting.isEmpty() && canGrant(tokens)) {
+        take(tokens);
+        ready();
+        return;
+    }
+
+    m_waiting.append(Waiter{owner, tokens, std::move(ready)});
+    scheduleNext();
+}
+
+void RateLimiter::cancel(QObject* owner) {
+    for (int i = m_waiting.size() - 1; i >= 0; --i) {
+        if (m_waiting[i].owner == owner) {
+            m_waiting.removeAt(i);
+        }
+    }
+}
+
+void RateLimiter::settle(int estimatedTokens, int actualTokens) {
+    if (m_tpm <= 0) {
+        return;
+    }
+    refill();
+    // 欠账最多一分钟的额度，估算严重偏差时不至于长时间停摆
+    m_tokens = qBound<double>(-m_tpm, m_tokens - (actualTokens - cappedTokens(estimatedTokens)), m_tpm);
+    dispatchWaiting();
+}
+
+void RateLimiter::pause(int ms) {
+    if (ms <= 0) {
+        return;
+    }
+    m_pausedUntilMs = qMax(m_pausedUntilMs, m_clock.elapsed() + ms);
+    m_timer.stop();
+    scheduleNext();
+}
+
+void RateLimiter::refill() {
+    const qint64 now = m_clock.elapsed();
+    const double minutes = (now - m_lastRefillMs) / 60000.0;
+    m_requests = qMin<double>(m_rpm, m_requests + minutes * m_rpm);
+    m_tokens = qMin<double>(m_tpm, m_tokens + minutes * m_tpm);
+    m_lastRefillMs = now;
+}
+
+bool RateLimiter::canGrant(int tokens) const {
+    if (m_clock.elapsed() < m_pausedUntilMs) {
+        return false;
+    }
+    return (m_rpm <= 0 || m_requests >= 1.0)
+        && (m_tpm <= 0 || m_tokens >= cappedTokens(tokens));
+}
+
+void RateLimiter::take(int tokens) {
+    if (m_rpm > 0) {
+        m_requests -= 1.0;
+    }
+    if (m_tpm > 0) {
+        m_tokens -= cappedTokens(tokens);
+    }
+}
+
+int RateLimiter::cappedTokens(int tokens) const {
+    return qBound(0, tokens, m_tpm);
+}
+
+void RateLimiter::dispatchWaiting() {
+    refill();
+    while (!m_waiting.isEmpty()) {
+        if (!m_waiting.first().owner) {
+            m_waiting.removeFirst();  // 申请方已销毁，不消耗令牌
+            continue;
+        }
+        if (!canGrant(m_waiting.first().tokens)) {
+            break;
+        }
+        const Waiter waiter = m_waiting.takeFirst();
+        take(waiter.tokens);
+        waiter.ready();
+    }
+    scheduleNext();
+}
+
+void RateLimiter::scheduleNext() {
+    if (m_waiting.isEmpty() || m_timer.isActive()) {
+        return;
+    }
+
+    // 距离队首请求可以发放还需要的时间：暂停剩余时间与两个桶补足时间中的最大值
+    const qint64 now = m_clock.elapsed();
+    double waitMs = qMax<qint64>(0, m_pausedUntilMs - now);
+    if (m_rpm > 0 && m_requests < 1.0) {
+        waitMs = qMax(waitMs, (1.0 - m_requests) * 60000.0 / m_rpm);
+    }
+    const int tokens = cappedTokens(m_waiting.first().tokens);
+    if (m_tpm > 0 && m_tokens < tokens) {
+        waitMs = qMax(waitMs, (tokens - m_tokens) * 60000.0 / m_tpm);
+    }
+    m_timer.start(qMax(1, qCeil(waitMs)));
+}
@@ -0,0 +1,93 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief 请求速率限制（令牌桶）
+ *
+ * 同时维护两个桶：每分钟请求数（RPM）与每分钟 token 数（TPM）。
+ * 多个 LLMAgent 共享同一个限制器时，按 FIFO 顺序发放请求许可，
+ * 令牌不足的请求在限制器内排队，不占用网络连接。
+ *
+ * TPM 在发放许可时按估算的输入 token 扣除，收到 usage 后用 settle() 按实际用量补差，
+ * 超出的部分记为欠账，推迟后续请求。
+ *
+ * NOTE: 只能在主线程（限制器所在线程）中使用
+ */
+class RateLimiter : public QObject {
+    Q_OBJECT
+public:
+    explicit RateLimiter(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置每分钟请求数上限（桶容量同为 rpm，允许一分钟内的突发）
+     * @param rpm 0 表示不限制
+     */
+    void setRequestsPerMinute(int rpm);
+    int requestsPerMinute() const { return m_rpm; }
+
+    /**
+     * @brief 设置每分钟 token 数上限（输入 + 输出）
+     * @param tpm 0 表示不限制
+     */
+    void setTokensPerMinute(int tpm);
+    int tokensPerMinute() const { return m_tpm; }
+
+    /**
+     * @brief 申请一次请求许可
+     * @param owner 申请方，销毁或 cancel 后不再回调
+     * @param tokens 本次请求估算的 token 数（超过桶容量时按容量计，避免永远等不到）
+     * @param ready 获得许可时调用（令牌充足时在本函数内同步调用）
+     */
+    void acquire(QObject* owner, int tokens, std::function<void()> ready);
+    void acquire(QObject* owner, std::function<void()> ready) { acquire(owner, 0, std::move(ready)); }
+
+    /**
+     * @brief 取消某申请方所有排队中的申请
+     */
+    void cancel(QObject* owner);
+
+    /**
+     * @brief 按实际用量补差（actual 大于估算时扣除差额，小于时退还）
+     */
+    void settle(int estimatedTokens, int actualTokens);
+
+    /**
+     * @brief 暂停发放许可（服务端返回 429 / Retry-After 时，所有共享者一起退避）
+     */
+    void pause(int ms);
+
+    int waitingCount() const { return m_waiting.size(); }
+
+private:
+    struct Waiter {
+        QPointer<QObject> owner;
+        int tokens = 0;
+        std::function<void()> ready;
+    };
+
+    void refill();
+    bool canGrant(int tokens) const;
+    void take(int tokens);
+    void dispatchWaiting();
+    void scheduleNext();
+    int cappedTokens(int tokens) const;
+
+    int m_rpm = 0;
+    int m_tpm = 0;
+    double m_requests = 0.0;       // RPM 桶余量
+    double m_tokens = 0.0;         // TPM 桶余量（欠账时为负）
+    QElapsedTimer m_clock;
+    qint64 m_lastRefillMs = 0;
+    qint64 m_pausedUntilMs = 0;
+    QList<Waiter> m_waiting;
+    QTimer m_timer;
+};
+
+#endif // RATELIMITER_H
@@ -0,0 +1,44 @@
+#include "ReplayServer.h"
+
+ReplayServer::ReplayServer(QObject *parent)
+    : SseServer(parent)
+{
+}
+
+void ReplayServer::setCassette(const SessionCassette& cassette) {
+    m_cassette = cassette;
+    m_used = QList<bool>();
+    for (int i = 0; i < cassette.exchanges.size(); ++i) {
+        m_used.append(false);
+    }
+    m_served = 0;
+    m_mismatches = 0;
+}
+
+int ReplayServer::remainingCount() const {
+    return m_used.count(false);
+}
+
+int ReplayServer::respond(const QByteArray& body, SseExchange& response) {
+    int index = -1;
+    for (int i = 0; i < m_used.size(); ++i) {
+        if (!m_used[i] && m_cassette.exchanges[i].requestBody == body) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        index = m_used.indexOf(false);
+        if (index < 0) {
+            return -1;  // 录制的响应已用完
+        }
+        if (!m_cassette.exchanges[index].requestBody.isEmpty()) {
+            ++m_mismatches;  // 合成会话不记录请求体，不算不匹配
+        }
+    }
+
+    m_used[index] = true;
+    ++m_served;
+    response = m_cassette.exchanges[index];
+    return index;
+}
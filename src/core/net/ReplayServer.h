@@ -0,0 +1,43 @@
+#ifndef REPLAYSERVER_H
+#define REPLAYSERVER_H
+
+#include <QList>
+#include "SseServer.h"
+
+/**
+ * @brief 本地回放服务（OpenAI 兼容的 /chat/completions）
+ *
+ * 把 SessionCassette 中录制的 SSE 响应按原有时间间隔（或固定间隔）重新发送，
+ * LLMAgent 只需把 baseUrl 指向 baseUrl() 即可离线、可重复地运行一次完整会话。
+ *
+ * 使用方式:
+ *   ReplayServer server;
+ *   server.setCassette(cassette);
+ *   server.listen();
+ *   config.baseUrl = server.baseUrl();
+ *
+ * 请求体与某次录制的请求逐字节相同时回放那一次，否则按顺序回放下一个未使用的响应并计入 mismatchCount()
+ * （提示词或工具定义有变化时仍可回放，但请求已不是录制时的请求）；没有请求体的合成响应不计入。
+ */
+class ReplayServer : public SseServer {
+    Q_OBJECT
+public:
+    explicit ReplayServer(QObject *parent = nullptr);
+
+    void setCassette(const SessionCassette& cassette);
+
+    int servedCount() const { return m_served; }
+    int mismatchCount() const { return m_mismatches; }
+    int remainingCount() const;
+
+protected:
+    int respond(const QByteArray& body, SseExchange& response) override;
+
+private:
+    SessionCassette m_cassette;
+    QList<bool> m_used;
+    int m_served = 0;
+    int m_mismatches = 0;
+};
+
+#endif // REPLAYSERVER_H
@@ -0,0 +1,126 @@
+#include "SessionCassette.h"
+#include "core/agent/ToolDispatcher.h"
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <memory>
+
+bool SessionCassette::load(const QString& path, SessionCassette& cassette, QString& error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("无法打开会话文件 %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    cassette = SessionCassette();
+    QMap<int, SseExchange> pending;  // 按序号排列，尚未结束的请求
+    QMap<int, SseExchange> finished;
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        ++lineNumber;
+        const QByteArray raw = file.readLine().trimmed();
+        if (raw.isEmpty()) {
+            continue;
+        }
+        const QJsonDocument doc = QJsonDocument::fromJson(raw);
+        if (!doc.isObject()) {
+            if (file.atEnd()) {
+                break;  // 录制中断时写了一半的最后一行
+            }
+            error = QString("第 %1 行不是合法的 JSON").arg(lineNumber);
+            return false;
+        }
+
+        const QJsonObject entry = doc.object();
+        const QString type = entry["type"].toString();
+        const int seq = entry["seq"].toInt();
+        if (type == "request") {
+            pending[seq].requestBody = entry["body"].toString().toUtf8();
+        } else if (type == "line" && pending.contains(seq)) {
+            pending[seq].lines.append(SseLine{entry["t"].toInt(), entry["data"].toString().toUtf8()});
+        } else if (type == "end" && pending.contains(seq)) {
+            SseExchange exchange = pending.take(seq);
+            exchange.status = entry["status"].toInt(200);
+            exchange.durationMs = entry["t"].toInt();
+            finished.insert(seq, exchange);
+        } else if (type == "tool") {
+            cassette.tools.append(ToolRecord{entry["id"].toString(), entry["name"].toString(),
+                                             entry["input"].toObject(), entry["result"].toString()});
+        }
+    }
+
+    cassette.exchanges = finished.values();
+    if (cassette.exchanges.isEmpty()) {
+        error = QString("会话文件 %1 中没有完整的请求").arg(path);
+        return false;
+    }
+    return true;
+}
+
+QList<Tool> SessionCassette::toolSchemas() const {
+    QList<Tool> schemas;
+    for (const SseExchange& exchange : exchanges) {
+        const QJsonArray toolArray = QJsonDocument::fromJson(exchange.requestBody).object()["tools"].toArray();
+        if (toolArray.isEmpty()) {
+            continue;
+        }
+        for (const QJsonValue& value : toolArray) {
+            const QJsonObject function = value.toObject()["function"].toObject();
+            Tool tool;
+            tool.name = function["name"].toString();
+            tool.description = function["description"].toString();
+            tool.inputSchema = function["parameters"].toObject();
+            schemas.append(tool);
+        }
+        break;
+    }
+    return schemas;
+}
+
+void SessionCassette::installTools(ToolDispatcher* dispatcher) const {
+    QList<Tool> schemas = toolSchemas();
+    if (schemas.isEmpty()) {
+        QStringList names;
+        for (const ToolRecord& record : tools) {
+            if (!names.contains(record.name)) {
+                names.append(record.name);
+                Tool tool;
+                tool.name = record.name;
+                tool.description = "回放工具 " + record.name;
+                tool.inputSchema = QJsonObject{{"type", "object"}};
+                schemas.append(tool);
+            }
+        }
+    }
+
+    // 多个回放工具共享同一份记录，每条记录只使用一次（同样的调用出现多次时按顺序返回）
+    auto remaining = std::make_shared<QList<ToolRecord>>(tools);
+    for (const Tool& schema : schemas) {
+        const QString name = schema.name;
+        dispatcher->registerTool(schema, "回放 " + name, [remaining, name](const QJsonObject& input) {
+            for (int i = 0; i < remaining->size(); ++i) {
+                if (remaining->at(i).name == name && remaining->at(i).input == input) {
+                    return remaining->takeAt(i).result;
+                }
+            }
+            return QString("错误: 回放会话中没有该调用的记录 (%1 %2)")
+                .arg(name, QString::fromUtf8(QJsonDocument(input).toJson(QJsonDocument::Compact)));
+        });
+    }
+}
+
+int SessionCassette::completionTokens() const {
+    int tokens = 0;
+    for (const SseExchange& exchange : exchanges) {
+        for (const SseLine& line : exchange.lines) {
+            if (!line.data.startsWith("data: {") || !line.data.contains("\"usage\"")) {
+                continue;
+            }
+            const QJsonObject usage = QJsonDocument::fromJson(line.data.mid(6)).object()["usage"].toObject();
+            tokens += usage["completion_tokens"].toInt();
+        }
+    }
+    return tokens;
+}
@@ -0,0 +1,80 @@
+#ifndef SESSIONCASSETTE_H
+#define SESSIONCASSETTE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QJsonObject>
+#include "core/agent/ToolTypes.h"
+
+class ToolDispatcher;  // 前向声明
+
+// SSE 数据行（t 为相对请求发出时的毫秒数）
+struct SseLine {
+    int timeMs = 0;
+    QByteArray data;
+};
+
+// 一次请求及其响应
+struct SseExchange {
+    // 响应的结束方式（录制的会话总是 Complete，其余用于 Mock 服务注入故障）
+    enum class Ending {
+        Complete,  // 正常结束
+        Close,     // 发完所有行后直接断开连接（流式输出中途断开）
+        Hang       // 发完所有行后保持连接但不再发送（触发客户端空闲超时）
+    };
+
+    QByteArray requestBody;
+    QList<SseLine> lines;
+    int status = 200;
+    int durationMs = 0;  // 请求发出到响应结束
+    Ending ending = Ending::Complete;
+    QList<QPair<QByteArray, QByteArray>> headers;  // 额外的响应头（如 Retry-After）
+};
+
+// 一次工具调用及其结果
+struct ToolRecord {
+    QString id;
+    QString name;
+    QJsonObject input;
+    QString result;
+};
+
+/**
+ * @brief 录制的 LLM 会话（SessionRecorder 的输出）
+ *
+ * 交给 ReplayServer 按原有节奏回放 SSE 流；installTools() 注册同名的回放工具，
+ * 按（工具名, 参数）返回录制时的结果，回放时不会读写本地文件或执行命令。
+ *
+ * 也可以直接在代码中构造 exchanges / tools，生成合成会话（见 tests/bench）。
+ */
+class SessionCassette {
+public:
+    QList<SseExchange> exchanges;
+    QList<ToolRecord> tools;
+
+    /**
+     * @brief 从 SessionRecorder 写出的文件加载
+     * @return 失败时 error 给出原因；未写完的最后一次请求（没有 end 行）被丢弃
+     */
+    static bool load(const QString& path, SessionCassette& cassette, QString& error);
+
+    /**
+     * @brief 录制时请求中携带的工具定义（取第一个带 tools 的请求）
+     */
+    QList<Tool> toolSchemas() const;
+
+    /**
+     * @brief 向调度器注册回放工具
+     * @note 请求中没有工具定义（合成会话）时按工具名生成最简 Schema
+     */
+    void installTools(ToolDispatcher* dispatcher) const;
+
+    /**
+     * @brief 所有响应中 usage.completion_tokens 的总和
+     */
+    int completionTokens() const;
+};
+
+#endif // SESSIONCASSETTE_H
@@ -0,0 +1,73 @@
+#include "SessionRecorder.h"
+#include <QJsonDocument>
+
+bool SessionRecorder::open(const QString& path) {
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    m_clock.start();
+    m_nextSeq = 1;
+    m_startMs.clear();
+    return true;
+}
+
+void SessionRecorder::close() {
+    m_file.close();
+}
+
+int SessionRecorder::beginExchange(const QString& agentId, const QByteArray& requestBody) {
+    const int seq = m_nextSeq++;
+    m_startMs.insert(seq, m_clock.elapsed());
+
+    QJsonObject entry;
+    entry["type"] = "request";
+    entry["seq"] = seq;
+    entry["agent"] = agentId;
+    entry["body"] = QString::fromUtf8(requestBody);  // 原样保存，回放时按字节匹配请求
+    write(entry);
+    return seq;
+}
+
+void SessionRecorder::recordLine(int seq, const QByteArray& line) {
+    QJsonObject entry;
+    entry["type"] = "line";
+    entry["seq"] = seq;
+    entry["t"] = elapsedSince(seq);
+    entry["data"] = QString::fromUtf8(line);
+    write(entry);
+}
+
+void SessionRecorder::endExchange(int seq, int status) {
+    QJsonObject entry;
+    entry["type"] = "end";
+    entry["seq"] = seq;
+    entry["t"] = elapsedSince(seq);
+    entry["status"] = status;
+    write(entry);
+    m_startMs.remove(seq);
+}
+
+void SessionRecorder::recordTool(const ToolCall& call, const QString& result) {
+    QJsonObject entry;
+    entry["type"] = "tool";
+    entry["id"] = call.id;
+    entry["name"] = call.name;
+    entry["input"] = call.input;
+    entry["result"] = result;
+    write(entry);
+}
+
+void SessionRecorder::write(const QJsonObject& entry) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    // NOTE: 每行立即 flush，进程崩溃时已记录的部分仍可回放
+    m_file.write(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+}
+
+qint64 SessionRecorder::elapsedSince(int seq) const {
+    return m_clock.elapsed() - m_startMs.value(seq, m_clock.elapsed());
+}
@@ -0,0 +1,51 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QFile>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include "core/agent/ToolTypes.h"
+
+/**
+ * @brief LLM 会话录制（JSON Lines 格式的 cassette）
+ *
+ * 记录每次请求的请求体、SSE 数据行（含相对请求发出时的毫秒时间戳）与结束状态，
+ * 以及每次工具调用的参数和结果，之后可由 SessionCassette 加载、ReplayServer 离线回放:
+ *   {"type":"request","seq":1,"agent":"worker-1","body":"{...}"}
+ *   {"type":"line","seq":1,"t":412,"data":"data: {...}"}
+ *   {"type":"end","seq":1,"t":3021,"status":200}
+ *   {"type":"tool","id":"call_0","name":"view_file","input":{...},"result":"..."}
+ *
+ * 启用方式：启动前设置环境变量 TMAGENT_RECORD=<文件路径>（见 LLMTransport）。
+ *
+ * NOTE: 请求体与工具结果原样写入，其中可能包含源码等敏感内容；API Key 不在请求体中，不会被记录
+ */
+class SessionRecorder {
+public:
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    /**
+     * @brief 开始记录一次请求
+     * @return 请求序号，之后的 recordLine / endExchange 用它关联（并发的 Agent 交错写入）
+     */
+    int beginExchange(const QString& agentId, const QByteArray& requestBody);
+    void recordLine(int seq, const QByteArray& line);
+    void endExchange(int seq, int status);
+
+    void recordTool(const ToolCall& call, const QString& result);
+
+private:
+    void write(const QJsonObject& entry);
+    qint64 elapsedSince(int seq) const;
+
+    QFile m_file;
+    QElapsedTimer m_clock;
+    QHash<int, qint64> m_startMs;  // 请求序号 -> 发出时间
+    int m_nextSeq = 1;
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,178 @@
+#include "SseServer.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QPointer>
+
+SseServer::SseServer(QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+{
+    connect(m_server, &QTcpServer::newConnection, this, &SseServer::onNewConnection);
+}
+
+void SseServer::setTiming(Timing timing, int intervalMs) {
+    m_timing = timing;
+    m_intervalMs = qMax(0, intervalMs);
+}
+
+bool SseServer::listen(quint16 port) {
+    return m_server->listen(QHostAddress::LocalHost, port);
+}
+
+quint16 SseServer::port() const {
+    return m_server->serverPort();
+}
+
+QString SseServer::baseUrl() const {
+    return QString("http://127.0.0.1:%1").arg(port());
+}
+
+void SseServer::onNewConnection() {
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            m_streams.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void SseServer::onReadyRead(QTcpSocket* socket) {
+    QByteArray& buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // NOTE: 只支持带 Content-Length 的请求（QNetworkAccessManager 发送 POST 时总是带上）；
+    // 同一连接上的下一个请求在当前响应结束后才会到达（客户端不做 pipelining）
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0 || m_streams.contains(socket)) {
+        return;
+    }
+    int contentLength = 0;
+    for (const QByteArray& header : buffer.left(headerEnd).split('\n')) {
+        const int colon = header.indexOf(':');
+        if (colon > 0 && header.left(colon).trimmed().toLower() == "content-length") {
+            contentLength = header.mid(colon + 1).trimmed().toInt();
+        }
+    }
+    if (buffer.size() < headerEnd + 4 + contentLength) {
+        return;
+    }
+
+    const QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+    buffer.remove(0, headerEnd + 4 + contentLength);
+    handleRequest(socket, body);
+}
+
+void SseServer::handleRequest(QTcpSocket* socket, const QByteArray& body) {
+    SseExchange response;
+    const int index = respond(body, response);
+    emit requestReceived(index, body);
+
+    if (index < 0) {
+        const QByteArray message = R"({"error":{"message":"no response available"}})";
+        socket->write("HTTP/1.1 500 Internal Server Error\r\nContent-Type: application/json\r\n"
+                      "Content-Length: " + QByteArray::number(message.size()) + "\r\n\r\n" + message);
+        return;
+    }
+
+    QByteArray extraHeaders;
+    for (const auto& header : response.headers) {
+        extraHeaders += header.first + ": " + header.second + "\r\n";
+    }
+
+    if (response.status != 200) {
+        // 错误响应（429、5xx 等）整体发送，由客户端照常走重试逻辑
+        QByteArray message;
+        for (const SseLine& line : response.lines) {
+            message += line.data + "\n";
+        }
+        const int status = response.status > 0 ? response.status : 502;  // 0 为录制时的网络错误
+        socket->write("HTTP/1.1 " + QByteArray::number(status) + " Error\r\n"
+                      "Content-Type: application/json\r\n" + extraHeaders
+                      + "Content-Length: " + QByteArray::number(message.size()) + "\r\n\r\n" + message);
+        emit responseFinished(index);
+        return;
+    }
+
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                  "Cache-Control: no-cache\r\n" + extraHeaders + "Transfer-Encoding: chunked\r\n\r\n");
+    Stream stream;
+    stream.index = index;
+    stream.response = response;
+    stream.clock.start();
+    m_streams.insert(socket, stream);
+    scheduleNext(socket);
+}
+
+void SseServer::sendNextLines(QTcpSocket* socket) {
+    auto it = m_streams.find(socket);
+    if (it == m_streams.end()) {
+        return;  // 连接已关闭
+    }
+    Stream& stream = it.value();
+    const QList<SseLine>& lines = stream.response.lines;
+
+    // 把已到发送时间的行合并成一个 chunk
+    QByteArray payload;
+    while (stream.nextLine < lines.size()) {
+        const SseLine& line = lines[stream.nextLine];
+        if (m_timing == Timing::Recorded && line.timeMs > stream.clock.elapsed()) {
+            break;
+        }
+        payload += line.data + "\n\n";
+        ++stream.nextLine;
+        if (m_timing == Timing::Fixed && m_intervalMs > 0) {
+            break;
+        }
+    }
+    if (!payload.isEmpty()) {
+        socket->write(QByteArray::number(payload.size(), 16) + "\r\n" + payload + "\r\n");
+    }
+
+    if (stream.nextLine >= lines.size()) {
+        finishStream(socket);
+        return;
+    }
+    scheduleNext(socket);
+}
+
+void SseServer::scheduleNext(QTcpSocket* socket) {
+    const Stream& stream = m_streams[socket];
+    const QList<SseLine>& lines = stream.response.lines;
+
+    int delay = m_intervalMs;
+    if (m_timing == Timing::Recorded) {
+        delay = stream.nextLine < lines.size()
+                    ? int(qMax<qint64>(0, lines[stream.nextLine].timeMs - stream.clock.elapsed()))
+                    : 0;
+    }
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delay, this, [this, guard]() {
+        if (guard) {
+            sendNextLines(guard);
+        }
+    });
+}
+
+void SseServer::finishStream(QTcpSocket* socket) {
+    const Stream stream = m_streams.take(socket);
+    switch (stream.response.ending) {
+    case SseExchange::Ending::Complete:
+        socket->write("0\r\n\r\n");
+        emit responseFinished(stream.index);
+        if (!m_buffers.value(socket).isEmpty()) {
+            onReadyRead(socket);  // 响应期间已到达的下一个请求
+        }
+        break;
+    case SseExchange::Ending::Close:
+        emit responseFinished(stream.index);
+        socket->disconnectFromHost();  // 不发送结束 chunk，客户端收到 RemoteHostClosedError
+        break;
+    case SseExchange::Ending::Hang:
+        // 保持连接直到客户端超时放弃；之后同一连接上不会再有请求
+        emit responseFinished(stream.index);
+        break;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef SSESERVER_H
+#define SSESERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include "SessionCassette.h"
+
+class QTcpServer;  // 前向声明
+class QTcpSocket;  // 前向声明
+
+/**
+ * @brief 本地 OpenAI 兼容服务的基类（HTTP/1.1 + 流式 SSE）
+ *
+ * 负责解析请求、按行的时间戳（或固定间隔）以 chunked 编码发送 SseExchange，以及注入断开与挂起；
+ * 子类只决定每个请求回复什么：
+ *   - ReplayServer：回放录制的会话
+ *   - MockLLMServer（TmMockServer 目标）：按脚本生成回复，用于压测
+ *
+ * 只监听 127.0.0.1，不校验请求路径与认证头。
+ */
+class SseServer : public QObject {
+    Q_OBJECT
+public:
+    enum class Timing {
+        Recorded,  // 按每行的时间戳发送
+        Fixed      // 每行间隔固定毫秒数（0 表示尽快发送）
+    };
+
+    explicit SseServer(QObject *parent = nullptr);
+
+    void setTiming(Timing timing, int intervalMs = 0);
+
+    /**
+     * @brief 在 127.0.0.1 上监听（port 为 0 时由系统分配）
+     */
+    bool listen(quint16 port = 0);
+    quint16 port() const;
+    QString baseUrl() const;
+
+    int activeStreams() const { return m_streams.size(); }
+
+signals:
+    void requestReceived(int exchangeIndex, const QByteArray& body);
+    void responseFinished(int exchangeIndex);
+
+protected:
+    /**
+     * @brief 为请求生成回复
+     * @return 回复的编号（随 requestReceived / responseFinished 发出）；-1 表示没有可用的回复（返回 500）
+     */
+    virtual int respond(const QByteArray& body, SseExchange& response) = 0;
+
+private:
+    // 一个连接上正在发送的响应
+    struct Stream {
+        int index = -1;
+        SseExchange response;
+        int nextLine = 0;
+        QElapsedTimer clock;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void handleRequest(QTcpSocket* socket, const QByteArray& body);
+    void sendNextLines(QTcpSocket* socket);
+    void scheduleNext(QTcpSocket* socket);
+    void finishStream(QTcpSocket* socket);
+
+    QTcpServer* m_server;
+    Timing m_timing = Timing::Recorded;
+    int m_intervalMs = 0;
+
+    QHash<QTcpSocket*, QByteArray> m_buffers;  // 未处理完的请求字节
+    QHash<QTcpSocket*, Stream> m_streams;
+};
+
+#endif // SSESERVER_H
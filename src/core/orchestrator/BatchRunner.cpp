@@ -0,0 +1,222 @@
+#include "BatchRunner.h"
+#include "Orchestrator.h"
+#include "core/events/EventBus.h"
+#include "core/log/LogCategories.h"
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QDebug>
+
+// 批量任务发布事件时使用的来源
+static const char* kBatchSource = "batch";
+
+BatchRunner::BatchRunner(QObject *parent)
+    : QObject(parent)
+    , m_orchestrator(new Orchestrator(this))
+{
+    connect(m_orchestrator, &Orchestrator::taskFinished, this, &BatchRunner::onTaskFinished);
+}
+
+void BatchRunner::setConfig(const LLMConfig& config) {
+    m_orchestrator->setConfig(config);
+}
+
+void BatchRunner::setToolDispatcher(ToolDispatcher* dispatcher) {
+    m_orchestrator->setToolDispatcher(dispatcher);
+}
+
+void BatchRunner::setRateLimiter(RateLimiter* limiter) {
+    m_orchestrator->setRateLimiter(limiter);
+}
+
+// ==================== 运行控制 ====================
+
+bool BatchRunner::start(const BatchManifest& manifest, const Options& options, QString& error) {
+    if (m_running) {
+        error = "批量任务已在运行";
+        return false;
+    }
+
+    // NOTE: 先读取检查点再以追加方式打开，结果文件同时是续跑依据
+    const QSet<QString> succeeded = BatchResultLog::loadSucceeded(options.resultsPath);
+    if (!m_log.open(options.resultsPath)) {
+        error = QString("无法打开结果文件 %1: %2").arg(options.resultsPath, m_log.errorString());
+        return false;
+    }
+
+    m_manifest = manifest;
+    m_options = options;
+    m_options.concurrency = qMax(1, options.concurrency);
+    m_queue.clear();
+    m_inFlight.clear();
+    m_retrying = 0;
+    m_skipped = 0;
+    m_succeeded = 0;
+    m_failed = 0;
+    m_canceled = false;
+    m_running = true;
+
+    for (int i = 0; i < m_manifest.items.size(); ++i) {
+        if (succeeded.contains(m_manifest.items[i].id)) {
+            ++m_skipped;
+        } else {
+            m_queue.append(ItemState{i, 0});
+        }
+    }
+    qCInfo(lcOrchestrator) << "[BatchRunner] 共" << totalCount() << "项，跳过已完成" << m_skipped
+             << "项，并发" << m_options.concurrency;
+
+    m_orchestrator->scheduler()->setGlobalLimit(m_options.concurrency);
+    fill();
+
+    // 全部已完成时也异步结束，调用方在 start 之后连接的槽同样能收到 finished
+    QMetaObject::invokeMethod(this, &BatchRunner::checkDone, Qt::QueuedConnection);
+    return true;
+}
+
+void BatchRunner::cancel() {
+    if (!m_running) {
+        return;
+    }
+    m_canceled = true;
+    m_queue.clear();
+    m_orchestrator->cancelAll();
+    checkDone();
+}
+
+QJsonObject BatchRunner::statsJson() const {
+    QJsonObject stats;
+    stats["total"] = totalCount();
+    stats["skipped"] = m_skipped;
+    stats["succeeded"] = m_succeeded;
+    stats["failed"] = m_failed;
+    stats["canceled"] = m_canceled;
+    return stats;
+}
+
+// ==================== 条目执行 ====================
+
+void BatchRunner::fill() {
+    // NOTE: Worker 可能同步失败并立即回调 onTaskFinished，这里循环提交而不是递归
+    if (m_filling) {
+        return;
+    }
+    m_filling = true;
+    while (!m_canceled && m_inFlight.size() < m_options.concurrency && !m_queue.isEmpty()) {
+        submitItem(m_queue.takeFirst());
+    }
+    m_filling = false;
+}
+
+void BatchRunner::submitItem(ItemState state) {
+    ++state.attempts;
+    const BatchItem& item = m_manifest.items[state.index];
+
+    AgentTask task;
+    task.id = state.attempts == 1 ? item.id : QString("%1#%2").arg(item.id).arg(state.attempts);
+    task.type = m_manifest.type;
+    task.prompt = m_manifest.render(item);
+    task.systemPrompt = m_manifest.systemPrompt;
+    task.allowedTools = m_manifest.allowedTools;
+    task.timeoutMs = m_manifest.timeoutMs;
+
+    // 先登记再提交，同步结束的任务也能找到对应条目
+    m_inFlight.insert(task.id, state);
+    if (m_orchestrator->submit(task).isEmpty()) {
+        m_inFlight.remove(task.id);
+        TaskResult result;
+        result.taskId = task.id;
+        result.status = TaskStatus::Failed;
+        result.summary = "任务提交失败";
+        writeRecord(state, result);
+    }
+}
+
+void BatchRunner::onTaskFinished(const TaskResult& result) {
+    auto it = m_inFlight.find(result.taskId);
+    if (it == m_inFlight.end()) {
+        return;
+    }
+    const ItemState state = it.value();
+    m_inFlight.erase(it);
+
+    const bool retryable = result.status == TaskStatus::Failed || result.status == TaskStatus::TimedOut;
+    if (retryable && !m_canceled && state.attempts < m_manifest.maxAttempts) {
+        scheduleRetry(state);
+    } else if (result.status != TaskStatus::Canceled) {
+        writeRecord(state, result);
+    }
+
+    fill();
+    checkDone();
+}
+
+void BatchRunner::writeRecord(const ItemState& state, const TaskResult& result) {
+    const BatchItem& item = m_manifest.items[state.index];
+
+    QJsonObject record;
+    record["id"] = item.id;
+    record["status"] = taskStatusName(result.status);
+    record["attempts"] = state.attempts;
+    record["agentId"] = result.agentId;
+    record["summary"] = result.summary;
+    record["metrics"] = result.metrics;
+    record["finishedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    m_log.append(record);
+
+    if (result.succeeded()) {
+        ++m_succeeded;
+    } else {
+        ++m_failed;
+    }
+    emit itemFinished(record);
+
+    const int done = m_skipped + m_succeeded + m_failed;
+    EventBus& bus = EventBus::instance();
+    bus.publish(AgentEvent::log(kBatchSource, EventChannel::BATCH,
+        QString("%1 %2 (%3/%4)").arg(item.id, taskStatusName(result.status)).arg(done).arg(totalCount()),
+        record));
+    bus.publish(AgentEvent::progress(kBatchSource, "items", double(done) / totalCount()));
+}
+
+void BatchRunner::scheduleRetry(const ItemState& state) {
+    const int delay = backoffDelay(state.attempts);
+    qCDebug(lcOrchestrator) << "[BatchRunner]" << m_manifest.items[state.index].id << "第" << state.attempts
+             << "次尝试失败，" << delay << "ms 后重试";
+
+    ++m_retrying;
+    QTimer::singleShot(delay, this, [this, state]() {
+        --m_retrying;
+        if (!m_running || m_canceled) {
+            return;
+        }
+        m_queue.prepend(state);  // 重试优先于新条目，尽早得出该条目的最终结果
+        fill();
+        checkDone();
+    });
+}
+
+int BatchRunner::backoffDelay(int attempts) const {
+    // 指数退避 + 随机抖动（取 [delay/2, delay)），避免多个失败条目同时重试
+    const qint64 exponential = qint64(m_options.backoffBaseMs) << qMin(attempts - 1, 16);
+    const int delay = int(qMin<qint64>(exponential, m_options.backoffMaxMs));
+    return delay / 2 + QRandomGenerator::global()->bounded(qMax(1, delay / 2));
+}
+
+void BatchRunner::checkDone() {
+    if (!m_running || !m_inFlight.isEmpty() || !m_queue.isEmpty()) {
+        return;
+    }
+    // 取消时不等待退避中的重试
+    if (m_retrying > 0 && !m_canceled) {
+        return;
+    }
+
+    m_running = false;
+    m_log.close();
+    qCInfo(lcOrchestrator) << "[BatchRunner] 结束: 成功" << m_succeeded << "失败" << m_failed << "跳过" << m_skipped;
+
+    EventBus::instance().publish(AgentEvent::finished(kBatchSource, EventChannel::BATCH,
+        QString("成功 %1, 失败 %2, 跳过 %3").arg(m_succeeded).arg(m_failed).arg(m_skipped), statsJson()));
+    emit finished();
+}
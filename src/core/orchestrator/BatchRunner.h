@@ -0,0 +1,93 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include "BatchTypes.h"
+#include "TaskTypes.h"
+#include "core/agent/ToolTypes.h"
+
+class Orchestrator;    // 前向声明
+class ToolDispatcher;  // 前向声明
+class RateLimiter;     // 前向声明
+
+/**
+ * @brief 批量任务执行器
+ *
+ * 按清单为每个条目生成一个独立任务，交给 Orchestrator 的 Worker 池并发执行（最多 concurrency 个在途），
+ * 失败或超时的条目按指数退避（带随机抖动）重试，最终结果逐行追加到结果文件。
+ * 重新运行同一清单时跳过结果文件中已成功的条目，实现断点续跑。
+ *
+ * 进度与结束通过 EventBus 发布（来源 "batch"）。
+ */
+class BatchRunner : public QObject {
+    Q_OBJECT
+public:
+    struct Options {
+        QString resultsPath;         // 结果文件（JSON Lines）
+        int concurrency = 4;         // 同时执行的 Agent 数
+        int backoffBaseMs = 2000;    // 第一次重试前的等待
+        int backoffMaxMs = 60000;    // 重试等待上限
+    };
+
+    explicit BatchRunner(QObject *parent = nullptr);
+
+    void setConfig(const LLMConfig& config);
+    void setToolDispatcher(ToolDispatcher* dispatcher);
+    void setRateLimiter(RateLimiter* limiter);
+
+    /**
+     * @brief 开始执行
+     * @return 结果文件无法打开时返回 false（error 给出原因）
+     */
+    bool start(const BatchManifest& manifest, const Options& options, QString& error);
+
+    /**
+     * @brief 取消剩余条目（已取消的条目不写入结果文件，续跑时会重新执行）
+     */
+    void cancel();
+
+    int totalCount() const { return m_manifest.items.size(); }
+    int skippedCount() const { return m_skipped; }
+    int succeededCount() const { return m_succeeded; }
+    int failedCount() const { return m_failed; }
+    bool isRunning() const { return m_running; }
+
+    QJsonObject statsJson() const;
+
+signals:
+    void itemFinished(const QJsonObject& record);
+    void finished();
+
+private:
+    struct ItemState {
+        int index = 0;      // 在清单中的位置
+        int attempts = 0;   // 已开始的尝试次数
+    };
+
+    void fill();
+    void submitItem(ItemState state);
+    void onTaskFinished(const TaskResult& result);
+    void writeRecord(const ItemState& state, const TaskResult& result);
+    void scheduleRetry(const ItemState& state);
+    void checkDone();
+    int backoffDelay(int attempts) const;
+
+    Orchestrator* m_orchestrator;
+    BatchManifest m_manifest;
+    Options m_options;
+    BatchResultLog m_log;
+
+    QList<ItemState> m_queue;                 // 等待执行（含退避结束的重试）
+    QHash<QString, ItemState> m_inFlight;     // 任务 ID -> 条目状态
+    int m_retrying = 0;                       // 退避等待中的条目数
+    int m_skipped = 0;
+    int m_succeeded = 0;
+    int m_failed = 0;
+    bool m_running = false;
+    bool m_canceled = false;
+    bool m_filling = false;
+};
+
+#endif // BATCHRUNNER_H
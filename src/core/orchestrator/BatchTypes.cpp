@@ -0,0 +1,137 @@
+#include "BatchTypes.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QVariant>
+#include <QHash>
+
+// ==================== BatchManifest ====================
+
+bool BatchManifest::fromJson(const QJsonObject& json, BatchManifest& manifest, QString& error) {
+    manifest = BatchManifest();
+    manifest.promptTemplate = json["template"].toString();
+    if (manifest.promptTemplate.trimmed().isEmpty()) {
+        error = "清单缺少 template";
+        return false;
+    }
+
+    manifest.type = json["type"].toString(manifest.type);
+    manifest.systemPrompt = json["systemPrompt"].toString();
+    for (const QJsonValue& value : json["allowedTools"].toArray()) {
+        manifest.allowedTools.append(value.toString());
+    }
+    manifest.timeoutMs = json["timeoutMs"].toInt();
+    manifest.maxAttempts = qMax(1, json["maxAttempts"].toInt(manifest.maxAttempts));
+
+    QSet<QString> ids;
+    const QJsonArray items = json["items"].toArray();
+    for (int i = 0; i < items.size(); ++i) {
+        BatchItem item;
+        if (items[i].isString()) {
+            item.id = items[i].toString();
+            item.vars["item"] = item.id;
+        } else if (items[i].isObject()) {
+            item.vars = items[i].toObject();
+            item.id = item.vars["id"].toString();
+            if (item.id.isEmpty()) {
+                item.id = QString("item-%1").arg(i + 1);
+            }
+        } else {
+            error = QString("第 %1 个条目既不是字符串也不是对象").arg(i + 1);
+            return false;
+        }
+
+        if (ids.contains(item.id)) {
+            error = QString("条目 ID 重复: %1").arg(item.id);
+            return false;
+        }
+        ids.insert(item.id);
+        manifest.items.append(item);
+    }
+
+    if (manifest.items.isEmpty()) {
+        error = "清单中没有条目";
+        return false;
+    }
+    return true;
+}
+
+QString BatchManifest::render(const BatchItem& item) const {
+    static const QRegularExpression placeholder(R"(\{\{\s*(\w+)\s*\}\})");
+
+    QString prompt;
+    int last = 0;
+    QRegularExpressionMatchIterator it = placeholder.globalMatch(promptTemplate);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        prompt += promptTemplate.midRef(last, match.capturedStart() - last);
+
+        const QString name = match.captured(1);
+        if (name == "id") {
+            prompt += item.id;
+        } else if (item.vars.contains(name)) {
+            prompt += item.vars[name].toVariant().toString();
+        } else {
+            prompt += match.captured(0);  // 未知变量原样保留，便于发现清单错误
+        }
+        last = match.capturedEnd();
+    }
+    prompt += promptTemplate.midRef(last);
+    return prompt;
+}
+
+// ==================== BatchResultLog ====================
+
+bool BatchResultLog::open(const QString& path) {
+    // NOTE: 上次中断可能留下没有换行的半行，先补换行，避免新记录接在半行后面一起失效
+    bool needsNewline = false;
+    QFile existing(path);
+    if (existing.size() > 0 && existing.open(QIODevice::ReadOnly)) {
+        existing.seek(existing.size() - 1);
+        needsNewline = existing.read(1) != "\n";
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    if (needsNewline) {
+        m_file.write("\n");
+    }
+    return true;
+}
+
+void BatchResultLog::append(const QJsonObject& record) {
+    m_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+}
+
+void BatchResultLog::close() {
+    m_file.close();
+}
+
+QSet<QString> BatchResultLog::loadSucceeded(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QSet<QString>();  // 首次运行
+    }
+
+    QHash<QString, bool> latest;  // ID -> 最后一行是否成功
+    while (!file.atEnd()) {
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readLine());
+        if (!doc.isObject()) {
+            continue;  // 中断时写了一半的行
+        }
+        const QJsonObject record = doc.object();
+        latest.insert(record["id"].toString(), record["status"].toString() == "succeeded");
+    }
+
+    QSet<QString> succeeded;
+    for (auto it = latest.constBegin(); it != latest.constEnd(); ++it) {
+        if (it.value()) {
+            succeeded.insert(it.key());
+        }
+    }
+    return succeeded;
+}
@@ -0,0 +1,78 @@
+#ifndef BATCHTYPES_H
+#define BATCHTYPES_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+#include <QFile>
+#include <QJsonObject>
+
+/**
+ * @brief 批量任务的数据结构
+ *
+ * 清单（manifest）用同一个提示词模板批量生成任务:
+ *   {
+ *     "template": "审查 {{file}} 中的资源泄漏，输出问题列表",
+ *     "type": "read_file",             // 可选，任务类型（决定默认资源锁）
+ *     "systemPrompt": "...",           // 可选
+ *     "allowedTools": ["view_file"],   // 可选
+ *     "timeoutMs": 300000,             // 可选，单个任务超时
+ *     "maxAttempts": 3,                // 可选，失败/超时后的最大尝试次数
+ *     "items": ["src/a.cpp", {"id": "b", "file": "src/b.cpp"}]
+ *   }
+ *
+ * 字符串条目以自身为 ID，模板中用 {{item}} 引用；对象条目的每个字段都可在模板中引用。
+ */
+
+// 批量任务中的一项
+struct BatchItem {
+    QString id;
+    QJsonObject vars;  // 模板变量
+};
+
+// 批量任务清单
+struct BatchManifest {
+    QString promptTemplate;
+    QString type = "batch";
+    QString systemPrompt;
+    QStringList allowedTools;
+    int timeoutMs = 0;
+    int maxAttempts = 3;
+    QList<BatchItem> items;
+
+    /**
+     * @brief 从清单 JSON 解析
+     * @return 成功返回 true；失败时 error 给出原因（缺少模板、条目 ID 重复等）
+     */
+    static bool fromJson(const QJsonObject& json, BatchManifest& manifest, QString& error);
+
+    /**
+     * @brief 用条目变量渲染提示词（{{id}} 与 {{name}}，未知变量原样保留）
+     */
+    QString render(const BatchItem& item) const;
+};
+
+/**
+ * @brief 批量结果文件（JSON Lines，同时作为断点续跑的检查点）
+ *
+ * 每个条目结束时追加一行并立即 flush，进程中断后最多丢失正在执行的条目。
+ * 同一 ID 以最后一行为准；末尾写了一半的行在加载时忽略。
+ */
+class BatchResultLog {
+public:
+    bool open(const QString& path);
+    void append(const QJsonObject& record);
+    void close();
+    QString errorString() const { return m_file.errorString(); }
+
+    /**
+     * @brief 读取已成功完成的条目 ID（续跑时跳过）
+     */
+    static QSet<QString> loadSucceeded(const QString& path);
+
+private:
+    QFile m_file;
+};
+
+#endif // BATCHTYPES_H
@@ -0,0 +1,216 @@
+#include "Orchestrator.h"
+#include "core/agent/LLMAgent.h"
+#include "core/agent/ToolDispatcher.h"
+#include "core/events/EventBus.h"
+#include "core/log/LogCategories.h"
+#include <QTimer>
+#include <QDebug>
+
+Orchestrator::Orchestrator(QObject *parent) : QObject(parent) {
+    connect(&m_scheduler, &TaskScheduler::taskReady, this, &Orchestrator::startTask);
+    connect(&m_scheduler, &TaskScheduler::taskSkipped, this, &Orchestrator::onTaskSkipped);
+    connect(&m_scheduler, &TaskScheduler::idle, this, &Orchestrator::allFinished);
+}
+
+void Orchestrator::setConfig(const LLMConfig& config) {
+    m_config = config;
+}
+
+void Orchestrator::setToolDispatcher(ToolDispatcher* dispatcher) {
+    m_toolDispatcher = dispatcher;
+    for (LLMAgent* worker : m_workers) {
+        worker->setToolDispatcher(dispatcher);
+    }
+}
+
+void Orchestrator::setRateLimiter(RateLimiter* limiter) {
+    m_rateLimiter = limiter;
+    for (LLMAgent* worker : m_workers) {
+        worker->setRateLimiter(limiter);
+    }
+}
+
+// ==================== 任务管理 ====================
+
+QString Orchestrator::submit(AgentTask task) {
+    // NOTE: Worker 比当前层级低一级，已到最大层级时不能再派生
+    const LLMConfig& base = task.config ? *task.config : m_config;
+    if (!base.canDelegate()) {
+        qCWarning(lcOrchestrator) << "[Orchestrator] 层级" << base.agentLevel << "已达上限，无法派生 Worker";
+        return QString();
+    }
+
+    if (task.id.isEmpty()) {
+        task.id = QString("task-%1").arg(m_nextTaskId++);
+    }
+    task.applyDefaultLocks();
+
+    if (!m_scheduler.enqueue(task)) {
+        return QString();
+    }
+    return task.id;
+}
+
+void Orchestrator::cancel(const QString& taskId) {
+    if (m_scheduler.cancelPending(taskId)) {
+        return;
+    }
+    if (m_executions.contains(taskId)) {
+        finishTask(taskId, TaskStatus::Canceled, "任务已取消");
+    }
+}
+
+void Orchestrator::cancelAll() {
+    // 先清空等待队列，避免运行中的任务结束后放行新任务
+    for (const QString& taskId : m_scheduler.pendingIds()) {
+        m_scheduler.cancelPending(taskId);
+    }
+    for (const QString& taskId : m_executions.keys()) {
+        finishTask(taskId, TaskStatus::Canceled, "任务已取消");
+    }
+}
+
+// ==================== 任务执行 ====================
+
+void Orchestrator::startTask(const AgentTask& task) {
+    LLMAgent* worker = acquireWorker();
+    worker->setConfig(workerConfig(task, worker));
+
+    Execution execution;
+    execution.task = task;
+    execution.worker = worker;
+    execution.elapsed.start();
+
+    if (task.timeoutMs > 0) {
+        execution.timer = new QTimer(this);
+        execution.timer->setSingleShot(true);
+        const QString taskId = task.id;
+        connect(execution.timer, &QTimer::timeout, this, [this, taskId]() {
+            finishTask(taskId, TaskStatus::TimedOut, "任务超时");
+        });
+        execution.timer->start(task.timeoutMs);
+    }
+
+    // NOTE: 先登记再发起请求，请求同步失败时 finishTask 也能找到该任务
+    m_workerTasks.insert(worker, task.id);
+    m_executions.insert(task.id, execution);
+
+    qCDebug(lcOrchestrator) << "[Orchestrator]" << m_workerIds.value(worker) << "开始执行任务" << task.id;
+    emit taskStarted(task, m_workerIds.value(worker));
+
+    // 每个任务使用独立的上下文（askOnce 会清空 Worker 之前的对话）
+    worker->askOnce(task.prompt);
+}
+
+void Orchestrator::finishTask(const QString& taskId, TaskStatus status, const QString& summary) {
+    auto it = m_executions.find(taskId);
+    if (it == m_executions.end()) {
+        return;
+    }
+    const Execution execution = it.value();
+    m_executions.erase(it);
+
+    if (execution.timer) {
+        execution.timer->stop();
+        execution.timer->deleteLater();
+    }
+
+    // NOTE: 先解除任务关联再中断，中断引发的信号不会再归到该任务上
+    m_workerTasks.remove(execution.worker);
+    if (status != TaskStatus::Succeeded) {
+        execution.worker->abort();
+    }
+    m_idleWorkers.append(execution.worker);
+
+    TaskResult result;
+    result.taskId = taskId;
+    result.type = execution.task.type;
+    result.agentId = m_workerIds.value(execution.worker);
+    result.status = status;
+    result.summary = summary;
+    result.metrics["durationMs"] = execution.elapsed.elapsed();
+    result.metrics["toolCalls"] = execution.toolCalls;
+    result.metrics["promptTokens"] = execution.usage.promptTokens;
+    result.metrics["completionTokens"] = execution.usage.completionTokens;
+    result.metrics["cachedPromptTokens"] = execution.usage.cachedPromptTokens;
+    m_results.insert(taskId, result);
+
+    qCDebug(lcOrchestrator) << "[Orchestrator] 任务" << taskId << "结束:" << taskStatusName(status)
+             << "耗时" << execution.elapsed.elapsed() << "ms";
+    emit taskFinished(result);
+    EventBus::instance().publish(AgentEvent::finished(result.taskId, EventChannel::TASK, result.summary, result.toJson()));
+
+    // 释放并发名额与资源锁，放行等待中的任务
+    m_scheduler.complete(taskId, status);
+}
+
+void Orchestrator::onTaskSkipped(const AgentTask& task, TaskStatus status, const QString& reason) {
+    TaskResult result;
+    result.taskId = task.id;
+    result.type = task.type;
+    result.status = status;
+    result.summary = reason;
+    m_results.insert(task.id, result);
+    emit taskFinished(result);
+    EventBus::instance().publish(AgentEvent::finished(result.taskId, EventChannel::TASK, result.summary, result.toJson()));
+}
+
+// ==================== Worker 管理 ====================
+
+LLMAgent* Orchestrator::acquireWorker() {
+    if (!m_idleWorkers.isEmpty()) {
+        return m_idleWorkers.takeLast();
+    }
+
+    // NOTE: Worker 数量由调度器的全局并发上限间接约束
+    LLMAgent* worker = new LLMAgent(this);
+    const QString parentId = m_config.agentId.isEmpty() ? QString("agent") : m_config.agentId;
+    m_workerIds.insert(worker, QString("%1-worker-%2").arg(parentId).arg(m_workers.size() + 1));
+    m_workers.append(worker);
+
+    if (m_toolDispatcher) {
+        worker->setToolDispatcher(m_toolDispatcher);
+    }
+    worker->setRateLimiter(m_rateLimiter);
+
+    connect(worker, &LLMAgent::finished, this, [this, worker](const QString& content) {
+        const QString taskId = m_workerTasks.value(worker);
+        if (!taskId.isEmpty()) {
+            finishTask(taskId, TaskStatus::Succeeded, content);
+        }
+    });
+    connect(worker, &LLMAgent::errorOccurred, this, [this, worker](const QString& errorMsg) {
+        const QString taskId = m_workerTasks.value(worker);
+        if (!taskId.isEmpty()) {
+            finishTask(taskId, TaskStatus::Failed, errorMsg);
+        }
+    });
+    connect(worker, &LLMAgent::toolEvent, this, [this, worker](const ToolExecutionEvent& event) {
+        auto it = m_executions.find(m_workerTasks.value(worker));
+        if (it != m_executions.end() && event.status == "started") {
+            ++it->toolCalls;
+        }
+    });
+    connect(worker, &LLMAgent::usageReported, this, [this, worker](const TokenUsage& usage) {
+        auto it = m_executions.find(m_workerTasks.value(worker));
+        if (it != m_executions.end()) {
+            it->usage += usage;
+        }
+    });
+
+    return worker;
+}
+
+LLMConfig Orchestrator::workerConfig(const AgentTask& task, LLMAgent* worker) const {
+    LLMConfig config = task.config ? *task.config : m_config;
+    config.agentId = m_workerIds.value(worker);
+    config.agentName = task.type;
+    config.agentLevel += 1;
+    if (!task.systemPrompt.isEmpty()) {
+        config.systemPrompt = task.systemPrompt;
+    }
+    if (!task.allowedTools.isEmpty()) {
+        config.allowedTools = task.allowedTools;
+    }
+    return config;
+}
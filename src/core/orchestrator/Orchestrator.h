@@ -0,0 +1,119 @@
+#ifndef ORCHESTRATOR_H
+#define ORCHESTRATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QElapsedTimer>
+#include "TaskTypes.h"
+#include "TaskScheduler.h"
+#include "core/agent/ToolTypes.h"
+
+class LLMAgent;        // 前向声明
+class ToolDispatcher;  // 前向声明
+class RateLimiter;     // 前向声明
+class QTimer;          // 前向声明
+
+/**
+ * @brief 主 Agent（设计文档第 2、3 节的 Orchestrator 层）
+ *
+ * 维护一组 LLMAgent Worker，把提交的任务交给 TaskScheduler 排队，
+ * 调度器放行后取一个空闲 Worker 执行，结束时汇总为 TaskResult。
+ *
+ * 相互独立的任务（如同时搜索三个模块）由多个 Worker 并发执行，
+ * 每个 Worker 有独立的对话上下文，互不干扰。
+ *
+ * 使用方式:
+ *   Orchestrator orchestrator;
+ *   orchestrator.setConfig(config);
+ *   orchestrator.setToolDispatcher(dispatcher);
+ *   connect(&orchestrator, &Orchestrator::taskFinished, ...);
+ *   orchestrator.submit(task);
+ */
+class Orchestrator : public QObject {
+    Q_OBJECT
+public:
+    explicit Orchestrator(QObject *parent = nullptr);
+
+    /**
+     * @brief 设置基础配置，Worker 在其基础上 agentLevel + 1
+     * @note 任务自带 config 时以任务的为准
+     */
+    void setConfig(const LLMConfig& config);
+    LLMConfig config() const { return m_config; }
+
+    /**
+     * @brief 设置 Worker 使用的工具调度器（生命周期由外部管理）
+     */
+    void setToolDispatcher(ToolDispatcher* dispatcher);
+
+    /**
+     * @brief 设置所有 Worker 共享的请求限流器（生命周期由外部管理）
+     * @note 为空时 Worker 使用 LLMTransport 的全局限流器；需要独立配额（如另一个 API Key）时才单独设置
+     */
+    void setRateLimiter(RateLimiter* limiter);
+
+    TaskScheduler* scheduler() { return &m_scheduler; }
+
+    // ==================== 任务管理 ====================
+
+    /**
+     * @brief 提交任务
+     * @return 任务 ID（task.id 为空时自动分配）；提交失败返回空字符串
+     */
+    QString submit(AgentTask task);
+
+    /**
+     * @brief 取消任务（等待中的直接移出队列，运行中的中断 Worker）
+     */
+    void cancel(const QString& taskId);
+    void cancelAll();
+
+    bool isIdle() const { return m_scheduler.isIdle(); }
+    bool hasResult(const QString& taskId) const { return m_results.contains(taskId); }
+    TaskResult result(const QString& taskId) const { return m_results.value(taskId); }
+    QList<TaskResult> results() const { return m_results.values(); }
+
+    int workerCount() const { return m_workers.size(); }
+
+signals:
+    void taskStarted(const AgentTask& task, const QString& agentId);
+    void taskFinished(const TaskResult& result);
+
+    // 所有已提交的任务都已结束
+    void allFinished();
+
+private:
+    // 运行中任务的执行状态
+    struct Execution {
+        AgentTask task;
+        LLMAgent* worker = nullptr;
+        QTimer* timer = nullptr;
+        QElapsedTimer elapsed;
+        int toolCalls = 0;
+        TokenUsage usage;
+    };
+
+    void startTask(const AgentTask& task);
+    void finishTask(const QString& taskId, TaskStatus status, const QString& summary);
+    void onTaskSkipped(const AgentTask& task, TaskStatus status, const QString& reason);
+
+    LLMAgent* acquireWorker();
+    LLMConfig workerConfig(const AgentTask& task, LLMAgent* worker) const;
+
+    LLMConfig m_config;
+    ToolDispatcher* m_toolDispatcher = nullptr;
+    RateLimiter* m_rateLimiter = nullptr;
+    TaskScheduler m_scheduler;
+
+    QList<LLMAgent*> m_workers;                 // 所有 Worker
+    QList<LLMAgent*> m_idleWorkers;             // 空闲 Worker
+    QHash<LLMAgent*, QString> m_workerIds;      // Worker -> agentId
+    QHash<LLMAgent*, QString> m_workerTasks;    // 忙碌 Worker -> 任务 ID
+    QHash<QString, Execution> m_executions;     // 任务 ID -> 执行状态
+    QHash<QString, TaskResult> m_results;       // 任务 ID -> 结果
+
+    int m_nextTaskId = 1;
+};
+
+#endif // ORCHESTRATOR_H
@@ -0,0 +1,59 @@
+#include "TaskLockTable.h"
+
+TaskLockTable::TaskLockTable(QObject *parent) : QObject(parent) {
+}
+
+bool TaskLockTable::available(const AgentTask& task, const QSet<QString>& reserved) const {
+    for (const QString& lock : task.exclusiveLocks) {
+        if (reserved.contains(lock)
+            || !onlyAncestors(m_exclusiveHolders.value(lock), task)
+            || !onlyAncestors(m_sharedHolders.value(lock), task)) {
+            return false;
+        }
+    }
+    for (const QString& lock : task.sharedLocks) {
+        if (reserved.contains(lock) || !onlyAncestors(m_exclusiveHolders.value(lock), task)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TaskLockTable::acquire(const AgentTask& task) {
+    for (const QString& lock : task.exclusiveLocks) {
+        m_exclusiveHolders[lock].append(task.id);
+    }
+    for (const QString& lock : task.sharedLocks) {
+        m_sharedHolders[lock].append(task.id);
+    }
+}
+
+void TaskLockTable::release(const AgentTask& task) {
+    auto releaseFrom = [&task](QHash<QString, QStringList>& holders, const QStringList& locks) {
+        for (const QString& lock : locks) {
+            auto it = holders.find(lock);
+            if (it == holders.end()) {
+                continue;
+            }
+            it->removeOne(task.id);
+            if (it->isEmpty()) {
+                holders.erase(it);
+            }
+        }
+    };
+    releaseFrom(m_exclusiveHolders, task.exclusiveLocks);
+    releaseFrom(m_sharedHolders, task.sharedLocks);
+
+    if (!task.exclusiveLocks.isEmpty() || !task.sharedLocks.isEmpty()) {
+        emit released();
+    }
+}
+
+bool TaskLockTable::onlyAncestors(const QStringList& holders, const AgentTask& task) {
+    for (const QString& holder : holders) {
+        if (!task.lockParents.contains(holder)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+#ifndef TASKLOCKTABLE_H
+#define TASKLOCKTABLE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include "TaskTypes.h"
+
+/**
+ * @brief 资源锁表（共享 / 独占），可由多个 TaskScheduler 共用
+ *
+ * 每个 TaskScheduler 默认使用自己的锁表；SubAgentDelegator 为每个层级创建一个 Orchestrator，
+ * 这些调度器共用同一张锁表，不同层级的子 Agent 之间独占锁同样生效。
+ *
+ * 子 Agent 在父任务持有的锁之下运行：task.lockParents 中的祖先任务持有的锁不阻塞该任务，
+ * 否则父任务独占 workspace 后委派的只读子任务会与父任务互相等待。
+ */
+class TaskLockTable : public QObject {
+    Q_OBJECT
+public:
+    explicit TaskLockTable(QObject *parent = nullptr);
+
+    /**
+     * @brief 任务申请的锁是否都可获得
+     * @param reserved 调用方等待队列中排在前面的任务申请的独占锁
+     */
+    bool available(const AgentTask& task, const QSet<QString>& reserved) const;
+
+    void acquire(const AgentTask& task);
+    void release(const AgentTask& task);
+
+    bool isHeld(const QString& lock) const {
+        return m_exclusiveHolders.contains(lock) || m_sharedHolders.contains(lock);
+    }
+
+signals:
+    // 有锁被释放，共用锁表的其他调度器需要重新调度
+    void released();
+
+private:
+    static bool onlyAncestors(const QStringList& holders, const AgentTask& task);
+
+    QHash<QString, QStringList> m_sharedHolders;     // 锁名 -> 共享持有任务
+    QHash<QString, QStringList> m_exclusiveHolders;  // 锁名 -> 独占持有任务（祖先与子任务可嵌套持有）
+};
+
+#endif // TASKLOCKTABLE_H
@@ -0,0 +1,211 @@
+#include "TaskScheduler.h"
+#include "core/log/LogCategories.h"
+#include <QDebug>
+
+TaskScheduler::TaskScheduler(QObject *parent) : QObject(parent) {
+    // NOTE: 并发构建会争抢 builddir 与 CPU，默认串行
+    m_typeLimits.insert(TaskType::BUILD, 1);
+}
+
+// ==================== 并发限制 ====================
+
+void TaskScheduler::setGlobalLimit(int limit) {
+    m_globalLimit = qMax(1, limit);
+    schedule();
+}
+
+void TaskScheduler::setTypeLimit(const QString& type, int limit) {
+    if (limit > 0) {
+        m_typeLimits.insert(type, limit);
+    } else {
+        m_typeLimits.remove(type);
+    }
+    schedule();
+}
+
+// ==================== 资源锁 ====================
+
+void TaskScheduler::setLockTable(TaskLockTable* locks) {
+    if (m_locks != &m_ownLocks) {
+        disconnect(m_locks, &TaskLockTable::released, this, nullptr);
+    }
+    m_locks = locks ? locks : &m_ownLocks;
+    if (m_locks != &m_ownLocks) {
+        // NOTE: 排队调用，其他调度器 complete 的调用栈中不会同步启动本调度器的任务
+        connect(m_locks, &TaskLockTable::released, this, &TaskScheduler::schedule, Qt::QueuedConnection);
+    }
+}
+
+// ==================== 任务管理 ====================
+
+bool TaskScheduler::enqueue(const AgentTask& task) {
+    if (task.id.isEmpty() || m_running.contains(task.id) || m_finished.contains(task.id)) {
+        qCWarning(lcOrchestrator) << "[TaskScheduler] 任务 ID 为空或重复:" << task.id;
+        return false;
+    }
+    for (const AgentTask& pending : m_pending) {
+        if (pending.id == task.id) {
+            qCWarning(lcOrchestrator) << "[TaskScheduler] 任务 ID 重复:" << task.id;
+            return false;
+        }
+    }
+
+    m_pending.append(task);
+    m_hasWork = true;
+    schedule();
+    return true;
+}
+
+void TaskScheduler::complete(const QString& taskId, TaskStatus status) {
+    auto it = m_running.find(taskId);
+    if (it == m_running.end()) {
+        qCWarning(lcOrchestrator) << "[TaskScheduler] 任务不在运行中:" << taskId;
+        return;
+    }
+
+    const AgentTask task = it.value();
+    m_running.erase(it);
+    m_locks->release(task);
+    m_typeRunning[task.type] -= 1;
+    m_finished.insert(taskId, status);
+
+    schedule();
+}
+
+bool TaskScheduler::cancelPending(const QString& taskId) {
+    for (int i = 0; i < m_pending.size(); ++i) {
+        if (m_pending[i].id == taskId) {
+            const AgentTask task = m_pending.takeAt(i);
+            m_finished.insert(taskId, TaskStatus::Canceled);
+            emit taskSkipped(task, TaskStatus::Canceled, "任务已取消");
+            // 依赖该任务的后续任务随之跳过
+            schedule();
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList TaskScheduler::pendingIds() const {
+    QStringList ids;
+    for (const AgentTask& task : m_pending) {
+        ids.append(task.id);
+    }
+    return ids;
+}
+
+TaskStatus TaskScheduler::status(const QString& taskId) const {
+    if (m_running.contains(taskId)) {
+        return TaskStatus::Running;
+    }
+    return m_finished.value(taskId, TaskStatus::Pending);
+}
+
+// ==================== 调度 ====================
+
+void TaskScheduler::schedule() {
+    if (m_scheduling) {
+        m_rescheduleRequested = true;
+        return;
+    }
+    m_scheduling = true;
+
+    do {
+        m_rescheduleRequested = false;
+
+        struct Skipped {
+            AgentTask task;
+            QString reason;
+        };
+        QList<AgentTask> ready;
+        QList<Skipped> skipped;
+        QSet<QString> reserved;  // 前面等待中的任务申请的独占锁
+
+        for (int i = 0; i < m_pending.size(); ) {
+            if (m_running.size() >= m_globalLimit) {
+                break;
+            }
+
+            const AgentTask& task = m_pending[i];
+            QString failedReason;
+            if (!dependenciesMet(task, &failedReason)) {
+                if (!failedReason.isEmpty()) {
+                    m_finished.insert(task.id, TaskStatus::Canceled);
+                    skipped.append(Skipped{m_pending.takeAt(i), failedReason});
+                    continue;
+                }
+                ++i;
+                continue;
+            }
+
+            const int limit = m_typeLimits.value(task.type, 0);
+            if (limit > 0 && m_typeRunning.value(task.type, 0) >= limit) {
+                ++i;
+                continue;
+            }
+
+            if (!m_locks->available(task, reserved)) {
+                for (const QString& lock : task.exclusiveLocks) {
+                    reserved.insert(lock);
+                }
+                ++i;
+                continue;
+            }
+
+            AgentTask started = m_pending.takeAt(i);
+            m_locks->acquire(started);
+            m_typeRunning[started.type] += 1;
+            m_running.insert(started.id, started);
+            ready.append(started);
+        }
+
+        // NOTE: 扫描结束后再发信号，槽函数中增删任务不会影响本轮遍历
+        for (const Skipped& item : skipped) {
+            qCDebug(lcOrchestrator) << "[TaskScheduler] 跳过任务" << item.task.id << ":" << item.reason;
+            emit taskSkipped(item.task, TaskStatus::Canceled, item.reason);
+        }
+        for (const AgentTask& task : ready) {
+            qCDebug(lcOrchestrator) << "[TaskScheduler] 开始任务" << task.id << "类型:" << task.type
+                     << "运行中:" << m_running.size() << "/" << m_globalLimit;
+            emit taskReady(task);
+        }
+
+        // 跳过的任务可能使其他依赖它的任务也需要跳过
+        if (!skipped.isEmpty()) {
+            m_rescheduleRequested = true;
+        }
+    } while (m_rescheduleRequested);
+
+    m_scheduling = false;
+
+    if (m_hasWork && isIdle()) {
+        m_hasWork = false;
+        emit idle();
+    }
+}
+
+bool TaskScheduler::dependenciesMet(const AgentTask& task, QString* failedReason) const {
+    bool met = true;
+    for (const QString& dep : task.dependsOn) {
+        if (m_finished.contains(dep)) {
+            const TaskStatus depStatus = m_finished.value(dep);
+            if (depStatus != TaskStatus::Succeeded) {
+                *failedReason = QString("依赖任务 %1 未成功 (%2)").arg(dep, taskStatusName(depStatus));
+                return false;
+            }
+            continue;
+        }
+
+        bool known = m_running.contains(dep);
+        for (int i = 0; !known && i < m_pending.size(); ++i) {
+            known = m_pending[i].id == dep;
+        }
+        if (!known) {
+            // NOTE: 依赖必须先于依赖方提交
+            *failedReason = QString("依赖任务 %1 不存在").arg(dep);
+            return false;
+        }
+        met = false;
+    }
+    return met;
+}
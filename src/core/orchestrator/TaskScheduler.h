@@ -0,0 +1,113 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include "TaskTypes.h"
+#include "TaskLockTable.h"
+
+/**
+ * @brief 任务调度器（设计文档 8.4）
+ *
+ * 只负责决定"哪个任务现在可以开始"，不关心任务如何执行:
+ *   - 并发限制: 全局上限 + 按任务类型的上限
+ *   - 资源锁: 共享/独占两种模式，如多个搜索任务共享 workspace，补丁任务独占 workspace
+ *   - 依赖: dependsOn 中的任务全部成功后才开始；任一依赖失败则跳过
+ *
+ * 按提交顺序调度；排在前面的任务因独占锁等待时，后面申请同一把锁的任务也会等待，
+ * 避免写任务被持续到来的读任务饿死。
+ * 资源锁默认只在本调度器内生效，setLockTable 后与共用同一锁表的其他调度器互斥。
+ *
+ * 使用方式:
+ *   TaskScheduler scheduler;
+ *   connect(&scheduler, &TaskScheduler::taskReady, runner, &Runner::start);
+ *   scheduler.enqueue(task);
+ *   // 任务结束后
+ *   scheduler.complete(task.id, TaskStatus::Succeeded);
+ */
+class TaskScheduler : public QObject {
+    Q_OBJECT
+public:
+    explicit TaskScheduler(QObject *parent = nullptr);
+
+    // ==================== 并发限制 ====================
+
+    void setGlobalLimit(int limit);
+    int globalLimit() const { return m_globalLimit; }
+
+    /**
+     * @brief 设置某类任务的并发上限，0 表示只受全局上限约束
+     */
+    void setTypeLimit(const QString& type, int limit);
+    int typeLimit(const QString& type) const { return m_typeLimits.value(type, 0); }
+
+    // ==================== 资源锁 ====================
+
+    /**
+     * @brief 与其他调度器共用锁表（生命周期由外部管理），传入空指针恢复使用自己的锁表
+     * @note 须在提交任务前设置
+     */
+    void setLockTable(TaskLockTable* locks);
+    TaskLockTable* lockTable() const { return m_locks; }
+
+    // ==================== 任务管理 ====================
+
+    /**
+     * @brief 提交任务
+     * @return 任务 ID 为空或重复时返回 false
+     */
+    bool enqueue(const AgentTask& task);
+
+    /**
+     * @brief 标记运行中的任务结束，释放其并发名额与资源锁
+     */
+    void complete(const QString& taskId, TaskStatus status);
+
+    /**
+     * @brief 取消尚未开始的任务
+     * @return 任务不在等待队列中（已开始或不存在）时返回 false
+     */
+    bool cancelPending(const QString& taskId);
+
+    int pendingCount() const { return m_pending.size(); }
+    int runningCount() const { return m_running.size(); }
+    int runningCount(const QString& type) const { return m_typeRunning.value(type, 0); }
+    bool isIdle() const { return m_pending.isEmpty() && m_running.isEmpty(); }
+
+    bool isRunning(const QString& taskId) const { return m_running.contains(taskId); }
+    QStringList pendingIds() const;
+    TaskStatus status(const QString& taskId) const;
+
+signals:
+    // 任务满足并发、锁与依赖条件，可以开始执行（此时已计入运行中）
+    void taskReady(const AgentTask& task);
+
+    // 任务因依赖失败或被取消而不再执行
+    void taskSkipped(const AgentTask& task, TaskStatus status, const QString& reason);
+
+    // 等待队列与运行中任务均为空
+    void idle();
+
+private:
+    void schedule();
+    bool dependenciesMet(const AgentTask& task, QString* failedReason) const;
+
+    int m_globalLimit = 4;
+    QHash<QString, int> m_typeLimits;           // 任务类型 -> 并发上限
+    QHash<QString, int> m_typeRunning;          // 任务类型 -> 运行中数量
+
+    QList<AgentTask> m_pending;                 // 按提交顺序
+    QHash<QString, AgentTask> m_running;
+    QHash<QString, TaskStatus> m_finished;      // 已结束任务的最终状态
+
+    TaskLockTable m_ownLocks;
+    TaskLockTable* m_locks = &m_ownLocks;       // 当前使用的锁表（自己的或共用的）
+
+    bool m_hasWork = false;                     // 自上次 idle 以来是否提交过任务
+    bool m_scheduling = false;                  // 防止 taskReady 槽函数内同步 complete 导致重入
+    bool m_rescheduleRequested = false;
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,150 @@
+#ifndef TASKTYPES_H
+#define TASKTYPES_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <memory>
+
+struct LLMConfig;  // 前向声明
+
+/**
+ * @brief 编排层的数据结构定义
+ *
+ * 对应设计文档第 4、5 节: Task type 标识任务类别，决定默认资源锁与并发限制；
+ * TaskResult 是所有 Worker 统一的结构化结果。
+ */
+
+// 任务类型（设计文档 5.2 第一批 Task type）
+namespace TaskType {
+    static constexpr const char* EXEC_SHELL = "exec_shell";
+    static constexpr const char* SEARCH_TEXT = "search_text";
+    static constexpr const char* SEMANTIC_QUERY = "semantic_query";
+    static constexpr const char* READ_FILE = "read_file";
+    static constexpr const char* WRITE_FILE = "write_file";
+    static constexpr const char* APPLY_PATCH = "apply_patch";
+    static constexpr const char* DIFF_WORKSPACE = "diff_workspace";
+    static constexpr const char* BUILD = "build";
+}
+
+// 资源锁名称
+namespace TaskLock {
+    static constexpr const char* WORKSPACE = "workspace";  // 工作区源码
+    static constexpr const char* BUILDDIR = "builddir";    // 构建目录
+}
+
+// 任务状态（设计文档 4.2）
+enum class TaskStatus {
+    Pending,
+    Running,
+    Succeeded,
+    Failed,
+    Canceled,
+    TimedOut
+};
+
+inline QString taskStatusName(TaskStatus status) {
+    switch (status) {
+    case TaskStatus::Pending:   return "pending";
+    case TaskStatus::Running:   return "running";
+    case TaskStatus::Succeeded: return "succeeded";
+    case TaskStatus::Failed:    return "failed";
+    case TaskStatus::Canceled:  return "canceled";
+    case TaskStatus::TimedOut:  return "timed_out";
+    }
+    return "unknown";
+}
+
+// 任务定义
+struct AgentTask {
+    QString id;                 // 任务 ID（为空时由 Orchestrator 分配）
+    QString type;               // 任务类型（TaskType::*）
+    QString prompt;             // 交给 Worker 的任务描述
+    QString systemPrompt;       // Worker 角色（为空时使用 Orchestrator 的基础配置）
+    QStringList allowedTools;   // Worker 可用的工具（为空表示全部）
+    QStringList dependsOn;      // 依赖的任务 ID，全部成功后才会开始
+    QStringList sharedLocks;    // 共享锁（可与其他共享持有者并发）
+    QStringList exclusiveLocks; // 独占锁
+    QStringList lockParents;    // 祖先任务 ID，它们持有的锁不阻塞本任务（子 Agent 在父任务的锁下运行）
+    int timeoutMs = 0;          // 任务总超时，0 表示不限制（请求本身只有空闲超时）
+
+    // 本任务的基础配置，为空时使用 Orchestrator::setConfig 的配置
+    // NOTE: 同一 Orchestrator 为多个调用方执行任务时（如 SubAgentDelegator），各任务继承各自调用方的配置
+    std::shared_ptr<const LLMConfig> config;
+
+    /**
+     * @brief 从 plan 文件中的任务对象解析
+     * @note 字段名与成员一致: {id, type, prompt, systemPrompt?, allowedTools?, dependsOn?, timeoutMs?}
+     */
+    static AgentTask fromJson(const QJsonObject& json) {
+        AgentTask task;
+        task.id = json["id"].toString();
+        task.type = json["type"].toString();
+        task.prompt = json["prompt"].toString();
+        task.systemPrompt = json["systemPrompt"].toString();
+        for (const QJsonValue& value : json["allowedTools"].toArray()) {
+            task.allowedTools.append(value.toString());
+        }
+        for (const QJsonValue& value : json["dependsOn"].toArray()) {
+            task.dependsOn.append(value.toString());
+        }
+        for (const QJsonValue& value : json["sharedLocks"].toArray()) {
+            task.sharedLocks.append(value.toString());
+        }
+        for (const QJsonValue& value : json["exclusiveLocks"].toArray()) {
+            task.exclusiveLocks.append(value.toString());
+        }
+        task.timeoutMs = json["timeoutMs"].toInt();
+        return task;
+    }
+
+    /**
+     * @brief 按任务类型填充默认资源锁（调用方已显式指定时不覆盖）
+     * @note 只读任务共享 workspace；写入类任务独占 workspace；构建独占 builddir
+     */
+    void applyDefaultLocks() {
+        if (!sharedLocks.isEmpty() || !exclusiveLocks.isEmpty()) {
+            return;
+        }
+        if (type == TaskType::SEARCH_TEXT || type == TaskType::SEMANTIC_QUERY
+            || type == TaskType::READ_FILE || type == TaskType::DIFF_WORKSPACE) {
+            sharedLocks << TaskLock::WORKSPACE;
+        } else if (type == TaskType::WRITE_FILE || type == TaskType::APPLY_PATCH
+                   || type == TaskType::EXEC_SHELL) {
+            exclusiveLocks << TaskLock::WORKSPACE;
+        } else if (type == TaskType::BUILD) {
+            sharedLocks << TaskLock::WORKSPACE;
+            exclusiveLocks << TaskLock::BUILDDIR;
+        }
+    }
+};
+
+// 任务结果（设计文档 4.4）
+struct TaskResult {
+    QString taskId;
+    QString type;
+    QString agentId;            // 执行该任务的 Worker
+    TaskStatus status = TaskStatus::Pending;
+    QString summary;            // 人读摘要（Worker 的最终回复或错误信息）
+    QStringList artifacts;      // 产物引用（文件路径等）
+    QJsonObject metrics;        // 耗时、工具调用次数、token 用量等
+    bool degraded = false;      // 是否降级执行
+
+    bool succeeded() const { return status == TaskStatus::Succeeded; }
+
+    QJsonObject toJson() const {
+        QJsonObject obj;
+        obj["taskId"] = taskId;
+        obj["type"] = type;
+        obj["agentId"] = agentId;
+        obj["status"] = taskStatusName(status);
+        obj["summary"] = summary;
+        obj["artifacts"] = QJsonArray::fromStringList(artifacts);
+        obj["metrics"] = metrics;
+        obj["degraded"] = degraded;
+        return obj;
+    }
+};
+
+#endif // TASKTYPES_H
@@ -1,4 +1,5 @@
 #include "TreeSitterParser.h"
+#include "core/trace/Tracer.h"
 #include <tree_sitter/api.h>
 #include <cstdlib>
 #include <cstring>
@@ -255,6 +256,8 @@ bool TreeSitterParser::parse(const QString& source) {
 }
 
 bool TreeSitterParser::parse(const QByteArray& utf8Source) {
+    TraceSpan span("parser", "parse");
+    span.setArg("bytes", utf8Source.size());
     if (!m_parser) {
         m_lastError = QStringLiteral("Parser not initialized");
         return false;
@@ -307,6 +310,8 @@ bool TreeSitterParser::reparse(const QString& newSource) {
 }
 
 bool TreeSitterParser::reparse(const QByteArray& newUtf8Source) {
+    TraceSpan span("parser", "reparse");
+    span.setArg("bytes", newUtf8Source.size());
     if (!m_parser) {
         m_lastError = QStringLiteral("Parser not initialized");
         return false;
@@ -0,0 +1,12 @@
+# 测试支撑模块（会话回放、本地 SSE 服务），只由 tests/ 下的测试、基准与 Mock 测试引入
+# 依赖核心模块，须在 core.pri 之后 include；GUI 与 CLI 目标不链接这些代码
+
+SOURCES += \
+    $$PWD/net/ReplayServer.cpp \
+    $$PWD/net/SessionCassette.cpp \
+    $$PWD/net/SseServer.cpp
+
+HEADERS += \
+    $$PWD/net/ReplayServer.h \
+    $$PWD/net/SessionCassette.h \
+    $$PWD/net/SseServer.h
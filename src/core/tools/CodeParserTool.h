@@ -10,6 +10,7 @@
 #include <QDebug>
 
 #include "core/parser/TreeSitterParser.h"
+#include "core/log/LogCategories.h"
 
 /**
  * @brief 代码解析工具
@@ -32,7 +33,7 @@ public:
      */
     static QString executeViewFileOutline(const QJsonObject& input) {
         QString filePath = input["file_path"].toString();
-        qDebug() << "[CodeParserTool] 查看文件大纲:" << filePath;
+        qCDebug(lcTool) << "[CodeParserTool] 查看文件大纲:" << filePath;
         return viewFileOutline(filePath);
     }
     
@@ -43,7 +44,7 @@ public:
     static QString executeViewCodeItem(const QJsonObject& input) {
         QString filePath = input["file_path"].toString();
         QString itemName = input["item_name"].toString();
-        qDebug() << "[CodeParserTool] 查看代码项:" << filePath << itemName;
+        qCDebug(lcTool) << "[CodeParserTool] 查看代码项:" << filePath << itemName;
         return viewCodeItem(filePath, itemName);
     }
     
@@ -10,6 +10,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDirIterator>
+#include "core/log/LogCategories.h"
 
 class FileTool {
 public:
@@ -36,7 +37,7 @@ public:
         QString filename = input["filename"].toString();
         QString content = input.value("content").toString();
         
-        qDebug() << "[FileTool] 创建文件:" << directory << "/" << filename;
+        qCDebug(lcTool) << "[FileTool] 创建文件:" << directory << "/" << filename;
         return createFile(directory, filename, content);
     }
     
@@ -47,7 +48,7 @@ public:
     static QString executeViewFile(const QJsonObject& input) {
         QString filePath = input["file_path"].toString();
         
-        qDebug() << "[FileTool] 读取文件:" << filePath;
+        qCDebug(lcTool) << "[FileTool] 读取文件:" << filePath;
         return readFile(filePath);
     }
     
@@ -60,7 +61,7 @@ public:
         int startLine = input["start_line"].toInt();
         int endLine = input["end_line"].toInt();
         
-        qDebug() << "[FileTool] 读取文件行:" << filePath << startLine << "-" << endLine;
+        qCDebug(lcTool) << "[FileTool] 读取文件行:" << filePath << startLine << "-" << endLine;
         return readFileLines(filePath, startLine, endLine);
     }
     
@@ -73,7 +74,7 @@ public:
         QString targetContent = input["target_content"].toString();
         QString replacementContent = input["replacement_content"].toString();
         
-        qDebug() << "[FileTool] 替换文件内容:" << filePath;
+        qCDebug(lcTool) << "[FileTool] 替换文件内容:" << filePath;
         return replaceInFile(filePath, targetContent, replacementContent);
     }
     
@@ -84,7 +85,7 @@ public:
     static QString executeDeleteFile(const QJsonObject& input) {
         QString filePath = input["file_path"].toString();
         
-        qDebug() << "[FileTool] 删除文件:" << filePath;
+        qCDebug(lcTool) << "[FileTool] 删除文件:" << filePath;
         return deleteFile(filePath);
     }
     
@@ -96,7 +97,7 @@ public:
         QString dirPath = input["directory_path"].toString();
         bool recursive = input.value("recursive").toBool(false);
         
-        qDebug() << "[FileTool] 列出目录:" << dirPath << "递归:" << recursive;
+        qCDebug(lcTool) << "[FileTool] 列出目录:" << dirPath << "递归:" << recursive;
         return listDirectory(dirPath, recursive);
     }
     
@@ -109,7 +110,7 @@ public:
         QString directory = input["directory"].toString();
         QString filePattern = input.value("file_pattern").toString();
         
-        qDebug() << "[FileTool] 搜索内容:" << pattern << "目录:" << directory;
+        qCDebug(lcTool) << "[FileTool] 搜索内容:" << pattern << "目录:" << directory;
         return grepSearch(pattern, directory, filePattern);
     }
     
@@ -121,7 +122,7 @@ public:
         QString pattern = input["pattern"].toString();
         QString directory = input["directory"].toString();
         
-        qDebug() << "[FileTool] 按名称搜索:" << pattern << "目录:" << directory;
+        qCDebug(lcTool) << "[FileTool] 按名称搜索:" << pattern << "目录:" << directory;
         return findByName(pattern, directory);
     }
     
@@ -134,7 +135,7 @@ public:
         int lineNumber = input["line_number"].toInt();
         QString content = input["content"].toString();
         
-        qDebug() << "[FileTool] 插入内容:" << filePath << "行:" << lineNumber;
+        qCDebug(lcTool) << "[FileTool] 插入内容:" << filePath << "行:" << lineNumber;
         return insertContent(filePath, lineNumber, content);
     }
     
@@ -146,7 +147,7 @@ public:
         QString filePath = input["file_path"].toString();
         QJsonArray replacements = input["replacements"].toArray();
         
-        qDebug() << "[FileTool] 多处替换:" << filePath << "共" << replacements.size() << "处";
+        qCDebug(lcTool) << "[FileTool] 多处替换:" << filePath << "共" << replacements.size() << "处";
         return multiReplaceInFile(filePath, replacements);
     }
     
@@ -170,7 +171,7 @@ public:
         }
         
         if (!canonicalTarget.startsWith(canonicalBase)) {
-            qDebug() << "[FileTool] 创建文件被拒绝: 目标目录" << winDirectory 
+            qCInfo(lcTool) << "[FileTool] 创建文件被拒绝: 目标目录" << winDirectory 
                      << "不在工作目录" << baseWorkDir << "内";
             return QString("错误: 写入操作只能在工作目录 (%1) 及其子目录内执行，无法操作 %2")
                 .arg(baseWorkDir)
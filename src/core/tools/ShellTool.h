@@ -9,7 +9,8 @@
 #include <QDebug>
 #include <QJsonObject>
 #include <QJsonArray>
-#include <QMessageBox>
+#include <functional>
+#include "core/log/LogCategories.h"
 
 /**
  * @brief Shell 命令执行工具
@@ -34,10 +35,22 @@ public:
         QString command = input["command"].toString();
         QString workingDir = input.value("working_directory").toString();
         
-        qDebug() << "[ShellTool] 执行命令:" << command;
+        qCDebug(lcTool) << "[ShellTool] 执行命令:" << command;
         return executeCommand(command, workingDir);
     }
     
+    // ==================== 执行确认 ====================
+    
+    /**
+     * @brief 可执行文件的确认回调
+     * @return true 允许执行；未设置回调时一律拒绝
+     */
+    using ApprovalHandler = std::function<bool(const QString& command, const QString& workingDir)>;
+    
+    static void setApprovalHandler(ApprovalHandler handler) {
+        approvalHandler() = std::move(handler);
+    }
+    
     // ==================== 工具实现（核心函数） ====================
 public:
     /**
@@ -66,7 +79,7 @@ public:
             
             // 检查目标目录是否在基础目录内
             if (!canonicalTarget.startsWith(canonicalBase)) {
-                qDebug() << "[ShellTool] 写命令被拒绝: 目标目录" << effectiveWorkDir 
+                qCInfo(lcTool) << "[ShellTool] 写命令被拒绝: 目标目录" << effectiveWorkDir 
                          << "不在工作目录" << baseWorkDir << "内";
                 return QString("错误: 写入操作只能在工作目录 (%1) 及其子目录内执行，无法操作 %2")
                     .arg(baseWorkDir)
@@ -74,23 +87,14 @@ public:
             }
         }
         
-        // NOTE: 可执行文件确认机制
+        // NOTE: 可执行文件确认机制（由运行形态注入：GUI 弹窗确认，CLI 按审批策略文件）
         if (isExecutableCommand(command)) {
-            QMessageBox::StandardButton reply = QMessageBox::question(
-                nullptr,
-                "执行确认",
-                QString("Agent 请求执行以下命令：\n\n%1\n\n工作目录：%2\n\n是否允许执行？")
-                    .arg(command)
-                    .arg(effectiveWorkDir),
-                QMessageBox::Yes | QMessageBox::No,
-                QMessageBox::No  // 默认选中"否"
-            );
-            
-            if (reply != QMessageBox::Yes) {
-                qDebug() << "[ShellTool] 用户拒绝执行命令:" << command;
-                return "错误: 用户拒绝执行该命令";
+            const ApprovalHandler& handler = approvalHandler();
+            if (!handler || !handler(command, effectiveWorkDir)) {
+                qCInfo(lcTool) << "[ShellTool] 命令未获批准:" << command;
+                return "错误: 命令未获批准执行 (用户拒绝或审批策略不允许)";
             }
-            qDebug() << "[ShellTool] 用户确认执行命令:" << command;
+            qCDebug(lcTool) << "[ShellTool] 命令已获批准:" << command;
         }
         
         QProcess process;
@@ -270,7 +274,7 @@ public:
         
         for (const QString& pattern : dangerousPatterns) {
             if (lowerCmd.contains(pattern.toLower())) {
-                qDebug() << "[ShellTool] WARNING: 命令被黑名单拒绝:" << command;
+                qCWarning(lcTool) << "[ShellTool] 命令被黑名单拒绝:" << command;
                 return false;
             }
         }
@@ -321,7 +325,7 @@ public:
             }
             
             if (!subCmdSafe) {
-                qDebug() << "[ShellTool] WARNING: 子命令不在白名单中:" << trimmedSubCmd;
+                qCInfo(lcTool) << "[ShellTool] 子命令不在白名单中:" << trimmedSubCmd;
                 return false;
             }
         }
@@ -330,6 +334,11 @@ public:
     }
     
 private:
+    static ApprovalHandler& approvalHandler() {
+        static ApprovalHandler handler;
+        return handler;
+    }
+    
     /**
      * @brief 查找 Git Bash 路径
      * @return Git Bash 可执行文件路径，或空字符串
@@ -0,0 +1,180 @@
+#include "Tracer.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QDebug>
+#include <cstring>
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+namespace {
+// 进程内统一的时间起点（第一次使用时开始计时）
+const QElapsedTimer& traceClock() {
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock;
+}
+
+thread_local void* t_buffer = nullptr;  // 当前线程的 Tracer::Buffer（首次写入时注册）
+}
+
+Tracer& Tracer::instance() {
+    // NOTE: 故意不析构，其他线程或静态对象析构时仍可能写入
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+void Tracer::setEnabled(bool enabled) {
+    traceClock();  // 启用前确定时间起点
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 Tracer::now() {
+    return traceClock().nsecsElapsed();
+}
+
+void Tracer::complete(const char* category, const char* name, qint64 startNs, qint64 endNs,
+                      const QString& detail, const char* argName, qint64 argValue) {
+    if (isEnabled()) {
+        record('X', category, name, startNs, qMax<qint64>(0, endNs - startNs), detail, argName, argValue);
+    }
+}
+
+void Tracer::instant(const char* category, const char* name, const QString& detail) {
+    if (isEnabled()) {
+        record('i', category, name, now(), 0, detail, nullptr, 0);
+    }
+}
+
+void Tracer::counter(const char* category, const char* name, qint64 value) {
+    if (isEnabled()) {
+        record('C', category, name, now(), 0, QString(), name, value);
+    }
+}
+
+Tracer::Buffer* Tracer::threadBuffer() {
+    if (t_buffer) {
+        return static_cast<Buffer*>(t_buffer);
+    }
+
+    // NOTE: 缓冲区归 Tracer 所有，线程退出后其事件仍可导出
+    auto buffer = std::make_unique<Buffer>();
+    buffer->events.resize(kBufferEvents);
+    QThread* thread = QThread::currentThread();
+    const bool isMain = QCoreApplication::instance() && thread == QCoreApplication::instance()->thread();
+
+    Tracer& tracer = instance();
+    QMutexLocker locker(&tracer.m_mutex);
+    buffer->tid = int(tracer.m_buffers.size()) + 1;
+    buffer->threadName = isMain ? QByteArray("main")
+                       : !thread->objectName().isEmpty() ? thread->objectName().toUtf8()
+                       : QByteArray("thread-") + QByteArray::number(buffer->tid);
+    t_buffer = buffer.get();
+    tracer.m_buffers.push_back(std::move(buffer));
+    return static_cast<Buffer*>(t_buffer);
+}
+
+void Tracer::record(char phase, const char* category, const char* name, qint64 startNs, qint64 durationNs,
+                    const QString& detail, const char* argName, qint64 argValue) {
+    Buffer* buffer = threadBuffer();
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index % kBufferEvents];
+    event.category = category;
+    event.name = name;
+    event.argName = argName;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.argValue = argValue;
+    event.phase = phase;
+    event.detail[0] = '\0';
+    if (!detail.isEmpty()) {
+        const QByteArray utf8 = detail.toUtf8();
+        const int size = qMin(utf8.size(), int(sizeof(event.detail)) - 1);
+        std::memcpy(event.detail, utf8.constData(), size_t(size));
+        event.detail[size] = '\0';
+    }
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+QByteArray Tracer::toChromeTraceJson() const {
+    QJsonArray traceEvents;
+    QMutexLocker locker(&m_mutex);
+    for (const auto& buffer : m_buffers) {
+        traceEvents.append(QJsonObject{{"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", buffer->tid},
+                                       {"args", QJsonObject{{"name", QString::fromUtf8(buffer->threadName)}}}});
+
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 count = qMin<quint64>(written, kBufferEvents);
+        for (quint64 i = written - count; i < written; ++i) {
+            const Event& event = buffer->events[i % kBufferEvents];
+            QJsonObject object{{"ph", QString(QChar(event.phase))},
+                               {"cat", event.category},
+                               {"name", event.name},
+                               {"pid", 1},
+                               {"tid", buffer->tid},
+                               {"ts", event.startNs / 1000.0}};  // 微秒
+            if (event.phase == 'X') {
+                object["dur"] = event.durationNs / 1000.0;
+            } else if (event.phase == 'i') {
+                object["s"] = "t";
+            }
+            QJsonObject args;
+            if (event.detail[0] != '\0') {
+                args["detail"] = QString::fromUtf8(event.detail);
+            }
+            if (event.argName) {
+                args[event.argName] = double(event.argValue);
+            }
+            if (!args.isEmpty()) {
+                object["args"] = args;
+            }
+            traceEvents.append(object);
+        }
+    }
+    locker.unlock();
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeChromeTrace(const QString& path, QString& error) const {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        error = file.errorString();
+        return false;
+    }
+    file.write(toChromeTraceJson());
+    return true;
+}
+
+void Tracer::clear() {
+    QMutexLocker locker(&m_mutex);
+    for (const auto& buffer : m_buffers) {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+void Tracer::initFromEnvironment() {
+    const QString path = qEnvironmentVariable("TMAGENT_TRACE");
+    if (path.isEmpty()) {
+        return;
+    }
+    setEnabled(true);
+    if (QCoreApplication* app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, [path]() {
+            QString error;
+            if (!Tracer::instance().writeChromeTrace(path, error)) {
+                qWarning() << "无法写入 trace 文件" << path << error;
+            }
+        });
+    }
+}
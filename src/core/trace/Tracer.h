@@ -0,0 +1,145 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 热路径计时（导出为 Chrome / Perfetto trace JSON）
+ *
+ * 每个线程写自己的环形缓冲区（无锁，只保留最近 kBufferEvents 个事件），关闭时每个埋点只有一次原子读。
+ * 导出的文件用 chrome://tracing 或 https://ui.perfetto.dev 打开，可以看出一次慢的会话卡在
+ * 模型（llm.*）、工具（tool）、解析（parser）还是界面刷新（ui.*）。
+ *
+ * 使用方式:
+ *   TRACE_SCOPE("tool", "dispatch");                  // 作用域结束时记录
+ *   TraceSpan span("tool", "dispatch", call.name);     // 带细节（工具名等）
+ *   Tracer::complete("llm", "ttft", sentNs, Tracer::now());  // 跨回调的区间
+ *
+ * 启用方式：环境变量 TMAGENT_TRACE=<文件> 启用并在退出时导出（Tracer::initFromEnvironment）；
+ * 界面版本始终启用，随时可以导出最近的事件。
+ *
+ * NOTE: category / name / argName 必须是字符串字面量（只保存指针）；细节文本复制并截断到 47 字节
+ */
+class Tracer {
+public:
+    static constexpr int kBufferEvents = 1 << 16;
+
+    static Tracer& instance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief 单调时钟（纳秒），所有线程共用同一起点
+     */
+    static qint64 now();
+
+    /**
+     * @brief 记录一个区间 [startNs, endNs]
+     */
+    static void complete(const char* category, const char* name, qint64 startNs, qint64 endNs,
+                         const QString& detail = QString(), const char* argName = nullptr, qint64 argValue = 0);
+
+    /**
+     * @brief 记录一个时间点（如首个 token 到达）
+     */
+    static void instant(const char* category, const char* name, const QString& detail = QString());
+
+    /**
+     * @brief 记录计数器的当前值（Perfetto 中显示为折线）
+     */
+    static void counter(const char* category, const char* name, qint64 value);
+
+    /**
+     * @brief 所有线程缓冲区中的事件，Chrome trace JSON（{"traceEvents": [...]}）
+     * @note 导出时仍在写入的线程可能有个别事件不完整，一般在空闲时导出
+     */
+    QByteArray toChromeTraceJson() const;
+    bool writeChromeTrace(const QString& path, QString& error) const;
+
+    void clear();
+
+    /**
+     * @brief 读取 TMAGENT_TRACE：设置时启用，并在 QCoreApplication 退出前导出到该文件
+     */
+    static void initFromEnvironment();
+
+private:
+    struct Event {
+        const char* category;
+        const char* name;
+        const char* argName;
+        qint64 startNs;
+        qint64 durationNs;
+        qint64 argValue;
+        char phase;          // 'X' 区间, 'i' 时间点, 'C' 计数器
+        char detail[48];
+    };
+
+    // 单个线程的环形缓冲区（只有所属线程写入）
+    struct Buffer {
+        int tid = 0;
+        QByteArray threadName;
+        std::vector<Event> events;
+        std::atomic<quint64> written{0};
+    };
+
+    Tracer() = default;
+    static Buffer* threadBuffer();
+    static void record(char phase, const char* category, const char* name, qint64 startNs, qint64 durationNs,
+                       const QString& detail, const char* argName, qint64 argValue);
+
+    static std::atomic<bool> s_enabled;
+
+    mutable QMutex m_mutex;  // 只保护缓冲区列表（注册新线程与导出）
+    std::vector<std::unique_ptr<Buffer>> m_buffers;
+};
+
+/**
+ * @brief 作用域计时，析构时记录一个区间（未启用时构造与析构都只读一次开关）
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name, const QString& detail = QString())
+        : m_category(category), m_name(name)
+        , m_startNs(Tracer::isEnabled() ? Tracer::now() : -1)
+    {
+        if (m_startNs >= 0) {
+            m_detail = detail;
+        }
+    }
+
+    ~TraceSpan() {
+        if (m_startNs >= 0) {
+            Tracer::complete(m_category, m_name, m_startNs, Tracer::now(), m_detail, m_argName, m_argValue);
+        }
+    }
+
+    // 附加一个数值参数（如字节数、事件数）
+    void setArg(const char* name, qint64 value) {
+        m_argName = name;
+        m_argValue = value;
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_category;
+    const char* m_name;
+    QString m_detail;
+    const char* m_argName = nullptr;
+    qint64 m_argValue = 0;
+    qint64 m_startNs;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(category, name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(category, name)
+
+#endif // TRACER_H
@@ -0,0 +1,317 @@
+#include "Tokenizer.h"
+#include "core/log/LogCategories.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMutexLocker>
+#include <QDebug>
+#include <climits>
+#include <functional>
+#include <cmath>
+
+// GPT-2 风格的默认预分词规则（tokenizer.json 未声明 Split 规则时使用）
+static const char* kDefaultSplitPattern =
+    "'s|'t|'re|'ve|'m|'ll|'d| ?\\p{L}+| ?\\p{N}+| ?[^\\s\\p{L}\\p{N}]+|\\s+(?!\\S)|\\s+";
+
+// 超长片段（如 base64、长分隔线）分块计算，避免 BPE 合并退化为平方复杂度
+static const int kMaxPieceLength = 128;
+
+// 片段缓存上限，超出后整体清空
+static const int kMaxCacheEntries = 100000;
+
+Tokenizer& Tokenizer::instance() {
+    static Tokenizer* tokenizer = []() {
+        Tokenizer* t = new Tokenizer();
+        const QString path = locateVocabulary();
+        if (path.isEmpty() || !t->loadFromFile(path)) {
+            qCWarning(lcConfig) << "[Tokenizer] 未找到 tokenizer.json，使用经验估算 token 数";
+        }
+        return t;
+    }();
+    return *tokenizer;
+}
+
+QString Tokenizer::locateVocabulary() {
+    // 与 tools.yaml 相同的查找顺序
+    const QStringList possiblePaths = {
+        QCoreApplication::applicationDirPath() + "/resources/tokenizer.json",
+        QCoreApplication::applicationDirPath() + "/../resources/tokenizer.json",
+        QDir::currentPath() + "/resources/tokenizer.json",
+        "resources/tokenizer.json"
+    };
+
+    for (const QString& path : possiblePaths) {
+        if (QFile::exists(path)) {
+            return path;
+        }
+    }
+    return QString();
+}
+
+bool Tokenizer::loadFromFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(lcConfig) << "[Tokenizer] 无法打开词表文件:" << path;
+        return false;
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    const QJsonObject model = root["model"].toObject();
+    if (model["type"].toString() != "BPE") {
+        qCWarning(lcConfig) << "[Tokenizer] 不支持的分词模型:" << model["type"].toString();
+        return false;
+    }
+
+    // 合并规则: 旧格式为 "a b" 字符串，新格式为 ["a", "b"] 数组
+    QHash<QString, int> ranks;
+    const QJsonArray merges = model["merges"].toArray();
+    ranks.reserve(merges.size());
+    for (int i = 0; i < merges.size(); ++i) {
+        const QJsonValue merge = merges[i];
+        if (merge.isArray()) {
+            const QJsonArray pair = merge.toArray();
+            ranks.insert(pair[0].toString() + ' ' + pair[1].toString(), i);
+        } else {
+            ranks.insert(merge.toString(), i);
+        }
+    }
+
+    // 预分词规则: 支持 Sequence / Split / ByteLevel
+    QVector<QRegularExpression> patterns;
+    std::function<void(const QJsonObject&)> addPreTokenizer = [&](const QJsonObject& pre) {
+        const QString type = pre["type"].toString();
+        if (type == "Sequence") {
+            for (const QJsonValue& child : pre["pretokenizers"].toArray()) {
+                addPreTokenizer(child.toObject());
+            }
+        } else if (type == "Split") {
+            const QJsonObject pattern = pre["pattern"].toObject();
+            const QString regex = pattern.contains("Regex")
+                ? pattern["Regex"].toString()
+                : QRegularExpression::escape(pattern["String"].toString());
+            patterns.append(QRegularExpression(regex, QRegularExpression::UseUnicodePropertiesOption));
+        } else if (type == "ByteLevel" && pre["use_regex"].toBool(true)) {
+            patterns.append(QRegularExpression(kDefaultSplitPattern,
+                                               QRegularExpression::UseUnicodePropertiesOption));
+        }
+    };
+    addPreTokenizer(root["pre_tokenizer"].toObject());
+
+    for (const QRegularExpression& re : patterns) {
+        if (!re.isValid()) {
+            qCWarning(lcConfig) << "[Tokenizer] 预分词规则无效:" << re.pattern() << re.errorString();
+            return false;
+        }
+    }
+    if (patterns.isEmpty()) {
+        patterns.append(QRegularExpression(kDefaultSplitPattern,
+                                           QRegularExpression::UseUnicodePropertiesOption));
+    }
+
+    m_mergeRanks = ranks;
+    m_splitPatterns = patterns;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        m_pieceCache.clear();
+        m_cacheHits = 0;
+        m_cacheMisses = 0;
+    }
+
+    qCInfo(lcConfig) << "[Tokenizer] 已加载词表:" << path << "合并规则" << m_mergeRanks.size() << "条";
+    return true;
+}
+
+// ==================== Token 统计 ====================
+
+int Tokenizer::countTokens(const QString& text) const {
+    if (text.isEmpty()) {
+        return 0;
+    }
+    if (!isLoaded()) {
+        return estimateTokens(text);
+    }
+
+    int tokens = 0;
+    for (const QString& piece : preTokenize(text)) {
+        tokens += countPiece(piece);
+    }
+    return tokens;
+}
+
+QString Tokenizer::truncateToTokens(const QString& text, int maxTokens, int* totalTokens) const {
+    int total = 0;
+    int cutPosition = -1;
+
+    if (isLoaded()) {
+        int position = 0;
+        for (const QString& piece : preTokenize(text)) {
+            const int pieceTokens = countPiece(piece);
+            if (cutPosition < 0 && total + pieceTokens > maxTokens) {
+                cutPosition = position;
+            }
+            total += pieceTokens;
+            position += piece.length();
+        }
+    } else {
+        // 经验估算: 逐字符累加
+        double tokens = 0.0;
+        for (int i = 0; i < text.length(); ++i) {
+            tokens += text[i].unicode() >= 0x2E80 ? 0.6 : 0.3;
+            if (cutPosition < 0 && tokens > maxTokens) {
+                cutPosition = i;
+            }
+        }
+        total = static_cast<int>(std::ceil(tokens));
+    }
+
+    if (totalTokens) {
+        *totalTokens = total;
+    }
+    return cutPosition < 0 ? text : text.left(cutPosition);
+}
+
+int Tokenizer::estimateTokens(const QString& text) {
+    double tokens = 0.0;
+    for (const QChar& ch : text) {
+        // CJK 及其他宽字符按 0.6，ASCII/拉丁字符按 0.3
+        tokens += ch.unicode() >= 0x2E80 ? 0.6 : 0.3;
+    }
+    return static_cast<int>(std::ceil(tokens));
+}
+
+// ==================== BPE 实现 ====================
+
+QStringList Tokenizer::preTokenize(const QString& text) const {
+    // NOTE: 按 Isolated 语义依次应用每条规则，匹配部分与间隙都作为独立片段，
+    // 因此所有片段拼接后仍等于原文
+    QStringList pieces{text};
+    for (const QRegularExpression& re : m_splitPatterns) {
+        QStringList next;
+        for (const QString& piece : pieces) {
+            int last = 0;
+            QRegularExpressionMatchIterator it = re.globalMatch(piece);
+            while (it.hasNext()) {
+                const QRegularExpressionMatch match = it.next();
+                if (match.capturedLength() == 0) {
+                    continue;
+                }
+                if (match.capturedStart() > last) {
+                    next.append(piece.mid(last, match.capturedStart() - last));
+                }
+                next.append(match.captured());
+                last = match.capturedEnd();
+            }
+            if (last < piece.length()) {
+                next.append(piece.mid(last));
+            }
+        }
+        pieces = next;
+    }
+    return pieces;
+}
+
+int Tokenizer::countPiece(const QString& piece) const {
+    if (piece.length() > kMaxPieceLength) {
+        int tokens = 0;
+        for (int i = 0; i < piece.length(); ) {
+            // NOTE: 在码点边界分块，拆开代理对会让两半各编码成替换字符，得到错误的字节序列
+            int length = qMin(kMaxPieceLength, piece.length() - i);
+            if (i + length < piece.length() && piece[i + length - 1].isHighSurrogate()) {
+                --length;
+            }
+            tokens += countPiece(piece.mid(i, length));
+            i += length;
+        }
+        return tokens;
+    }
+
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        auto it = m_pieceCache.constFind(piece);
+        if (it != m_pieceCache.constEnd()) {
+            ++m_cacheHits;
+            return it.value();
+        }
+    }
+
+    const int tokens = bpeLength(piece);
+
+    QMutexLocker locker(&m_cacheMutex);
+    ++m_cacheMisses;
+    if (m_pieceCache.size() >= kMaxCacheEntries) {
+        m_pieceCache.clear();
+    }
+    m_pieceCache.insert(piece, tokens);
+    return tokens;
+}
+
+int Tokenizer::bpeLength(const QString& piece) const {
+    // byte-level: 先把 UTF-8 字节映射为可见字符，再按合并规则逐步合并
+    const QVector<QChar>& table = byteToUnicode();
+    const QByteArray bytes = piece.toUtf8();
+
+    QStringList symbols;
+    symbols.reserve(bytes.size());
+    for (char byte : bytes) {
+        symbols.append(QString(table[static_cast<uchar>(byte)]));
+    }
+
+    while (symbols.size() > 1) {
+        int bestRank = INT_MAX;
+        int bestIndex = -1;
+        for (int i = 0; i + 1 < symbols.size(); ++i) {
+            const int rank = m_mergeRanks.value(symbols[i] + ' ' + symbols[i + 1], -1);
+            if (rank >= 0 && rank < bestRank) {
+                bestRank = rank;
+                bestIndex = i;
+            }
+        }
+        if (bestIndex < 0) {
+            break;
+        }
+
+        // 合并所有相同的相邻对
+        const QString first = symbols[bestIndex];
+        const QString second = symbols[bestIndex + 1];
+        QStringList merged;
+        merged.reserve(symbols.size());
+        for (int i = 0; i < symbols.size(); ) {
+            if (i + 1 < symbols.size() && symbols[i] == first && symbols[i + 1] == second) {
+                merged.append(first + second);
+                i += 2;
+            } else {
+                merged.append(symbols[i]);
+                ++i;
+            }
+        }
+        symbols = merged;
+    }
+
+    return symbols.size();
+}
+
+Tokenizer::CacheStats Tokenizer::cacheStats() const {
+    QMutexLocker locker(&m_cacheMutex);
+    CacheStats stats;
+    stats.hits = m_cacheHits;
+    stats.misses = m_cacheMisses;
+    stats.entries = m_pieceCache.size();
+    return stats;
+}
+
+const QVector<QChar>& Tokenizer::byteToUnicode() {
+    // GPT-2 byte-level 映射: 可打印字节映射为自身，其余映射到 U+0100 之后
+    static const QVector<QChar> table = []() {
+        QVector<QChar> t(256);
+        int next = 256;
+        for (int b = 0; b < 256; ++b) {
+            const bool printable = (b >= 33 && b <= 126) || (b >= 161 && b <= 172) || (b >= 174 && b <= 255);
+            t[b] = printable ? QChar(b) : QChar(next++);
+        }
+        return t;
+    }();
+    return table;
+}
@@ -0,0 +1,98 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
+
+/**
+ * @brief 离线 BPE 分词器（用于请求大小估算）
+ *
+ * 从 resources/tokenizer.json 加载 HuggingFace 格式的 byte-level BPE 词表
+ * （与 DeepSeek 等模型仓库中的 tokenizer.json 相同），在本地精确统计 token 数，
+ * 无需等待服务端返回 usage。
+ *
+ * 性能:
+ *   - 预分词后的每个片段按内容缓存 token 数，长会话中重复出现的片段只计算一次
+ *   - 缓存受互斥锁保护，可在多个 Agent 间共享
+ *
+ * 未找到词表文件时退化为经验估算（1 个中文字符 ≈ 0.6 token，1 个英文字符 ≈ 0.3 token）。
+ *
+ * 使用方式:
+ *   int tokens = Tokenizer::instance().countTokens(text);
+ *   QString head = Tokenizer::instance().truncateToTokens(text, 1024);
+ */
+class Tokenizer {
+public:
+    /**
+     * @brief 获取全局分词器（首次调用时自动查找并加载词表）
+     */
+    static Tokenizer& instance();
+
+    /**
+     * @brief 从 tokenizer.json 加载词表和合并规则
+     * @param path 词表文件路径
+     * @return 是否加载成功
+     */
+    bool loadFromFile(const QString& path);
+
+    /**
+     * @brief 是否已加载 BPE 词表（否则使用经验估算）
+     */
+    bool isLoaded() const { return !m_mergeRanks.isEmpty(); }
+
+    /**
+     * @brief 统计文本的 token 数
+     */
+    int countTokens(const QString& text) const;
+
+    /**
+     * @brief 截断文本，使其不超过指定 token 数（在预分词片段边界截断）
+     * @param text 原始文本
+     * @param maxTokens 最大 token 数
+     * @param totalTokens 可选，输出原始文本的 token 总数
+     * @return 截断后的文本（未超出时原样返回）
+     */
+    QString truncateToTokens(const QString& text, int maxTokens, int* totalTokens = nullptr) const;
+
+    /**
+     * @brief 经验估算（未加载词表时使用）
+     */
+    static int estimateTokens(const QString& text);
+
+    /**
+     * @brief 片段缓存统计（loadFromFile 时清零）
+     */
+    struct CacheStats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int entries = 0;
+    };
+    CacheStats cacheStats() const;
+
+private:
+    Tokenizer() = default;
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
+
+    static QString locateVocabulary();
+    static const QVector<QChar>& byteToUnicode();
+
+    QStringList preTokenize(const QString& text) const;
+    int countPiece(const QString& piece) const;
+    int bpeLength(const QString& piece) const;
+
+    QHash<QString, int> m_mergeRanks;           // "左 右" -> 合并优先级
+    QVector<QRegularExpression> m_splitPatterns; // 预分词规则（按顺序应用）
+
+    // 片段 -> token 数缓存
+    mutable QMutex m_cacheMutex;
+    mutable QHash<QString, int> m_pieceCache;
+    mutable quint64 m_cacheHits = 0;
+    mutable quint64 m_cacheMisses = 0;
+};
+
+#endif // TOKENIZER_H
@@ -1,30 +1,72 @@
 #include "ToolSchemaLoader.h"
+#include "core/log/LogCategories.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QDebug>
 #include <QJsonArray>
 #include <yaml-cpp/yaml.h>
 
 // 静态成员初始化
-QMap<QString, Tool> ToolSchemaLoader::s_toolCache;
+QReadWriteLock ToolSchemaLoader::s_lock;
+QHash<QString, Tool> ToolSchemaLoader::s_toolCache;
 QString ToolSchemaLoader::s_lastLoadedPath;
+QString ToolSchemaLoader::s_cacheDir;
 
 QVector<Tool> ToolSchemaLoader::loadFromFile(const QString& yamlPath) {
     QVector<Tool> tools;
     
     // 检查文件是否存在
     QFile file(yamlPath);
-    if (!file.exists()) {
-        qWarning() << "[ToolSchemaLoader] YAML 文件不存在:" << yamlPath;
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(lcConfig) << "[ToolSchemaLoader] YAML 文件不存在:" << yamlPath;
         return tools;
     }
+    const QByteArray content = file.readAll();
     
+    // NOTE: 内容未变时直接读编译缓存，启动时不再经过 yaml-cpp 与逐字段构造 QJsonObject
+    const QString cacheFile = cachePath(content);
+    if (cacheFile.isEmpty() || !readCache(cacheFile, tools)) {
+        if (!parseYaml(content, tools)) {
+            return QVector<Tool>();
+        }
+        if (!cacheFile.isEmpty()) {
+            writeCache(cacheFile, tools);
+        }
+    }
+    
+    if (tools.isEmpty()) {
+        return tools;  // 编辑到一半的空文件不替换已加载的工具
+    }
+    
+    QHash<QString, Tool> loaded;
+    for (const Tool& tool : tools) {
+        loaded.insert(tool.name, tool);
+    }
+    {
+        QWriteLocker locker(&s_lock);
+        s_toolCache = loaded;
+        s_lastLoadedPath = yamlPath;
+    }
+    qCInfo(lcConfig) << "[ToolSchemaLoader] 成功加载" << tools.size() << "个工具定义";
+    return tools;
+}
+
+bool ToolSchemaLoader::parseYaml(const QByteArray& content, QVector<Tool>& tools) {
+    tools.clear();
     try {
-        // 使用 yaml-cpp 加载文件
-        YAML::Node root = YAML::LoadFile(yamlPath.toStdString());
+        // 使用 yaml-cpp 解析文件内容
+        YAML::Node root = YAML::Load(content.toStdString());
         
         if (!root["tools"]) {
-            qWarning() << "[ToolSchemaLoader] YAML 文件缺少 'tools' 节点";
-            return tools;
+            qCWarning(lcConfig) << "[ToolSchemaLoader] YAML 文件缺少 'tools' 节点";
+            return false;
         }
         
         YAML::Node toolsNode = root["tools"];
@@ -91,33 +133,34 @@ QVector<Tool> ToolSchemaLoader::loadFromFile(const QString& yamlPath) {
             inputSchema["required"] = required;
             tool.inputSchema = inputSchema;
             
+            tool.serialized = QJsonDocument(tool.toJson()).toJson(QJsonDocument::Compact);
             tools.append(tool);
-            s_toolCache[tool.name] = tool;
             
-            qDebug() << "[ToolSchemaLoader] 加载工具:" << tool.name;
+            qCDebug(lcConfig) << "[ToolSchemaLoader] 加载工具:" << tool.name;
         }
-        
-        s_lastLoadedPath = yamlPath;
-        qInfo() << "[ToolSchemaLoader] 成功加载" << tools.size() << "个工具定义";
-        
     } catch (const YAML::Exception& e) {
-        qCritical() << "[ToolSchemaLoader] YAML 解析错误:" << e.what();
+        qCCritical(lcConfig) << "[ToolSchemaLoader] YAML 解析错误:" << e.what();
+        return false;
     }
-    
-    return tools;
+    return true;
 }
 
 Tool ToolSchemaLoader::getToolSchema(const QString& name) {
-    if (s_toolCache.contains(name)) {
-        return s_toolCache[name];
+    QReadLocker locker(&s_lock);
+    auto it = s_toolCache.constFind(name);
+    if (it != s_toolCache.constEnd()) {
+        return it.value();
     }
+    locker.unlock();
     
-    qWarning() << "[ToolSchemaLoader] 未找到工具:" << name;
+    qCWarning(lcConfig) << "[ToolSchemaLoader] 未找到工具:" << name;
     return Tool();
 }
 
 QVector<Tool> ToolSchemaLoader::getAllTools() {
+    QReadLocker locker(&s_lock);
     QVector<Tool> tools;
+    tools.reserve(s_toolCache.size());
     for (const Tool& tool : s_toolCache) {
         tools.append(tool);
     }
@@ -125,6 +168,101 @@ QVector<Tool> ToolSchemaLoader::getAllTools() {
 }
 
 void ToolSchemaLoader::reload(const QString& yamlPath) {
-    s_toolCache.clear();
-    loadFromFile(yamlPath);
+    loadFromFile(yamlPath);  // 成功时整体替换，失败时保留原有工具
+}
+
+QString ToolSchemaLoader::defaultPath() {
+    // NOTE: 只在第一次找到文件时探测，之后直接返回
+    static QString resolved;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    if (!resolved.isEmpty()) {
+        return resolved;
+    }
+    
+    const QStringList possiblePaths = {
+        QCoreApplication::applicationDirPath() + "/resources/tools.yaml",
+        QCoreApplication::applicationDirPath() + "/../resources/tools.yaml",
+        QDir::currentPath() + "/resources/tools.yaml"
+    };
+    for (const QString& path : possiblePaths) {
+        qCDebug(lcConfig) << "[ToolSchemaLoader] 尝试加载:" << path;
+        if (QFile::exists(path)) {
+            resolved = QFileInfo(path).absoluteFilePath();
+            break;
+        }
+    }
+    return resolved;
+}
+
+QString ToolSchemaLoader::cacheDir() {
+    QReadLocker locker(&s_lock);
+    if (!s_cacheDir.isEmpty()) {
+        return s_cacheDir;
+    }
+    const QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return base.isEmpty() ? QString() : base + "/tool_schemas";
+}
+
+void ToolSchemaLoader::setCacheDir(const QString& dir) {
+    QWriteLocker locker(&s_lock);
+    s_cacheDir = dir;
+}
+
+QString ToolSchemaLoader::cachePath(const QByteArray& yamlContent) {
+    const QString dir = cacheDir();
+    if (dir.isEmpty()) {
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(kCacheFormat));
+    hash.addData(yamlContent);
+    return dir + "/" + QString::fromLatin1(hash.result().toHex()) + ".jsonl";
+}
+
+bool ToolSchemaLoader::readCache(const QString& path, QVector<Tool>& tools) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    tools.clear();
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.endsWith('\n')) {
+            line.chop(1);
+        }
+        if (line.isEmpty()) {
+            continue;
+        }
+        const QJsonObject function = QJsonDocument::fromJson(line).object()["function"].toObject();
+        if (function.isEmpty()) {
+            qCWarning(lcConfig) << "[ToolSchemaLoader] 编译缓存已损坏，重新解析 YAML:" << path;
+            return false;
+        }
+        Tool tool;
+        tool.name = function["name"].toString();
+        tool.description = function["description"].toString();
+        tool.inputSchema = function["parameters"].toObject();
+        tool.serialized = line;
+        tools.append(tool);
+    }
+    qCDebug(lcConfig) << "[ToolSchemaLoader] 使用编译缓存:" << path;
+    return true;
+}
+
+void ToolSchemaLoader::writeCache(const QString& path, const QVector<Tool>& tools) {
+    QDir().mkpath(QFileInfo(path).path());
+    
+    // NOTE: QSaveFile 先写临时文件再改名，多个进程同时启动也不会读到写了一半的缓存
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(lcConfig) << "[ToolSchemaLoader] 无法写入编译缓存:" << path << file.errorString();
+        return;
+    }
+    for (const Tool& tool : tools) {
+        file.write(tool.toJsonBytes());
+        file.write("\n");
+    }
+    file.commit();
 }
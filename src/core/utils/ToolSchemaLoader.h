@@ -3,47 +3,79 @@
 
 #include <QString>
 #include <QVector>
-#include <QMap>
+#include <QHash>
+#include <QReadWriteLock>
 #include "core/agent/ToolTypes.h"
 
 /**
  * @brief 工具 Schema 加载器
- * 
+ *
  * 从 YAML 文件加载工具定义，将其转换为 Tool 对象。
  * 支持运行时加载，无需重新编译即可更新工具定义。
+ *
+ * 编译缓存：YAML 解析后的结果按文件内容的 SHA-1 写入缓存目录（<hash>.jsonl，每行一个工具的
+ * API 格式 JSON），内容未变时直接读缓存、跳过 yaml-cpp；每行字节原样存入 Tool::serialized，
+ * 请求体拼接工具定义时不再重新序列化。
+ *
+ * 线程安全：所有静态函数都可在任意线程调用，重新加载时整体替换已加载的工具表。
  */
 class ToolSchemaLoader {
 public:
+    static constexpr int kCacheFormat = 1;  // 编译结果格式变化时加 1，旧缓存自动失效
+
     /**
-     * @brief 从 YAML 文件加载所有工具定义
+     * @brief 从 YAML 文件加载所有工具定义（优先使用编译缓存）
      * @param yamlPath YAML 文件的绝对路径
-     * @return 加载的工具列表
+     * @return 加载的工具列表（按文件中的顺序）；文件不存在或解析失败时为空，已加载的工具保持不变
      */
     static QVector<Tool> loadFromFile(const QString& yamlPath);
-    
+
     /**
      * @brief 获取指定名称的工具 Schema
      * @param name 工具名称
      * @return 工具定义（如果未找到返回空 Tool）
      */
     static Tool getToolSchema(const QString& name);
-    
+
     /**
      * @brief 获取所有已加载的工具
      * @return 工具列表
      */
     static QVector<Tool> getAllTools();
-    
+
     /**
      * @brief 刷新工具定义（重新从文件加载）
      * @param yamlPath YAML 文件路径
      */
     static void reload(const QString& yamlPath);
 
+    /**
+     * @brief 默认的 tools.yaml 路径（依次查找程序目录、上级目录与工作目录下的 resources/，结果缓存）
+     * @return 未找到时为空
+     */
+    static QString defaultPath();
+
+    /**
+     * @brief 编译缓存目录（默认 <CacheLocation>/tool_schemas），测试中可改到临时目录
+     */
+    static QString cacheDir();
+    static void setCacheDir(const QString& dir);
+
+    /**
+     * @brief 给定 YAML 内容对应的缓存文件路径
+     */
+    static QString cachePath(const QByteArray& yamlContent);
+
 private:
-    // 缓存已加载的工具
-    static QMap<QString, Tool> s_toolCache;
+    static bool parseYaml(const QByteArray& content, QVector<Tool>& tools);
+    static bool readCache(const QString& path, QVector<Tool>& tools);
+    static void writeCache(const QString& path, const QVector<Tool>& tools);
+
+    // 缓存已加载的工具（s_lock 保护）
+    static QReadWriteLock s_lock;
+    static QHash<QString, Tool> s_toolCache;
     static QString s_lastLoadedPath;
+    static QString s_cacheDir;
 };
 
 #endif // TOOLSCHEMALOADER_H
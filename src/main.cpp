@@ -1,9 +1,16 @@
 #include <QApplication>
 #include "ui/AgentChatWidget.h"
+#include "core/trace/Tracer.h"
+#include "core/log/Logger.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    Logger::initFromEnvironment();
+    
+    // NOTE: 界面版本始终记录计时（每个线程只保留最近的事件），慢的时候可随时导出
+    Tracer::setEnabled(true);
+    Tracer::initFromEnvironment();
     
     AgentChatWidget w;
     w.show();
@@ -0,0 +1,147 @@
+#include "MockLLMServer.h"
+#include <QCryptographicHash>
+#include <QJsonDocument>
+
+MockLLMServer::MockLLMServer(QObject *parent)
+    : SseServer(parent)
+{
+    setTiming(Timing::Recorded);  // 每行的发送时间由 buildStream 计算
+    setScript(MockScript());
+}
+
+void MockLLMServer::setScript(const MockScript& script) {
+    m_script = script;
+    m_random.seed(script.seed);
+    m_failedOnce.clear();
+}
+
+QJsonObject MockLLMServer::statsJson() const {
+    QJsonObject injected;
+    for (auto it = m_injected.constBegin(); it != m_injected.constEnd(); ++it) {
+        injected[it.key()] = it.value();
+    }
+    return QJsonObject{{"requests", m_requests},
+                       {"active", activeStreams()},
+                       {"completionChunks", m_completionChunks},
+                       {"injected", injected}};
+}
+
+int MockLLMServer::respond(const QByteArray& body, SseExchange& response) {
+    const int index = m_requests++;
+    const QJsonObject request = QJsonDocument::fromJson(body).object();
+
+    QString userMessage;
+    const int stepIndex = MockScript::stepIndex(request["messages"].toArray(), userMessage);
+    const MockStep step = m_script.step(userMessage, stepIndex);
+
+    buildStream(step, body.size(), response);
+    const QString failure = pickFailure(body, step);
+    if (!failure.isEmpty()) {
+        m_injected[failure] += 1;
+        injectFailure(failure, response);
+    }
+    return index;
+}
+
+QString MockLLMServer::pickFailure(const QByteArray& body, const MockStep& step) {
+    // 脚本指定的故障只注入一次，客户端用相同请求体重试时正常回复
+    if (!step.fail.isEmpty()) {
+        const QByteArray key = QCryptographicHash::hash(body, QCryptographicHash::Sha1);
+        if (!m_failedOnce.contains(key)) {
+            m_failedOnce.insert(key);
+            return step.fail;
+        }
+    }
+
+    // NOTE: 每个请求只抽一次随机数，各类故障按概率占据 [0, 1) 中互不重叠的区间
+    if (m_script.failureRates.isEmpty()) {
+        return QString();
+    }
+    double roll = m_random.generateDouble();
+    for (auto it = m_script.failureRates.constBegin(); it != m_script.failureRates.constEnd(); ++it) {
+        if (roll < it.value()) {
+            return it.key();
+        }
+        roll -= it.value();
+    }
+    return QString();
+}
+
+static SseLine sseLine(int timeMs, const QJsonObject& chunk) {
+    return SseLine{timeMs, "data: " + QJsonDocument(chunk).toJson(QJsonDocument::Compact)};
+}
+
+static QJsonObject deltaChunk(const QJsonObject& delta, const QJsonValue& finishReason = QJsonValue::Null) {
+    QJsonObject choice{{"index", 0}, {"delta", delta}, {"finish_reason", finishReason}};
+    return QJsonObject{{"object", "chat.completion.chunk"}, {"model", "mock"}, {"choices", QJsonArray{choice}}};
+}
+
+void MockLLMServer::buildStream(const MockStep& step, int promptBytes, SseExchange& response) {
+    const double interval = m_script.chunksPerSecond > 0 ? 1000.0 / m_script.chunksPerSecond : 0.0;
+    double timeMs = m_script.latencyMs;
+    int chunks = 0;
+    auto nextTime = [&]() {
+        const int jitter = m_script.jitterMs > 0 ? int(m_random.bounded(m_script.jitterMs + 1)) : 0;
+        const int at = int(timeMs) + jitter;
+        timeMs += interval;
+        return at;
+    };
+
+    const int size = m_script.chunkChars;
+    QString content;
+    for (int i = 0; i < step.repeat; ++i) {
+        content += step.content;
+    }
+    for (int pos = 0; pos < content.size(); pos += size) {
+        response.lines.append(sseLine(nextTime(), deltaChunk(QJsonObject{{"content", content.mid(pos, size)}})));
+        ++chunks;
+    }
+
+    for (int i = 0; i < step.toolCalls.size(); ++i) {
+        const MockToolCall& call = step.toolCalls[i];
+        const QString id = QString("call_mock_%1_%2").arg(m_requests).arg(i);
+        QJsonObject head{{"index", i}, {"id", id}, {"type", "function"},
+                         {"function", QJsonObject{{"name", call.name}, {"arguments", ""}}}};
+        response.lines.append(sseLine(nextTime(), deltaChunk(QJsonObject{{"tool_calls", QJsonArray{head}}})));
+
+        const QString arguments = QString::fromUtf8(QJsonDocument(call.arguments).toJson(QJsonDocument::Compact));
+        for (int pos = 0; pos < arguments.size(); pos += size) {
+            QJsonObject part{{"index", i}, {"function", QJsonObject{{"arguments", arguments.mid(pos, size)}}}};
+            response.lines.append(sseLine(nextTime(), deltaChunk(QJsonObject{{"tool_calls", QJsonArray{part}}})));
+            ++chunks;
+        }
+    }
+
+    QString finishReason = step.finishReason;
+    if (finishReason.isEmpty()) {
+        finishReason = step.toolCalls.isEmpty() ? "stop" : "tool_calls";
+    }
+    const int endTime = nextTime();
+    response.lines.append(sseLine(endTime, deltaChunk(QJsonObject(), finishReason)));
+
+    // 开启 include_usage 时的最后一个 chunk（prompt token 按 4 字节 1 个粗略估算）
+    const QJsonObject usage{{"prompt_tokens", promptBytes / 4},
+                            {"completion_tokens", chunks},
+                            {"total_tokens", promptBytes / 4 + chunks}};
+    response.lines.append(sseLine(endTime, QJsonObject{{"object", "chat.completion.chunk"}, {"model", "mock"},
+                                                       {"choices", QJsonArray()}, {"usage", usage}}));
+    response.lines.append(SseLine{endTime, "data: [DONE]"});
+    m_completionChunks += chunks;
+}
+
+void MockLLMServer::injectFailure(const QString& kind, SseExchange& response) const {
+    if (kind == "429" || kind == "500") {
+        const QString message = kind == "429" ? "Rate limit reached (mock)" : "Internal server error (mock)";
+        response.status = kind.toInt();
+        response.lines = {SseLine{m_script.latencyMs, QJsonDocument(QJsonObject{
+            {"error", QJsonObject{{"message", message}, {"type", "mock_failure"}}}}).toJson(QJsonDocument::Compact)}};
+        if (kind == "429") {
+            response.headers.append(qMakePair(QByteArray("Retry-After"), QByteArray::number(m_script.retryAfterSec)));
+        }
+    } else if (kind == "drop" || kind == "stall") {
+        response.lines = response.lines.mid(0, response.lines.size() / 2);
+        response.ending = kind == "drop" ? SseExchange::Ending::Close : SseExchange::Ending::Hang;
+    } else if (kind == "truncate") {
+        response.lines = response.lines.mid(0, response.lines.size() - 3);  // 去掉 finish_reason、usage 与 [DONE]
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef MOCKLLMSERVER_H
+#define MOCKLLMSERVER_H
+
+#include <QSet>
+#include <QMap>
+#include <QRandomGenerator>
+#include "MockScript.h"
+#include "core/net/SseServer.h"
+
+/**
+ * @brief 按脚本回复的本地 LLM 服务（OpenAI 兼容的流式 /chat/completions）
+ *
+ * 与真实服务一样分片输出文本与 tool_calls、以 finish_reason 与 usage 结束，
+ * 并按脚本注入 429 / 5xx / 中途断开 / 挂起 / 缺少 finish_reason，用于压测调度、流式解码与重试。
+ *
+ * 使用方式:
+ *   MockLLMServer server;
+ *   server.setScript(script);
+ *   server.listen(8080);
+ *   config.baseUrl = server.baseUrl();   // 或 TmMockServer --port 8080 后在配置中填写
+ */
+class MockLLMServer : public SseServer {
+    Q_OBJECT
+public:
+    explicit MockLLMServer(QObject *parent = nullptr);
+
+    void setScript(const MockScript& script);
+    const MockScript& script() const { return m_script; }
+
+    int requestCount() const { return m_requests; }
+    int injectedCount(const QString& kind) const { return m_injected.value(kind); }
+
+    // {"requests": n, "active": n, "completionChunks": n, "injected": {"429": n, ...}}
+    QJsonObject statsJson() const;
+
+protected:
+    int respond(const QByteArray& body, SseExchange& response) override;
+
+private:
+    QString pickFailure(const QByteArray& body, const MockStep& step);
+    void buildStream(const MockStep& step, int promptBytes, SseExchange& response);
+    void injectFailure(const QString& kind, SseExchange& response) const;
+
+    MockScript m_script;
+    QRandomGenerator m_random;
+    QSet<QByteArray> m_failedOnce;  // 已注入过脚本故障的请求（按请求体哈希）
+    int m_requests = 0;
+    qint64 m_completionChunks = 0;
+    QMap<QString, int> m_injected;
+};
+
+#endif // MOCKLLMSERVER_H
@@ -0,0 +1,104 @@
+#include "MockScript.h"
+
+const QStringList& MockScript::failureKinds() {
+    static const QStringList kinds = {"429", "500", "drop", "stall", "truncate"};
+    return kinds;
+}
+
+static bool parseStep(const QJsonObject& json, MockStep& step, QString& error) {
+    step.content = json["content"].toString();
+    step.repeat = qMax(1, json["repeat"].toInt(1));
+    step.finishReason = json["finishReason"].toString();
+    step.fail = json["fail"].toString();
+    if (!step.fail.isEmpty() && !MockScript::failureKinds().contains(step.fail)) {
+        error = QString("未知的故障类型: %1").arg(step.fail);
+        return false;
+    }
+    for (const QJsonValue& value : json["toolCalls"].toArray()) {
+        const QJsonObject call = value.toObject();
+        if (call["name"].toString().isEmpty()) {
+            error = "toolCalls 中的条目缺少 name";
+            return false;
+        }
+        step.toolCalls.append(MockToolCall{call["name"].toString(), call["arguments"].toObject()});
+    }
+    return true;
+}
+
+bool MockScript::fromJson(const QJsonObject& json, MockScript& script, QString& error) {
+    script = MockScript();
+    script.latencyMs = qMax(0, json["latencyMs"].toInt());
+    script.jitterMs = qMax(0, json["jitterMs"].toInt());
+    script.chunkChars = qMax(1, json["chunkChars"].toInt(script.chunkChars));
+    script.chunksPerSecond = qMax(0.0, json["chunksPerSecond"].toDouble());
+    script.seed = quint32(json["seed"].toInt(int(script.seed)));
+
+    const QJsonObject failures = json["failures"].toObject();
+    for (auto it = failures.constBegin(); it != failures.constEnd(); ++it) {
+        if (it.key() == "retryAfterSec") {
+            script.retryAfterSec = qMax(0, it.value().toInt());
+        } else if (failureKinds().contains(it.key())) {
+            script.failureRates.insert(it.key(), qBound(0.0, it.value().toDouble(), 1.0));
+        } else {
+            error = QString("未知的故障类型: %1").arg(it.key());
+            return false;
+        }
+    }
+
+    const QJsonArray scenarios = json["scenarios"].toArray();
+    for (int i = 0; i < scenarios.size(); ++i) {
+        const QJsonObject object = scenarios[i].toObject();
+        MockScenario scenario;
+        const QString pattern = object["match"].toString();
+        if (!pattern.isEmpty()) {
+            scenario.match.setPattern(pattern);
+            if (!scenario.match.isValid()) {
+                error = QString("第 %1 个场景的 match 不是有效的正则: %2").arg(i + 1).arg(scenario.match.errorString());
+                return false;
+            }
+        }
+        for (const QJsonValue& value : object["steps"].toArray()) {
+            MockStep step;
+            if (!parseStep(value.toObject(), step, error)) {
+                error = QString("第 %1 个场景: %2").arg(i + 1).arg(error);
+                return false;
+            }
+            scenario.steps.append(step);
+        }
+        script.scenarios.append(scenario);
+    }
+    return true;
+}
+
+int MockScript::stepIndex(const QJsonArray& messages, QString& lastUserMessage) {
+    int index = 0;
+    for (int i = messages.size() - 1; i >= 0; --i) {
+        const QJsonObject message = messages[i].toObject();
+        const QString role = message["role"].toString();
+        if (role == "user") {
+            lastUserMessage = message["content"].toString();
+            return index;
+        }
+        if (role == "assistant") {
+            ++index;
+        }
+    }
+    lastUserMessage.clear();
+    return index;
+}
+
+MockStep MockScript::step(const QString& userMessage, int index) const {
+    for (const MockScenario& scenario : scenarios) {
+        if (!scenario.match.pattern().isEmpty() && !scenario.match.match(userMessage).hasMatch()) {
+            continue;
+        }
+        if (index < scenario.steps.size()) {
+            return scenario.steps[index];
+        }
+        break;  // 匹配的场景已执行完
+    }
+
+    MockStep done;
+    done.content = "（mock）任务已完成。";
+    return done;
+}
@@ -0,0 +1,93 @@
+#ifndef MOCKSCRIPT_H
+#define MOCKSCRIPT_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRegularExpression>
+
+/**
+ * @brief Mock 服务的回复脚本
+ *
+ * 脚本文件（所有字段可选）:
+ *   {
+ *     "latencyMs": 300,          // 首个 chunk 之前的等待（模拟排队与 prefill）
+ *     "jitterMs": 50,            // 每个 chunk 额外的随机延迟上限
+ *     "chunkChars": 4,           // 每个 chunk 的字符数（文本与工具参数都按它切分）
+ *     "chunksPerSecond": 40,     // 输出速率，0 表示尽快发送
+ *     "seed": 1,                 // 随机数种子（抖动与故障注入），相同种子结果可复现
+ *     "failures": {"429": 0.05, "500": 0.01, "drop": 0.02, "stall": 0, "truncate": 0, "retryAfterSec": 1},
+ *     "scenarios": [
+ *       {
+ *         "match": "构建",        // 正则，匹配最后一条 user 消息；省略表示匹配所有
+ *         "steps": [
+ *           {"content": "先看看日志。", "toolCalls": [{"name": "view_file", "arguments": {"file_path": "build.log"}}]},
+ *           {"content": "缺少头文件。", "repeat": 20, "fail": "429"}
+ *         ]
+ *       }
+ *     ]
+ *   }
+ *
+ * 请求在会话中的步数 = 最后一条 user 消息之后 assistant 消息的条数，第 N 步回复 steps[N]；
+ * 超出脚本的步骤回复一句结束语。step.fail 只在该请求第一次到达时注入，客户端重试后正常回复。
+ *
+ * 故障类型:
+ *   429 / 500  返回对应状态码（429 带 Retry-After）
+ *   drop       输出一半后断开连接
+ *   stall      输出一半后挂起，直到客户端空闲超时
+ *   truncate   正常结束但没有 finish_reason
+ */
+
+struct MockToolCall {
+    QString name;
+    QJsonObject arguments;
+};
+
+struct MockStep {
+    QString content;
+    int repeat = 1;                  // content 重复次数（生成长回复）
+    QList<MockToolCall> toolCalls;
+    QString finishReason;            // 为空时按是否有工具调用取 "tool_calls" / "stop"
+    QString fail;                    // 第一次请求时注入的故障
+};
+
+struct MockScenario {
+    QRegularExpression match;        // 为空表示匹配所有
+    QList<MockStep> steps;
+};
+
+class MockScript {
+public:
+    int latencyMs = 0;
+    int jitterMs = 0;
+    int chunkChars = 4;
+    double chunksPerSecond = 0;
+    quint32 seed = 1;
+    QMap<QString, double> failureRates;  // 故障类型 -> 每个请求的注入概率
+    int retryAfterSec = 1;
+    QList<MockScenario> scenarios;
+
+    static const QStringList& failureKinds();
+
+    /**
+     * @brief 从脚本 JSON 解析
+     * @return 失败时 error 给出原因（正则无效、未知的故障类型等）
+     */
+    static bool fromJson(const QJsonObject& json, MockScript& script, QString& error);
+
+    /**
+     * @brief 请求在会话中的位置
+     * @param lastUserMessage 输出最后一条 user 消息的内容
+     * @return 最后一条 user 消息之后 assistant 消息的条数
+     */
+    static int stepIndex(const QJsonArray& messages, QString& lastUserMessage);
+
+    /**
+     * @brief 第 index 步的回复（第一个匹配的场景；没有匹配或超出脚本时为结束语）
+     */
+    MockStep step(const QString& userMessage, int index) const;
+};
+
+#endif // MOCKSCRIPT_H
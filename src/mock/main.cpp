@@ -0,0 +1,87 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTimer>
+#include <cstdio>
+#include "MockLLMServer.h"
+
+/**
+ * 本地 Mock LLM 服务（压测用，不消耗 token）
+ *
+ *   TmMockServer --port 8080 --script mock.json
+ *   TmMockServer --rate 50 --latency 300 --fail 429=0.05 --fail drop=0.02
+ *
+ * Agent 的 baseUrl 填 http://127.0.0.1:8080，API Key 任意。每 5 秒向 stderr 输出一行统计（JSON）。
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("OpenAI 兼容的本地 Mock LLM 服务（流式 /chat/completions）");
+    parser.addHelpOption();
+    parser.addOption({"port", "监听端口（仅 127.0.0.1）", "port", "8080"});
+    parser.addOption({"script", "回复脚本（JSON，格式见 src/mock/MockScript.h）", "file"});
+    parser.addOption({"latency", "首个 chunk 前的等待（毫秒）", "ms"});
+    parser.addOption({"jitter", "每个 chunk 的随机延迟上限（毫秒）", "ms"});
+    parser.addOption({"chunk-chars", "每个 chunk 的字符数", "n"});
+    parser.addOption({"rate", "每秒输出的 chunk 数，0 表示尽快发送", "n"});
+    parser.addOption({"seed", "随机数种子", "n"});
+    parser.addOption({"fail", "按概率注入故障，可重复: 429|500|drop|stall|truncate=<0~1>", "kind=p"});
+    parser.process(app);
+
+    MockScript script;
+    if (parser.isSet("script")) {
+        QFile file(parser.value("script"));
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "无法打开脚本: %s\n", qPrintable(file.errorString()));
+            return 2;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+        QString error = parseError.errorString();
+        if (!doc.isObject() || !MockScript::fromJson(doc.object(), script, error)) {
+            std::fprintf(stderr, "脚本无效: %s\n", qPrintable(error));
+            return 2;
+        }
+    }
+
+    // 命令行参数覆盖脚本中的设置
+    if (parser.isSet("latency")) script.latencyMs = qMax(0, parser.value("latency").toInt());
+    if (parser.isSet("jitter")) script.jitterMs = qMax(0, parser.value("jitter").toInt());
+    if (parser.isSet("chunk-chars")) script.chunkChars = qMax(1, parser.value("chunk-chars").toInt());
+    if (parser.isSet("rate")) script.chunksPerSecond = qMax(0.0, parser.value("rate").toDouble());
+    if (parser.isSet("seed")) script.seed = parser.value("seed").toUInt();
+    for (const QString& value : parser.values("fail")) {
+        const QString kind = value.section('=', 0, 0);
+        bool ok = false;
+        const double rate = value.section('=', 1).toDouble(&ok);
+        if (!MockScript::failureKinds().contains(kind) || !ok) {
+            std::fprintf(stderr, "无效的 --fail: %s\n", qPrintable(value));
+            return 2;
+        }
+        script.failureRates.insert(kind, qBound(0.0, rate, 1.0));
+    }
+
+    MockLLMServer server;
+    server.setScript(script);
+    if (!server.listen(quint16(parser.value("port").toUInt()))) {
+        std::fprintf(stderr, "无法监听端口 %s\n", qPrintable(parser.value("port")));
+        return 2;
+    }
+    std::fprintf(stderr, "Mock LLM 服务: %s\n", qPrintable(server.baseUrl()));
+
+    QByteArray lastStats;
+    QTimer statsTimer;
+    QObject::connect(&statsTimer, &QTimer::timeout, [&server, &lastStats]() {
+        const QByteArray stats = QJsonDocument(server.statsJson()).toJson(QJsonDocument::Compact);
+        if (stats != lastStats) {
+            std::fprintf(stderr, "%s\n", stats.constData());
+            lastStats = stats;
+        }
+    });
+    statsTimer.start(5000);
+
+    return app.exec();
+}
@@ -1,12 +1,26 @@
 #include "AgentChatWidget.h"
+#include "HistoryModel.h"
+#include "HistoryDelegate.h"
+#include "TranscriptModel.h"
+#include "TranscriptView.h"
 #include "core/utils/AppSettings.h"
 #include "core/agent/ToolDispatcher.h"
+#include "core/events/EventBus.h"
+#include "core/tools/ShellTool.h"
+#include "core/trace/Tracer.h"
+#include "core/metrics/MetricsRegistry.h"
+#include "core/log/LogCategories.h"
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QGroupBox>
 #include <QSplitter>
-#include <QTextCursor>
-#include <QTextDocument>
+#include <QFileDialog>
+#include <QDateTime>
+#include <QTimer>
+#include <QFontDatabase>
+#include <QListView>
+#include <QScrollBar>
+#include <QJsonObject>
 
 AgentChatWidget::AgentChatWidget(QWidget *parent) : QWidget(parent) {
     m_agent = new LLMAgent(this);
@@ -16,16 +30,56 @@ AgentChatWidget::AgentChatWidget(QWidget *parent) : QWidget(parent) {
     // NOTE: 将 ToolDispatcher 传给 Agent，实现自治执行（会自动注册工具）
     m_agent->setToolDispatcher(m_toolDispatcher);
     
+    // 执行可执行文件前弹窗确认
+    ShellTool::setApprovalHandler([this](const QString& command, const QString& workingDir) {
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            this,
+            "执行确认",
+            QString("Agent 请求执行以下命令：\n\n%1\n\n工作目录：%2\n\n是否允许执行？")
+                .arg(command)
+                .arg(workingDir),
+            QMessageBox::Yes | QMessageBox::No,
+            QMessageBox::No  // 默认选中"否"
+        );
+        return reply == QMessageBox::Yes;
+    });
+    
     setupUI();
     loadConfig();
 
-    // 接收到字节流信息
-    connect(m_agent, &LLMAgent::streamDataReceived, this, &AgentChatWidget::onStreamDataReceived);
-    connect(m_agent, &LLMAgent::finished, this, &AgentChatWidget::onFinished);
-    connect(m_agent, &LLMAgent::errorOccurred, this, &AgentChatWidget::onErrorOccurred);
-    
-    // 连接工具事件信号（统一处理 started/completed）
-    connect(m_agent, &LLMAgent::toolEvent, this, &AgentChatWidget::onToolEvent);
+    // NOTE: 历史面板逐条追加，不再每轮遍历整个历史重建 HTML
+    connect(m_agent, &LLMAgent::historyAppended, this, &AgentChatWidget::onHistoryAppended);
+    connect(m_agent, &LLMAgent::historyReset, this, &AgentChatWidget::updateHistoryDisplay);
+
+    // NOTE: 流式输出、工具事件、结束与错误统一经 EventBus 按发布顺序批量送达，
+    //       UI 刷新慢时只会合并流式片段，不会阻塞 Agent 的网络读取与工具执行
+    EventBus::Options options;
+    options.source = m_agent->eventSource();
+    options.kinds = static_cast<int>(EventKind::Log) | static_cast<int>(EventKind::Finished);
+    options.overflow = EventBus::Overflow::Coalesce;
+    EventBus::instance().subscribe(this, [this](const QVector<AgentEvent>& events) {
+        onAgentEvents(events);
+    }, options);
+}
+
+void AgentChatWidget::onAgentEvents(const QVector<AgentEvent>& events) {
+    TraceSpan span("ui", "flush");
+    span.setArg("events", events.size());
+    for (const AgentEvent& event : events) {
+        // 中断后仍在队列中的旧事件不再显示
+        if (!m_abortBtn->isEnabled()) {
+            break;
+        }
+        if (event.kind == EventKind::Finished) {
+            onFinished(event.message);
+        } else if (event.channel == EventChannel::STREAM) {
+            onStreamDataReceived(event.message);
+        } else if (event.channel == EventChannel::TOOL) {
+            onToolEvent(ToolExecutionEvent::fromJson(event.data));
+        } else if (event.channel == EventChannel::FAILURE) {
+            onErrorOccurred(event.message);
+        }
+    }
 }
 
 void AgentChatWidget::setupUI() {
@@ -71,13 +125,36 @@ void AgentChatWidget::setupUI() {
     m_debugModeCheck->setToolTip("启用后显示详细的工具调用信息");
     connect(m_debugModeCheck, &QCheckBox::toggled, this, [this](bool checked) {
         m_isDebugMode = checked;
-        m_chatDisplay->append(QString("<p style='color: #666;'><i>已切换到%1模式</i></p>")
-            .arg(checked ? "调试" : "用户友好"));
+        appendNotice(QString("已切换到%1模式").arg(checked ? "调试" : "用户友好"));
     });
     formLayout->addRow(m_debugModeCheck);
 
+    m_exportTraceBtn = new QPushButton("导出 Trace", this);
+    m_exportTraceBtn->setToolTip("导出最近的请求、工具、解析与界面刷新耗时，用 chrome://tracing 或 ui.perfetto.dev 打开");
+    connect(m_exportTraceBtn, &QPushButton::clicked, this, &AgentChatWidget::onExportTraceClicked);
+    formLayout->addRow(m_exportTraceBtn);
+
     leftLayout->addWidget(configGroup);
-    leftLayout->addStretch();
+
+    // 指标面板：首 token、生成速度、token 与字节数、重试、各工具耗时
+    QGroupBox *metricsGroup = new QGroupBox("指标", this);
+    QVBoxLayout *metricsLayout = new QVBoxLayout(metricsGroup);
+    m_metricsDisplay = new QTextBrowser(this);
+    m_metricsDisplay->setMinimumHeight(160);
+    m_metricsDisplay->setLineWrapMode(QTextEdit::NoWrap);
+    m_metricsDisplay->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    metricsLayout->addWidget(m_metricsDisplay);
+    m_resetMetricsBtn = new QPushButton("重置指标", this);
+    connect(m_resetMetricsBtn, &QPushButton::clicked, this, [this]() {
+        MetricsRegistry::instance().reset();
+        updateMetricsDisplay();
+    });
+    metricsLayout->addWidget(m_resetMetricsBtn);
+    leftLayout->addWidget(metricsGroup, 1);
+
+    m_metricsTimer = new QTimer(this);
+    connect(m_metricsTimer, &QTimer::timeout, this, &AgentChatWidget::updateMetricsDisplay);
+    m_metricsTimer->start(1000);
     
     splitter->addWidget(leftContainer);
 
@@ -86,8 +163,9 @@ void AgentChatWidget::setupUI() {
     QVBoxLayout *centerLayout = new QVBoxLayout(centerContainer);
     centerLayout->setContentsMargins(0, 0, 0, 0);
     
-    m_chatDisplay = new QTextBrowser(this);
-    m_chatDisplay->setPlaceholderText("交流内容显示区...");
+    m_transcript = new TranscriptModel(this);
+    m_chatDisplay = new TranscriptView(this);
+    m_chatDisplay->setTranscriptModel(m_transcript);
     centerLayout->addWidget(m_chatDisplay, 1);
 
     // 输入区
@@ -100,9 +178,13 @@ void AgentChatWidget::setupUI() {
     m_sendBtn = new QPushButton("发送 (Send)", this);
     m_abortBtn = new QPushButton("停止 (Abort)", this);
     m_abortBtn->setEnabled(false);
+    m_resumeBtn = new QPushButton("继续 (Resume)", this);
+    m_resumeBtn->setEnabled(false);
+    m_resumeBtn->setToolTip("网络中断且自动重试失败后，从最后完成的步骤继续");
     
     btnLayout->addWidget(m_sendBtn);
     btnLayout->addWidget(m_abortBtn);
+    btnLayout->addWidget(m_resumeBtn);
     
     inputLayout->addWidget(m_inputEdit);
     inputLayout->addLayout(btnLayout);
@@ -122,9 +204,16 @@ void AgentChatWidget::setupUI() {
     m_historyLabel->setFont(labelFont);
     historyLayout->addWidget(m_historyLabel);
     
-    m_historyDisplay = new QTextBrowser(this);
-    m_historyDisplay->setPlaceholderText("对话历史将在此显示...");
-    historyLayout->addWidget(m_historyDisplay, 1);
+    m_historyModel = new HistoryModel(this);
+    m_historyView = new QListView(this);
+    m_historyView->setModel(m_historyModel);
+    m_historyView->setItemDelegate(new HistoryDelegate(m_historyView));
+    m_historyView->setUniformItemSizes(true);  // 固定行高：追加行时不测量文本
+    m_historyView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    m_historyView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_historyView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_historyView->setMouseTracking(true);  // 悬停显示完整内容
+    historyLayout->addWidget(m_historyView, 1);
     
     m_clearHistoryBtn = new QPushButton("清空历史", this);
     historyLayout->addWidget(m_clearHistoryBtn);
@@ -140,24 +229,25 @@ void AgentChatWidget::setupUI() {
 
     connect(m_sendBtn, &QPushButton::clicked, this, &AgentChatWidget::onSendClicked);
     connect(m_abortBtn, &QPushButton::clicked, this, &AgentChatWidget::onAbortClicked);
+    connect(m_resumeBtn, &QPushButton::clicked, this, &AgentChatWidget::onResumeClicked);
     connect(m_clearHistoryBtn, &QPushButton::clicked, this, &AgentChatWidget::onClearHistoryClicked);
 }
 
 // ==================== UI 辅助函数 ====================
 
 void AgentChatWidget::appendUserMessage(const QString& message) {
-    m_chatDisplay->append("<br>");
-    m_chatDisplay->append("<b style='color: #2196F3;'>User:</b>");
-    m_chatDisplay->append("<p>" + message.toHtmlEscaped() + "</p>");
+    m_transcript->append(TranscriptModel::Kind::User, message);
+    m_chatDisplay->followTail();  // 发送新问题时回到底部
 }
 
-void AgentChatWidget::appendAssistantLabel() {
-    m_chatDisplay->append("<b style='color: #4CAF50;'>Assistant:</b>\n");
+void AgentChatWidget::appendNotice(const QString& text) {
+    m_transcript->append(TranscriptModel::Kind::Notice, text);
 }
 
 void AgentChatWidget::setSendingState(bool isSending) {
     m_sendBtn->setEnabled(!isSending);
     m_abortBtn->setEnabled(isSending);
+    m_resumeBtn->setEnabled(false);
     m_testToolBtn->setEnabled(!isSending);
     
     if (!isSending) {
@@ -204,10 +294,6 @@ void AgentChatWidget::onSendClicked() {
     QString prompt = m_inputEdit->toPlainText().trimmed();
     if (prompt.isEmpty()) return;
 
-    // 清空累积内容
-    m_currentAssistantReply.clear();
-    m_pendingAssistantSeparator = false;
-
     // 显示用户消息
     appendUserMessage(prompt);
     setSendingState(true);
@@ -218,123 +304,84 @@ void AgentChatWidget::onSendClicked() {
 
 void AgentChatWidget::onAbortClicked() {
     m_agent->abort();
-    m_chatDisplay->append("<br><i>[已中断]</i>");
+    appendNotice("[已中断]");
     setSendingState(false);
 }
 
+void AgentChatWidget::onResumeClicked() {
+    // 已输出的部分保留在界面上，Agent 只会输出之后的新内容
+    appendNotice("[继续]");
+    m_sendBtn->setEnabled(false);
+    m_abortBtn->setEnabled(true);
+    m_testToolBtn->setEnabled(false);
+    m_resumeBtn->setEnabled(false);
+    m_agent->resume();
+}
+
 void AgentChatWidget::onStreamDataReceived(const QString& data) {
-    // 首次收到数据时处理分隔和标签
-    if (m_currentAssistantReply.isEmpty()) {
-        if (m_pendingAssistantSeparator) {
-            // 工具日志与助手回复之间加一行，避免粘连
-            m_chatDisplay->append("\n");
-            m_pendingAssistantSeparator = false;
-        }
-        
-        // 检测 LLM 是否自带 "Assistant:" 前缀，避免重复
-        if (!data.trimmed().startsWith("Assistant:")) {
-            appendAssistantLabel();
+    static const QString kPrefix = "Assistant:";
+    QString text = data;
+    // 检测 LLM 是否自带 "Assistant:" 前缀，避免与块标题重复
+    if (!m_transcript->isStreaming() && text.trimmed().startsWith(kPrefix)) {
+        text = text.mid(text.indexOf(kPrefix) + kPrefix.size());
+        while (!text.isEmpty() && text.front().isSpace()) {
+            text.remove(0, 1);
         }
     }
     
-    m_currentAssistantReply += data;
-    
-    // 实时显示纯文本(流式效果)
-    QTextCursor cursor = m_chatDisplay->textCursor();
-    cursor.movePosition(QTextCursor::End);
-    m_chatDisplay->setTextCursor(cursor);
-    
-    m_chatDisplay->insertPlainText(data);
-    m_chatDisplay->ensureCursorVisible();
+    // 实时显示纯文本（流式效果），只有当前助手块重新排版
+    m_transcript->appendStreamText(text);
 }
 
 void AgentChatWidget::onFinished(const QString& fullContent) {
-    qDebug() << "========== onFinished 被调用 ==========";
-    qDebug() << "内容:" << fullContent;
-    qDebug() << "当前累积内容长度:" << m_currentAssistantReply.length();
+    qCDebug(lcUi) << "onFinished, 内容长度:" << fullContent.length()
+                  << "流式输出中:" << m_transcript->isStreaming();
     
-    Q_UNUSED(fullContent);
-    
-    // 将累积的纯文本替换为 Markdown 渲染
-    if (!m_currentAssistantReply.isEmpty()) {
-        QTextCursor cursor = m_chatDisplay->textCursor();
-        cursor.movePosition(QTextCursor::End);
-        
-        // 向前删除刚才插入的纯文本
-        for (int i = 0; i < m_currentAssistantReply.length(); i++) {
-            cursor.deletePreviousChar();
-        }
-        
-        // 使用 QTextDocument 渲染 Markdown
-        QTextDocument doc;
-        doc.setMarkdown(m_currentAssistantReply);
-        
-        // 插入渲染后的 HTML
-        cursor.insertHtml(doc.toHtml());
-        m_chatDisplay->setTextCursor(cursor);
-    } else {
-        // 工具调用模式下,可能没有累积内容,直接显示 fullContent
-        if (!fullContent.isEmpty()) {
-            m_chatDisplay->append(fullContent);
-        }
+    // 结束流式输出，助手块下次绘制时按 Markdown 渲染
+    if (!m_transcript->finishStreaming() && !fullContent.isEmpty()) {
+        // 工具调用模式下,可能没有流式内容,直接显示 fullContent
+        m_transcript->append(TranscriptModel::Kind::Assistant, fullContent);
     }
     
-    qDebug() << "恢复按钮状态...";
     setSendingState(false);
-    qDebug() << "按钮状态已恢复";
     
 }
 
+void AgentChatWidget::updateHistoryLabel() {
+    m_historyLabel->setText(QString("对话历史 (共 %1 轮)").arg(m_agent->getConversationCount()));
+}
+
 void AgentChatWidget::updateHistoryDisplay() {
-    QJsonArray history = m_agent->getHistory();
-    int count = m_agent->getConversationCount();
-    
-    m_historyLabel->setText(QString("对话历史 (共 %1 轮)").arg(count));
-    
-    if (history.isEmpty()) {
-        m_historyDisplay->clear();
+    m_historyModel->setHistory(m_agent->getHistory());
+    updateHistoryLabel();
+    m_historyView->scrollToBottom();
+}
+
+void AgentChatWidget::onHistoryAppended(const QJsonObject& message) {
+    // 用户正在往上翻看时不跳到底部
+    QScrollBar *bar = m_historyView->verticalScrollBar();
+    const bool atBottom = bar->value() >= bar->maximum();
+    if (!m_historyModel->append(message)) {
         return;
     }
-    
-    QString htmlContent;
-    int roundNum = 0;
-    
-    for (int i = 0; i < history.size(); i++) {
-        QJsonObject msg = history[i].toObject();
-        QString role = msg["role"].toString();
-        QString content = msg["content"].toString();
-        
-        if (role == "user") {
-            roundNum++;
-            htmlContent += QString("<p><b>第 %1 轮:</b></p>").arg(roundNum);
-            htmlContent += QString("<p style='color: blue;'><b>User:</b> %1</p>").arg(content.toHtmlEscaped());
-        } else if (role == "assistant") {
-            htmlContent += QString("<p style='color: green;'><b>Assistant:</b> %1</p><br>").arg(content.toHtmlEscaped());
-        }
+    updateHistoryLabel();
+    if (atBottom) {
+        m_historyView->scrollToBottom();
     }
-    
-    m_historyDisplay->setHtml(htmlContent);
 }
 
 void AgentChatWidget::onClearHistoryClicked() {
-    m_agent->clearHistory();
-    m_historyDisplay->clear();
-    m_historyLabel->setText("对话历史 (共 0 轮)");
-    m_chatDisplay->append("<br><i>[对话历史已清空]</i>");
+    m_agent->clearHistory();  // 经 historyReset 清空历史面板
+    appendNotice("[对话历史已清空]");
 }
 
 // ==================== 工具调用相关 ====================
 
 void AgentChatWidget::onTestToolClicked() {
-    // 清空累积内容
-    m_currentAssistantReply.clear();
-    m_pendingAssistantSeparator = false;
-    
     // 显示测试消息
     QString testPrompt = "请在 E:/test 目录下创建一个名为 helloworld.txt 的文件,内容是 'Hello from DeepSeek Tool Calling!'";
-    m_chatDisplay->append("<br>");
-    m_chatDisplay->append("<b style='color: #FF9800;'>🔧 工具调用测试:</b>");
-    m_chatDisplay->append("<p>" + testPrompt + "</p>");
+    m_transcript->append(TranscriptModel::Kind::User, testPrompt, "🔧 工具调用测试:");
+    m_chatDisplay->followTail();
     setSendingState(true);
     
     // 使用 sendMessage 发起工具调用
@@ -342,69 +389,96 @@ void AgentChatWidget::onTestToolClicked() {
 }
 
 
+void AgentChatWidget::onExportTraceClicked() {
+    const QString defaultName = QString("tmagent-trace-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+    const QString path = QFileDialog::getSaveFileName(this, "导出 Trace", defaultName, "Trace JSON (*.json)");
+    if (path.isEmpty()) {
+        return;
+    }
+
+    QString error;
+    if (!Tracer::instance().writeChromeTrace(path, error)) {
+        QMessageBox::warning(this, "导出失败", QString("无法写入 %1: %2").arg(path, error));
+        return;
+    }
+    appendNotice(QString("Trace 已导出到 %1").arg(path));
+}
+
+void AgentChatWidget::updateMetricsDisplay() {
+    if (!m_metricsDisplay->isVisible()) {
+        return;
+    }
+
+    const QJsonObject metrics = MetricsRegistry::instance().toJson();
+    QStringList lines;
+    const QJsonObject counters = metrics["counters"].toObject();
+    for (auto it = counters.constBegin(); it != counters.constEnd(); ++it) {
+        lines << QString("%1  %2").arg(it.key(), -28).arg(it.value().toVariant().toLongLong());
+    }
+    const QJsonObject gauges = metrics["gauges"].toObject();
+    for (auto it = gauges.constBegin(); it != gauges.constEnd(); ++it) {
+        lines << QString("%1  %2").arg(it.key(), -28).arg(it.value().toVariant().toLongLong());
+    }
+    const QJsonObject histograms = metrics["histograms"].toObject();
+    for (auto it = histograms.constBegin(); it != histograms.constEnd(); ++it) {
+        const QJsonObject h = it.value().toObject();
+        if (h["count"].toInt() == 0) {
+            continue;
+        }
+        lines << QString("%1  n=%2 p50=%3 p90=%4 p99=%5 max=%6 %7")
+                     .arg(it.key(), -28).arg(h["count"].toInt())
+                     .arg(h["p50"].toVariant().toLongLong()).arg(h["p90"].toVariant().toLongLong())
+                     .arg(h["p99"].toVariant().toLongLong()).arg(h["max"].toVariant().toLongLong())
+                     .arg(h["unit"].toString());
+    }
+
+    const QString text = lines.join('\n');
+    if (text != m_metricsDisplay->toPlainText()) {
+        m_metricsDisplay->setPlainText(text);
+    }
+}
+
 void AgentChatWidget::onErrorOccurred(const QString& errorMsg) {
-    m_chatDisplay->append(QString("<p style='color: red;'>❌ 错误: %1</p>").arg(errorMsg));
+    m_transcript->append(TranscriptModel::Kind::Error, QString("❌ 错误: %1").arg(errorMsg));
     
     // 恢复按钮状态
     m_sendBtn->setEnabled(true);
     m_abortBtn->setEnabled(false);
+    m_resumeBtn->setEnabled(m_agent->canResume());
 }
 
 // ==================== 工具事件处理 ====================
 
 void AgentChatWidget::onToolEvent(const ToolExecutionEvent& event) {
+    // NOTE: 每个工具事件是一个独立的块，调试模式的原始输出较长时默认折叠，点击标题展开
     if (event.status == "started") {
         // 工具开始执行
         if (m_isDebugMode) {
             // 调试模式: 显示详细信息
-            QString html = QString(
-                "<div style='background: #f0f0f0; padding: 8px; margin: 5px 0; border-left: 3px solid #2196F3;'>"
-                "<b>🔧 工具调用开始</b><br>"
-                "<b>工具名:</b> %1<br>"
-                "<b>详细信息:</b> <code>%2</code>"
-                "</div>")
-                .arg(event.toolName)
-                .arg(event.debugMessage().toHtmlEscaped());
-            m_chatDisplay->append(html);
+            m_transcript->appendTool(TranscriptModel::ToolStatus::Running,
+                                     QString("🔧 工具调用开始: %1").arg(event.toolName),
+                                     event.debugMessage());
         } else {
             // 用户友好模式: 显示简洁提示
-            QString html = QString("<p style='color: #888; font-style: italic; margin: 5px 0;'>🔧 %1</p>")
-                           .arg(event.userMessage());
-            m_chatDisplay->append(html);
+            m_transcript->appendTool(TranscriptModel::ToolStatus::Running,
+                                     QString("🔧 %1").arg(event.userMessage()));
         }
-        m_pendingAssistantSeparator = true;
         
     } else if (event.status == "completed") {
         // 工具执行完成
-        QString icon = event.success ? "✅" : "❌";
-        QString borderColor = event.success ? "#28a745" : "#dc3545";
+        const QString icon = event.success ? "✅" : "❌";
+        const auto status = event.success ? TranscriptModel::ToolStatus::Succeeded
+                                          : TranscriptModel::ToolStatus::Failed;
         
         if (m_isDebugMode) {
             // 调试模式: 显示完整结果
-            QString html = QString(
-                "<div style='background: #f8f9fa; padding: 8px; margin: 5px 0; border-left: 3px solid %1;'>"
-                "<b>%2 工具执行完成</b><br>"
-                "<b>工具名:</b> %3<br>"
-                "<b>结果:</b> %4<br>"
-                "<b>原始输出:</b><br><pre style='background: #eee; padding: 5px;'>%5</pre>"
-                "</div>")
-                .arg(borderColor)
-                .arg(icon)
-                .arg(event.toolName)
-                .arg(event.userMessage().toHtmlEscaped())
-                .arg(event.debugMessage().toHtmlEscaped());
-            m_chatDisplay->append(html);
+            m_transcript->appendTool(status,
+                                     QString("%1 工具执行完成: %2 - %3").arg(icon, event.toolName, event.userMessage()),
+                                     event.debugMessage());
         } else {
             // 用户友好模式: 显示简洁结果
-            QString html = QString("<p style='color: %1; margin: 5px 0;'>%2 %3</p>")
-                           .arg(borderColor)
-                           .arg(icon)
-                           .arg(event.userMessage());
-            m_chatDisplay->append(html);
+            m_transcript->appendTool(status, QString("%1 %2").arg(icon, event.userMessage()));
         }
-        m_pendingAssistantSeparator = true;
     }
-    
-    m_chatDisplay->ensureCursorVisible();
 }
-
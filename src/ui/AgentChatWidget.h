@@ -10,9 +10,16 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QCheckBox>
+#include <QVector>
 #include "core/agent/LLMAgent.h"
+#include "core/events/AgentEvent.h"
 
 class ToolDispatcher;  // 前向声明
+class QTimer;          // 前向声明
+class QListView;       // 前向声明
+class HistoryModel;    // 前向声明
+class TranscriptView;  // 前向声明
+class TranscriptModel; // 前向声明
 
 class AgentChatWidget : public QWidget {
     Q_OBJECT
@@ -23,12 +30,16 @@ private slots:
     void onSaveClicked();
     void onSendClicked();
     void onAbortClicked();
+    void onResumeClicked();
     void onFinished(const QString& content);
     void onStreamDataReceived(const QString& data);
     void onErrorOccurred(const QString& errorMsg);
-    void updateHistoryDisplay();
+    void updateHistoryDisplay();  // 整体刷新（清空或恢复会话后）
+    void onHistoryAppended(const QJsonObject& message);
     void onClearHistoryClicked();
     void onTestToolClicked();
+    void onExportTraceClicked();
+    void updateMetricsDisplay();
     
     // 工具事件处理（统一处理 started/completed）
     void onToolEvent(const ToolExecutionEvent& event);
@@ -36,11 +47,13 @@ private slots:
 private:
     void setupUI();
     void loadConfig();
+    void onAgentEvents(const QVector<AgentEvent>& events);  // EventBus 批量事件分发
     
     // UI 辅助函数
     void appendUserMessage(const QString& message);   // 显示用户消息
-    void appendAssistantLabel();                      // 显示助手标签
+    void appendNotice(const QString& text);           // 显示灰色提示（中断、模式切换等）
     void setSendingState(bool isSending);             // 设置发送状态
+    void updateHistoryLabel();                        // 刷新历史面板标题中的轮数
 
     // UI Widgets
     QLineEdit *m_baseUrlEdit;
@@ -48,15 +61,18 @@ private:
     QLineEdit *m_modelEdit;
     QTextEdit *m_systemPromptEdit;
     
-    QTextBrowser *m_chatDisplay;
+    TranscriptView *m_chatDisplay;   // 按消息块显示，只绘制可见的块
+    TranscriptModel *m_transcript;
     QTextEdit *m_inputEdit;
     
     QPushButton *m_saveBtn;
     QPushButton *m_sendBtn;
     QPushButton *m_abortBtn;
+    QPushButton *m_resumeBtn;  // 自动重试用尽后从最后完成的步骤继续
     
-    // 对话历史显示
-    QTextBrowser *m_historyDisplay;
+    // 对话历史显示（逐条追加，只绘制可见的行）
+    QListView *m_historyView;
+    HistoryModel *m_historyModel;
     QPushButton *m_clearHistoryBtn;
     QLabel *m_historyLabel;
     
@@ -65,11 +81,15 @@ private:
     
     // 阶段三: 调试模式复选框
     QCheckBox *m_debugModeCheck;
+    QPushButton *m_exportTraceBtn;  // 导出最近的计时数据（Chrome trace）
+    
+    // 指标面板（每秒刷新）
+    QTextBrowser *m_metricsDisplay;
+    QPushButton *m_resetMetricsBtn;
+    QTimer *m_metricsTimer;
 
     LLMAgent *m_agent;
     ToolDispatcher *m_toolDispatcher;
-    QString m_currentAssistantReply;  // 当前助手回复的累积内容
-    bool m_pendingAssistantSeparator = false;
     
     // UI 显示模式（由 UI 自行管理，与 Agent 无关）
     bool m_isDebugMode = false;
@@ -0,0 +1,82 @@
+#include "HistoryDelegate.h"
+#include "HistoryModel.h"
+#include <QApplication>
+#include <QPainter>
+#include <QTextLayout>
+
+namespace {
+
+QFont headerFont(const QFont& base) {
+    QFont font = base;
+    font.setBold(true);
+    return font;
+}
+
+} // namespace
+
+void HistoryDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    opt.text.clear();  // 文本自己绘制，样式只负责背景与选中状态
+    const QWidget* widget = opt.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    const bool isUser = index.data(HistoryModel::IsUserRole).toBool();
+    const bool selected = opt.state & QStyle::State_Selected;
+    const QString preview = index.data(HistoryModel::PreviewRole).toString();
+    const QRect rect = opt.rect.adjusted(kPadding, kPadding, -kPadding, -kPadding);
+
+    painter->save();
+    painter->setClipRect(opt.rect);
+
+    const QFont bold = headerFont(opt.font);
+    const QFontMetrics boldMetrics(bold);
+    const QString header = isUser
+        ? QString("第 %1 轮 · User:").arg(index.data(HistoryModel::TurnRole).toInt())
+        : QString("Assistant:");
+    painter->setFont(bold);
+    painter->setPen(selected ? opt.palette.color(QPalette::HighlightedText)
+                             : QColor(isUser ? "#2196F3" : "#4CAF50"));
+    painter->drawText(QRect(rect.left(), rect.top(), rect.width(), boldMetrics.height()),
+                      Qt::AlignLeft | Qt::AlignVCenter, header);
+
+    // NOTE: 摘要最多 kPreviewChars 个字符，排版到 kBodyLines 行即停止
+    const QFontMetrics metrics(opt.font);
+    QTextLayout layout(preview, opt.font);
+    layout.beginLayout();
+    qreal y = rect.top() + boldMetrics.height();
+    for (int i = 0; i < kBodyLines; ++i) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) {
+            break;
+        }
+        line.setLineWidth(rect.width());
+        line.setPosition(QPointF(0, y));
+        y += metrics.lineSpacing();
+    }
+    layout.endLayout();
+
+    painter->setFont(opt.font);
+    painter->setPen(opt.palette.color(selected ? QPalette::HighlightedText : QPalette::Text));
+    for (int i = 0; i < layout.lineCount(); ++i) {
+        const QTextLine line = layout.lineAt(i);
+        const int end = line.textStart() + line.textLength();
+        if (i == kBodyLines - 1 && end < preview.size()) {
+            // 最后一行放不下剩余内容：省略号结尾
+            const QString rest = metrics.elidedText(preview.mid(line.textStart()), Qt::ElideRight, rect.width());
+            painter->drawText(QPointF(rect.left(), line.y() + metrics.ascent()), rest);
+        } else {
+            line.draw(painter, QPointF(rect.left(), 0));
+        }
+    }
+    painter->restore();
+}
+
+QSize HistoryDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    Q_UNUSED(index);
+    // 与内容无关的固定行高；宽度由视图按视口宽度决定
+    const QFontMetrics boldMetrics(headerFont(option.font));
+    const QFontMetrics metrics(option.font);
+    return QSize(0, 2 * kPadding + boldMetrics.height() + kBodyLines * metrics.lineSpacing());
+}
@@ -0,0 +1,25 @@
+#ifndef HISTORYDELEGATE_H
+#define HISTORYDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+/**
+ * @brief 对话历史面板的行绘制
+ *
+ * 每行固定高度：标题（"第 N 轮 · User:" / "Assistant:"）加最多 kBodyLines 行摘要，超出部分以省略号结尾，
+ * 完整内容在悬停提示中显示。行高与内容无关，视图配合 setUniformItemSizes(true) 时
+ * 追加行不需要逐行测量文本，只排版和绘制可见的行。
+ */
+class HistoryDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    static constexpr int kBodyLines = 3;
+    static constexpr int kPadding = 4;
+
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+};
+
+#endif // HISTORYDELEGATE_H
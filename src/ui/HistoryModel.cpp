@@ -0,0 +1,88 @@
+#include "HistoryModel.h"
+
+namespace {
+
+// 只处理前 kPreviewChars 个字符，长回复不会整段复制与折叠
+QString makePreview(const QString& content) {
+    QString preview = content.left(HistoryModel::kPreviewChars).simplified();
+    if (content.size() > HistoryModel::kPreviewChars) {
+        preview += QStringLiteral("…");
+    }
+    return preview;
+}
+
+} // namespace
+
+HistoryModel::HistoryModel(QObject* parent)
+    : QAbstractListModel(parent) {
+}
+
+int HistoryModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant HistoryModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+    const Entry& entry = m_entries[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+        case PreviewRole:
+            return entry.preview;
+        case Qt::ToolTipRole:
+        case ContentRole:
+            return entry.content;
+        case IsUserRole:
+            return entry.isUser;
+        case TurnRole:
+            return entry.turn;
+        default:
+            return QVariant();
+    }
+}
+
+bool HistoryModel::makeEntry(const QJsonObject& message, Entry& entry) {
+    const QString role = message["role"].toString();
+    if (role != "user" && role != "assistant") {
+        return false;
+    }
+    entry.isUser = role == "user";
+    if (entry.isUser) {
+        ++m_turns;
+    }
+    entry.turn = qMax(1, m_turns);
+    entry.content = message["content"].toString();
+    entry.preview = makePreview(entry.content);
+    return true;
+}
+
+bool HistoryModel::append(const QJsonObject& message) {
+    Entry entry;
+    if (!makeEntry(message, entry)) {
+        return false;
+    }
+    const int row = m_entries.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_entries.append(std::move(entry));
+    endInsertRows();
+    return true;
+}
+
+void HistoryModel::setHistory(const QJsonArray& history) {
+    beginResetModel();
+    m_entries.clear();
+    m_turns = 0;
+    m_entries.reserve(history.size());
+    for (const QJsonValue& value : history) {
+        Entry entry;
+        if (makeEntry(value.toObject(), entry)) {
+            m_entries.append(std::move(entry));
+        }
+    }
+    endResetModel();
+}
+
+void HistoryModel::clear() {
+    setHistory(QJsonArray());
+}
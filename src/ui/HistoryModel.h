@@ -0,0 +1,64 @@
+#ifndef HISTORYMODEL_H
+#define HISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 对话历史面板的数据模型
+ *
+ * 每条 user / assistant 消息一行（system 与工具消息不显示），由 LLMAgent::historyAppended 逐条追加，
+ * 追加只插入一行，不重建已有内容；轮数随追加累计，不再扫描整个历史。
+ *
+ * 每行只保存摘要（kPreviewChars 个字符，空白折叠为单个空格），HistoryDelegate 绘制时只排版这段摘要；
+ * 完整内容通过 Qt::ToolTipRole / ContentRole 按需取出。
+ */
+class HistoryModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    static constexpr int kPreviewChars = 300;
+
+    enum Roles {
+        IsUserRole = Qt::UserRole + 1,  // bool，用户消息为 true
+        TurnRole,                       // int，所属轮次（从 1 开始）
+        PreviewRole,                    // QString，摘要
+        ContentRole                     // QString，完整内容
+    };
+
+    explicit HistoryModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 追加一条消息（非 user / assistant 消息忽略）
+     * @return 是否新增了一行
+     */
+    bool append(const QJsonObject& message);
+
+    /**
+     * @brief 整体替换（清空历史或从会话日志恢复时使用）
+     */
+    void setHistory(const QJsonArray& history);
+    void clear();
+
+    int turnCount() const { return m_turns; }
+
+private:
+    struct Entry {
+        bool isUser = false;
+        int turn = 0;
+        QString preview;
+        QString content;
+    };
+
+    bool makeEntry(const QJsonObject& message, Entry& entry);
+
+    QVector<Entry> m_entries;
+    int m_turns = 0;
+};
+
+#endif // HISTORYMODEL_H
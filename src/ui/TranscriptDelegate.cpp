@@ -0,0 +1,219 @@
+#include "TranscriptDelegate.h"
+#include "TranscriptModel.h"
+#include <QAbstractItemView>
+#include <QAbstractTextDocumentLayout>
+#include <QApplication>
+#include <QFontDatabase>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+
+using Kind = TranscriptModel::Kind;
+using ToolStatus = TranscriptModel::ToolStatus;
+
+Kind kindOf(const QModelIndex& index) {
+    return Kind(index.data(TranscriptModel::KindRole).toInt());
+}
+
+QFont headerFont(const QStyleOptionViewItem& option, const QModelIndex& index) {
+    QFont font = option.font;
+    if (kindOf(index) == Kind::Tool) {
+        font.setItalic(ToolStatus(index.data(TranscriptModel::ToolStatusRole).toInt()) == ToolStatus::Running);
+    } else {
+        font.setBold(true);
+    }
+    return font;
+}
+
+QColor headerColor(const QModelIndex& index) {
+    switch (kindOf(index)) {
+        case Kind::User:      return QColor("#2196F3");
+        case Kind::Assistant: return QColor("#4CAF50");
+        case Kind::Tool:
+            switch (ToolStatus(index.data(TranscriptModel::ToolStatusRole).toInt())) {
+                case ToolStatus::Running:   return QColor("#888888");
+                case ToolStatus::Succeeded: return QColor("#28a745");
+                case ToolStatus::Failed:    return QColor("#dc3545");
+            }
+            break;
+        default:
+            break;
+    }
+    return QColor();
+}
+
+QColor bodyColor(const QStyleOptionViewItem& option, const QModelIndex& index) {
+    switch (kindOf(index)) {
+        case Kind::Notice: return QColor("#666666");
+        case Kind::Error:  return QColor("red");
+        default:           return option.palette.color(QPalette::Text);
+    }
+}
+
+} // namespace
+
+TranscriptDelegate::TranscriptDelegate(QObject* parent)
+    : QStyledItemDelegate(parent)
+    , m_layouts(TranscriptModel::kMaxBlocks)
+    , m_documents(kDocumentCacheSize) {
+}
+
+int TranscriptDelegate::contentWidth(const QStyleOptionViewItem& option) const {
+    // NOTE: 以视口宽度为准（sizeHint 收到的 option.rect 不一定是行宽），保证测量与绘制使用同一宽度
+    const auto* view = qobject_cast<const QAbstractItemView*>(option.widget);
+    const int width = view ? view->viewport()->width() : option.rect.width();
+    return qMax(1, width - 2 * kPadding);
+}
+
+QString TranscriptDelegate::header(const QModelIndex& index) const {
+    const QString title = index.data(TranscriptModel::TitleRole).toString();
+    if (!title.isEmpty()) {
+        return title;
+    }
+    switch (kindOf(index)) {
+        case Kind::User:
+            return "User:";
+        case Kind::Assistant:
+            return "Assistant:";
+        case Kind::Tool: {
+            const QString text = index.data(Qt::DisplayRole).toString();
+            if (index.data(TranscriptModel::DetailRole).toString().isEmpty()) {
+                return text;
+            }
+            return (index.data(TranscriptModel::CollapsedRole).toBool() ? "▸ " : "▾ ") + text;
+        }
+        default:
+            return QString();
+    }
+}
+
+QTextDocument* TranscriptDelegate::document(const QStyleOptionViewItem& option, const QModelIndex& index,
+                                            int width) const {
+    const quint64 id = index.data(TranscriptModel::IdRole).toULongLong();
+    const int revision = index.data(TranscriptModel::RevisionRole).toInt();
+    CachedDocument* cached = m_documents.object(id);
+    if (cached && cached->width == width && cached->revision == revision) {
+        return &cached->document;
+    }
+    if (!cached) {
+        cached = new CachedDocument;
+        m_documents.insert(id, cached);
+    }
+    cached->width = width;
+    cached->revision = revision;
+
+    QTextDocument& doc = cached->document;
+    doc.setDocumentMargin(0);
+    QFont font = option.font;
+    switch (kindOf(index)) {
+        case Kind::Tool:
+            font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+            doc.setDefaultFont(font);
+            doc.setPlainText(index.data(TranscriptModel::CollapsedRole).toBool()
+                                 ? QString() : index.data(TranscriptModel::DetailRole).toString());
+            break;
+        case Kind::Assistant:
+            doc.setDefaultFont(font);
+            if (index.data(TranscriptModel::StreamingRole).toBool()) {
+                doc.setPlainText(index.data(Qt::DisplayRole).toString());
+            } else {
+                doc.setMarkdown(index.data(Qt::DisplayRole).toString());
+            }
+            break;
+        case Kind::Notice:
+            font.setItalic(true);
+            doc.setDefaultFont(font);
+            doc.setPlainText(index.data(Qt::DisplayRole).toString());
+            break;
+        default:
+            doc.setDefaultFont(font);
+            doc.setPlainText(index.data(Qt::DisplayRole).toString());
+            break;
+    }
+    doc.setTextWidth(width);
+    return &doc;
+}
+
+int TranscriptDelegate::blockHeight(const QStyleOptionViewItem& option, const QModelIndex& index, int width) const {
+    const quint64 id = index.data(TranscriptModel::IdRole).toULongLong();
+    const int revision = index.data(TranscriptModel::RevisionRole).toInt();
+    if (Layout* layout = m_layouts.object(id)) {
+        if (layout->width == width && layout->revision == revision) {
+            return layout->height;
+        }
+    }
+
+    int height = 2 * kPadding;
+    if (!header(index).isEmpty()) {
+        height += QFontMetrics(headerFont(option, index)).height();
+    }
+    QTextDocument* doc = document(option, index, width);
+    if (!doc->isEmpty()) {
+        height += qCeil(doc->size().height());
+    }
+
+    auto* layout = new Layout;
+    layout->width = width;
+    layout->revision = revision;
+    layout->height = height;
+    m_layouts.insert(id, layout);
+    return height;
+}
+
+QSize TranscriptDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    return QSize(0, blockHeight(option, index, contentWidth(option)));
+}
+
+void TranscriptDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    const int width = contentWidth(option);
+    painter->save();
+    painter->setClipRect(option.rect);
+
+    if (kindOf(index) == Kind::Tool) {
+        // 工具块保留原来的左侧色条
+        painter->fillRect(option.rect.adjusted(kPadding / 2, kPadding / 2, 0, -kPadding / 2), QColor("#f5f5f5"));
+        painter->fillRect(QRect(option.rect.left() + kPadding / 2, option.rect.top() + kPadding / 2,
+                                3, option.rect.height() - kPadding), headerColor(index));
+    }
+
+    QPoint origin = option.rect.topLeft() + QPoint(kPadding, kPadding);
+    const QString title = header(index);
+    if (!title.isEmpty()) {
+        const QFont font = headerFont(option, index);
+        const QFontMetrics metrics(font);
+        painter->setFont(font);
+        painter->setPen(headerColor(index));
+        painter->drawText(QRect(origin, QSize(width, metrics.height())), Qt::AlignLeft | Qt::AlignVCenter,
+                          metrics.elidedText(title, Qt::ElideRight, width));
+        origin.ry() += metrics.height();
+    }
+
+    QTextDocument* doc = document(option, index, width);
+    if (!doc->isEmpty()) {
+        painter->translate(origin);
+        QAbstractTextDocumentLayout::PaintContext context;
+        context.palette = option.palette;
+        context.palette.setColor(QPalette::Text, bodyColor(option, index));
+        context.clip = QRectF(0, 0, width, option.rect.bottom() - origin.y());
+        doc->documentLayout()->draw(painter, context);
+    }
+    painter->restore();
+}
+
+bool TranscriptDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option,
+                                     const QModelIndex& index) {
+    if (event->type() != QEvent::MouseButtonRelease || kindOf(index) != Kind::Tool
+        || index.data(TranscriptModel::DetailRole).toString().isEmpty()) {
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+    // 点击标题行切换折叠状态
+    const auto* mouse = static_cast<QMouseEvent*>(event);
+    const int headerBottom = option.rect.top() + kPadding + QFontMetrics(headerFont(option, index)).height();
+    if (mouse->button() == Qt::LeftButton && mouse->pos().y() <= headerBottom) {
+        return model->setData(index, !index.data(TranscriptModel::CollapsedRole).toBool(),
+                              TranscriptModel::CollapsedRole);
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
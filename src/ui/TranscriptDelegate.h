@@ -0,0 +1,53 @@
+#ifndef TRANSCRIPTDELEGATE_H
+#define TRANSCRIPTDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QCache>
+#include <QTextDocument>
+
+/**
+ * @brief 交流面板消息块的排版与绘制
+ *
+ * 每个块由标题行（"User:" / "Assistant:" / 工具状态）与正文组成，正文排版为独立的 QTextDocument:
+ *   - 行高按 (块 id, 修订号, 宽度) 缓存，视图重新布局时未变化的块不再排版
+ *   - 文档只为最近绘制的块保留（kDocumentCacheSize 个），屏幕外的块不占用排版内存
+ *   - 助手块在流式输出期间按纯文本显示，结束后第一次绘制时才解析 Markdown
+ *   - 工具块的原始输出折叠时只绘制标题行，点击标题切换折叠状态
+ */
+class TranscriptDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+public:
+    static constexpr int kPadding = 6;
+    static constexpr int kDocumentCacheSize = 128;
+
+    explicit TranscriptDelegate(QObject* parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+protected:
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option,
+                     const QModelIndex& index) override;
+
+private:
+    struct Layout {
+        int width = 0;
+        int revision = -1;
+        int height = 0;
+    };
+    struct CachedDocument {
+        int width = 0;
+        int revision = -1;
+        QTextDocument document;
+    };
+
+    int contentWidth(const QStyleOptionViewItem& option) const;
+    QString header(const QModelIndex& index) const;
+    QTextDocument* document(const QStyleOptionViewItem& option, const QModelIndex& index, int width) const;
+    int blockHeight(const QStyleOptionViewItem& option, const QModelIndex& index, int width) const;
+
+    mutable QCache<quint64, Layout> m_layouts;
+    mutable QCache<quint64, CachedDocument> m_documents;
+};
+
+#endif // TRANSCRIPTDELEGATE_H
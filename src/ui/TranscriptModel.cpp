@@ -0,0 +1,131 @@
+#include "TranscriptModel.h"
+
+TranscriptModel::TranscriptModel(QObject* parent)
+    : QAbstractListModel(parent) {
+}
+
+int TranscriptModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : m_blocks.size();
+}
+
+QVariant TranscriptModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= m_blocks.size()) {
+        return QVariant();
+    }
+    const Block& block = m_blocks[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:   return block.text;
+        case KindRole:          return int(block.kind);
+        case TitleRole:         return block.title;
+        case DetailRole:        return block.detail;
+        case ToolStatusRole:    return int(block.status);
+        case CollapsedRole:     return block.collapsed;
+        case StreamingRole:     return block.streaming;
+        case IdRole:            return block.id;
+        case RevisionRole:      return block.revision;
+        default:                return QVariant();
+    }
+}
+
+bool TranscriptModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (!index.isValid() || index.row() >= m_blocks.size() || role != CollapsedRole) {
+        return false;
+    }
+    Block& block = m_blocks[index.row()];
+    if (block.detail.isEmpty() || block.collapsed == value.toBool()) {
+        return false;
+    }
+    block.collapsed = value.toBool();
+    touch(index.row());
+    return true;
+}
+
+int TranscriptModel::append(Kind kind, const QString& text, const QString& title) {
+    Block block;
+    block.kind = kind;
+    block.text = text;
+    block.title = title;
+    return appendBlock(std::move(block));
+}
+
+int TranscriptModel::appendTool(ToolStatus status, const QString& text, const QString& detail) {
+    Block block;
+    block.kind = Kind::Tool;
+    block.status = status;
+    block.text = text;
+    if (detail.size() > kMaxDetailChars) {
+        block.detail = detail.left(kMaxDetailChars)
+            + QString("\n…（已截断，共 %1 个字符）").arg(detail.size());
+    } else {
+        block.detail = detail;
+    }
+    block.collapsed = block.detail.count('\n') >= kAutoCollapseLines;
+    return appendBlock(std::move(block));
+}
+
+void TranscriptModel::appendStreamText(const QString& text) {
+    if (text.isEmpty()) {
+        return;
+    }
+    if (m_streamingRow < 0) {
+        Block block;
+        block.kind = Kind::Assistant;
+        block.streaming = true;
+        block.text = text;
+        m_streamingRow = appendBlock(std::move(block));
+        return;
+    }
+    m_blocks[m_streamingRow].text += text;
+    touch(m_streamingRow);
+}
+
+bool TranscriptModel::finishStreaming() {
+    if (m_streamingRow < 0) {
+        return false;
+    }
+    const int row = m_streamingRow;
+    m_streamingRow = -1;
+    m_blocks[row].streaming = false;
+    touch(row);
+    return true;
+}
+
+void TranscriptModel::clear() {
+    beginResetModel();
+    m_blocks.clear();
+    m_streamingRow = -1;
+    endResetModel();
+}
+
+int TranscriptModel::appendBlock(Block block) {
+    if (!block.streaming) {
+        finishStreaming();
+    }
+    trim();
+    block.id = m_nextId++;
+    const int row = m_blocks.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_blocks.append(std::move(block));
+    endInsertRows();
+    return row;
+}
+
+void TranscriptModel::touch(int row) {
+    ++m_blocks[row].revision;
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed);
+}
+
+void TranscriptModel::trim() {
+    if (m_blocks.size() < kMaxBlocks) {
+        return;
+    }
+    // NOTE: 一次丢弃十分之一，避免之后每追加一块都移动整个数组
+    const int count = m_blocks.size() - kMaxBlocks + kMaxBlocks / 10;
+    beginRemoveRows(QModelIndex(), 0, count - 1);
+    m_blocks.remove(0, count);
+    endRemoveRows();
+    if (m_streamingRow >= 0) {
+        m_streamingRow = qMax(-1, m_streamingRow - count);
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef TRANSCRIPTMODEL_H
+#define TRANSCRIPTMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 交流面板的消息块模型
+ *
+ * 每个用户消息、助手回复片段、工具事件与提示各占一行（块），替代原来不断 append 的单个 QTextDocument:
+ *   - 流式输出只追加到当前的助手块（appendStreamText），每次只通知这一行变化
+ *   - 工具块的原始输出（调试模式）超过 kAutoCollapseLines 行时默认折叠，点击标题展开
+ *   - 块数超过 kMaxBlocks 时丢弃最早的块，长时间运行时内存与布局开销有上限
+ *
+ * 每个块有唯一的 id 与修订号（内容或折叠状态变化时加 1），TranscriptDelegate 以此缓存排版结果。
+ */
+class TranscriptModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    static constexpr int kMaxBlocks = 2000;
+    static constexpr int kAutoCollapseLines = 10;
+    static constexpr int kMaxDetailChars = 64 * 1024;  // 单个工具块保留的原始输出上限
+
+    enum class Kind { User, Assistant, Tool, Notice, Error };
+    enum class ToolStatus { Running, Succeeded, Failed };
+
+    enum Roles {
+        KindRole = Qt::UserRole + 1,  // int(Kind)
+        TitleRole,                    // QString，覆盖默认标题（如 "🔧 工具调用测试:"）
+        DetailRole,                   // QString，工具块可折叠的原始输出
+        ToolStatusRole,               // int(ToolStatus)
+        CollapsedRole,                // bool，可通过 setData 修改
+        StreamingRole,                // bool，助手块仍在接收流式输出（按纯文本显示）
+        IdRole,                       // quint64，块的唯一标识
+        RevisionRole                  // int，内容或折叠状态的修订号
+    };
+
+    explicit TranscriptModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief 追加一个块（结束正在进行的流式输出）
+     * @return 新块的行号
+     */
+    int append(Kind kind, const QString& text, const QString& title = QString());
+    int appendTool(ToolStatus status, const QString& text, const QString& detail = QString());
+
+    /**
+     * @brief 流式输出：追加到当前助手块，没有时新建
+     */
+    void appendStreamText(const QString& text);
+
+    /**
+     * @brief 结束当前助手块的流式输出（之后按 Markdown 显示）
+     * @return 是否有正在流式输出的块
+     */
+    bool finishStreaming();
+    bool isStreaming() const { return m_streamingRow >= 0; }
+
+    void clear();
+
+private:
+    struct Block {
+        quint64 id = 0;
+        int revision = 0;
+        Kind kind = Kind::Notice;
+        ToolStatus status = ToolStatus::Running;
+        QString title;
+        QString text;
+        QString detail;
+        bool collapsed = false;
+        bool streaming = false;
+    };
+
+    int appendBlock(Block block);
+    void touch(int row);  // 修订号加 1 并通知该行变化
+    void trim();
+
+    QVector<Block> m_blocks;
+    quint64 m_nextId = 1;
+    int m_streamingRow = -1;
+};
+
+#endif // TRANSCRIPTMODEL_H
@@ -0,0 +1,47 @@
+#include "TranscriptView.h"
+#include "TranscriptDelegate.h"
+#include "TranscriptModel.h"
+#include <QScrollBar>
+
+namespace {
+constexpr int kFollowSlack = 4;  // 距底部几个像素以内视为停在底部
+}
+
+TranscriptView::TranscriptView(QWidget* parent)
+    : QListView(parent) {
+    setItemDelegate(new TranscriptDelegate(this));
+    setWordWrap(true);  // 宽度变化时重新布局
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setFocusPolicy(Qt::NoFocus);
+
+    QScrollBar* bar = verticalScrollBar();
+    connect(bar, &QScrollBar::valueChanged, this, [this, bar](int value) {
+        m_followTail = value >= bar->maximum() - kFollowSlack;
+    });
+    // NOTE: 内容变高时滚动条范围先变化、值不变，在这里跟随，不再每次追加后 ensureCursorVisible
+    connect(bar, &QScrollBar::rangeChanged, this, [this, bar](int, int maximum) {
+        if (m_followTail) {
+            bar->setValue(maximum);
+        }
+    });
+}
+
+void TranscriptView::setTranscriptModel(TranscriptModel* model) {
+    m_model = model;
+    setModel(model);
+}
+
+void TranscriptView::followTail() {
+    m_followTail = true;
+    scrollToBottom();
+}
+
+void TranscriptView::dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                 const QVector<int>& roles) {
+    QListView::dataChanged(topLeft, bottomRight, roles);
+    // 块的高度可能变化（流式输出、折叠 / 展开），未变化的块由 TranscriptDelegate 直接返回缓存的行高
+    scheduleDelayedItemsLayout();
+}
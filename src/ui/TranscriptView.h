@@ -0,0 +1,34 @@
+#ifndef TRANSCRIPTVIEW_H
+#define TRANSCRIPTVIEW_H
+
+#include <QListView>
+
+class TranscriptModel;  // 前向声明
+
+/**
+ * @brief 交流面板：TranscriptModel 的列表视图
+ *
+ * 只排版与绘制可见的消息块（TranscriptDelegate），块内容变化（流式输出、折叠）时重新布局。
+ * 停在底部时自动跟随新内容；用户向上翻看时保持位置，滚回底部后恢复跟随。
+ */
+class TranscriptView : public QListView {
+    Q_OBJECT
+public:
+    explicit TranscriptView(QWidget* parent = nullptr);
+
+    void setTranscriptModel(TranscriptModel* model);
+    TranscriptModel* transcriptModel() const { return m_model; }
+
+    // 跳到底部并恢复自动跟随
+    void followTail();
+
+protected:
+    void dataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                     const QVector<int>& roles = QVector<int>()) override;
+
+private:
+    TranscriptModel* m_model = nullptr;
+    bool m_followTail = true;
+};
+
+#endif // TRANSCRIPTVIEW_H
@@ -0,0 +1,299 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+
+#include "core/agent/ContextManager.h"
+#include "core/utils/Tokenizer.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 消息构造辅助函数 ====================
+
+static QJsonObject userMessage(const QString& content) {
+    QJsonObject msg;
+    msg["role"] = "user";
+    msg["content"] = content;
+    return msg;
+}
+
+static QJsonObject toolCallMessage(const QString& id, const QString& name, const QJsonObject& args) {
+    QJsonObject func;
+    func["name"] = name;
+    func["arguments"] = QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact));
+
+    QJsonObject call;
+    call["id"] = id;
+    call["type"] = "function";
+    call["function"] = func;
+
+    QJsonObject msg;
+    msg["role"] = "assistant";
+    msg["tool_calls"] = QJsonArray{call};
+    return msg;
+}
+
+static QJsonObject toolResultMessage(const QString& id, const QString& content) {
+    QJsonObject msg;
+    msg["role"] = "tool";
+    msg["tool_call_id"] = id;
+    msg["content"] = content;
+    return msg;
+}
+
+// 追加一步 view_file 调用及其结果
+static void appendViewFile(ContextManager& context, const QString& id,
+                           const QString& path, int lines) {
+    QJsonObject args;
+    args["file_path"] = path;
+    context.append(toolCallMessage(id, "view_file", args));
+
+    QString content;
+    for (int i = 1; i <= lines; ++i) {
+        content += QString("line %1 of %2: some source code here\n").arg(i).arg(path);
+    }
+    context.append(toolResultMessage(id, content));
+}
+
+// 检查每条 tool 消息都能找到对应的 tool_calls
+static bool hasOrphanToolMessages(const QJsonArray& messages) {
+    QSet<QString> knownIds;
+    for (const QJsonValue& value : messages) {
+        const QJsonObject msg = value.toObject();
+        for (const QJsonValue& tc : msg["tool_calls"].toArray()) {
+            knownIds.insert(tc.toObject()["id"].toString());
+        }
+        if (msg["role"].toString() == "tool" && !knownIds.contains(msg["tool_call_id"].toString())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int sumTokens(const QJsonArray& messages) {
+    int total = 0;
+    for (const QJsonValue& value : messages) {
+        total += ContextManager::estimateTokens(value.toObject());
+    }
+    return total;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        ContextManager 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 中英文 token 估算
+    // ========================================
+    TEST("Tokenizer::estimateTokens - 中文与英文经验估算") {
+        PRINT_INPUT("text", "你好世界 / hello world");
+        PRINT_EXPECTED("中文 3 tokens，英文 4 tokens");
+
+        int cjk = Tokenizer::estimateTokens(QString("你好世界"));
+        int ascii = Tokenizer::estimateTokens(QString("hello world"));
+
+        if (cjk != 3 || ascii != 4) {
+            PRINT_ACTUAL(QString("中文 %1，英文 %2").arg(cjk).arg(ascii));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 估算符合经验值");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 未超预算时不裁剪
+    // ========================================
+    TEST("enforceBudget - 未超预算不裁剪") {
+        ContextManager context;
+        context.setTokenBudget(100000);
+        context.append(userMessage("读取 main.cpp"));
+        appendViewFile(context, "call_1", "/src/main.cpp", 50);
+
+        PRINT_EXPECTED("释放 0 tokens，消息数保持 3");
+
+        int before = context.totalTokens();
+        int freed = context.enforceBudget(4096);
+
+        if (freed != 0 || context.size() != 3 || context.totalTokens() != before) {
+            PRINT_ACTUAL(QString("释放 %1，消息数 %2").arg(freed).arg(context.size()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 上下文未变化");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 省略过期的文件内容
+    // ========================================
+    TEST("enforceBudget - 省略重复读取的旧文件内容") {
+        ContextManager context;
+        context.setRecentSteps(2);
+        context.append(userMessage("分析 main.cpp"));
+        appendViewFile(context, "call_1", "/src/main.cpp", 100);
+        appendViewFile(context, "call_2", "/src/util.cpp", 5);
+        appendViewFile(context, "call_3", "/src/main.cpp", 100);
+
+        // 预算只够容纳一份 main.cpp
+        context.setTokenBudget(context.totalTokens() - 100);
+        context.enforceBudget(0);
+
+        QJsonArray messages = context.messages();
+        QString oldDump = messages[2].toObject()["content"].toString();
+        QString newDump = messages[6].toObject()["content"].toString();
+
+        PRINT_EXPECTED("第一次读取被替换为 [已省略]，最后一次读取保持原文");
+
+        if (!oldDump.startsWith("[已省略]") || !newDump.contains("line 100")) {
+            PRINT_ACTUAL(oldDump.left(80));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + oldDump);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 压缩较早的工具输出
+    // ========================================
+    TEST("enforceBudget - 旧工具输出压缩为摘要") {
+        ContextManager context;
+        context.setRecentSteps(2);
+        context.append(userMessage("浏览项目"));
+        appendViewFile(context, "call_1", "/src/a.cpp", 80);
+        appendViewFile(context, "call_2", "/src/b.cpp", 80);
+        appendViewFile(context, "call_3", "/src/c.cpp", 80);
+
+        context.setTokenBudget(context.totalTokens() - 200);
+        int freed = context.enforceBudget(0);
+
+        QString collapsed = context.messages()[2].toObject()["content"].toString();
+        QString recent = context.messages()[6].toObject()["content"].toString();
+
+        PRINT_EXPECTED("a.cpp 输出被压缩，c.cpp（最近步骤）保持原文");
+
+        if (freed < 200 || !collapsed.startsWith("[已压缩] view_file") || !recent.contains("line 80")) {
+            PRINT_ACTUAL(QString("释放 %1, 首条: %2").arg(freed).arg(collapsed.left(80)));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + collapsed);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 5: 整步丢弃，保留任务描述与工具调用配对
+    // ========================================
+    TEST("enforceBudget - 丢弃最早的步骤") {
+        ContextManager context;
+        context.setRecentSteps(2);
+        context.append(userMessage("任务描述: 重构解析器"));
+        for (int i = 1; i <= 10; ++i) {
+            appendViewFile(context, QString("call_%1").arg(i), QString("/src/f%1.cpp").arg(i), 2);
+        }
+
+        // 预算远小于当前总量，必须整步丢弃
+        context.setTokenBudget(context.totalTokens() / 3);
+        context.enforceBudget(0);
+
+        QJsonArray messages = context.messages();
+        QString first = messages[0].toObject()["content"].toString();
+        QString last = messages.last().toObject()["tool_call_id"].toString();
+
+        PRINT_EXPECTED("首条用户消息保留，最近步骤保留，无孤立的 tool 消息，token 计数一致");
+
+        if (first != "任务描述: 重构解析器" || last != "call_10"
+            || hasOrphanToolMessages(messages)
+            || sumTokens(messages) != context.totalTokens()
+            || context.size() >= 21) {
+            PRINT_ACTUAL(QString("消息数 %1，首条: %2，末条: %3")
+                         .arg(context.size()).arg(first).arg(last));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ 剩余 %1 条消息, %2 tokens").arg(context.size()).arg(context.totalTokens()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 6: 裁剪到低水位后前缀保持稳定
+    // ========================================
+    TEST("enforceBudget - 裁到低水位，之后几轮追加不改写前缀") {
+        // 超出预算 50 tokens 后再追加两步，返回每轮请求前的前缀是否都未被改写
+        auto prefixStable = [](double lowWaterRatio) {
+            ContextManager context;
+            context.setRecentSteps(2);
+            context.setLowWaterRatio(lowWaterRatio);
+            context.append(userMessage("任务描述: 梳理模块依赖"));
+            for (int i = 1; i <= 10; ++i) {
+                appendViewFile(context, QString("call_%1").arg(i), QString("/src/f%1.cpp").arg(i), 20);
+            }
+            context.setTokenBudget(context.totalTokens() - 50);
+            context.enforceBudget(0);
+
+            QByteArray prefix;
+            context.appendSerialized(prefix);
+            bool stable = true;
+            for (int i = 11; i <= 12; ++i) {
+                appendViewFile(context, QString("call_%1").arg(i), QString("/src/f%1.cpp").arg(i), 20);
+                context.enforceBudget(0);
+                QByteArray body;
+                context.appendSerialized(body);
+                stable = stable && body.startsWith(prefix);
+            }
+            return stable;
+        };
+
+        const bool lowWater = prefixStable(0.75);
+        const bool exact = prefixStable(1.0);
+        PRINT_EXPECTED("低水位 0.75: 前缀不变；只裁到恰好满足预算 (1.0): 下一轮即改写前缀");
+
+        if (!lowWater || exact) {
+            PRINT_ACTUAL(QString("低水位前缀稳定: %1, 恰好满足预算前缀稳定: %2").arg(lowWater).arg(exact));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 低水位裁剪后两轮追加前缀字节不变");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
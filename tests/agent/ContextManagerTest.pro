@@ -0,0 +1,18 @@
+# ContextManager 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ContextManagerTest
+
+# 源文件
+SOURCES += ContextManagerTest.cpp \
+           ../../src/core/agent/ContextManager.cpp \
+           ../../src/core/utils/Tokenizer.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
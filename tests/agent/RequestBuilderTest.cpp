@@ -0,0 +1,260 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/agent/RequestBuilder.h"
+#include "core/agent/ContextManager.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static QJsonObject message(const QString& role, const QString& content) {
+    QJsonObject msg;
+    msg["role"] = role;
+    msg["content"] = content;
+    return msg;
+}
+
+static QList<Tool> sampleTools() {
+    Tool viewFile;
+    viewFile.name = "view_file";
+    viewFile.description = "查看文件内容";
+    viewFile.inputSchema = QJsonDocument::fromJson(
+        R"({"type":"object","properties":{"file_path":{"type":"string"}},"required":["file_path"]})").object();
+
+    Tool grep;
+    grep.name = "grep_search";
+    grep.description = "搜索文本";
+    grep.inputSchema = QJsonDocument::fromJson(
+        R"({"type":"object","properties":{"query":{"type":"string"}},"required":["query"]})").object();
+
+    return {viewFile, grep};
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        RequestBuilder 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 请求体是合法 JSON，system 消息在最前
+    // ========================================
+    TEST("build - 生成合法请求体") {
+        RequestBuilder builder;
+        builder.setModel("deepseek-chat", 4096);
+        builder.setSystemPrompt("你是一个助手");
+        builder.setTools(sampleTools());
+
+        QJsonArray messages{message("user", "你好"), message("assistant", "你好，有什么可以帮你？")};
+        QJsonParseError error;
+        const QJsonObject root = QJsonDocument::fromJson(builder.build(messages), &error).object();
+        PRINT_EXPECTED("messages 共 3 条且首条为 system，tools 共 2 个，开启 include_usage");
+
+        const QJsonArray sent = root["messages"].toArray();
+        if (error.error != QJsonParseError::NoError || sent.size() != 3
+            || sent[0].toObject()["role"].toString() != "system"
+            || sent[2].toObject()["role"].toString() != "assistant"
+            || root["tools"].toArray().size() != 2
+            || root["model"].toString() != "deepseek-chat"
+            || !root["stream_options"].toObject()["include_usage"].toBool()) {
+            PRINT_ACTUAL(QString::fromUtf8(builder.build(messages)));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 请求体结构正确");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 多轮请求的前缀字节一致
+    // ========================================
+    TEST("build - 追加消息后前缀字节不变") {
+        RequestBuilder builder;
+        builder.setModel("deepseek-chat", 4096);
+        builder.setSystemPrompt("你是一个助手");
+        builder.setTools(sampleTools());
+
+        QJsonArray messages{message("user", "第一轮")};
+        const QByteArray first = builder.build(messages);
+        messages.append(message("assistant", "好的"));
+        messages.append(message("user", "第二轮"));
+        const QByteArray second = builder.build(messages);
+
+        // 去掉第一次请求末尾的 "]}"，其余部分应是第二次请求的前缀
+        const QByteArray firstPrefix = first.left(first.size() - 2);
+        PRINT_EXPECTED("第二次请求以第一次请求（除结尾外）的字节开头");
+
+        if (!second.startsWith(firstPrefix) || builder.prefixRevision() != 1) {
+            PRINT_ACTUAL(QString("前缀一致: %1, 版本: %2")
+                         .arg(second.startsWith(firstPrefix)).arg(builder.prefixRevision()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 前缀字节一致");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 重复设置相同内容不会使前缀失效
+    // ========================================
+    TEST("setSystemPrompt / setTools - 内容不变时前缀版本不变") {
+        RequestBuilder builder;
+        builder.setModel("deepseek-chat", 4096);
+        builder.setSystemPrompt("你是一个助手");
+        builder.setTools(sampleTools());
+        builder.build(QJsonArray());
+
+        builder.setSystemPrompt("你是一个助手");
+        builder.setTools(sampleTools());
+        builder.setModel("deepseek-chat", 4096);
+        builder.build(QJsonArray());
+        const int unchanged = builder.prefixRevision();
+
+        builder.setSystemPrompt("你是一个代码审查助手");
+        builder.build(QJsonArray());
+        PRINT_EXPECTED("相同内容版本保持 1，修改 system prompt 后变为 2");
+
+        if (unchanged != 1 || builder.prefixRevision() != 2) {
+            PRINT_ACTUAL(QString("%1 -> %2").arg(unchanged).arg(builder.prefixRevision()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 仅内容变化时重建前缀");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 解析两种格式的前缀缓存命中数
+    // ========================================
+    TEST("TokenUsage::fromJson - DeepSeek 与 OpenAI 格式") {
+        const QJsonObject deepseek = QJsonDocument::fromJson(
+            R"({"prompt_tokens":1200,"completion_tokens":80,"prompt_cache_hit_tokens":1024,"prompt_cache_miss_tokens":176})").object();
+        const QJsonObject openai = QJsonDocument::fromJson(
+            R"({"prompt_tokens":1200,"completion_tokens":80,"prompt_tokens_details":{"cached_tokens":1024}})").object();
+        PRINT_EXPECTED("两种格式的 cachedPromptTokens 均为 1024");
+
+        TokenUsage total = TokenUsage::fromJson(deepseek);
+        const TokenUsage second = TokenUsage::fromJson(openai);
+        total += second;
+
+        if (second.cachedPromptTokens != 1024 || total.cachedPromptTokens != 2048
+            || total.promptTokens != 2400 || total.completionTokens != 160) {
+            PRINT_ACTUAL(QString("cached: %1, total: %2").arg(second.cachedPromptTokens).arg(total.cachedPromptTokens));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ 命中率 %1%").arg(total.cacheHitRate() * 100, 0, 'f', 1));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 5: 复用 ContextManager 缓存的消息字节
+    // ========================================
+    TEST("build(ContextManager) - 与逐条序列化的结果一致") {
+        RequestBuilder builder;
+        builder.setModel("deepseek-chat", 4096);
+        builder.setSystemPrompt("你是一个助手");
+
+        ContextManager context;
+        context.append(message("user", "列出 src 目录"));
+        context.append(message("assistant", "src 下有 core、ui 两个目录"));
+        context.append(message("user", "换行\n与 \"引号\" 也要正确转义"));
+        PRINT_EXPECTED("两种方式生成的请求体字节完全相同");
+
+        const QByteArray fromCache = builder.build(context);
+        const QByteArray fromArray = builder.build(context.messages());
+
+        if (fromCache != fromArray
+            || context.serializedSize() + builder.prefix().size() + 2 != fromCache.size()) {
+            PRINT_ACTUAL(QString::fromUtf8(fromCache));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ 请求体 %1 字节").arg(fromCache.size()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 6: 预序列化的工具定义原样拼接
+    // ========================================
+    TEST("setTools - 预序列化字节原样拼接，与整体序列化的结果一致") {
+        RequestBuilder plain;
+        plain.setModel("deepseek-chat", 4096);
+        plain.setSystemPrompt("你是一个助手");
+        plain.setTools(sampleTools());
+
+        // 旧的做法：工具定义作为 QJsonArray 放入 header 后整体序列化
+        QJsonArray toolsJson;
+        for (const Tool& tool : sampleTools()) {
+            toolsJson.append(tool.toJson());
+        }
+        QJsonObject header;
+        header["model"] = "deepseek-chat";
+        header["max_tokens"] = 4096;
+        header["stream"] = true;
+        header["stream_options"] = QJsonObject{{"include_usage", true}};
+        header["tools"] = toolsJson;
+        QByteArray expected = QJsonDocument(header).toJson(QJsonDocument::Compact);
+        expected.chop(1);
+        expected.append(",\"messages\":[");
+        expected.append(QJsonDocument(message("system", "你是一个助手")).toJson(QJsonDocument::Compact));
+
+        QList<Tool> cached = sampleTools();
+        cached[0].serialized = cached[0].toJsonBytes().replace(":", ": ");  // 内容等价、字节不同
+        RequestBuilder reused;
+        reused.setModel("deepseek-chat", 4096);
+        reused.setSystemPrompt("你是一个助手");
+        reused.setTools(cached);
+
+        PRINT_EXPECTED("未预序列化时与整体序列化字节相同；预序列化字节原样出现在前缀中且请求体合法");
+        const QJsonObject root = QJsonDocument::fromJson(reused.build(QJsonArray{message("user", "你好")})).object();
+        if (plain.prefix() != expected || !reused.prefix().contains(cached[0].serialized)
+            || root["tools"].toArray().size() != 2 || root["messages"].toArray().size() != 2) {
+            PRINT_ACTUAL(QString::fromUtf8(plain.prefix()));
+            PRINT_ACTUAL(QString::fromUtf8(reused.prefix()));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ 前缀 %1 字节").arg(plain.prefix().size()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,19 @@
+# RequestBuilder 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = RequestBuilderTest
+
+# 源文件
+SOURCES += RequestBuilderTest.cpp \
+           ../../src/core/agent/RequestBuilder.cpp \
+           ../../src/core/agent/ContextManager.cpp \
+           ../../src/core/utils/Tokenizer.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,187 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "core/agent/SessionJournal.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static QJsonObject message(const QString& role, const QString& content) {
+    QJsonObject msg;
+    msg["role"] = role;
+    msg["content"] = content;
+    return msg;
+}
+
+static QJsonObject toolCallMessage() {
+    return QJsonDocument::fromJson(R"({"role":"assistant","tool_calls":[{"id":"call_0","type":"function",
+        "function":{"name":"view_file","arguments":"{\"file_path\":\"main.cpp\"}"}}]})").object();
+}
+
+// 写入一段典型的会话：用户消息、工具调用、工具结果、最终回复
+static bool writeSession(const QString& path, SessionJournal::Encoding encoding) {
+    SessionJournal journal;
+    if (!journal.open(path, encoding)) {
+        return false;
+    }
+    journal.append(SessionJournal::HistoryMessage, message("user", "main.cpp 做了什么？"));
+    journal.append(SessionJournal::ContextMessage, message("user", "main.cpp 做了什么？"), 12);
+    journal.append(SessionJournal::ContextMessage, toolCallMessage(), 30);
+    journal.append(SessionJournal::ContextMessage,
+                   QJsonObject{{"role", "tool"}, {"tool_call_id", "call_0"}, {"content", "int main() {}"}}, 9);
+    journal.append(SessionJournal::HistoryMessage, message("assistant", "只有一个空的 main 函数。"));
+    return journal.recordCount() == 5;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        SessionJournal 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QTemporaryDir dir;
+
+    // ========================================
+    // 测试 1: JSON 编码的写入与加载
+    // ========================================
+    TEST("load - JSON 编码逐条恢复，负载即紧凑 JSON") {
+        const QString path = dir.filePath("json.tmj");
+        if (!writeSession(path, SessionJournal::Encoding::Json)) {
+            return 1;
+        }
+        const SessionJournal::LoadResult loaded = SessionJournal::load(path);
+        const SessionJournal::Record& call = loaded.records.value(2);
+
+        PRINT_EXPECTED("5 条记录，类型与 token 数一致，json 字段等于 QJsonDocument 紧凑序列化结果；CRC-32(\"123456789\") = cbf43926");
+        PRINT_ACTUAL(QString("%1 条记录，truncated=%2，crc=%3")
+                     .arg(loaded.records.size()).arg(loaded.truncated)
+                     .arg(SessionJournal::crc32("123456789", 9), 0, 16));
+        return loaded.ok && !loaded.truncated && loaded.records.size() == 5
+            && call.kind == SessionJournal::ContextMessage && call.tokens == 30
+            && call.json == QJsonDocument(toolCallMessage()).toJson(QJsonDocument::Compact)
+            && loaded.records[4].data["content"].toString() == "只有一个空的 main 函数。"
+            && SessionJournal::crc32("123456789", 9) == 0xCBF43926u ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: CBOR 编码
+    // ========================================
+    TEST("load - CBOR 编码，重新打开时沿用文件头中的编码") {
+        const QString path = dir.filePath("cbor.tmj");
+        if (!writeSession(path, SessionJournal::Encoding::Cbor)) {
+            return 1;
+        }
+        SessionJournal reopened;
+        reopened.open(path, SessionJournal::Encoding::Json);
+        reopened.append(SessionJournal::ClearAll);
+        reopened.close();
+
+        const SessionJournal::LoadResult loaded = SessionJournal::load(path);
+        PRINT_EXPECTED("编码为 CBOR，共 6 条记录，工具调用内容与写入时相同");
+        PRINT_ACTUAL(QString("encoding=%1，%2 条记录，%3 字节")
+                     .arg(int(loaded.encoding)).arg(loaded.records.size()).arg(QFileInfo(path).size()));
+        return loaded.ok && loaded.encoding == SessionJournal::Encoding::Cbor && loaded.records.size() == 6
+            && loaded.records[2].data == toolCallMessage() && loaded.records[2].json.isEmpty()
+            && loaded.records[5].kind == SessionJournal::ClearAll ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 写了一半的尾部
+    // ========================================
+    TEST("open - 截断不完整的尾部后继续追加") {
+        const QString path = dir.filePath("torn.tmj");
+        if (!writeSession(path, SessionJournal::Encoding::Json)) {
+            return 1;
+        }
+        QFile file(path);
+        file.resize(file.size() - 5);  // 模拟最后一条记录写到一半时进程退出
+
+        const SessionJournal::LoadResult torn = SessionJournal::load(path);
+        SessionJournal journal;
+        journal.open(path);
+        const int restored = journal.loadedRecords().size();
+        journal.append(SessionJournal::HistoryMessage, message("assistant", "重新生成的回复"));
+        journal.close();
+        const SessionJournal::LoadResult repaired = SessionJournal::load(path);
+
+        PRINT_EXPECTED("损坏时 4 条记录且 truncated；重新打开追加后 5 条记录且完整");
+        PRINT_ACTUAL(QString("损坏: %1 条 truncated=%2，修复后: %3 条 truncated=%4")
+                     .arg(torn.records.size()).arg(torn.truncated)
+                     .arg(repaired.records.size()).arg(repaired.truncated));
+        return torn.records.size() == 4 && torn.truncated && restored == 4
+            && repaired.records.size() == 5 && !repaired.truncated
+            && repaired.records[4].data["content"].toString() == "重新生成的回复" ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 从中间分叉
+    // ========================================
+    TEST("fork - 保留前 N 条记录并注明分叉来源") {
+        const QString source = dir.filePath("source.tmj");
+        const QString target = dir.filePath("fork.tmj");
+        if (!writeSession(source, SessionJournal::Encoding::Json)) {
+            return 1;
+        }
+        QString error;
+        const bool forked = SessionJournal::fork(source, target, 2, &error);
+        const bool outOfRange = SessionJournal::fork(source, dir.filePath("bad.tmj"), 9, &error);
+
+        const SessionJournal::LoadResult copy = SessionJournal::load(target);
+        const SessionJournal::LoadResult original = SessionJournal::load(source);
+        PRINT_EXPECTED("新会话 2 条记录 + 1 条 Meta(forkedAt=2)，原会话仍为 5 条；超出记录数时失败");
+        PRINT_ACTUAL(QString("新会话 %1 条，原会话 %2 条，越界: %3").arg(copy.records.size())
+                     .arg(original.records.size()).arg(error));
+        return forked && !outOfRange && copy.records.size() == 3
+            && copy.records[2].kind == SessionJournal::Meta && copy.records[2].data["forkedAt"].toInt() == 2
+            && copy.records[1].data == message("user", "main.cpp 做了什么？")
+            && original.records.size() == 5 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,17 @@
+# SessionJournal 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = SessionJournalTest
+
+# 源文件
+SOURCES += SessionJournalTest.cpp \
+           ../../src/core/agent/SessionJournal.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
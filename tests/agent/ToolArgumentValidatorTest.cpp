@@ -0,0 +1,192 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/agent/ToolArgumentValidator.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static QJsonObject json(const char* text) {
+    return QJsonDocument::fromJson(text).object();
+}
+
+static QString compact(const QJsonObject& object) {
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+static QString describe(const ToolArgumentValidator::Result& result) {
+    QStringList errors;
+    for (const ToolArgumentValidator::Error& error : result.errors) {
+        errors << compact(error.toJson());
+    }
+    return QString("ok=%1 errors=[%2] repairs=[%3]")
+        .arg(result.ok).arg(errors.join(", "), result.repairs.join("; "));
+}
+
+// 与 tools.yaml 中 read_file_lines / edit_file 相同结构的 schema
+static QJsonObject readLinesSchema() {
+    return json(R"({"type":"object","properties":{
+        "file_path":{"type":"string"},
+        "start_line":{"type":"integer"},
+        "end_line":{"type":"integer"},
+        "show_line_numbers":{"type":"boolean"}},
+        "required":["file_path","start_line"]})");
+}
+
+static QJsonObject editSchema() {
+    return json(R"({"type":"object","properties":{
+        "file_path":{"type":"string"},
+        "replacements":{"type":"array","items":{"type":"object","properties":{
+            "old_text":{"type":"string"},"new_text":{"type":"string"}}}}},
+        "required":["file_path","replacements"]})");
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "      ToolArgumentValidator 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 常见的类型失误就地修复
+    // ========================================
+    TEST("validate - 修复字符串形式的数字 / 布尔值与字符串化的数组") {
+        ToolArgumentValidator lines(readLinesSchema());
+        const QJsonObject input = json(
+            R"({"file_path":"a.cpp","start_line":"10","end_line":20.0,"show_line_numbers":"true"})");
+        PRINT_INPUT("arguments", compact(input));
+        const ToolArgumentValidator::Result fixed = lines.validate(input);
+
+        ToolArgumentValidator edit(editSchema());
+        const ToolArgumentValidator::Result parsed = edit.validate(json(
+            R"({"file_path":"a.cpp","replacements":"[{\"old_text\":\"a\",\"new_text\":\"b\"}]"})"));
+
+        PRINT_EXPECTED("start_line 为整数 10，show_line_numbers 为 true，replacements 解析为数组");
+        if (!fixed.ok || fixed.arguments["start_line"] != QJsonValue(10)
+            || fixed.arguments["show_line_numbers"] != QJsonValue(true) || fixed.repairs.size() != 2
+            || !parsed.ok || parsed.arguments["replacements"].toArray().size() != 1) {
+            PRINT_ACTUAL(describe(fixed));
+            PRINT_ACTUAL(describe(parsed));
+            return 1;
+        }
+        PRINT_ACTUAL(fixed.repairs.join("; "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 无法修复的错误带参数路径
+    // ========================================
+    TEST("validate - 缺少必填参数、类型错误与数组元素错误") {
+        ToolArgumentValidator lines(readLinesSchema());
+        const ToolArgumentValidator::Result missing = lines.validate(json(
+            R"({"file_path":"a.cpp","end_line":"末尾"})"));
+
+        ToolArgumentValidator edit(editSchema());
+        const ToolArgumentValidator::Result item = edit.validate(json(
+            R"({"file_path":"a.cpp","replacements":[{"old_text":"a","new_text":"b"},{"old_text":["a"]}]})"));
+
+        PRINT_EXPECTED("start_line: missing_required，end_line: type_mismatch，replacements[1].old_text: type_mismatch");
+        if (missing.ok || missing.errors.size() != 2
+            || missing.errors[0].path != "start_line" || missing.errors[0].code != "missing_required"
+            || missing.errors[1].path != "end_line" || missing.errors[1].code != "type_mismatch"
+            || item.ok || item.errors.size() != 1 || item.errors[0].path != "replacements[1].old_text"
+            || item.errors[0].expected != "string" || item.errors[0].actual != "array") {
+            PRINT_ACTUAL(describe(missing));
+            PRINT_ACTUAL(describe(item));
+            return 1;
+        }
+        PRINT_ACTUAL(describe(missing));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: arguments 原文的宽松解析
+    // ========================================
+    TEST("decode - 去掉代码块标记与多余文本") {
+        ToolArgumentValidator lines(readLinesSchema());
+        const ToolArgumentValidator::Result fenced = lines.decode(
+            "```json\n{\"file_path\":\"a.cpp\",\"start_line\":1}\n```");
+        const ToolArgumentValidator::Result trailing = lines.decode(
+            "{\"file_path\":\"a.cpp\",\"start_line\":1} 我来读取这个文件");
+        const ToolArgumentValidator::Result broken = lines.decode("{\"file_path\":\"a.cpp\",");
+        const ToolArgumentValidator::Result empty = ToolArgumentValidator().decode("");
+
+        PRINT_EXPECTED("代码块与尾部文本被修复，截断的 JSON 报 invalid_json，空字符串视为 {}");
+        if (!fenced.ok || fenced.arguments["start_line"] != QJsonValue(1)
+            || !trailing.ok || trailing.repairs.isEmpty()
+            || broken.ok || broken.errors.size() != 1 || broken.errors[0].code != "invalid_json"
+            || !empty.ok || !empty.arguments.isEmpty()) {
+            PRINT_ACTUAL(describe(fenced));
+            PRINT_ACTUAL(describe(trailing));
+            PRINT_ACTUAL(describe(broken));
+            PRINT_ACTUAL(describe(empty));
+            return 1;
+        }
+        PRINT_ACTUAL(trailing.repairs.join("; "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 回给模型的错误结果
+    // ========================================
+    TEST("errorReport - 机器可读的错误结果") {
+        ToolArgumentValidator lines(readLinesSchema());
+        const ToolArgumentValidator::Result result = lines.validate(json(R"({"start_line":"abc"})"));
+        const QString report = ToolArgumentValidator::errorReport("read_file_lines", result);
+        PRINT_ACTUAL(report);
+
+        const QString prefix = "错误: 参数校验失败 ";
+        const QJsonObject body = QJsonDocument::fromJson(report.mid(prefix.size()).toUtf8()).object();
+        PRINT_EXPECTED("以\"错误:\"开头，JSON 中 error=invalid_arguments、tool 为工具名、errors 共 2 条");
+        if (!report.startsWith(prefix) || body["error"].toString() != "invalid_arguments"
+            || body["tool"].toString() != "read_file_lines" || body["errors"].toArray().size() != 2) {
+            return 1;
+        }
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
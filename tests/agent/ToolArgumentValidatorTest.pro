@@ -0,0 +1,16 @@
+# ToolArgumentValidator 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolArgumentValidatorTest
+
+# 源文件
+SOURCES += ToolArgumentValidatorTest.cpp \
+           ../../src/core/agent/ToolArgumentValidator.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
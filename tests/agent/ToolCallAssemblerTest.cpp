@@ -0,0 +1,184 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QStringList>
+
+#include "core/agent/ToolCallAssembler.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+// 第一个片段：带 id、type 与工具名
+static QJsonObject head(int index, const QString& id, const QString& name) {
+    QJsonObject function;
+    function["name"] = name;
+    function["arguments"] = "";
+    QJsonObject fragment;
+    fragment["index"] = index;
+    fragment["id"] = id;
+    fragment["type"] = "function";
+    fragment["function"] = function;
+    return fragment;
+}
+
+// 后续片段：只带一段 arguments
+static QJsonObject args(int index, const QString& chunk) {
+    QJsonObject function;
+    function["arguments"] = chunk;
+    QJsonObject fragment;
+    fragment["index"] = index;
+    fragment["function"] = function;
+    return fragment;
+}
+
+static QString indexList(const QList<int>& indexes) {
+    QStringList parts;
+    for (int index : indexes) {
+        parts.append(QString::number(index));
+    }
+    return "[" + parts.join(", ") + "]";
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        ToolCallAssembler 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 括号闭合即完整
+    // ========================================
+    TEST("括号闭合 - 最外层对象闭合的片段报告完整") {
+        ToolCallAssembler assembler;
+        QList<int> completed;
+        completed += assembler.append(head(0, "call_0", "view_file"));
+        completed += assembler.append(args(0, "{\"file_path\":"));
+        completed += assembler.append(args(0, " \"src/a.cpp\""));
+        PRINT_EXPECTED("闭合前为空，闭合片段返回 [0]");
+
+        if (!completed.isEmpty()) {
+            PRINT_ACTUAL("提前报告: " + indexList(completed));
+            return 1;
+        }
+        completed = assembler.append(args(0, "}"));
+        const QJsonObject call = assembler.call(0);
+        const QJsonObject input = QJsonDocument::fromJson(
+            call["function"].toObject()["arguments"].toString().toUtf8()).object();
+        if (completed != QList<int>({0}) || input["file_path"].toString() != "src/a.cpp"
+            || call["id"].toString() != "call_0") {
+            PRINT_ACTUAL(indexList(completed) + " " + QJsonDocument(call).toJson(QJsonDocument::Compact));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + indexList(completed));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 字符串中的括号与转义
+    // ========================================
+    TEST("字符串 - 引号内的括号与转义引号不影响深度") {
+        ToolCallAssembler assembler;
+        assembler.append(head(0, "call_0", "grep_search"));
+        QList<int> completed;
+        completed += assembler.append(args(0, "{\"query\": \"if (a) { b(\\\""));
+        completed += assembler.append(args(0, "}\\\" ]\", \"path\": \"src\""));
+        PRINT_EXPECTED("字符串内的 } 与 ] 不触发完整；最后的 } 才触发");
+
+        if (!completed.isEmpty()) {
+            PRINT_ACTUAL("提前报告: " + indexList(completed));
+            return 1;
+        }
+        completed = assembler.append(args(0, "}"));
+        if (completed != QList<int>({0})) {
+            PRINT_ACTUAL(indexList(completed));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + assembler.call(0)["function"].toObject()["arguments"].toString());
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 下一个调用开始
+    // ========================================
+    TEST("顺序 - 下一个 index 开始时前一个视为完整") {
+        ToolCallAssembler assembler;
+        assembler.append(head(0, "call_0", "list_directory"));
+        assembler.append(args(0, "{\"path\": \"src\""));  // 未闭合（模型输出有误）
+        const QList<int> completed = assembler.append(head(1, "call_1", "view_file"));
+        PRINT_EXPECTED("[0]；call_1 尚未完整");
+
+        if (completed != QList<int>({0}) || assembler.isComplete(1)) {
+            PRINT_ACTUAL(indexList(completed));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + indexList(completed));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 流结束与合并结果
+    // ========================================
+    TEST("finish - 剩余调用完整，toolCalls 按 index 排序") {
+        ToolCallAssembler assembler;
+        assembler.append(head(0, "call_0", "view_file"));
+        assembler.append(args(0, "{\"file_path\": \"a\"}"));
+        assembler.append(head(1, "call_1", "create_file"));
+        assembler.append(args(1, "{\"directory\": \"d\", "));
+        assembler.append(args(1, "\"filename\": \"f\""));
+        const QList<int> completed = assembler.finish();
+        const QJsonArray calls = assembler.toolCalls();
+        PRINT_EXPECTED("finish 返回 [1]，toolCalls 依次为 call_0、call_1");
+
+        if (completed != QList<int>({1}) || calls.size() != 2
+            || calls[0].toObject()["id"].toString() != "call_0"
+            || calls[1].toObject()["function"].toObject()["arguments"].toString()
+                   != "{\"directory\": \"d\", \"filename\": \"f\"") {
+            PRINT_ACTUAL(indexList(completed) + " " + QJsonDocument(calls).toJson(QJsonDocument::Compact));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + QJsonDocument(calls).toJson(QJsonDocument::Compact));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,16 @@
+# ToolCallAssembler 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolCallAssemblerTest
+
+# 源文件
+SOURCES += ToolCallAssemblerTest.cpp \
+           ../../src/core/agent/ToolCallAssembler.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,165 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+#include "core/agent/ToolResultCache.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static bool writeFile(const QString& path, const QByteArray& content) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(content);
+    return true;
+}
+
+static QJsonObject json(const char* text) {
+    return QJsonDocument::fromJson(text).object();
+}
+
+static QString stats(const ToolResultCache& cache) {
+    return QString("hits=%1 misses=%2 invalidations=%3 size=%4")
+        .arg(cache.stats().hits).arg(cache.stats().misses).arg(cache.stats().invalidations).arg(cache.size());
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        ToolResultCache 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QTemporaryDir dir;
+    const QString root = dir.path();
+    const QString file = root + "/src/a.cpp";
+    QDir(root).mkpath("src");
+    writeFile(file, "int a;\n");
+
+    // ========================================
+    // 测试 1: 参数顺序不同的相同调用命中
+    // ========================================
+    TEST("lookup - 规范化参数后命中") {
+        ToolResultCache cache;
+        const QString key = ToolResultCache::key("grep_search", json(R"({"pattern":"a","directory":"src"})"));
+        cache.store(key, ToolResultCache::capture({root + "/src"}), "src/a.cpp:1: int a;");
+
+        QString cached;
+        const bool hit = cache.lookup(
+            ToolResultCache::key("grep_search", json(R"({"directory":"src","pattern":"a"})")), cached);
+        const bool otherTool = cache.lookup(
+            ToolResultCache::key("find_by_name", json(R"({"directory":"src","pattern":"a"})")), cached);
+
+        PRINT_EXPECTED("参数顺序不同仍命中，工具名不同不命中");
+        PRINT_ACTUAL(stats(cache));
+        return hit && !otherTool && cached == "src/a.cpp:1: int a;" && cache.stats().hits == 1 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 读取的文件变化后作废
+    // ========================================
+    TEST("lookup - 文件大小变化、过期与错误结果") {
+        ToolResultCache cache;
+        const QString key = ToolResultCache::key("view_file", json(R"({"file_path":"src/a.cpp"})"));
+        cache.store(key, ToolResultCache::capture({file}), "int a;");
+        cache.store("error", ToolResultCache::capture({file}), "错误: 文件不存在 b.cpp");
+
+        QString cached;
+        const bool before = cache.lookup(key, cached);
+        writeFile(file, "int a;\nint b;\n");
+        const bool after = cache.lookup(key, cached);
+
+        ToolResultCache expired(ToolResultCache::kMaxEntries, -1);
+        expired.store(key, ToolResultCache::capture({file}), "int a;\nint b;");
+
+        PRINT_EXPECTED("修改前命中，修改后未命中且条目被删除；错误结果不缓存；过期条目不命中");
+        PRINT_ACTUAL(stats(cache));
+        return before && !after && cache.size() == 0 && cache.stats().invalidations == 1
+            && !expired.lookup(key, cached) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 写入类工具按路径作废
+    // ========================================
+    TEST("invalidatePaths - 写入文件作废该文件与上级目录的结果") {
+        ToolResultCache cache;
+        cache.store("view a", ToolResultCache::capture({file}), "a");
+        cache.store("list src", ToolResultCache::capture({root + "/src"}), "a.cpp");
+        cache.store("list root", ToolResultCache::capture({root}), "src/");
+        cache.store("view other", ToolResultCache::capture({root + "/src2/b.cpp"}), "b");
+
+        cache.invalidatePaths({file});
+
+        QString cached;
+        PRINT_EXPECTED("只剩 src2/b.cpp（与 src/a.cpp 无上下级关系）");
+        PRINT_ACTUAL(stats(cache));
+        return cache.size() == 1 && cache.lookup("view other", cached) && cache.stats().invalidations == 3 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 整体作废与容量上限
+    // ========================================
+    TEST("invalidateAll / 容量上限 - 代数加 1，淘汰最久未使用的条目") {
+        ToolResultCache cache(2);
+        cache.store("a", ToolResultCache::capture({file}), "a");
+        cache.store("b", ToolResultCache::capture({file}), "b");
+        QString cached;
+        cache.lookup("a", cached);  // a 比 b 更近使用
+        cache.store("c", ToolResultCache::capture({file}), "c");
+        const bool evicted = !cache.lookup("b", cached) && cache.lookup("a", cached) && cache.lookup("c", cached);
+
+        const quint64 generation = cache.generation();
+        cache.invalidateAll();
+
+        PRINT_EXPECTED("b 被淘汰，a、c 保留；整体作废后为空且代数加 1");
+        PRINT_ACTUAL(stats(cache));
+        return evicted && cache.size() == 0 && cache.generation() == generation + 1 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
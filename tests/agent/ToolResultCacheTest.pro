@@ -0,0 +1,16 @@
+# ToolResultCache 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolResultCacheTest
+
+# 源文件
+SOURCES += ToolResultCacheTest.cpp \
+           ../../src/core/agent/ToolResultCache.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,204 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+
+#include "core/agent/ToolResultCompactor.h"
+#include "core/agent/ToolArgumentValidator.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        ToolResultCompactor 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: grep 结果按文件分组并去重
+    // ========================================
+    TEST("compactGrep - 按文件分组，合并相同内容") {
+        QString raw = "搜索: \"qDebug\" 在 /src\n---\n"
+                      "core/a.cpp:10: qDebug() << x;\n"
+                      "core/a.cpp:20: qDebug() << x;\n"
+                      "core/a.cpp:30: qDebug() << y;\n"
+                      "core/b.cpp:5: qDebug() << x;\n"
+                      "共 4 处匹配\n";
+        PRINT_INPUT("rawResult", "4 处匹配，分布在 2 个文件");
+        PRINT_EXPECTED("core/a.cpp 只出现一次，第 10/20 行合并");
+
+        QString result = ToolResultCompactor::compactGrep(raw, QJsonObject());
+
+        if (result.count("core/a.cpp") != 1 || !result.contains("  10, 20: qDebug() << x;")
+            || !result.contains("  5: qDebug() << x;") || !result.contains("共 4 处匹配")) {
+            PRINT_ACTUAL(result);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 分组与去重正确");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 命令输出保留首尾
+    // ========================================
+    TEST("compactShell - 长输出保留首尾") {
+        QString raw = "退出码: 2\n标准输出:\n";
+        for (int i = 1; i <= 500; ++i) {
+            raw += QString("compiling file_%1.cpp\n").arg(i);
+        }
+        raw += "错误输出:\nerror: undefined reference to `main'\n";
+        PRINT_INPUT("rawResult", "500 行标准输出 + 1 行错误输出");
+        PRINT_EXPECTED("保留退出码、首行、末行和错误输出，中间省略");
+
+        QString result = ToolResultCompactor::compactShell(raw, QJsonObject());
+
+        if (!result.startsWith("退出码: 2") || !result.contains("file_1.cpp")
+            || !result.contains("file_500.cpp") || result.contains("file_100.cpp")
+            || !result.contains("行) ...") || !result.contains("undefined reference")) {
+            PRINT_ACTUAL(result.left(300));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 首尾保留，错误输出完整");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 目录列表按目录汇总
+    // ========================================
+    TEST("compactListing - 条目过多时按目录汇总") {
+        QString raw = "目录: /proj\n---\n[目录] src\n";
+        for (int i = 0; i < 80; ++i) {
+            raw += QString("[文件] src/file_%1.cpp 1024 字节\n").arg(i);
+        }
+        raw += "共 81 项\n";
+        PRINT_INPUT("rawResult", "81 项（src 下 80 个文件）");
+        PRINT_EXPECTED("输出 'src/  文件 80, 目录 0, 80 KB'");
+
+        QString result = ToolResultCompactor::compactListing(raw, QJsonObject());
+
+        if (!result.contains("src/  文件 80, 目录 0, 80 KB") || result.contains("file_42")) {
+            PRINT_ACTUAL(result);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 已按目录汇总");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 文件内容去掉元信息头
+    // ========================================
+    TEST("compactFileView - 去掉 view_file 元信息") {
+        QString raw = "文件路径: /proj/a.txt\n文件大小: 12 字节\n总行数: 2\n"
+                      "---内容开始---\nhello\nworld\n---内容结束---\n";
+        PRINT_EXPECTED("只保留 'hello\\nworld'");
+
+        QString result = ToolResultCompactor::compactFileView(raw, QJsonObject());
+
+        if (result != "hello\nworld") {
+            PRINT_ACTUAL(result);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 元信息已去除");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 5: 超出预算时标注省略的行号
+    // ========================================
+    TEST("keepHeadAndTail - 标注省略的行号范围") {
+        QStringList lines;
+        for (int i = 1; i <= 1000; ++i) {
+            lines.append(QString("int value_%1 = %1;").arg(i));
+        }
+        PRINT_INPUT("text", "1000 行代码, 预算 200 tokens");
+        PRINT_EXPECTED("包含首行、末行和 '省略第 ...~... 行'");
+
+        QString result = ToolResultCompactor::keepHeadAndTail(lines.join('\n'), 200, 1);
+
+        if (!result.startsWith("int value_1 = 1;") || !result.endsWith("int value_1000 = 1000;")
+            || !result.contains("省略第 ")) {
+            PRINT_ACTUAL(result.left(300));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 首尾保留，省略范围已标注");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 6: 压缩使用修复后的参数
+    // ========================================
+    TEST("修复后的参数 - 标注文件来源与搜索模式") {
+        const QJsonObject schema{
+            {"type", "object"},
+            {"properties", QJsonObject{
+                {"file_path", QJsonObject{{"type", "string"}}},
+                {"pattern", QJsonObject{{"type", "string"}}}
+            }}
+        };
+        ToolArgumentValidator validator(schema);
+
+        // arguments 包在代码块中：解析失败时 ToolCall::input 为空，只有修复后才拿得到 file_path
+        const QString rawArguments = "```json\n{\"file_path\": \"src/a.txt\"}\n```";
+        const QJsonObject viewInput = validator.decode(rawArguments).arguments;
+        const QString view = "文件路径: C:/proj/src/a.txt\n文件大小: 12 字节\n总行数: 2\n"
+                             "---内容开始---\nhello\nworld\n---内容结束---\n";
+        const QString viewRaw = ToolResultCompactor::compactFileView(view, QJsonObject());
+        const QString viewRepaired = ToolResultCompactor::compactFileView(view, viewInput);
+
+        // pattern 给成了数字，修复为字符串后替换带绝对路径的头部
+        const QJsonObject grepInput = validator.validate(QJsonObject{{"pattern", 404}}).arguments;
+        const QString grep = "搜索: \"404\" 在 C:/proj\n---\nsrc/http.cpp:7: return 404;\n共 1 处匹配\n";
+        const QString grepRaw = ToolResultCompactor::compactGrep(grep, QJsonObject{{"pattern", 404}});
+        const QString grepRepaired = ToolResultCompactor::compactGrep(grep, grepInput);
+
+        PRINT_INPUT("arguments", rawArguments);
+        PRINT_EXPECTED("修复前: 无来源标注 / 保留原头部；修复后: '[src/a.txt]' / '搜索 \"404\":'");
+        if (viewRaw != "hello\nworld" || viewRepaired != "[src/a.txt]\nhello\nworld"
+            || !grepRaw.startsWith("搜索: \"404\" 在 C:/proj") || !grepRepaired.startsWith("搜索 \"404\":\n")) {
+            PRINT_ACTUAL(viewRepaired + " / " + grepRepaired);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + viewRepaired.section('\n', 0, 0) + " / " + grepRepaired.section('\n', 0, 0));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,19 @@
+# ToolResultCompactor 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolResultCompactorTest
+
+# 源文件
+SOURCES += ToolResultCompactorTest.cpp \
+           ../../src/core/agent/ToolResultCompactor.cpp \
+           ../../src/core/agent/ToolArgumentValidator.cpp \
+           ../../src/core/utils/Tokenizer.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,144 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+
+#include "core/agent/ToolRouter.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+// 与 tools.yaml 相同顺序的工具，外加一个未分组的工具
+static QList<Tool> allTools() {
+    const QStringList names = {
+        "create_file", "view_file", "read_file_lines", "replace_in_file", "delete_file",
+        "list_directory", "grep_search", "find_by_name", "insert_content", "multi_replace_in_file",
+        "execute_command", "view_file_outline", "view_code_item", "delegate_task", "custom_tool"
+    };
+    QList<Tool> tools;
+    for (const QString& name : names) {
+        Tool tool;
+        tool.name = name;
+        tools.append(tool);
+    }
+    return tools;
+}
+
+static QStringList names(const QList<Tool>& tools) {
+    QStringList result;
+    for (const Tool& tool : tools) {
+        result << tool.name;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "          ToolRouter 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 关键词匹配
+    // ========================================
+    TEST("matchedGroups - 中英文关键词，英文按词首匹配") {
+        ToolRouter router;
+        const QStringList fix = router.matchedGroups("修复 src/net 下的编译错误");
+        const QStringList english = router.matchedGroups("Run the Tests and fix the failing one");
+        const QStringList latest = router.matchedGroups("summarize the latest README");
+
+        PRINT_EXPECTED("[edit, shell]、[edit, shell]、[]（latest 不匹配 test）");
+        PRINT_ACTUAL(QString("[%1] [%2] [%3]").arg(fix.join(", "), english.join(", "), latest.join(", ")));
+        return fix == QStringList{"edit", "shell"} && english == QStringList{"edit", "shell"}
+            && latest.isEmpty() ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 按任务类型挑选子集
+    // ========================================
+    TEST("select - 编辑任务只提供浏览、编辑与未分组的工具") {
+        ToolRouter router;
+        const QStringList selected = names(router.select(allTools(), "把 config.ini 里的端口改成 8080"));
+        PRINT_ACTUAL(selected.join(", "));
+
+        const QStringList expected = {
+            "create_file", "view_file", "read_file_lines", "replace_in_file", "delete_file",
+            "list_directory", "grep_search", "find_by_name", "insert_content", "multi_replace_in_file",
+            "custom_tool"
+        };
+        PRINT_EXPECTED(expected.join(", "));
+        return selected == expected ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 无法判断任务类型时提供全部工具
+    // ========================================
+    TEST("select - 没有命中关键词时提供全部工具") {
+        ToolRouter router;
+        const QList<Tool> selected = router.select(allTools(), "这个项目是做什么的？");
+        PRINT_EXPECTED(QString("%1 个工具").arg(allTools().size()));
+        PRINT_ACTUAL(QString("%1 个工具").arg(selected.size()));
+        return selected.size() == allTools().size() ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 会话内只增不减，reset 后重新挑选
+    // ========================================
+    TEST("select / recordUse / reset - 已选工具保留到会话结束") {
+        ToolRouter router;
+        router.select(allTools(), "运行单元测试");
+        const QStringList second = names(router.select(allTools(), "查看 main 函数的大纲"));
+        const bool added = router.recordUse("delegate_task");
+        const bool again = router.recordUse("delegate_task");
+        const QStringList withDelegate = names(router.filter(allTools()));
+
+        router.reset();
+        const QStringList afterReset = names(router.select(allTools(), "查看 main 函数"));
+
+        PRINT_EXPECTED("第二轮仍含 execute_command；recordUse 首次返回 true 并加入 delegate_task；reset 后不再含 execute_command");
+        PRINT_ACTUAL(second.join(", "));
+        return second.contains("execute_command") && second.contains("view_code_item")
+            && !second.contains("create_file") && added && !again && withDelegate.contains("delegate_task")
+            && !afterReset.contains("execute_command") && afterReset.contains("view_file_outline") ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
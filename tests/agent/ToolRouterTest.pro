@@ -0,0 +1,17 @@
+# ToolRouter 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolRouterTest
+
+# 源文件
+SOURCES += ToolRouterTest.cpp \
+           ../../src/core/agent/ToolRouter.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
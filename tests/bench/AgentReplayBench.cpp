@@ -0,0 +1,291 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+
+#include "core/agent/LLMAgent.h"
+#include "core/agent/ToolDispatcher.h"
+#include "core/net/ReplayServer.h"
+#include "core/net/SessionCassette.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/**
+ * 离线基准：ReplayServer 回放会话，LLMAgent 照常解析 SSE、执行（回放）工具、构建下一次请求。
+ *
+ * 用法:
+ *   AgentReplayBench                          # 合成的 100 步 view_file 工具循环
+ *   AgentReplayBench --steps 300 --interval 2 # 300 步，每个 SSE 行间隔 2ms
+ *   AgentReplayBench session.jsonl            # 回放 TMAGENT_RECORD 录制的会话（默认按录制节奏）
+ *
+ * 输出（最后一行为 JSON，便于脚本比较两次提交）:
+ *   turn_latency     相邻两次请求的间隔（一步完整的模型回复 + 工具执行 + 构建请求）
+ *   client_overhead  上一次响应结束到下一次请求到达服务端（客户端自身开销，与回放节奏无关）
+ *   cpu_us_per_token 进程 CPU 时间 / completion token（含进程内回放服务的开销）
+ *   rss_growth_kb    预热 10 步后到结束的常驻内存增长
+ */
+
+// 进程累计 CPU 时间（用户态 + 内核态，微秒）
+static qint64 processCpuMicros() {
+#ifdef Q_OS_WIN
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    auto toMicros = [](const FILETIME& time) {
+        return ((qint64(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;  // 100ns -> us
+    };
+    return toMicros(kernel) + toMicros(user);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return qint64(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000
+         + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+}
+
+// 当前常驻内存（KB）
+static qint64 residentKb() {
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return qint64(counters.WorkingSetSize) / 1024;
+#else
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    return fields.size() > 1 ? fields[1].toLongLong() * sysconf(_SC_PAGESIZE) / 1024 : 0;
+#endif
+}
+
+static SseLine sseData(const QJsonObject& chunk) {
+    return SseLine{0, "data: " + QJsonDocument(chunk).toJson(QJsonDocument::Compact)};
+}
+
+static SseLine deltaChunk(const QJsonObject& delta, const QJsonValue& finishReason = QJsonValue::Null) {
+    return sseData(QJsonObject{{"choices", QJsonArray{QJsonObject{{"index", 0}, {"delta", delta}, {"finish_reason", finishReason}}}}});
+}
+
+static SseLine usageChunk(int promptTokens, int completionTokens) {
+    return sseData(QJsonObject{{"choices", QJsonArray()},
+                               {"usage", QJsonObject{{"prompt_tokens", promptTokens},
+                                                     {"completion_tokens", completionTokens},
+                                                     {"total_tokens", promptTokens + completionTokens}}}});
+}
+
+/**
+ * 合成会话：steps 步 view_file，每步先输出一句说明，再分片输出工具调用参数；
+ * 最后一步输出总结。工具结果约 4KB，上下文随步数增长（与真实的读文件循环相同）。
+ */
+static SessionCassette syntheticSession(int steps) {
+    SessionCassette cassette;
+    QString fileBody;
+    for (int line = 0; line < 120; ++line) {
+        fileBody += QString("    int value%1 = compute(%1);  // 第 %1 行\n").arg(line);
+    }
+
+    for (int step = 0; step < steps; ++step) {
+        const QString id = QString("call_%1").arg(step);
+        const QJsonObject args{{"file_path", QString("src/module%1/File%1.cpp").arg(step)}};
+        const QString argsText = QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact));
+
+        SseExchange exchange;
+        for (const QString& word : QString("接下来 查看 第 %1 个 文件 的 实现 。").arg(step).split(' ')) {
+            exchange.lines.append(deltaChunk(QJsonObject{{"content", word}}));
+        }
+        QJsonObject head{{"index", 0}, {"id", id}, {"type", "function"},
+                         {"function", QJsonObject{{"name", "view_file"}, {"arguments", ""}}}};
+        exchange.lines.append(deltaChunk(QJsonObject{{"tool_calls", QJsonArray{head}}}));
+        for (int pos = 0; pos < argsText.size(); pos += 4) {  // 参数按约 1 token 分片
+            QJsonObject part{{"index", 0}, {"function", QJsonObject{{"arguments", argsText.mid(pos, 4)}}}};
+            exchange.lines.append(deltaChunk(QJsonObject{{"tool_calls", QJsonArray{part}}}));
+        }
+        exchange.lines.append(deltaChunk(QJsonObject(), "tool_calls"));
+        exchange.lines.append(usageChunk(1000 + step * 1100, 30));
+        exchange.lines.append(SseLine{0, "data: [DONE]"});
+        cassette.exchanges.append(exchange);
+
+        cassette.tools.append(ToolRecord{id, "view_file", args, fileBody});
+    }
+
+    SseExchange answer;
+    for (int i = 0; i < 50; ++i) {
+        answer.lines.append(deltaChunk(QJsonObject{{"content", QString("总结%1 ").arg(i)}}));
+    }
+    answer.lines.append(deltaChunk(QJsonObject(), "stop"));
+    answer.lines.append(usageChunk(1000 + steps * 1100, 50));
+    answer.lines.append(SseLine{0, "data: [DONE]"});
+    cassette.exchanges.append(answer);
+    return cassette;
+}
+
+struct Percentiles {
+    double mean = 0;
+    qint64 p50 = 0;
+    qint64 p95 = 0;
+    qint64 max = 0;
+};
+
+static Percentiles percentiles(QList<qint64> values) {
+    Percentiles result;
+    if (values.isEmpty()) {
+        return result;
+    }
+    std::sort(values.begin(), values.end());
+    qint64 sum = 0;
+    for (qint64 value : values) {
+        sum += value;
+    }
+    result.mean = double(sum) / values.size();
+    result.p50 = values[values.size() / 2];
+    result.p95 = values[qMin(values.size() - 1, values.size() * 95 / 100)];
+    result.max = values.last();
+    return result;
+}
+
+static QJsonObject toJson(const Percentiles& p) {
+    return QJsonObject{{"mean_us", qRound(p.mean)}, {"p50_us", p.p50}, {"p95_us", p.p95}, {"max_us", p.max}};
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TmAgent 离线回放基准");
+    parser.addHelpOption();
+    parser.addPositionalArgument("cassette", "TMAGENT_RECORD 录制的会话文件（省略时使用合成会话）", "[cassette]");
+    parser.addOption({"steps", "合成会话的工具循环步数", "n", "100"});
+    parser.addOption({"interval", "每个 SSE 行的固定间隔（毫秒）；回放录制文件时省略表示按录制节奏", "ms"});
+    parser.process(app);
+
+    SessionCassette cassette;
+    if (!parser.positionalArguments().isEmpty()) {
+        QString error;
+        if (!SessionCassette::load(parser.positionalArguments().first(), cassette, error)) {
+            qCritical().noquote() << error;
+            return 2;
+        }
+    } else {
+        cassette = syntheticSession(qMax(1, parser.value("steps").toInt()));
+    }
+
+    ReplayServer server;
+    server.setCassette(cassette);
+    if (parser.isSet("interval") || parser.positionalArguments().isEmpty()) {
+        server.setTiming(ReplayServer::Timing::Fixed, parser.value("interval").toInt());
+    }
+    if (!server.listen()) {
+        qCritical().noquote() << "无法监听本地端口";
+        return 2;
+    }
+
+    ToolDispatcher dispatcher;
+    cassette.installTools(&dispatcher);
+    dispatcher.setReadOnly("view_file");  // 与默认工具集一致，参数完整即提前执行
+
+    LLMConfig config;
+    config.agentId = "bench";
+    config.apiKey = "replay";
+    config.baseUrl = server.baseUrl();
+    config.contextWindowTokens = 1 << 24;  // 不让上下文裁剪干扰测量
+    config.maxRetries = 0;
+
+    LLMAgent agent;
+    agent.setConfig(config);
+    agent.setToolDispatcher(&dispatcher);
+
+    // 服务端视角的时间点
+    QElapsedTimer clock;
+    QList<qint64> requestAt;
+    QList<qint64> responseEndAt;
+    qint64 warmRss = 0;
+    QObject::connect(&server, &ReplayServer::requestReceived, [&](int, const QByteArray&) {
+        requestAt.append(clock.nsecsElapsed() / 1000);
+        if (requestAt.size() == qMin(10, cassette.exchanges.size())) {
+            warmRss = residentKb();
+        }
+    });
+    QObject::connect(&server, &ReplayServer::responseFinished, [&](int) {
+        responseEndAt.append(clock.nsecsElapsed() / 1000);
+    });
+
+    int exitCode = 0;
+    QObject::connect(&agent, &LLMAgent::finished, &app, [&app]() { app.quit(); });
+    QObject::connect(&agent, &LLMAgent::errorOccurred, &app, [&app, &exitCode](const QString& message) {
+        qCritical().noquote() << "Agent 报错:" << message;
+        exitCode = 1;
+        app.quit();
+    });
+
+    const qint64 startRss = residentKb();
+    const qint64 startCpu = processCpuMicros();
+    clock.start();
+    agent.sendMessage("依次查看每个文件并总结");
+    app.exec();
+
+    const qint64 wallUs = clock.nsecsElapsed() / 1000;
+    const qint64 cpuUs = processCpuMicros() - startCpu;
+    const qint64 endRss = residentKb();
+
+    QList<qint64> turns;
+    QList<qint64> overhead;
+    for (int i = 1; i < requestAt.size(); ++i) {
+        turns.append(requestAt[i] - requestAt[i - 1]);
+        if (i - 1 < responseEndAt.size()) {
+            overhead.append(requestAt[i] - responseEndAt[i - 1]);
+        }
+    }
+    const int completionTokens = cassette.completionTokens();
+    const Percentiles turn = percentiles(turns);
+    const Percentiles client = percentiles(overhead);
+    const int steps = requestAt.size();
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        Agent 离线回放基准";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("  请求数            %1（不匹配 %2，未使用 %3）")
+                              .arg(steps).arg(server.mismatchCount()).arg(server.remainingCount());
+    qDebug().noquote() << QString("  总耗时            %1 ms").arg(wallUs / 1000.0, 0, 'f', 1);
+    qDebug().noquote() << QString("  每步耗时          mean %1 / p50 %2 / p95 %3 / max %4 us")
+                              .arg(qRound(turn.mean)).arg(turn.p50).arg(turn.p95).arg(turn.max);
+    qDebug().noquote() << QString("  客户端开销        mean %1 / p50 %2 / p95 %3 / max %4 us")
+                              .arg(qRound(client.mean)).arg(client.p50).arg(client.p95).arg(client.max);
+    qDebug().noquote() << QString("  CPU               %1 ms，%2 us/token（%3 completion token）")
+                              .arg(cpuUs / 1000.0, 0, 'f', 1)
+                              .arg(completionTokens > 0 ? double(cpuUs) / completionTokens : 0.0, 0, 'f', 1)
+                              .arg(completionTokens);
+    qDebug().noquote() << QString("  常驻内存          %1 KB -> %2 KB（预热后增长 %3 KB）")
+                              .arg(startRss).arg(endRss).arg(endRss - (warmRss > 0 ? warmRss : startRss));
+
+    QJsonObject summary{
+        {"steps", steps},
+        {"mismatches", server.mismatchCount()},
+        {"wall_ms", wallUs / 1000.0},
+        {"turn_latency", toJson(turn)},
+        {"client_overhead", toJson(client)},
+        {"cpu_us", cpuUs},
+        {"completion_tokens", completionTokens},
+        {"cpu_us_per_token", completionTokens > 0 ? double(cpuUs) / completionTokens : 0.0},
+        {"rss_start_kb", startRss},
+        {"rss_end_kb", endRss},
+        {"rss_growth_kb", endRss - (warmRss > 0 ? warmRss : startRss)},
+        {"ok", exitCode == 0}
+    };
+    std::fputs(QJsonDocument(summary).toJson(QJsonDocument::Compact).constData(), stdout);
+    std::fputs("\n", stdout);
+    return exitCode;
+}
@@ -0,0 +1,28 @@
+# Agent 离线基准（本地回放服务驱动 LLMAgent 跑完整工具循环）
+
+QT += core network
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = AgentReplayBench
+
+# 第三方库（核心模块依赖）
+include(../../3rdparty/yaml-cpp.pri)
+include(../../3rdparty/tree-sitter.pri)
+
+# 核心模块
+include(../../src/core/core.pri)
+
+# 回放与 SSE 服务（测试支撑模块）
+include(../../src/core/testsupport.pri)
+
+# 源文件
+SOURCES += AgentReplayBench.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
+
+# 进程内存统计
+win32: LIBS += -lpsapi
@@ -0,0 +1,16 @@
+# ApprovalPolicy 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ApprovalPolicyTest
+
+# 源文件
+SOURCES += ApprovalPolicyTest.cpp \
+           ../../src/cli/ApprovalPolicy.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,264 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <thread>
+#include <vector>
+
+#include "core/events/EventBus.h"
+#include "core/events/MpscQueue.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 处理事件循环直到条件满足或超时
+template <typename Predicate>
+static bool waitUntil(Predicate done, int timeoutMs = 3000) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return done();
+}
+
+// 记录收到的批次
+struct Recorder {
+    QObject receiver;
+    QVector<AgentEvent> events;
+    int batches = 0;
+
+    EventBus::Handler handler() {
+        return [this](const QVector<AgentEvent>& batch) {
+            ++batches;
+            events += batch;
+        };
+    }
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        EventBus 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 多生产者无锁队列
+    // ========================================
+    TEST("MpscQueue - 多生产者并发入队") {
+        const int producers = 4;
+        const int perProducer = 20000;
+        MpscQueue<QPair<int, int>> queue;
+        PRINT_INPUT("生产者", QString("%1 x %2").arg(producers).arg(perProducer));
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, p]() {
+                for (int i = 0; i < perProducer; ++i) {
+                    queue.push(qMakePair(p, i));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        QVector<int> next(producers, 0);
+        QPair<int, int> item;
+        int total = 0;
+        while (queue.pop(item)) {
+            if (item.second != next[item.first]) {
+                PRINT_ACTUAL(QString("生产者 %1 乱序: 期望 %2, 实际 %3")
+                             .arg(item.first).arg(next[item.first]).arg(item.second));
+                return 1;
+            }
+            ++next[item.first];
+            ++total;
+        }
+        PRINT_EXPECTED(QString("共 %1 个元素，每个生产者内部有序").arg(producers * perProducer));
+        PRINT_ACTUAL(QString("共 %1 个元素，剩余 %2").arg(total).arg(queue.size()));
+        return (total == producers * perProducer && queue.size() == 0) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 批量投递
+    // ========================================
+    TEST("批量投递 - 一次唤醒处理整批事件") {
+        EventBus bus;
+        Recorder recorder;
+        bus.subscribe(&recorder.receiver, recorder.handler());
+
+        for (int i = 0; i < 100; ++i) {
+            bus.publish(AgentEvent::log("agent", EventChannel::AGENT, QString::number(i)));
+        }
+        PRINT_EXPECTED("发布时不调用处理函数；事件循环中 1 批收到 100 个事件，顺序不变");
+        const bool deferred = recorder.events.isEmpty();
+        waitUntil([&]() { return recorder.events.size() >= 100; });
+
+        bool ordered = true;
+        for (int i = 0; i < recorder.events.size(); ++i) {
+            ordered = ordered && recorder.events[i].message == QString::number(i);
+        }
+        PRINT_ACTUAL(QString("批次: %1, 事件: %2, 有序: %3")
+                     .arg(recorder.batches).arg(recorder.events.size()).arg(ordered));
+        return (deferred && recorder.batches == 1 && recorder.events.size() == 100 && ordered) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: Drop 策略
+    // ========================================
+    TEST("Drop 策略 - 超出容量丢弃，finished 保留") {
+        EventBus bus;
+        Recorder recorder;
+        EventBus::Options options;
+        options.capacity = 10;
+        const int id = bus.subscribe(&recorder.receiver, recorder.handler(), options);
+
+        for (int i = 0; i < 50; ++i) {
+            bus.publish(AgentEvent::log("agent", EventChannel::AGENT, QString::number(i)));
+        }
+        bus.publish(AgentEvent::finished("agent", EventChannel::AGENT, "done"));
+        waitUntil([&]() { return !recorder.events.isEmpty(); });
+
+        const EventBus::Stats stats = bus.stats(id);
+        PRINT_EXPECTED("收到前 10 条 log 与 finished，丢弃 40 条");
+        PRINT_ACTUAL(QString("收到: %1, 丢弃: %2, 最后: %3")
+                     .arg(recorder.events.size()).arg(stats.dropped)
+                     .arg(recorder.events.isEmpty() ? QString() : recorder.events.last().message));
+        return (recorder.events.size() == 11 && stats.dropped == 40
+                && recorder.events.last().kind == EventKind::Finished) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: Coalesce 策略
+    // ========================================
+    TEST("Coalesce 策略 - 拼接流式片段，只保留最新进度") {
+        EventBus bus;
+        Recorder recorder;
+        EventBus::Options options;
+        options.overflow = EventBus::Overflow::Coalesce;
+        const int id = bus.subscribe(&recorder.receiver, recorder.handler(), options);
+
+        bus.publish(AgentEvent::progress("a", "tools", 0.25));
+        bus.publish(AgentEvent::log("a", EventChannel::STREAM, "Hel"));
+        bus.publish(AgentEvent::log("a", EventChannel::STREAM, "lo"));
+        bus.publish(AgentEvent::log("b", EventChannel::STREAM, "!"));
+        bus.publish(AgentEvent::log("b", EventChannel::STREAM, "?"));
+        bus.publish(AgentEvent::progress("a", "tools", 1.0));
+        waitUntil([&]() { return !recorder.events.isEmpty(); });
+
+        QStringList actual;
+        for (const AgentEvent& event : recorder.events) {
+            actual << (event.isStreamLog() ? event.source + ":" + event.message
+                                           : QString("%1=%2").arg(event.channel).arg(event.value));
+        }
+        const QStringList expected = {"tools=1", "a:Hello", "b:!?"};
+        PRINT_EXPECTED(expected.join(", "));
+        PRINT_ACTUAL(actual.join(", ") + QString(" (合并 %1)").arg(bus.stats(id).coalesced));
+        return (actual == expected && bus.stats(id).coalesced == 3) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 5: Coalesce 对增量指标求和
+    // ========================================
+    TEST("Coalesce 策略 - 增量指标求和，不丢弃") {
+        EventBus bus;
+        Recorder recorder;
+        EventBus::Options options;
+        options.overflow = EventBus::Overflow::Coalesce;
+        const int id = bus.subscribe(&recorder.receiver, recorder.handler(), options);
+
+        // 三次请求的 usage 在同一批内到达，中间夹着普通 metric
+        bus.publish(AgentEvent::metricDelta("a", "prompt_tokens", 100));
+        bus.publish(AgentEvent::metric("a", "context_ratio", 0.2));
+        bus.publish(AgentEvent::metricDelta("a", "prompt_tokens", 250));
+        bus.publish(AgentEvent::metricDelta("b", "prompt_tokens", 7));
+        bus.publish(AgentEvent::metricDelta("a", "prompt_tokens", 50));
+        bus.publish(AgentEvent::metric("a", "context_ratio", 0.5));
+        waitUntil([&]() { return !recorder.events.isEmpty(); });
+
+        QStringList actual;
+        for (const AgentEvent& event : recorder.events) {
+            actual << QString("%1:%2%3=%4").arg(event.source, event.delta ? "+" : "", event.channel).arg(event.value);
+        }
+        const QStringList expected = {"a:+prompt_tokens=400", "a:context_ratio=0.5", "b:+prompt_tokens=7"};
+        PRINT_EXPECTED(expected.join(", "));
+        PRINT_ACTUAL(actual.join(", ") + QString(" (合并 %1)").arg(bus.stats(id).coalesced));
+        return (actual == expected && bus.stats(id).coalesced == 3) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 6: 跨线程发布与自动退订
+    // ========================================
+    TEST("跨线程发布与 receiver 销毁后自动退订") {
+        EventBus bus;
+        auto recorder = new Recorder;
+        EventBus::Options options;
+        options.kinds = static_cast<int>(EventKind::Metric);
+        options.capacity = 100000;
+        bus.subscribe(&recorder->receiver, recorder->handler(), options);
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < 4; ++p) {
+            threads.emplace_back([&bus, p]() {
+                for (int i = 0; i < 1000; ++i) {
+                    bus.publish(AgentEvent::metric(QString("worker-%1").arg(p), "tokens", i));
+                    bus.publish(AgentEvent::log(QString("worker-%1").arg(p), EventChannel::AGENT, "ignored"));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        waitUntil([&]() { return recorder->events.size() >= 4000; });
+        const int received = recorder->events.size();
+
+        delete recorder;  // 销毁 receiver 后继续发布不应崩溃
+        bus.publish(AgentEvent::metric("worker-0", "tokens", 1));
+        QCoreApplication::processEvents();
+
+        PRINT_EXPECTED("只收到 4000 个 metric；销毁后订阅数为 0");
+        PRINT_ACTUAL(QString("收到: %1, 订阅数: %2").arg(received).arg(bus.subscriberCount()));
+        return (received == 4000 && bus.subscriberCount() == 0) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
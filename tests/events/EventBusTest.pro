@@ -0,0 +1,20 @@
+# EventBus 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = EventBusTest
+
+# 源文件
+SOURCES += EventBusTest.cpp \
+           ../../src/core/events/EventBus.cpp
+
+HEADERS += ../../src/core/events/EventBus.h \
+           ../../src/core/events/AgentEvent.h \
+           ../../src/core/events/MpscQueue.h
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,179 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "core/log/Logger.h"
+#include "core/log/LogCategories.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 读取日志文件（含轮转出的历史文件）中的所有记录
+static QList<QJsonObject> readRecords(const QStringList& paths, int& invalidLines) {
+    QList<QJsonObject> records;
+    invalidLines = 0;
+    for (const QString& path : paths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine().trimmed();
+            const QJsonDocument doc = QJsonDocument::fromJson(line);
+            if (doc.isObject()) {
+                records.append(doc.object());
+            } else if (!line.isEmpty()) {
+                ++invalidLines;
+            }
+        }
+    }
+    return records;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        Logger 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QTemporaryDir tempDir;
+    const QString secret = "test-api-key-0123456789";
+
+    // ========================================
+    // 测试 1: 脱敏
+    // ========================================
+    TEST("redact - API Key、Bearer 与 sk- 密钥替换为 ***") {
+        Logger::addSecret(secret);
+        Logger::addSecret("short");
+        const QString input = QString("key=%1 Authorization: Bearer abcdefgh12345678 token sk-abcdefghijklmnop short")
+                                  .arg(secret);
+        const QString output = Logger::redact(input);
+        PRINT_INPUT("文本", input);
+        PRINT_EXPECTED("key=*** Authorization: Bearer *** token sk-*** short");
+        PRINT_ACTUAL(output);
+        return output == "key=*** Authorization: Bearer *** token sk-*** short" ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 文件与轮转
+    // ========================================
+    TEST("文件输出 - JSON Lines、按大小轮转、info 级别过滤 debug、密钥已脱敏") {
+        const QString path = tempDir.filePath("agent.log");
+        Logger::Options options;
+        options.filePath = path;
+        options.maxFileBytes = 4096;
+        options.maxFiles = 2;
+        options.level = QtInfoMsg;
+        if (!Logger::install(options)) {
+            PRINT_ACTUAL("无法打开日志文件");
+            return 1;
+        }
+        for (int i = 0; i < 300; ++i) {
+            qCInfo(lcTool) << "info-line" << i << secret;
+            qCDebug(lcTool) << "debug-line" << i;
+        }
+        Logger::shutdown();
+
+        int invalidLines = 0;
+        const QList<QJsonObject> records = readRecords({path + ".2", path + ".1", path}, invalidLines);
+        int debugLines = 0;
+        int leaked = 0;
+        for (const QJsonObject& record : records) {
+            debugLines += record["msg"].toString().contains("debug-line") ? 1 : 0;
+            leaked += record["msg"].toString().contains(secret) ? 1 : 0;
+        }
+        const bool rotated = QFile::exists(path + ".1") && QFile::exists(path + ".2") && !QFile::exists(path + ".3");
+        const bool sized = QFile(path).size() <= options.maxFileBytes && QFile(path + ".1").size() <= options.maxFileBytes;
+        const QJsonObject last = records.isEmpty() ? QJsonObject() : records.last();
+
+        PRINT_EXPECTED("存在 .1 / .2、没有 .3，每个文件 <= 4096 字节，最后一条为 info-line 299，无 debug、无密钥");
+        PRINT_ACTUAL(QString("记录 %1 条，无效行 %2，debug %3，泄露 %4，轮转 %5，大小 %6，最后一条: %7")
+                         .arg(records.size()).arg(invalidLines).arg(debugLines).arg(leaked)
+                         .arg(rotated).arg(sized)
+                         .arg(QString::fromUtf8(QJsonDocument(last).toJson(QJsonDocument::Compact))));
+        if (records.isEmpty() || invalidLines != 0 || debugLines != 0 || leaked != 0 || !rotated || !sized
+            || !last["msg"].toString().startsWith("info-line 299") || last["level"].toString() != "info"
+            || last["cat"].toString() != "tmagent.tool" || last["ts"].toString().isEmpty()
+            || last["tid"].toString().isEmpty() || Logger::droppedCount() != 0) {
+            return 1;
+        }
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 请求体采样
+    // ========================================
+    TEST("logPayload - 分类关闭时不输出，打开后每 3 次输出一次并截断到 32 KB") {
+        const QString path = tempDir.filePath("payload.log");
+        Logger::Options options;
+        options.filePath = path;
+        options.payloadSampleEvery = 3;
+        Logger::install(options);
+
+        const QByteArray payload = "{\"key\": \"sk-abcdefghijklmnop\", \"text\": \"" + QByteArray(40 * 1024, 'a') + "\"}";
+        Logger::logPayload(lcRequest(), "Request JSON", payload);  // 默认关闭
+
+        QLoggingCategory::setFilterRules("tmagent.request.debug=true");
+        for (int i = 0; i < 9; ++i) {
+            Logger::logPayload(lcRequest(), "Request JSON", payload);
+        }
+        Logger::shutdown();
+
+        int invalidLines = 0;
+        const QList<QJsonObject> records = readRecords({path}, invalidLines);
+        int valid = 0;
+        for (const QJsonObject& record : records) {
+            const QString message = record["msg"].toString();
+            if (record["cat"].toString() == "tmagent.request" && message.contains("已截断")
+                && message.size() < Logger::kMaxPayloadBytes + 100 && message.contains("sk-***")) {
+                ++valid;
+            }
+        }
+        PRINT_EXPECTED("3 条 tmagent.request 记录，均已截断并脱敏");
+        PRINT_ACTUAL(QString("%1 条记录，其中符合的 %2 条").arg(records.size()).arg(valid));
+        return records.size() == 3 && valid == 3 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
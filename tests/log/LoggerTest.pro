@@ -0,0 +1,20 @@
+# Logger 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = LoggerTest
+
+# 源文件
+SOURCES += LoggerTest.cpp \
+           ../../src/core/log/Logger.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+HEADERS += ../../src/core/log/Logger.h \
+           ../../src/core/log/LogCategories.h
+
+# 包含路径
+INCLUDEPATH += ../../src
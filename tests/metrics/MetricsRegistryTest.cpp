@@ -0,0 +1,135 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <cmath>
+
+#include "core/metrics/MetricsRegistry.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        MetricsRegistry 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 分桶
+    // ========================================
+    TEST("Histogram 分桶 - 值落在所属桶内，桶宽不超过值的 1/32") {
+        QRandomGenerator random(42);
+        QList<qint64> values = {0, 1, 63, 64, 65, 127, 128, 1000, 123456, qint64(1) << 40};
+        for (int i = 0; i < 10000; ++i) {
+            values.append(qint64(random.bounded(1 << 30)) * (1 + random.bounded(1000)));
+        }
+        PRINT_EXPECTED("lower <= v < lower + width，且 width <= max(1, v / 32)");
+        for (qint64 value : values) {
+            const int index = Histogram::bucketIndex(value);
+            const qint64 lower = Histogram::bucketLowerBound(index);
+            const qint64 width = Histogram::bucketWidth(index);
+            if (index < 0 || index >= Histogram::kBucketCount || value < lower || value >= lower + width
+                || width > qMax<qint64>(1, value / 32)) {
+                PRINT_ACTUAL(QString("v=%1 index=%2 lower=%3 width=%4").arg(value).arg(index).arg(lower).arg(width));
+                return 1;
+            }
+        }
+        PRINT_ACTUAL(QString("✓ %1 个值").arg(values.size()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 分位数
+    // ========================================
+    TEST("Histogram 分位数 - 均匀分布的 p50 / p90 / p99 相对误差 < 3%") {
+        Histogram histogram;
+        for (qint64 v = 1; v <= 100000; ++v) {
+            histogram.record(v);
+        }
+        auto near = [](qint64 actual, double expected) {
+            return std::abs(actual - expected) / expected < 0.03;
+        };
+        PRINT_EXPECTED("p50≈50000, p90≈90000, p99≈99000, min=1, max=100000, mean=50000.5");
+        if (histogram.count() != 100000 || histogram.min() != 1 || histogram.max() != 100000
+            || std::abs(histogram.mean() - 50000.5) > 1e-6
+            || !near(histogram.percentile(50), 50000) || !near(histogram.percentile(90), 90000)
+            || !near(histogram.percentile(99), 99000) || histogram.percentile(100) > 100000) {
+            PRINT_ACTUAL(QString::fromUtf8(QJsonDocument(histogram.toJson()).toJson(QJsonDocument::Compact)));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + QString::fromUtf8(QJsonDocument(histogram.toJson()).toJson(QJsonDocument::Compact)));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 注册表
+    // ========================================
+    TEST("MetricsRegistry - 同名同指标，reset 后指针有效，toJson 包含三类指标") {
+        MetricsRegistry& registry = MetricsRegistry::instance();
+        Counter* retries = registry.counter("llm.retries");
+        retries->add(2);
+        registry.counter("llm.retries")->add();
+        registry.gauge("llm.in_flight")->set(4);
+        Histogram* latency = registry.histogram(MetricsRegistry::labeled("tool.latency_us", "view_file"));
+        latency->record(1500);
+
+        const QJsonObject before = registry.toJson();
+        registry.reset();
+        retries->add();
+        const QJsonObject after = registry.toJson();
+
+        PRINT_EXPECTED("重置前 retries=3、in_flight=4、tool.latency_us{view_file} count=1；重置后 retries=1、直方图清空、仪表保留");
+        if (before["counters"].toObject()["llm.retries"].toInt() != 3
+            || before["gauges"].toObject()["llm.in_flight"].toInt() != 4
+            || before["histograms"].toObject()["tool.latency_us{view_file}"].toObject()["count"].toInt() != 1
+            || after["counters"].toObject()["llm.retries"].toInt() != 1
+            || after["histograms"].toObject()["tool.latency_us{view_file}"].toObject()["count"].toInt() != 0
+            || after["gauges"].toObject()["llm.in_flight"].toInt() != 4) {
+            PRINT_ACTUAL(QString::fromUtf8(QJsonDocument(after).toJson(QJsonDocument::Compact)));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + QString::fromUtf8(QJsonDocument(before).toJson(QJsonDocument::Compact)));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
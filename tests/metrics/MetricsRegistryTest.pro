@@ -0,0 +1,18 @@
+# MetricsRegistry 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = MetricsRegistryTest
+
+# 源文件
+SOURCES += MetricsRegistryTest.cpp \
+           ../../src/core/metrics/MetricsRegistry.cpp
+
+HEADERS += ../../src/core/metrics/MetricsRegistry.h
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,228 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/agent/LLMAgent.h"
+#include "core/agent/ToolDispatcher.h"
+#include "mock/MockLLMServer.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 在事件循环中等待，直到条件满足或超时
+template <typename Pred>
+static bool waitFor(Pred pred, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!pred() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return pred();
+}
+
+static MockScript parseScript(const char* json) {
+    MockScript script;
+    QString error;
+    if (!MockScript::fromJson(QJsonDocument::fromJson(json).object(), script, error)) {
+        qCritical().noquote() << "脚本无效:" << error;
+    }
+    return script;
+}
+
+static LLMConfig mockConfig(const MockLLMServer& server) {
+    LLMConfig config;
+    config.agentId = "mock";
+    config.apiKey = "mock";
+    config.baseUrl = server.baseUrl();
+    config.maxRetries = 2;
+    return config;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        MockLLMServer 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 脚本解析与步骤选择
+    // ========================================
+    TEST("MockScript - 按最后一条 user 消息选场景，按之后的 assistant 条数选步骤") {
+        MockScript script;
+        QString error;
+        const bool ok = MockScript::fromJson(QJsonDocument::fromJson(R"({
+            "failures": {"429": 0.1, "retryAfterSec": 2},
+            "scenarios": [
+                {"match": "构建", "steps": [{"content": "a", "toolCalls": [{"name": "view_file"}]}, {"content": "b"}]},
+                {"steps": [{"content": "default"}]}
+            ]})").object(), script, error);
+        MockScript invalid;
+        const bool rejected = !MockScript::fromJson(QJsonDocument::fromJson(R"({"failures": {"timeout": 1}})").object(),
+                                                    invalid, error);
+
+        const QJsonArray messages = QJsonDocument::fromJson(R"([
+            {"role": "system", "content": "s"},
+            {"role": "user", "content": "旧问题"}, {"role": "assistant", "content": "x"},
+            {"role": "user", "content": "检查构建错误"},
+            {"role": "assistant", "tool_calls": []}, {"role": "tool", "content": "log"}])").array();
+        QString userMessage;
+        const int index = MockScript::stepIndex(messages, userMessage);
+
+        PRINT_EXPECTED("第 1 步，user = 检查构建错误；第 1 步回复 b，其他问题回复 default，超出脚本回复结束语");
+        if (!ok || !rejected || script.failureRates.value("429") != 0.1 || script.retryAfterSec != 2
+            || index != 1 || userMessage != "检查构建错误"
+            || script.step(userMessage, index).content != "b"
+            || script.step(userMessage, 0).toolCalls.size() != 1
+            || script.step("其他", 0).content != "default"
+            || !script.step(userMessage, 2).toolCalls.isEmpty()) {
+            PRINT_ACTUAL(QString("ok: %1, rejected: %2, index: %3, user: %4").arg(ok).arg(rejected).arg(index).arg(userMessage));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 选择正确");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 脚本化工具循环
+    // ========================================
+    TEST("工具循环 - 分片输出的 tool_calls 被拼装执行，结果进入下一步请求") {
+        MockLLMServer server;
+        server.setScript(parseScript(R"({
+            "latencyMs": 50, "chunkChars": 3, "chunksPerSecond": 200,
+            "scenarios": [{"steps": [
+                {"content": "先看文件。", "toolCalls": [{"name": "echo", "arguments": {"text": "来自工具的结果"}}]},
+                {"content": "文件内容已确认。"}
+            ]}]})"));
+        server.listen();
+        QList<QByteArray> bodies;
+        QObject::connect(&server, &SseServer::requestReceived,
+                         [&bodies](int, const QByteArray& body) { bodies.append(body); });
+
+        ToolDispatcher dispatcher;
+        Tool echo;
+        echo.name = "echo";
+        echo.description = "返回 text";
+        echo.inputSchema = QJsonObject{{"type", "object"}};
+        dispatcher.registerTool(echo, "回显", [](const QJsonObject& input) { return input["text"].toString(); });
+
+        LLMAgent agent;
+        agent.setConfig(mockConfig(server));
+        agent.setToolDispatcher(&dispatcher);
+        QString finished;
+        QObject::connect(&agent, &LLMAgent::finished, [&finished](const QString& content) { finished = content; });
+
+        agent.sendMessage("看看文件");
+        PRINT_EXPECTED("2 次请求，第二次携带工具结果，最终回复为第 2 步内容");
+        if (!waitFor([&finished]() { return !finished.isEmpty(); }, 5000)) {
+            PRINT_ACTUAL(QString("超时，请求数: %1").arg(bodies.size()));
+            return 1;
+        }
+        if (bodies.size() != 2 || !bodies[1].contains("来自工具的结果") || finished != "文件内容已确认。") {
+            PRINT_ACTUAL(QString("请求数: %1, 回复: %2").arg(bodies.size()).arg(finished));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + finished);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 注入 429
+    // ========================================
+    TEST("故障注入 - 脚本指定的 429 只注入一次，Agent 按 Retry-After 重试后完成") {
+        MockLLMServer server;
+        server.setScript(parseScript(R"({
+            "failures": {"retryAfterSec": 0},
+            "scenarios": [{"steps": [{"content": "重试后的回复", "fail": "429"}]}]})"));
+        server.listen();
+
+        LLMAgent agent;
+        agent.setConfig(mockConfig(server));
+        QString finished;
+        QString error;
+        QObject::connect(&agent, &LLMAgent::finished, [&finished](const QString& content) { finished = content; });
+        QObject::connect(&agent, &LLMAgent::errorOccurred, [&error](const QString& message) { error = message; });
+
+        agent.sendMessage("你好");
+        PRINT_EXPECTED("2 次请求（注入 1 次 429），最终正常完成");
+        if (!waitFor([&]() { return !finished.isEmpty() || !error.isEmpty(); }, 5000)
+            || finished != "重试后的回复" || server.requestCount() != 2 || server.injectedCount("429") != 1) {
+            PRINT_ACTUAL(QString("回复: %1, 错误: %2, 请求数: %3").arg(finished, error).arg(server.requestCount()));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ %1 次请求").arg(server.requestCount()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 注入挂起
+    // ========================================
+    TEST("故障注入 - 输出一半后挂起，空闲超时后重试，已显示的文本不重复") {
+        MockLLMServer server;
+        server.setScript(parseScript(R"({
+            "chunkChars": 2,
+            "scenarios": [{"steps": [{"content": "一二三四五六七八", "fail": "stall"}]}]})"));
+        server.listen();
+
+        LLMConfig config = mockConfig(server);
+        config.idleTimeoutMs = 300;
+        LLMAgent agent;
+        agent.setConfig(config);
+        QString streamed;
+        QString finished;
+        QObject::connect(&agent, &LLMAgent::streamDataReceived, [&streamed](const QString& data) { streamed += data; });
+        QObject::connect(&agent, &LLMAgent::finished, [&finished](const QString& content) { finished = content; });
+
+        agent.sendMessage("数数");
+        PRINT_EXPECTED("约 300ms 后重试，流式输出合计为完整内容且没有重复");
+        if (!waitFor([&finished]() { return !finished.isEmpty(); }, 8000)
+            || finished != "一二三四五六七八" || streamed != finished || server.injectedCount("stall") != 1) {
+            PRINT_ACTUAL(QString("回复: %1, 流式: %2, 请求数: %3").arg(finished, streamed).arg(server.requestCount()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + streamed);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,30 @@
+# Mock LLM 服务测试项目（脚本解析，以及 LLMAgent 对脚本回复与注入故障的处理）
+
+QT += core network
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = MockLLMServerTest
+
+# 第三方库（核心模块依赖）
+include(../../3rdparty/yaml-cpp.pri)
+include(../../3rdparty/tree-sitter.pri)
+
+# 核心模块
+include(../../src/core/core.pri)
+
+# 回放与 SSE 服务（测试支撑模块）
+include(../../src/core/testsupport.pri)
+
+# 源文件
+SOURCES += MockLLMServerTest.cpp \
+           ../../src/mock/MockLLMServer.cpp \
+           ../../src/mock/MockScript.cpp
+
+HEADERS += ../../src/mock/MockLLMServer.h \
+           ../../src/mock/MockScript.h
+
+# 包含路径
+INCLUDEPATH += ../../src
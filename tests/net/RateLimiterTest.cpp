@@ -0,0 +1,188 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QStringList>
+
+#include "core/net/RateLimiter.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 在事件循环中等待，直到条件满足或超时
+template <typename Pred>
+static bool waitFor(Pred pred, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!pred() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return pred();
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        RateLimiter 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: RPM 突发与 FIFO
+    // ========================================
+    TEST("RPM - 桶内令牌立即放行，其余按 FIFO 排队") {
+        RateLimiter limiter;
+        limiter.setRequestsPerMinute(600);  // 每 100ms 补充一个令牌
+        QObject owner;
+        QStringList granted;
+
+        // 先耗尽突发额度
+        for (int i = 0; i < 600; ++i) {
+            limiter.acquire(&owner, [](){});
+        }
+        limiter.acquire(&owner, [&granted]() { granted.append("a"); });
+        limiter.acquire(&owner, [&granted]() { granted.append("b"); });
+        PRINT_EXPECTED("额度耗尽后排队，约 200ms 内依次放行 a, b");
+
+        if (!granted.isEmpty() || limiter.waitingCount() != 2) {
+            PRINT_ACTUAL(QString("立即放行: %1").arg(granted.join(", ")));
+            return 1;
+        }
+        if (!waitFor([&granted]() { return granted.size() == 2; }, 1000) || granted != QStringList({"a", "b"})) {
+            PRINT_ACTUAL(granted.join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + granted.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 取消与申请方销毁
+    // ========================================
+    TEST("取消 - cancel 与申请方销毁后不再回调") {
+        RateLimiter limiter;
+        limiter.setRequestsPerMinute(600);
+        QObject keep;
+        QObject canceled;
+        QObject* destroyed = new QObject;
+        QStringList granted;
+
+        for (int i = 0; i < 600; ++i) {
+            limiter.acquire(&keep, [](){});
+        }
+        limiter.acquire(&canceled, [&granted]() { granted.append("canceled"); });
+        limiter.acquire(destroyed, [&granted]() { granted.append("destroyed"); });
+        limiter.acquire(&keep, [&granted]() { granted.append("keep"); });
+        limiter.cancel(&canceled);
+        delete destroyed;
+        PRINT_EXPECTED("只有 keep 被放行，且不为已销毁的申请方消耗令牌");
+
+        if (!waitFor([&granted]() { return !granted.isEmpty(); }, 1000) || granted != QStringList({"keep"})) {
+            PRINT_ACTUAL(granted.join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + granted.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: TPM 估算与补差
+    // ========================================
+    TEST("TPM - 按估算扣除，settle 退还后排队请求立即放行") {
+        RateLimiter limiter;
+        limiter.setTokensPerMinute(1000);
+        QObject owner;
+        QStringList granted;
+
+        limiter.acquire(&owner, 600, [&granted]() { granted.append("first"); });
+        limiter.acquire(&owner, 600, [&granted]() { granted.append("second"); });
+        PRINT_EXPECTED("second 排队；first 实际只用 100 token，settle 后 second 放行");
+
+        if (granted != QStringList({"first"})) {
+            PRINT_ACTUAL(granted.join(", "));
+            return 1;
+        }
+        limiter.settle(600, 100);
+        if (granted != QStringList({"first", "second"})) {
+            PRINT_ACTUAL(granted.join(", "));
+            return 1;
+        }
+
+        // 超过桶容量的请求按容量计，不会永远等待
+        limiter.setTokensPerMinute(1000);
+        bool huge = false;
+        limiter.acquire(&owner, 5000, [&huge]() { huge = true; });
+        if (!huge) {
+            PRINT_ACTUAL("超大请求未放行");
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + granted.join(", ") + ", huge");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: Retry-After 暂停
+    // ========================================
+    TEST("暂停 - pause 期间不限速的请求也要等待") {
+        RateLimiter limiter;
+        QObject owner;
+        bool granted = false;
+        QElapsedTimer timer;
+
+        limiter.pause(150);
+        timer.start();
+        limiter.acquire(&owner, [&granted]() { granted = true; });
+        PRINT_EXPECTED("约 150ms 后放行");
+
+        if (granted) {
+            PRINT_ACTUAL("暂停期间被放行");
+            return 1;
+        }
+        if (!waitFor([&granted]() { return granted; }, 1000) || timer.elapsed() < 140) {
+            PRINT_ACTUAL(QString("granted: %1, elapsed: %2ms").arg(granted).arg(timer.elapsed()));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ %1ms").arg(timer.elapsed()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
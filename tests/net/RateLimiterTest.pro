@@ -0,0 +1,18 @@
+# RateLimiter 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = RateLimiterTest
+
+# 源文件
+SOURCES += RateLimiterTest.cpp \
+           ../../src/core/net/RateLimiter.cpp
+
+HEADERS += ../../src/core/net/RateLimiter.h
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,250 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "core/agent/LLMAgent.h"
+#include "core/agent/ToolDispatcher.h"
+#include "core/net/LLMTransport.h"
+#include "core/net/ReplayServer.h"
+#include "core/net/SessionCassette.h"
+#include "core/net/SessionRecorder.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 在事件循环中等待，直到条件满足或超时
+template <typename Pred>
+static bool waitFor(Pred pred, int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!pred() && timer.elapsed() < timeoutMs) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return pred();
+}
+
+// 构造一行 SSE 数据
+static SseLine sseData(int timeMs, const QJsonObject& chunk) {
+    return SseLine{timeMs, "data: " + QJsonDocument(chunk).toJson(QJsonDocument::Compact)};
+}
+
+static SseLine contentChunk(int timeMs, const QString& text, const QJsonValue& finishReason = QJsonValue::Null) {
+    QJsonObject choice{{"index", 0}, {"delta", QJsonObject{{"content", text}}}, {"finish_reason", finishReason}};
+    return sseData(timeMs, QJsonObject{{"choices", QJsonArray{choice}}});
+}
+
+static SseLine toolCallChunk(int timeMs, const QString& id, const QString& name, const QJsonObject& args) {
+    QJsonObject function{{"name", name}, {"arguments", QString::fromUtf8(QJsonDocument(args).toJson(QJsonDocument::Compact))}};
+    QJsonObject call{{"index", 0}, {"id", id}, {"type", "function"}, {"function", function}};
+    QJsonObject choice{{"index", 0}, {"delta", QJsonObject{{"tool_calls", QJsonArray{call}}}}, {"finish_reason", QJsonValue::Null}};
+    return sseData(timeMs, QJsonObject{{"choices", QJsonArray{choice}}});
+}
+
+static SseLine finishChunk(int timeMs, const QString& reason) {
+    QJsonObject choice{{"index", 0}, {"delta", QJsonObject()}, {"finish_reason", reason}};
+    return sseData(timeMs, QJsonObject{{"choices", QJsonArray{choice}}});
+}
+
+static LLMConfig replayConfig(const ReplayServer& server) {
+    LLMConfig config;
+    config.agentId = "replay";
+    config.apiKey = "replay";
+    config.baseUrl = server.baseUrl();
+    config.maxRetries = 0;
+    return config;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        会话录制 / 回放 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QTemporaryDir tempDir;
+
+    // ========================================
+    // 测试 1: 录制文件往返
+    // ========================================
+    TEST("SessionRecorder -> SessionCassette - 请求、SSE 行与工具结果往返，未结束的请求被丢弃") {
+        const QString path = tempDir.filePath("roundtrip.jsonl");
+        SessionRecorder recorder;
+        if (!recorder.open(path)) {
+            PRINT_ACTUAL(recorder.errorString());
+            return 1;
+        }
+        const int first = recorder.beginExchange("main", R"({"model":"deepseek-chat"})");
+        const int second = recorder.beginExchange("worker-1", R"({"model":"other"})");  // 并发请求交错写入
+        recorder.recordLine(first, "data: {\"a\":1}");
+        recorder.recordLine(second, "data: {\"b\":1}");
+        recorder.recordLine(first, "data: [DONE]");
+        recorder.endExchange(first, 200);
+        ToolCall call;
+        call.id = "call_0";
+        call.name = "view_file";
+        call.input = QJsonObject{{"file_path", "a.cpp"}};
+        recorder.recordTool(call, "int main() {}");
+        recorder.close();  // second 没有 end
+
+        SessionCassette cassette;
+        QString error;
+        PRINT_EXPECTED("1 个完整请求（2 行，状态 200），1 条工具记录");
+        if (!SessionCassette::load(path, cassette, error)) {
+            PRINT_ACTUAL(error);
+            return 1;
+        }
+        if (cassette.exchanges.size() != 1 || cassette.exchanges[0].lines.size() != 2
+            || cassette.exchanges[0].requestBody != R"({"model":"deepseek-chat"})"
+            || cassette.exchanges[0].lines[1].data != "data: [DONE]" || cassette.exchanges[0].status != 200
+            || cassette.tools.size() != 1 || cassette.tools[0].result != "int main() {}"
+            || cassette.tools[0].input != call.input) {
+            PRINT_ACTUAL(QString("请求: %1, 工具: %2").arg(cassette.exchanges.size()).arg(cassette.tools.size()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 往返一致");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 纯文本回放
+    // ========================================
+    TEST("ReplayServer - 按录制时间回放文本回复，LLMAgent 拼出完整内容") {
+        SessionCassette cassette;
+        SseExchange exchange;
+        exchange.lines = {contentChunk(0, "你好"), contentChunk(30, "，世界"), finishChunk(60, "stop"),
+                          SseLine{60, "data: [DONE]"}};
+        cassette.exchanges.append(exchange);
+
+        ReplayServer server;
+        server.setCassette(cassette);
+        if (!server.listen()) {
+            PRINT_ACTUAL("无法监听本地端口");
+            return 1;
+        }
+
+        LLMAgent agent;
+        agent.setConfig(replayConfig(server));
+        QString finished;
+        QString error;
+        QObject::connect(&agent, &LLMAgent::finished, [&finished](const QString& content) { finished = content; });
+        QObject::connect(&agent, &LLMAgent::errorOccurred, [&error](const QString& message) { error = message; });
+
+        QElapsedTimer timer;
+        timer.start();
+        agent.sendMessage("打个招呼");
+        PRINT_EXPECTED("约 60ms 后结束，内容为 \"你好，世界\"");
+        if (!waitFor([&]() { return !finished.isEmpty() || !error.isEmpty(); }, 5000)) {
+            PRINT_ACTUAL("超时");
+            return 1;
+        }
+        if (finished != "你好，世界" || timer.elapsed() < 55 || server.servedCount() != 1) {
+            PRINT_ACTUAL(QString("内容: %1, 错误: %2, 用时: %3ms").arg(finished, error).arg(timer.elapsed()));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ %1 (%2ms)").arg(finished).arg(timer.elapsed()));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 工具循环回放并重新录制
+    // ========================================
+    TEST("回放工具循环 - 工具返回录制结果；回放过程可被再次录制") {
+        const QJsonObject args{{"file_path", "src/main.cpp"}};
+        SessionCassette cassette;
+        SseExchange toolStep;
+        toolStep.lines = {toolCallChunk(0, "call_0", "view_file", args), finishChunk(0, "tool_calls"),
+                          SseLine{0, "data: [DONE]"}};
+        SseExchange answer;
+        answer.lines = {contentChunk(0, "main.cpp 只有一个空的 main"), finishChunk(0, "stop"), SseLine{0, "data: [DONE]"}};
+        cassette.exchanges = {toolStep, answer};
+        cassette.tools.append(ToolRecord{"call_0", "view_file", args, "int main() { return 0; }"});
+
+        ReplayServer server;
+        server.setCassette(cassette);
+        server.setTiming(ReplayServer::Timing::Fixed, 0);
+        server.listen();
+        QList<QByteArray> bodies;
+        QObject::connect(&server, &ReplayServer::requestReceived,
+                         [&bodies](int, const QByteArray& body) { bodies.append(body); });
+
+        ToolDispatcher dispatcher;
+        cassette.installTools(&dispatcher);
+
+        const QString recordPath = tempDir.filePath("rerecord.jsonl");
+        SessionRecorder recorder;
+        recorder.open(recordPath);
+        LLMTransport::instance().setRecorder(&recorder);
+
+        LLMAgent agent;
+        agent.setConfig(replayConfig(server));
+        agent.setToolDispatcher(&dispatcher);
+        QString finished;
+        QObject::connect(&agent, &LLMAgent::finished, [&finished](const QString& content) { finished = content; });
+
+        agent.sendMessage("看看 main.cpp");
+        const bool done = waitFor([&finished]() { return !finished.isEmpty(); }, 5000);
+        LLMTransport::instance().setRecorder(nullptr);
+        recorder.close();
+
+        PRINT_EXPECTED("2 次请求，第二次请求携带录制的工具结果；重新录制的文件可再次加载");
+        if (!done || bodies.size() != 2 || !bodies[1].contains("int main() { return 0; }")) {
+            PRINT_ACTUAL(QString("结束: %1, 请求数: %2").arg(done).arg(bodies.size()));
+            return 1;
+        }
+
+        SessionCassette rerecorded;
+        QString error;
+        if (!SessionCassette::load(recordPath, rerecorded, error) || rerecorded.exchanges.size() != 2
+            || rerecorded.exchanges[1].requestBody != bodies[1] || rerecorded.tools.size() != 1
+            || rerecorded.tools[0].result != "int main() { return 0; }") {
+            PRINT_ACTUAL(QString("重新录制: %1 个请求, %2 条工具记录 %3")
+                             .arg(rerecorded.exchanges.size()).arg(rerecorded.tools.size()).arg(error));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ %1").arg(finished));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
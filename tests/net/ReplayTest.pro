@@ -0,0 +1,25 @@
+# 会话录制 / 回放测试项目（通过本地回放服务驱动 LLMAgent）
+
+QT += core network
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ReplayTest
+
+# 第三方库（核心模块依赖）
+include(../../3rdparty/yaml-cpp.pri)
+include(../../3rdparty/tree-sitter.pri)
+
+# 核心模块
+include(../../src/core/core.pri)
+
+# 回放与 SSE 服务（测试支撑模块）
+include(../../src/core/testsupport.pri)
+
+# 源文件
+SOURCES += ReplayTest.cpp
+
+# 包含路径
+INCLUDEPATH += ../../src
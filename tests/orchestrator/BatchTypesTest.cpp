@@ -0,0 +1,183 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QTemporaryDir>
+#include <QFile>
+
+#include "core/orchestrator/BatchTypes.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static QJsonObject parse(const char* json) {
+    return QJsonDocument::fromJson(json).object();
+}
+
+static QJsonObject makeRecord(const QString& id, const QString& status) {
+    QJsonObject record;
+    record["id"] = id;
+    record["status"] = status;
+    return record;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        BatchTypes 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 字符串条目
+    // ========================================
+    TEST("字符串条目 - 以自身为 ID，{{item}} 引用") {
+        BatchManifest manifest;
+        QString error;
+        const bool ok = BatchManifest::fromJson(
+            parse(R"({"template": "审查 {{item}}", "maxAttempts": 2, "items": ["a.cpp", "b.cpp"]})"),
+            manifest, error);
+        PRINT_EXPECTED("2 个条目，ID 为 a.cpp / b.cpp，maxAttempts = 2");
+
+        if (!ok || manifest.items.size() != 2 || manifest.items[1].id != "b.cpp" || manifest.maxAttempts != 2) {
+            PRINT_ACTUAL(QString("ok: %1, error: %2").arg(ok).arg(error));
+            return 1;
+        }
+        const QString prompt = manifest.render(manifest.items[0]);
+        if (prompt != "审查 a.cpp") {
+            PRINT_ACTUAL(prompt);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + prompt);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 对象条目与模板变量
+    // ========================================
+    TEST("对象条目 - 字段替换，未知变量原样保留") {
+        BatchManifest manifest;
+        QString error;
+        const bool ok = BatchManifest::fromJson(
+            parse(R"({"template": "[{{id}}] {{ file }} 第 {{line}} 行 {{missing}}",
+                      "items": [{"id": "x", "file": "a.cpp", "line": 42}, {"file": "b.cpp"}]})"),
+            manifest, error);
+        PRINT_EXPECTED("[x] a.cpp 第 42 行 {{missing}}；无 ID 的条目为 item-2");
+
+        if (!ok || manifest.items.size() != 2) {
+            PRINT_ACTUAL(error);
+            return 1;
+        }
+        const QString prompt = manifest.render(manifest.items[0]);
+        if (prompt != "[x] a.cpp 第 42 行 {{missing}}" || manifest.items[1].id != "item-2") {
+            PRINT_ACTUAL(prompt + " / " + manifest.items[1].id);
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + prompt);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 无效清单
+    // ========================================
+    TEST("无效清单 - 缺少模板、ID 重复、没有条目") {
+        const char* manifests[] = {
+            R"({"items": ["a"]})",
+            R"({"template": "{{item}}", "items": ["a", {"id": "a"}]})",
+            R"({"template": "{{item}}", "items": []})",
+        };
+        for (const char* json : manifests) {
+            BatchManifest manifest;
+            QString error;
+            if (BatchManifest::fromJson(parse(json), manifest, error) || error.isEmpty()) {
+                PRINT_ACTUAL(QString("未拒绝: %1").arg(json));
+                return 1;
+            }
+            PRINT_ACTUAL("✓ " + error);
+        }
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 结果文件续跑
+    // ========================================
+    TEST("续跑 - 以最后一行为准，半行被忽略") {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("results.jsonl");
+
+        BatchResultLog log;
+        if (!log.open(path)) {
+            PRINT_ACTUAL(log.errorString());
+            return 1;
+        }
+        log.append(makeRecord("a", "succeeded"));
+        log.append(makeRecord("b", "succeeded"));
+        log.append(makeRecord("c", "failed"));
+        log.append(makeRecord("b", "failed"));   // 重跑后失败，以最后一行为准
+        log.close();
+
+        // 模拟进程在写入时被杀
+        QFile file(path);
+        file.open(QIODevice::Append);
+        file.write(R"({"id": "d", "status": "succ)");
+        file.close();
+
+        // 再次打开后追加的记录不能接在半行后面
+        if (!log.open(path)) {
+            PRINT_ACTUAL(log.errorString());
+            return 1;
+        }
+        log.append(makeRecord("c", "succeeded"));
+        log.close();
+
+        const QSet<QString> succeeded = BatchResultLog::loadSucceeded(path);
+        PRINT_EXPECTED("已成功: a, c");
+        if (succeeded != QSet<QString>({"a", "c"})) {
+            PRINT_ACTUAL(QStringList(succeeded.values()).join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ a, c");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,18 @@
+# BatchTypes 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = BatchTypesTest
+
+# 源文件
+SOURCES += BatchTypesTest.cpp \
+           ../../src/core/orchestrator/BatchTypes.cpp
+
+HEADERS += ../../src/core/orchestrator/BatchTypes.h
+
+# 包含路径
+INCLUDEPATH += ../../src
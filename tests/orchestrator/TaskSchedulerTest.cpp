@@ -0,0 +1,265 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QStringList>
+
+#include "core/orchestrator/TaskScheduler.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// ==================== 构造辅助函数 ====================
+
+static AgentTask makeTask(const QString& id, const QString& type,
+                          const QStringList& dependsOn = QStringList()) {
+    AgentTask task;
+    task.id = id;
+    task.type = type;
+    task.prompt = "任务 " + id;
+    task.dependsOn = dependsOn;
+    task.applyDefaultLocks();
+    return task;
+}
+
+// 记录调度器放行/跳过的任务
+struct Recorder {
+    QStringList started;
+    QStringList skipped;
+    int idleCount = 0;
+
+    explicit Recorder(TaskScheduler& scheduler) {
+        QObject::connect(&scheduler, &TaskScheduler::taskReady, [this](const AgentTask& task) {
+            started.append(task.id);
+        });
+        QObject::connect(&scheduler, &TaskScheduler::taskSkipped,
+                         [this](const AgentTask& task, TaskStatus, const QString&) {
+            skipped.append(task.id);
+        });
+        QObject::connect(&scheduler, &TaskScheduler::idle, [this]() { ++idleCount; });
+    }
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        TaskScheduler 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 全局并发上限
+    // ========================================
+    TEST("全局并发上限") {
+        TaskScheduler scheduler;
+        Recorder recorder(scheduler);
+        scheduler.setGlobalLimit(2);
+
+        scheduler.enqueue(makeTask("a", "llm"));
+        scheduler.enqueue(makeTask("b", "llm"));
+        scheduler.enqueue(makeTask("c", "llm"));
+        PRINT_EXPECTED("先开始 a、b；a 结束后开始 c");
+
+        const QStringList beforeComplete = recorder.started;
+        scheduler.complete("a", TaskStatus::Succeeded);
+
+        if (beforeComplete != QStringList({"a", "b"})
+            || recorder.started != QStringList({"a", "b", "c"})
+            || scheduler.runningCount() != 2) {
+            PRINT_ACTUAL(recorder.started.join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + recorder.started.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 共享锁并发，独占锁等待且不被饿死
+    // ========================================
+    TEST("workspace 锁 - 搜索并发，补丁独占") {
+        TaskScheduler scheduler;
+        Recorder recorder(scheduler);
+
+        scheduler.enqueue(makeTask("search-core", TaskType::SEARCH_TEXT));
+        scheduler.enqueue(makeTask("search-ui", TaskType::SEARCH_TEXT));
+        scheduler.enqueue(makeTask("search-tools", TaskType::SEARCH_TEXT));
+        scheduler.enqueue(makeTask("patch", TaskType::APPLY_PATCH));
+        scheduler.enqueue(makeTask("search-late", TaskType::SEARCH_TEXT));
+        PRINT_EXPECTED("三个搜索并发；补丁等搜索结束后独占执行；之后的搜索排在补丁之后");
+
+        const QStringList phase1 = recorder.started;
+        scheduler.complete("search-core", TaskStatus::Succeeded);
+        scheduler.complete("search-ui", TaskStatus::Succeeded);
+        const QStringList phase2 = recorder.started;
+        scheduler.complete("search-tools", TaskStatus::Succeeded);
+        const QStringList phase3 = recorder.started;
+        scheduler.complete("patch", TaskStatus::Succeeded);
+
+        if (phase1 != QStringList({"search-core", "search-ui", "search-tools"})
+            || phase2 != phase1
+            || phase3.last() != "patch"
+            || recorder.started.last() != "search-late") {
+            PRINT_ACTUAL(recorder.started.join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + recorder.started.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 按任务类型的并发上限
+    // ========================================
+    TEST("按类型并发上限 - build 默认串行") {
+        TaskScheduler scheduler;
+        Recorder recorder(scheduler);
+
+        AgentTask buildDebug = makeTask("build-debug", TaskType::BUILD);
+        AgentTask buildRelease = makeTask("build-release", TaskType::BUILD);
+        // 不同的构建目录，不存在锁冲突，只受类型上限约束
+        buildDebug.exclusiveLocks = QStringList{"builddir:debug"};
+        buildRelease.exclusiveLocks = QStringList{"builddir:release"};
+        scheduler.enqueue(buildDebug);
+        scheduler.enqueue(buildRelease);
+        scheduler.enqueue(makeTask("search", TaskType::SEARCH_TEXT));
+        PRINT_EXPECTED("build-debug 与 search 先开始，build-release 等待");
+
+        const QStringList before = recorder.started;
+        scheduler.complete("build-debug", TaskStatus::Succeeded);
+
+        if (before != QStringList({"build-debug", "search"})
+            || recorder.started.last() != "build-release"
+            || scheduler.runningCount(TaskType::BUILD) != 1) {
+            PRINT_ACTUAL(recorder.started.join(", "));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + recorder.started.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 依赖失败时跳过后续任务
+    // ========================================
+    TEST("依赖 - 失败向下游传播") {
+        TaskScheduler scheduler;
+        Recorder recorder(scheduler);
+
+        scheduler.enqueue(makeTask("build", TaskType::BUILD));
+        scheduler.enqueue(makeTask("test", TaskType::EXEC_SHELL, {"build"}));
+        scheduler.enqueue(makeTask("report", "llm", {"test"}));
+        PRINT_EXPECTED("build 失败后 test 与 report 被跳过，调度器进入空闲");
+
+        const QStringList before = recorder.started;
+        scheduler.complete("build", TaskStatus::Failed);
+
+        if (before != QStringList({"build"})
+            || recorder.skipped != QStringList({"test", "report"})
+            || scheduler.status("report") != TaskStatus::Canceled
+            || !scheduler.isIdle() || recorder.idleCount != 1) {
+            PRINT_ACTUAL(QString("started: %1, skipped: %2")
+                         .arg(recorder.started.join(", "), recorder.skipped.join(", ")));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 跳过: " + recorder.skipped.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 5: 在 taskReady 中同步结束任务
+    // ========================================
+    TEST("重入 - taskReady 槽函数中立即 complete") {
+        TaskScheduler scheduler;
+        Recorder recorder(scheduler);
+        scheduler.setGlobalLimit(1);
+        QObject::connect(&scheduler, &TaskScheduler::taskReady, [&scheduler](const AgentTask& task) {
+            scheduler.complete(task.id, TaskStatus::Succeeded);
+        });
+
+        for (int i = 0; i < 5; ++i) {
+            scheduler.enqueue(makeTask(QString("t%1").arg(i), TaskType::APPLY_PATCH));
+        }
+        PRINT_EXPECTED("5 个任务依次执行完毕，每次提交后回到空闲");
+
+        if (recorder.started.size() != 5 || !scheduler.isIdle() || recorder.idleCount != 5) {
+            PRINT_ACTUAL(QString("started: %1, idle: %2")
+                         .arg(recorder.started.size()).arg(recorder.idleCount));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + recorder.started.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 6: 多个调度器共用锁表
+    // ========================================
+    TEST("共用锁表 - 跨调度器独占，子任务可在祖先的锁下运行") {
+        TaskLockTable locks;
+        TaskScheduler level1;
+        TaskScheduler level2;
+        level1.setLockTable(&locks);
+        level2.setLockTable(&locks);
+        Recorder recorder1(level1);
+        Recorder recorder2(level2);
+
+        level1.enqueue(makeTask("patch", TaskType::APPLY_PATCH));
+        AgentTask child = makeTask("child-search", TaskType::SEARCH_TEXT);
+        child.lockParents << "patch";
+        level2.enqueue(child);
+        level2.enqueue(makeTask("other-patch", TaskType::APPLY_PATCH));
+        PRINT_EXPECTED("patch 的子任务立即开始；无关的 other-patch 等 patch 释放锁后才开始");
+
+        const QStringList phase1 = recorder2.started;
+        level2.complete("child-search", TaskStatus::Succeeded);
+        const QStringList phase2 = recorder2.started;
+        level1.complete("patch", TaskStatus::Succeeded);
+        QCoreApplication::processEvents();  // 其他调度器的释放通知是排队投递的
+
+        if (recorder1.started != QStringList({"patch"})
+            || phase1 != QStringList({"child-search"})
+            || phase2 != phase1
+            || recorder2.started != QStringList({"child-search", "other-patch"})
+            || !locks.isHeld(TaskLock::WORKSPACE)) {
+            PRINT_ACTUAL(QString("level1: %1 / level2: %2")
+                         .arg(recorder1.started.join(", "), recorder2.started.join(", ")));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ " + recorder1.started.join(", ") + " / " + recorder2.started.join(", "));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,21 @@
+# TaskScheduler 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = TaskSchedulerTest
+
+# 源文件
+SOURCES += TaskSchedulerTest.cpp \
+           ../../src/core/orchestrator/TaskScheduler.cpp \
+           ../../src/core/orchestrator/TaskLockTable.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+HEADERS += ../../src/core/orchestrator/TaskScheduler.h \
+           ../../src/core/orchestrator/TaskLockTable.h
+
+# 包含路径
+INCLUDEPATH += ../../src
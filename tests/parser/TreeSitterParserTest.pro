@@ -11,7 +11,9 @@ include(../../3rdparty/tree-sitter.pri)
 
 SOURCES += \
     TreeSitterParserTest.cpp \
-    ../../src/core/parser/TreeSitterParser.cpp
+    ../../src/core/parser/TreeSitterParser.cpp \
+    ../../src/core/trace/Tracer.cpp
 
 HEADERS += \
-    ../../src/core/parser/TreeSitterParser.h
+    ../../src/core/parser/TreeSitterParser.h \
+    ../../src/core/trace/Tracer.h
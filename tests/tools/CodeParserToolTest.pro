@@ -10,7 +10,9 @@ TARGET = CodeParserToolTest
 
 # 源文件
 SOURCES += CodeParserToolTest.cpp \
-           ../../src/core/parser/TreeSitterParser.cpp
+           ../../src/core/parser/TreeSitterParser.cpp \
+           ../../src/core/trace/Tracer.cpp \
+           ../../src/core/log/LogCategories.cpp
 
 # 包含路径
 INCLUDEPATH += ../../src
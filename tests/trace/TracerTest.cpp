@@ -0,0 +1,180 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QHash>
+
+#include "core/trace/Tracer.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// 导出的事件（不含线程名元数据）
+static QList<QJsonObject> exportedEvents() {
+    QList<QJsonObject> events;
+    const QJsonObject root = QJsonDocument::fromJson(Tracer::instance().toChromeTraceJson()).object();
+    for (const QJsonValue& value : root["traceEvents"].toArray()) {
+        if (value.toObject()["ph"].toString() != "M") {
+            events.append(value.toObject());
+        }
+    }
+    return events;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        Tracer 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 开关与导出格式
+    // ========================================
+    TEST("区间 / 时间点 / 计数器 - 关闭时不记录，开启后导出为 Chrome trace 事件") {
+        Tracer::setEnabled(false);
+        Tracer::instance().clear();
+        {
+            TRACE_SCOPE("test", "ignored");
+        }
+        const int disabledCount = exportedEvents().size();
+
+        Tracer::setEnabled(true);
+        {
+            TraceSpan span("tool", "dispatch", "view_file");
+            span.setArg("bytes", 128);
+            QThread::msleep(20);
+        }
+        Tracer::instant("llm", "first_token");
+        Tracer::counter("llm", "in_flight", 3);
+        Tracer::setEnabled(false);
+
+        const QList<QJsonObject> events = exportedEvents();
+        PRINT_EXPECTED("关闭时 0 个事件；开启后 X（dur >= 20ms，带 detail 与 bytes）、i、C 各一个");
+        if (disabledCount != 0 || events.size() != 3) {
+            PRINT_ACTUAL(QString("关闭时: %1, 开启后: %2").arg(disabledCount).arg(events.size()));
+            return 1;
+        }
+        const QJsonObject span = events[0];
+        if (span["ph"].toString() != "X" || span["cat"].toString() != "tool" || span["name"].toString() != "dispatch"
+            || span["dur"].toDouble() < 19000 || span["args"].toObject()["detail"].toString() != "view_file"
+            || span["args"].toObject()["bytes"].toInt() != 128
+            || events[1]["ph"].toString() != "i" || events[2]["ph"].toString() != "C"
+            || events[2]["args"].toObject()["in_flight"].toInt() != 3
+            || events[1]["ts"].toDouble() < span["ts"].toDouble() + span["dur"].toDouble()) {
+            PRINT_ACTUAL(QString::fromUtf8(QJsonDocument(span).toJson(QJsonDocument::Compact)));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ dispatch %1us").arg(span["dur"].toDouble(), 0, 'f', 0));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 环形缓冲区
+    // ========================================
+    TEST("环形缓冲区 - 超出容量后只保留最近的事件，细节文本被截断") {
+        Tracer::instance().clear();
+        Tracer::setEnabled(true);
+        const int total = Tracer::kBufferEvents + 10;
+        for (int i = 0; i < total; ++i) {
+            Tracer::complete("test", "step", i, i + 1, QString(), "index", i);
+        }
+        Tracer::complete("test", "long", 0, 1, QString(100, QChar('x')));
+        Tracer::setEnabled(false);
+
+        const QList<QJsonObject> events = exportedEvents();
+        PRINT_EXPECTED(QString("%1 个事件，最早的 index 为 11，细节截断为 47 字节").arg(Tracer::kBufferEvents));
+        if (events.size() != Tracer::kBufferEvents || events.first()["args"].toObject()["index"].toInt() != 11
+            || events.last()["args"].toObject()["detail"].toString().size() != 47) {
+            PRINT_ACTUAL(QString("%1 个事件，最早 index %2").arg(events.size())
+                             .arg(events.isEmpty() ? -1 : events.first()["args"].toObject()["index"].toInt()));
+            return 1;
+        }
+        PRINT_ACTUAL("✓ 保留最近的事件");
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 多线程
+    // ========================================
+    TEST("多线程 - 每个线程独立的缓冲区与 tid，线程退出后事件仍可导出") {
+        Tracer::instance().clear();
+        Tracer::setEnabled(true);
+        QThread* worker = QThread::create([]() {
+            for (int i = 0; i < 100; ++i) {
+                TRACE_SCOPE("parser", "parse");
+            }
+        });
+        worker->setObjectName("parser-worker");
+        worker->start();
+        for (int i = 0; i < 100; ++i) {
+            TRACE_SCOPE("ui", "flush");
+        }
+        worker->wait();
+        delete worker;
+        Tracer::setEnabled(false);
+
+        const QJsonObject root = QJsonDocument::fromJson(Tracer::instance().toChromeTraceJson()).object();
+        QHash<QString, int> tidByName;
+        QHash<int, int> countByTid;
+        for (const QJsonValue& value : root["traceEvents"].toArray()) {
+            const QJsonObject event = value.toObject();
+            if (event["ph"].toString() == "M") {
+                tidByName.insert(event["args"].toObject()["name"].toString(), event["tid"].toInt());
+            } else {
+                countByTid[event["tid"].toInt()] += 1;
+            }
+        }
+        PRINT_EXPECTED("main 与 parser-worker 各 100 个事件，tid 不同");
+        const int mainTid = tidByName.value("main", -1);
+        const int workerTid = tidByName.value("parser-worker", -1);
+        if (mainTid < 0 || workerTid < 0 || mainTid == workerTid
+            || countByTid.value(mainTid) != 100 || countByTid.value(workerTid) != 100) {
+            PRINT_ACTUAL(QString("线程: %1").arg(QStringList(tidByName.keys()).join(", ")));
+            return 1;
+        }
+        PRINT_ACTUAL(QString("✓ main tid %1, parser-worker tid %2").arg(mainTid).arg(workerTid));
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,18 @@
+# Tracer 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = TracerTest
+
+# 源文件
+SOURCES += TracerTest.cpp \
+           ../../src/core/trace/Tracer.cpp
+
+HEADERS += ../../src/core/trace/Tracer.h
+
+# 包含路径
+INCLUDEPATH += ../../src
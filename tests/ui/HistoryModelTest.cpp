@@ -0,0 +1,155 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "ui/HistoryModel.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+static QJsonObject message(const QString& role, const QString& content) {
+    QJsonObject msg;
+    msg["role"] = role;
+    msg["content"] = content;
+    return msg;
+}
+
+static QJsonArray conversation(int turns) {
+    QJsonArray history;
+    for (int i = 1; i <= turns; ++i) {
+        history.append(message("user", QString("问题 %1").arg(i)));
+        history.append(message("assistant", QString("回答 %1").arg(i)));
+    }
+    return history;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        HistoryModel 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 逐条追加
+    // ========================================
+    TEST("append - 每条消息只插入一行，不重置模型") {
+        HistoryModel model;
+        model.setHistory(conversation(200));
+
+        QList<QPair<int, int>> inserted;
+        int resets = 0;
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&](const QModelIndex&, int first, int last) {
+            inserted.append(qMakePair(first, last));
+        });
+        QObject::connect(&model, &QAbstractItemModel::modelReset, [&]() { ++resets; });
+
+        model.append(message("user", "第 201 个问题"));
+        model.append(message("assistant", "第 201 个回答"));
+
+        PRINT_EXPECTED("两次 rowsInserted，分别为 (400, 400) 与 (401, 401)，没有 modelReset，共 201 轮");
+        PRINT_ACTUAL(QString("rowsInserted %1 次，modelReset %2 次，%3 行，%4 轮")
+                     .arg(inserted.size()).arg(resets).arg(model.rowCount()).arg(model.turnCount()));
+        return inserted.size() == 2 && inserted[0] == qMakePair(400, 400) && inserted[1] == qMakePair(401, 401)
+            && resets == 0 && model.rowCount() == 402 && model.turnCount() == 201 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 只显示 user / assistant 消息
+    // ========================================
+    TEST("append - 忽略 system 与工具消息，回答归入所在轮次") {
+        HistoryModel model;
+        const bool systemAdded = model.append(message("system", "你是助手"));
+        model.append(message("user", "列出文件"));
+        const bool toolAdded = model.append(QJsonObject{{"role", "tool"}, {"tool_call_id", "call_0"}, {"content", "a.cpp"}});
+        model.append(message("assistant", "只有 a.cpp"));
+        model.append(message("user", "打开它"));
+
+        const QModelIndex answer = model.index(1);
+        PRINT_EXPECTED("3 行；第 2 行为 assistant，属于第 1 轮；共 2 轮");
+        PRINT_ACTUAL(QString("%1 行，第 2 行 isUser=%2 turn=%3，%4 轮")
+                     .arg(model.rowCount()).arg(answer.data(HistoryModel::IsUserRole).toBool())
+                     .arg(answer.data(HistoryModel::TurnRole).toInt()).arg(model.turnCount()));
+        return !systemAdded && !toolAdded && model.rowCount() == 3
+            && !answer.data(HistoryModel::IsUserRole).toBool() && answer.data(HistoryModel::TurnRole).toInt() == 1
+            && model.index(2).data(HistoryModel::TurnRole).toInt() == 2 && model.turnCount() == 2 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 摘要
+    // ========================================
+    TEST("data - 摘要截断并折叠空白，完整内容按需取出") {
+        HistoryModel model;
+        const QString longReply = "第一行\n\n    第二行  " + QString(1000, QChar('x'));
+        model.append(message("assistant", longReply));
+
+        const QString preview = model.index(0).data(HistoryModel::PreviewRole).toString();
+        PRINT_INPUT("内容长度", longReply.size());
+        PRINT_EXPECTED(QString("摘要以 \"第一行 第二行 x\" 开头、以 … 结尾且不超过 %1 + 1 个字符；ToolTip 为完整内容")
+                       .arg(HistoryModel::kPreviewChars));
+        PRINT_ACTUAL(QString("摘要长度 %1: %2...").arg(preview.size()).arg(preview.left(12)));
+        return preview.startsWith("第一行 第二行 x") && preview.endsWith(QStringLiteral("…"))
+            && preview.size() <= HistoryModel::kPreviewChars + 1
+            && model.index(0).data(Qt::ToolTipRole).toString() == longReply
+            && model.index(0).data(Qt::DisplayRole).toString() == preview ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 整体替换
+    // ========================================
+    TEST("setHistory / clear - 重新计算轮数") {
+        HistoryModel model;
+        model.setHistory(conversation(3));
+        const int restoredRows = model.rowCount();
+        const int restoredTurns = model.turnCount();
+        model.clear();
+        model.append(message("user", "新的对话"));
+
+        PRINT_EXPECTED("恢复后 6 行 3 轮；清空后追加的消息为第 1 轮");
+        PRINT_ACTUAL(QString("恢复后 %1 行 %2 轮；清空后 %3 行，turn=%4")
+                     .arg(restoredRows).arg(restoredTurns).arg(model.rowCount())
+                     .arg(model.index(0).data(HistoryModel::TurnRole).toInt()));
+        return restoredRows == 6 && restoredTurns == 3 && model.rowCount() == 1 && model.turnCount() == 1
+            && model.index(0).data(HistoryModel::TurnRole).toInt() == 1 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
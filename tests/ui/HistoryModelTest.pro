@@ -0,0 +1,18 @@
+# HistoryModel 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = HistoryModelTest
+
+# 源文件
+SOURCES += HistoryModelTest.cpp \
+           ../../src/ui/HistoryModel.cpp
+
+HEADERS += ../../src/ui/HistoryModel.h
+
+# 包含路径
+INCLUDEPATH += ../../src
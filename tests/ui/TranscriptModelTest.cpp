@@ -0,0 +1,167 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QStringList>
+
+#include "ui/TranscriptModel.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+using Kind = TranscriptModel::Kind;
+using ToolStatus = TranscriptModel::ToolStatus;
+
+static QString lines(int count) {
+    QStringList result;
+    for (int i = 1; i <= count; ++i) {
+        result << QString("line %1").arg(i);
+    }
+    return result.join('\n');
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        TranscriptModel 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    // ========================================
+    // 测试 1: 流式输出
+    // ========================================
+    TEST("appendStreamText - 片段追加到同一个助手块，只通知这一行") {
+        TranscriptModel model;
+        model.append(Kind::User, "你好");
+
+        int inserted = 0;
+        QList<int> changedRows;
+        QObject::connect(&model, &QAbstractItemModel::rowsInserted, [&]() { ++inserted; });
+        QObject::connect(&model, &QAbstractItemModel::dataChanged, [&](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+            changedRows << topLeft.row() << bottomRight.row();
+        });
+
+        model.appendStreamText("你");
+        model.appendStreamText("好，");
+        model.appendStreamText("有什么可以帮你？");
+        const QModelIndex reply = model.index(1);
+        const bool streaming = reply.data(TranscriptModel::StreamingRole).toBool();
+        const int revision = reply.data(TranscriptModel::RevisionRole).toInt();
+        model.finishStreaming();
+
+        PRINT_EXPECTED("插入 1 行，之后追加 2 次、结束 1 次，dataChanged 都只涉及第 2 行；结束前修订号 2");
+        PRINT_ACTUAL(QString("插入 %1 次，变化行 %2，修订号 %3，内容 \"%4\"")
+                     .arg(inserted).arg(changedRows.size()).arg(revision).arg(reply.data().toString()));
+        return inserted == 1 && changedRows == QList<int>({1, 1, 1, 1, 1, 1}) && streaming && revision == 2
+            && reply.data().toString() == "你好，有什么可以帮你？"
+            && !reply.data(TranscriptModel::StreamingRole).toBool() && !model.isStreaming() ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 工具块打断流式输出
+    // ========================================
+    TEST("append - 工具事件结束当前助手块，之后的输出进入新块") {
+        TranscriptModel model;
+        model.appendStreamText("先看一下文件");
+        model.appendTool(ToolStatus::Running, "🔧 查看 main.cpp");
+        model.appendStreamText("文件只有一个 main 函数");
+
+        PRINT_EXPECTED("3 行：助手（已结束）/ 工具 / 助手（流式中）");
+        PRINT_ACTUAL(QString("%1 行，第 1 行 streaming=%2，第 3 行 streaming=%3")
+                     .arg(model.rowCount())
+                     .arg(model.index(0).data(TranscriptModel::StreamingRole).toBool())
+                     .arg(model.index(2).data(TranscriptModel::StreamingRole).toBool()));
+        return model.rowCount() == 3
+            && !model.index(0).data(TranscriptModel::StreamingRole).toBool()
+            && Kind(model.index(1).data(TranscriptModel::KindRole).toInt()) == Kind::Tool
+            && model.index(2).data(TranscriptModel::StreamingRole).toBool()
+            && model.index(2).data().toString() == "文件只有一个 main 函数" ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 折叠
+    // ========================================
+    TEST("appendTool / setData - 长输出默认折叠，点击切换并更新修订号") {
+        TranscriptModel model;
+        model.appendTool(ToolStatus::Succeeded, "✅ 执行完成", lines(3));
+        model.appendTool(ToolStatus::Succeeded, "✅ 执行完成", lines(40));
+        model.appendTool(ToolStatus::Failed, "❌ 执行失败");
+        model.appendTool(ToolStatus::Succeeded, "✅ 执行完成",
+                         QString(TranscriptModel::kMaxDetailChars + 100, QChar('x')));
+
+        const QModelIndex longOutput = model.index(1);
+        const bool expanded = model.setData(longOutput, false, TranscriptModel::CollapsedRole);
+        const bool noDetail = model.setData(model.index(2), true, TranscriptModel::CollapsedRole);
+        const int detailSize = model.index(3).data(TranscriptModel::DetailRole).toString().size();
+
+        PRINT_EXPECTED("3 行输出展开、40 行输出折叠；展开后修订号 1；没有输出的块不能折叠；超长输出被截断");
+        PRINT_ACTUAL(QString("折叠: %1 / %2，展开: %3 修订号 %4，无输出: %5，截断后 %6 字符")
+                     .arg(model.index(0).data(TranscriptModel::CollapsedRole).toBool())
+                     .arg(!expanded || longOutput.data(TranscriptModel::CollapsedRole).toBool())
+                     .arg(expanded).arg(longOutput.data(TranscriptModel::RevisionRole).toInt())
+                     .arg(noDetail).arg(detailSize));
+        return !model.index(0).data(TranscriptModel::CollapsedRole).toBool() && expanded
+            && !longOutput.data(TranscriptModel::CollapsedRole).toBool()
+            && longOutput.data(TranscriptModel::RevisionRole).toInt() == 1 && !noDetail
+            && detailSize < TranscriptModel::kMaxDetailChars + 100 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 块数上限
+    // ========================================
+    TEST("append - 超过 kMaxBlocks 时丢弃最早的块") {
+        TranscriptModel model;
+        for (int i = 0; i < TranscriptModel::kMaxBlocks - 1; ++i) {
+            model.append(Kind::Notice, QString("提示 %1").arg(i));
+        }
+        model.appendStreamText("最后的");       // 第 kMaxBlocks 个块
+        model.append(Kind::User, "追问");        // 超出上限，触发丢弃（同时结束流式块）
+        const quint64 firstId = model.index(0).data(TranscriptModel::IdRole).toULongLong();
+        const int rows = model.rowCount();
+        const QModelIndex reply = model.index(rows - 2);
+
+        PRINT_EXPECTED(QString("行数不超过 %1，最早的块被丢弃，倒数第 2 行仍是助手块").arg(TranscriptModel::kMaxBlocks));
+        PRINT_ACTUAL(QString("%1 行，第 1 行 id=%2，倒数第 2 行 \"%3\"")
+                     .arg(rows).arg(firstId).arg(reply.data().toString()));
+        return rows <= TranscriptModel::kMaxBlocks && firstId > 1
+            && reply.data().toString() == "最后的"
+            && Kind(model.index(rows - 1).data(TranscriptModel::KindRole).toInt()) == Kind::User ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,18 @@
+# TranscriptModel 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = TranscriptModelTest
+
+# 源文件
+SOURCES += TranscriptModelTest.cpp \
+           ../../src/ui/TranscriptModel.cpp
+
+HEADERS += ../../src/ui/TranscriptModel.h
+
+# 包含路径
+INCLUDEPATH += ../../src
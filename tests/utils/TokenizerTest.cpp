@@ -0,0 +1,139 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QDir>
+
+#include "core/utils/Tokenizer.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+// NOTE: fixtures/tokenizer_bpe.json 是手写的小词表（ByteLevel 预分词），合并规则只有:
+//   h+e、l+l、he+ll、hell+o → "hello"；Ġ+w、o+r、Ġw+or、l+d、Ġwor+ld → " world"；
+//   "你" 的 3 个 UTF-8 字节 → 1 个 token。其余字节各算 1 个 token。
+
+static QString emoji() {
+    return QString::fromUtf8("\xF0\x9F\x98\x80");  // 😀，UTF-16 中为一个代理对
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        Tokenizer 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QString fixturesDir = QDir::currentPath() + "/../fixtures";
+    if (!QDir(fixturesDir).exists()) {
+        fixturesDir = QDir::currentPath() + "/../../fixtures";
+    }
+    qDebug().noquote() << "测试数据目录: " << fixturesDir;
+
+    Tokenizer& tokenizer = Tokenizer::instance();
+    if (!tokenizer.loadFromFile(fixturesDir + "/tokenizer_bpe.json")) {
+        qCritical().noquote() << "❌ 无法加载 tokenizer_bpe.json";
+        return 1;
+    }
+
+    // ========================================
+    // 测试 1: ASCII
+    // ========================================
+    TEST("countTokens - ASCII 按合并规则合并，空格并入下一个片段") {
+        const int helloWorld = tokenizer.countTokens("hello world");
+        const int repeated = tokenizer.countTokens("hello world hello");
+        const int unknown = tokenizer.countTokens("hi!");
+
+        PRINT_EXPECTED("\"hello world\" = 2，\"hello world hello\" = 4（\" hello\" 没有 Ġ+hello 合并），\"hi!\" = 3");
+        PRINT_ACTUAL(QString("%1 / %2 / %3").arg(helloWorld).arg(repeated).arg(unknown));
+        return tokenizer.isLoaded() && helloWorld == 2 && repeated == 4 && unknown == 3 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: CJK 与 emoji
+    // ========================================
+    TEST("countTokens - 中文与 emoji 按 UTF-8 字节计算") {
+        const int cjk = tokenizer.countTokens(QString::fromUtf8("你好你"));
+        const int single = tokenizer.countTokens(emoji());
+        // 超过 128 个 UTF-16 单元的片段分块计算：'!' 之后第 64 个 emoji 正好跨在分块边界上
+        const QString longPiece = "!" + emoji().repeated(100);
+        const int longTokens = tokenizer.countTokens(longPiece);
+
+        PRINT_INPUT("长片段 UTF-16 长度", longPiece.size());
+        PRINT_EXPECTED("\"你好你\" = 1 + 3 + 1 = 5，😀 = 4，\"!\" + 100 个 😀 = 401");
+        PRINT_ACTUAL(QString("%1 / %2 / %3").arg(cjk).arg(single).arg(longTokens));
+        return cjk == 5 && single == 4 && longTokens == 401 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 片段缓存
+    // ========================================
+    TEST("cacheStats - 重复片段只计算一次") {
+        tokenizer.loadFromFile(fixturesDir + "/tokenizer_bpe.json");  // 清空缓存与统计
+        tokenizer.countTokens("hello hello hello");
+        const Tokenizer::CacheStats first = tokenizer.cacheStats();
+        tokenizer.countTokens("hello hello hello");
+        const Tokenizer::CacheStats second = tokenizer.cacheStats();
+
+        PRINT_EXPECTED("第一次: 2 次未命中（\"hello\"、\" hello\"）+ 1 次命中；第二次全部命中，条目数不变");
+        PRINT_ACTUAL(QString("第一次 hits=%1 misses=%2 entries=%3，第二次 hits=%4 misses=%5 entries=%6")
+                     .arg(first.hits).arg(first.misses).arg(first.entries)
+                     .arg(second.hits).arg(second.misses).arg(second.entries));
+        return first.misses == 2 && first.hits == 1 && first.entries == 2
+            && second.misses == 2 && second.hits == 4 && second.entries == 2 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 4: 截断
+    // ========================================
+    TEST("truncateToTokens - 在片段边界截断并返回总数") {
+        int total = 0;
+        const QString head = tokenizer.truncateToTokens("hello world hello", 3, &total);
+        int cjkTotal = 0;
+        const QString cjkHead = tokenizer.truncateToTokens(QString::fromUtf8("hello 你好"), 4, &cjkTotal);
+        const QString untouched = tokenizer.truncateToTokens("hello world", 2);
+
+        PRINT_EXPECTED("\"hello world\"（共 4）；\"hello\"（\" 你好\" 为 1 + 1 + 3 = 5，共 6）；未超出时原样返回");
+        PRINT_ACTUAL(QString("\"%1\"（共 %2）；\"%3\"（共 %4）；\"%5\"")
+                     .arg(head).arg(total).arg(cjkHead).arg(cjkTotal).arg(untouched));
+        return head == "hello world" && total == 4 && cjkHead == "hello" && cjkTotal == 6
+            && untouched == "hello world" ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,19 @@
+# Tokenizer 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = TokenizerTest
+
+# 源文件
+SOURCES += TokenizerTest.cpp \
+           ../../src/core/utils/Tokenizer.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+HEADERS += ../../src/core/utils/Tokenizer.h
+
+# 包含路径
+INCLUDEPATH += ../../src
@@ -0,0 +1,194 @@
+#include <QDebug>
+#include <QTextCodec>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QThread>
+#include <QJsonArray>
+#include <atomic>
+
+#include "core/utils/ToolSchemaLoader.h"
+
+static int g_testCount = 0;
+static int g_passCount = 0;
+
+// 打印测试信息的辅助宏
+#define PRINT_DIVIDER() qDebug().noquote() << "────────────────────────────────────────"
+#define PRINT_INPUT(name, value) qDebug().noquote() << "  [输入] " << name << ": " << value
+#define PRINT_EXPECTED(value) qDebug().noquote() << "  [期望] " << value
+#define PRINT_ACTUAL(value) qDebug().noquote() << "  [实际] " << value
+#define PRINT_RESULT(pass) qDebug().noquote() << (pass ? "  ✅ 通过" : "  ❌ 失败")
+
+#define TEST(name) \
+    ++g_testCount; \
+    PRINT_DIVIDER(); \
+    qDebug().noquote() << QString("[测试 %1] %2").arg(g_testCount).arg(name); \
+    if (auto result = [&]() -> int
+
+#define END_TEST \
+    (); result != 0) { \
+        PRINT_RESULT(false); \
+    } else { \
+        ++g_passCount; \
+        PRINT_RESULT(true); \
+    }
+
+static const char* kToolsYaml = R"(tools:
+  - name: view_file
+    description: "读取文件"
+    parameters:
+      - name: file_path
+        type: string
+        description: "文件路径"
+        required: true
+  - name: grep_search
+    description: "搜索内容"
+    parameters:
+      - name: query
+        type: string
+        required: true
+      - name: includes
+        type: array
+        items:
+          type: string
+)";
+
+static bool writeFile(const QString& path, const QByteArray& content) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    file.write(content);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
+
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << "        ToolSchemaLoader 测试套件";
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    QTemporaryDir tempDir;
+    const QString yamlPath = tempDir.filePath("tools.yaml");
+    ToolSchemaLoader::setCacheDir(tempDir.filePath("cache"));
+
+    // ========================================
+    // 测试 1: 编译并写入缓存
+    // ========================================
+    TEST("loadFromFile - 解析 YAML 并写入编译缓存") {
+        writeFile(yamlPath, kToolsYaml);
+        const QVector<Tool> tools = ToolSchemaLoader::loadFromFile(yamlPath);
+        const QString cacheFile = ToolSchemaLoader::cachePath(kToolsYaml);
+
+        PRINT_EXPECTED("2 个工具（view_file、grep_search），缓存文件存在，serialized 与 toJson() 一致");
+        if (tools.size() != 2 || tools[0].name != "view_file" || tools[1].name != "grep_search"
+            || tools[0].inputSchema["required"].toArray() != QJsonArray{"file_path"}
+            || tools[1].inputSchema["properties"].toObject()["includes"].toObject()["items"].toObject()["type"] != "string"
+            || !QFile::exists(cacheFile)) {
+            PRINT_ACTUAL(QString("%1 个工具，缓存 %2").arg(tools.size()).arg(QFile::exists(cacheFile)));
+            return 1;
+        }
+        for (const Tool& tool : tools) {
+            if (tool.serialized != QJsonDocument(tool.toJson()).toJson(QJsonDocument::Compact)) {
+                PRINT_ACTUAL("serialized 不一致: " + QString::fromUtf8(tool.serialized));
+                return 1;
+            }
+        }
+        PRINT_ACTUAL("✓ " + cacheFile);
+        return 0;
+    } END_TEST
+
+    // ========================================
+    // 测试 2: 缓存命中与失效
+    // ========================================
+    TEST("loadFromFile - 内容未变读缓存，内容变化重新解析，解析失败保留原有工具") {
+        // 改写缓存中的描述：再次加载得到改写后的描述，说明没有重新解析 YAML
+        const QString cacheFile = ToolSchemaLoader::cachePath(kToolsYaml);
+        QFile file(cacheFile);
+        file.open(QIODevice::ReadOnly);
+        QByteArray cached = file.readAll();
+        file.close();
+        writeFile(cacheFile, cached.replace("读取文件", "来自缓存"));
+        const QString fromCache = ToolSchemaLoader::loadFromFile(yamlPath).value(0).description;
+
+        // YAML 变化：哈希不同，重新解析
+        const QByteArray changed = QByteArray(kToolsYaml).replace("读取文件", "读取文件（新）");
+        writeFile(yamlPath, changed);
+        const QString fromYaml = ToolSchemaLoader::loadFromFile(yamlPath).value(0).description;
+
+        // 解析失败：返回空，已加载的工具保持不变
+        writeFile(yamlPath, "tools: [unterminated");
+        const bool failed = ToolSchemaLoader::loadFromFile(yamlPath).isEmpty();
+        const QString kept = ToolSchemaLoader::getToolSchema("view_file").description;
+
+        PRINT_EXPECTED("来自缓存 / 读取文件（新） / 解析失败 / 读取文件（新）");
+        PRINT_ACTUAL(QString("%1 / %2 / %3 / %4").arg(fromCache, fromYaml, failed ? "解析失败" : "未失败", kept));
+        return fromCache == "来自缓存" && fromYaml == "读取文件（新）" && failed && kept == "读取文件（新）"
+            && QFile::exists(ToolSchemaLoader::cachePath(changed)) ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 测试 3: 多线程查询与重新加载
+    // ========================================
+    TEST("多线程 - 查询线程始终看到完整的工具表") {
+        const QString pathA = tempDir.filePath("a.yaml");
+        const QString pathB = tempDir.filePath("b.yaml");
+        writeFile(pathA, kToolsYaml);
+        writeFile(pathB, QByteArray(kToolsYaml) + R"(  - name: list_directory
+    description: "列出目录"
+    parameters:
+      - name: path
+        type: string
+        required: true
+)");
+        ToolSchemaLoader::loadFromFile(pathA);
+
+        std::atomic<bool> stop{false};
+        std::atomic<int> lookups{0};
+        std::atomic<int> errors{0};
+        QList<QThread*> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.append(QThread::create([&]() {
+                while (!stop.load()) {
+                    const QVector<Tool> all = ToolSchemaLoader::getAllTools();
+                    const Tool tool = ToolSchemaLoader::getToolSchema("grep_search");
+                    if ((all.size() != 2 && all.size() != 3) || tool.serialized.isEmpty()) {
+                        errors.fetch_add(1);
+                    }
+                    lookups.fetch_add(1);
+                }
+            }));
+            readers.last()->start();
+        }
+        for (int i = 0; i < 50 || lookups.load() < 1000; ++i) {
+            ToolSchemaLoader::reload(i % 2 == 0 ? pathB : pathA);
+        }
+        stop.store(true);
+        for (QThread* thread : readers) {
+            thread->wait();
+            delete thread;
+        }
+
+        PRINT_EXPECTED("查询过程中没有不完整的结果");
+        PRINT_ACTUAL(QString("查询 %1 次，错误 %2 次").arg(lookups.load()).arg(errors.load()));
+        return errors.load() == 0 && lookups.load() > 0 ? 0 : 1;
+    } END_TEST
+
+    // ========================================
+    // 输出结果
+    // ========================================
+    qDebug().noquote() << "";
+    qDebug().noquote() << "════════════════════════════════════════";
+    qDebug().noquote() << QString("        测试完成: %1/%2 通过").arg(g_passCount).arg(g_testCount);
+    qDebug().noquote() << "════════════════════════════════════════";
+
+    if (g_passCount == g_testCount) {
+        qDebug().noquote() << "🎉 所有测试通过!";
+        return 0;
+    } else {
+        qCritical().noquote() << "❌ 有测试失败!";
+        return 1;
+    }
+}
@@ -0,0 +1,22 @@
+# ToolSchemaLoader 测试项目
+
+QT += core
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = ToolSchemaLoaderTest
+
+# yaml-cpp
+include(../../3rdparty/yaml-cpp.pri)
+
+# 源文件
+SOURCES += ToolSchemaLoaderTest.cpp \
+           ../../src/core/utils/ToolSchemaLoader.cpp \
+           ../../src/core/log/LogCategories.cpp
+
+HEADERS += ../../src/core/utils/ToolSchemaLoader.h
+
+# 包含路径
+INCLUDEPATH += ../../src